@@ -0,0 +1,151 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "ExampleParallelFor.h"
+#include "PDB_MappedFile.h"
+#include "PDB_RawFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_BlockLoader.h"
+#include "PDB_Types.h"
+
+
+namespace
+{
+#ifdef _WIN32
+	static bool Read(void*, intptr_t file, void* buffer, size_t size, uint64_t offset)
+	{
+		uint8_t* destination = static_cast<uint8_t*>(buffer);
+		while (size != 0u)
+		{
+			OVERLAPPED overlapped = {};
+			overlapped.Offset = static_cast<DWORD>(offset);
+			overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32u);
+
+			const DWORD bytesToRead = static_cast<DWORD>(std::min<size_t>(size, 1u << 30u));
+			DWORD bytesRead = 0u;
+			if (!ReadFile(reinterpret_cast<HANDLE>(file), destination, bytesToRead, &bytesRead, &overlapped) || (bytesRead == 0u))
+			{
+				return false;
+			}
+
+			destination += bytesRead;
+			size -= bytesRead;
+			offset += bytesRead;
+		}
+
+		return true;
+	}
+#endif
+
+	static void OnStreamLoaded(void* userData, uint32_t, PDB::ErrorCode error)
+	{
+		if (error == PDB::ErrorCode::Success)
+		{
+			static_cast<std::atomic<uint32_t>*>(userData)->fetch_add(1u);
+		}
+	}
+
+	static void LoadStreams(intptr_t file, size_t fileSize, const PDB::DBIStream& dbiStream, bool useIoUring)
+	{
+		TimedScope total(useIoUring ? "Loading using io_uring" : "Loading using a parallel loop");
+
+		std::vector<uint8_t> image(fileSize);
+
+		PDB::BlockLoader::Options options;
+#ifdef _WIN32
+		options.read = &Read;
+#endif
+		options.parallelFor = &ParallelFor;
+		options.useIoUring = useIoUring;
+
+		PDB::BlockLoader loader(file, image.data(), image.size(), options);
+		if (useIoUring && !loader.IsUsingIoUring())
+		{
+			printf("io_uring is not available\n");
+			total.Done();
+
+			return;
+		}
+
+		{
+			TimedScope scope("Loading directory");
+			if (loader.LoadDirectory() != PDB::ErrorCode::Success)
+			{
+				printf("Cannot load directory\n");
+				scope.Done();
+				total.Done();
+
+				return;
+			}
+
+			scope.Done();
+		}
+
+		std::atomic<uint32_t> loadedStreamCount(0u);
+
+		// first load the streams needed for symbolization, then all remaining ones in a single batch
+		{
+			TimedScope scope("Loading symbol streams");
+
+			const PDB::DBI::StreamHeader& header = dbiStream.GetHeader();
+			const uint32_t streamIndices[] = { 3u, header.publicStreamIndex, header.globalStreamIndex, header.symbolRecordStreamIndex };
+			if (loader.LoadStreams(streamIndices, 4u, &OnStreamLoaded, &loadedStreamCount) != PDB::ErrorCode::Success)
+			{
+				printf("Cannot load symbol streams\n");
+			}
+
+			scope.Done(loadedStreamCount.load());
+		}
+
+		{
+			TimedScope scope("Loading all streams");
+
+			std::vector<uint32_t> streamIndices(loader.GetRawFile().GetStreamCount());
+			for (size_t i = 0u; i < streamIndices.size(); ++i)
+			{
+				streamIndices[i] = static_cast<uint32_t>(i);
+			}
+
+			loadedStreamCount = 0u;
+			if (loader.LoadStreams(streamIndices.data(), static_cast<uint32_t>(streamIndices.size()), &OnStreamLoaded, &loadedStreamCount) != PDB::ErrorCode::Success)
+			{
+				printf("Cannot load all streams\n");
+			}
+
+			scope.Done(loadedStreamCount.load());
+		}
+
+		total.Done();
+	}
+}
+
+
+void ExampleBlockLoader(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::MappedFile& pdbFile);
+void ExampleBlockLoader(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::MappedFile& pdbFile)
+{
+	TimedScope total("\nRunning example \"BlockLoader\"");
+
+	// the file has just been memory-mapped and read, so this measures reading from the page cache.
+	// drop the page cache before running the examples to measure cold-cache loading.
+	const PDB::SuperBlock* superBlock = rawPdbFile.GetSuperBlock();
+	if (!superBlock)
+	{
+		printf("Block loading is only supported for MSF files\n");
+		total.Done();
+
+		return;
+	}
+
+	const size_t fileSize = static_cast<size_t>(superBlock->blockSize) * static_cast<size_t>(superBlock->blockCount);
+
+	// the loader only reads from the file, it doesn't use the memory-mapped view
+	const intptr_t file = pdbFile.GetFileHandle();
+#ifndef _WIN32
+	LoadStreams(file, fileSize, dbiStream, true);
+#endif
+	LoadStreams(file, fileSize, dbiStream, false);
+
+	total.Done();
+}
@@ -0,0 +1,69 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "PDB_RawFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_Demangler.h"
+
+
+void ExampleDemangler(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream);
+void ExampleDemangler(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream)
+{
+	TimedScope total("\nRunning example \"Demangler\"");
+
+	const PDB::CoalescedMSFStream symbolRecordStream = dbiStream.CreateSymbolRecordStream(rawPdbFile);
+	const PDB::PublicSymbolStream publicSymbolStream = dbiStream.CreatePublicSymbolStream(rawPdbFile);
+
+	// the names of public symbols are decorated, and point directly into the symbol record stream
+	std::vector<const char*> names;
+	{
+		const PDB::ArrayView<PDB::HashRecord> hashRecords = publicSymbolStream.GetRecords();
+		names.reserve(hashRecords.GetLength());
+
+		for (const PDB::HashRecord& hashRecord : hashRecords)
+		{
+			const PDB::CodeView::DBI::Record* record = publicSymbolStream.GetRecord(symbolRecordStream, hashRecord);
+			if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_PUB32)
+			{
+				names.push_back(record->data.S_PUB32.name);
+			}
+		}
+	}
+
+	PDB::Demangler demangler;
+
+	// demangling single names reuses the output of the demangler, which must be copied if it is needed later
+	{
+		TimedScope scope("Demangling public symbols one by one");
+
+		size_t demangledCount = 0u;
+		for (const char* name : names)
+		{
+			const char* demangledName = demangler.Demangle(name);
+			demangledCount += (demangledName != name) ? 1u : 0u;
+		}
+
+		scope.Done(demangledCount);
+	}
+
+	// demangling names in batches stores all of them in an arena, and the cache makes sure that names shared
+	// by several symbols are demangled only once
+	PDB::DemangleArena arena;
+	PDB::DemangleCache cache;
+	std::vector<const char*> demangledNames(names.size());
+	{
+		TimedScope scope("Demangling public symbols in a batch");
+		demangler.DemangleBatch(names.data(), names.size(), demangledNames.data(), arena, &cache);
+		scope.Done(names.size());
+	}
+
+	printf("Stored %zu demangled names in %zu bytes\n", cache.GetSize(), arena.GetSize());
+
+	const size_t exampleCount = (names.size() < 10u) ? names.size() : 10u;
+	for (size_t i = 0u; i < exampleCount; ++i)
+	{
+		printf("  %s\n    %s\n", names[i], demangledNames[i]);
+	}
+}
@@ -65,8 +65,11 @@ void ExampleFunctionSymbols(const PDB::RawFile& rawPdbFile, const PDB::DBIStream
 				continue;
 			}
 
+			// separated code blocks are nested inside the procedure they were split off from
+			size_t procedureIndex = 0u;
+
 			const PDB::ModuleSymbolStream moduleSymbolStream = module.CreateSymbolStream(rawPdbFile);
-			moduleSymbolStream.ForEachSymbol([&functionSymbols, &seenFunctionRVAs, &imageSectionStream](const PDB::CodeView::DBI::Record* record)
+			moduleSymbolStream.ForEachSymbol([&functionSymbols, &seenFunctionRVAs, &imageSectionStream, &procedureIndex](const PDB::CodeView::DBI::Record* record)
 			{
 				// only grab function symbols from the module streams
 				const char* name = nullptr;
@@ -118,12 +121,32 @@ void ExampleFunctionSymbols(const PDB::RawFile& rawPdbFile, const PDB::DBIStream
 					rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_GPROC32_ID.section, record->data.S_GPROC32_ID.offset);
 					size = record->data.S_GPROC32_ID.codeSize;
 				}
+				else if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_SEPCODE)
+				{
+					// PGO builds split functions into hot and cold parts. the cold part lives somewhere else in the image, and is
+					// described by a S_SEPCODE record. store it under the name of its parent, otherwise cold code would be attributed
+					// to whatever function happens to be located in front of it.
+					const uint32_t parentRVA = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_SEPCODE.parentSection, record->data.S_SEPCODE.parentOffset);
+					if ((procedureIndex < functionSymbols.size()) && (functionSymbols[procedureIndex].rva == parentRVA))
+					{
+						rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_SEPCODE.section, record->data.S_SEPCODE.offset);
+						if (rva != 0u)
+						{
+							functionSymbols.push_back(FunctionSymbol { functionSymbols[procedureIndex].name, rva, record->data.S_SEPCODE.length, nullptr });
+							seenFunctionRVAs.emplace(rva);
+						}
+					}
+
+					return;
+				}
 
 				if (rva == 0u)
 				{
 					return;
 				}
 
+				procedureIndex = functionSymbols.size();
+
 				functionSymbols.push_back(FunctionSymbol { name, rva, size, nullptr });
 				seenFunctionRVAs.emplace(rva);
 			});
@@ -3,17 +3,17 @@
 
 #include "Examples_PCH.h"
 #include "ExampleTimedScope.h"
-#include "ExampleTypeTable.h"
+#include "PDB_TypeTable.h"
 #include "PDB_RawFile.h"
 #include "PDB_DBIStream.h"
 #include "PDB_TPIStream.h"
 
 using SymbolRecordKind = PDB::CodeView::DBI::SymbolRecordKind;
 
-static std::string GetVariableTypeName(const TypeTable& typeTable, uint32_t typeIndex)
+static std::string GetVariableTypeName(const PDB::TypeTable& typeTable, uint32_t typeIndex)
 {
 	// Defined in ExampleTypes.cpp
-	extern std::string GetTypeName(const TypeTable & typeTable, uint32_t typeIndex);
+	extern std::string GetTypeName(const PDB::TypeTable& typeTable, uint32_t typeIndex);
 
 	std::string typeName = GetTypeName(typeTable, typeIndex);
 
@@ -44,7 +44,7 @@ void ExampleFunctionVariables(const PDB::RawFile& rawPdbFile, const PDB::DBIStre
 	TimedScope total("\nRunning example \"Function variables\"");
 
 	TimedScope typeTableScope("Create TypeTable");
-	TypeTable typeTable(tpiStream);
+	PDB::TypeTable typeTable(tpiStream);
 	typeTableScope.Done();
 
 	// in order to keep the example easy to understand, we load the PDB data serially.
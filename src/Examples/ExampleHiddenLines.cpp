@@ -0,0 +1,255 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_Types.h"
+#include "PDB_Util.h"
+#include "PDB_DBIStream.h"
+#include "PDB_NamesStream.h"
+#include "PDB_LineIndex.h"
+
+
+// Checks that code covered by hidden lines doesn't resolve to a line, using a small synthetic PDB built in memory.
+// The PDB holds a single module whose line stream marks parts of its code with both kinds of hidden line numbers.
+namespace
+{
+	static const uint32_t BlockSize = 4096u;
+	static const uint32_t SectionRVA = 0x1000u;
+
+	// streams 0 to 2 are empty, the DBI stream is followed by the module stream, the section headers and the /names stream
+	static const uint32_t DBIStreamIndex = 3u;
+	static const uint32_t ModuleStreamIndex = 4u;
+	static const uint32_t SectionHeaderStreamIndex = 5u;
+	static const uint32_t NamesStreamIndex = 6u;
+	static const uint32_t StreamCount = 7u;
+
+	// the directory is stored in block 3 and its index in block 4, all streams fit into a single block following them
+	static const uint32_t DirectoryBlock = 3u;
+	static const uint32_t DirectoryIndexBlock = 4u;
+	static const uint32_t FirstStreamBlock = 5u;
+
+	struct ExpectedLine
+	{
+		uint32_t offset;								// offset of the line's code in the section
+		uint32_t lineNumber;							// 0 if the code doesn't belong to any line
+	};
+
+	// the line numbers stored in the line stream, each covering 8 bytes of code
+	static const uint32_t StoredLineNumbers[] = { 10u, 11u, PDB::CodeView::DBI::Line::HiddenLineNumber, 12u, PDB::CodeView::DBI::Line::AlternateHiddenLineNumber };
+	static const uint32_t LineCodeSize = 8u;
+
+	static const ExpectedLine ExpectedLines[] =
+	{
+		{ 0x00u, 10u },
+		{ 0x08u, 11u },
+		{ 0x10u, 0u },
+		{ 0x18u, 12u },
+		{ 0x20u, 0u }
+	};
+
+
+	template <typename T>
+	static void Append(std::vector<uint8_t>& stream, const T& value)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+		stream.insert(stream.end(), bytes, bytes + sizeof(T));
+	}
+
+	static void AppendString(std::vector<uint8_t>& stream, const char* string)
+	{
+		stream.insert(stream.end(), string, string + strlen(string) + 1u);
+	}
+
+	static void AlignTo4(std::vector<uint8_t>& stream)
+	{
+		stream.resize((stream.size() + 3u) & ~static_cast<size_t>(3u), 0u);
+	}
+
+	static std::vector<uint8_t> BuildModuleStream(uint32_t& c13Size)
+	{
+		std::vector<uint8_t> stream;
+
+		// the module stream starts with its signature, there are no symbols
+		Append(stream, uint32_t(4u));
+
+		// the only file is found at offset 1 of the /names stream
+		const size_t c13Offset = stream.size();
+		Append(stream, PDB::CodeView::DBI::DebugSubsectionHeader { PDB::CodeView::DBI::DebugSubsectionKind::S_FILECHECKSUMS, 8u });
+		Append(stream, uint32_t(1u));
+		Append(stream, uint32_t(0u));
+
+		const uint32_t lineCount = static_cast<uint32_t>(sizeof(StoredLineNumbers) / sizeof(StoredLineNumbers[0]));
+		const uint32_t blockSize = static_cast<uint32_t>(sizeof(PDB::CodeView::DBI::LinesFileBlockHeader) + lineCount * sizeof(PDB::CodeView::DBI::Line));
+		Append(stream, PDB::CodeView::DBI::DebugSubsectionHeader { PDB::CodeView::DBI::DebugSubsectionKind::S_LINES, static_cast<uint32_t>(sizeof(PDB::CodeView::DBI::LinesHeader)) + blockSize });
+
+		PDB::CodeView::DBI::LinesHeader linesHeader = {};
+		linesHeader.sectionIndex = 1u;
+		linesHeader.codeSize = lineCount * LineCodeSize;
+		Append(stream, linesHeader);
+		Append(stream, PDB::CodeView::DBI::LinesFileBlockHeader { 0u, lineCount, blockSize });
+
+		for (uint32_t i = 0u; i < lineCount; ++i)
+		{
+			PDB::CodeView::DBI::Line line = {};
+			line.offset = i * LineCodeSize;
+			line.linenumStart = StoredLineNumbers[i] & 0xFFFFFFu;
+			line.fStatement = 1u;
+			Append(stream, line);
+		}
+
+		c13Size = static_cast<uint32_t>(stream.size() - c13Offset);
+
+		return stream;
+	}
+
+	static std::vector<uint8_t> BuildDBIStream(uint32_t c13Size)
+	{
+		std::vector<uint8_t> moduleInfo;
+		{
+			PDB::DBI::ModuleInfo info = {};
+			info.moduleSymbolStreamIndex = static_cast<uint16_t>(ModuleStreamIndex);
+			info.symbolSize = 4u;
+			info.c13Size = c13Size;
+			Append(moduleInfo, info);
+			AppendString(moduleInfo, "a.obj");
+			AppendString(moduleInfo, "a.obj");
+			AlignTo4(moduleInfo);
+		}
+
+		PDB::DBI::StreamHeader header = {};
+		header.signature = PDB::DBI::StreamHeader::Signature;
+		header.version = PDB::DBI::StreamHeader::Version::V70;
+		header.age = 1u;
+		header.globalStreamIndex = PDB::NilStreamIndex;
+		header.publicStreamIndex = PDB::NilStreamIndex;
+		header.symbolRecordStreamIndex = PDB::NilStreamIndex;
+		header.moduleInfoSize = static_cast<uint32_t>(moduleInfo.size());
+		header.optionalDebugHeaderSize = sizeof(PDB::DBI::DebugHeader);
+		header.machine = 0x8664u;
+
+		PDB::DBI::DebugHeader debugHeader;
+		memset(&debugHeader, 0xFF, sizeof(debugHeader));
+		debugHeader.sectionHeaderStreamIndex = static_cast<uint16_t>(SectionHeaderStreamIndex);
+
+		std::vector<uint8_t> stream;
+		Append(stream, header);
+		stream.insert(stream.end(), moduleInfo.begin(), moduleInfo.end());
+		Append(stream, debugHeader);
+
+		return stream;
+	}
+
+	static std::vector<uint8_t> BuildFile(void)
+	{
+		std::vector<uint8_t> streams[StreamCount];
+
+		uint32_t c13Size = 0u;
+		streams[ModuleStreamIndex] = BuildModuleStream(c13Size);
+		streams[DBIStreamIndex] = BuildDBIStream(c13Size);
+
+		PDB::IMAGE_SECTION_HEADER sectionHeader = {};
+		memcpy(sectionHeader.Name, ".text", 5u);
+		sectionHeader.Misc.VirtualSize = BlockSize;
+		sectionHeader.VirtualAddress = SectionRVA;
+		Append(streams[SectionHeaderStreamIndex], sectionHeader);
+
+		Append(streams[NamesStreamIndex], PDB::NamesHeader { 0xEFFEEFFEu, 1u, 7u });
+		AppendString(streams[NamesStreamIndex], "");
+		AppendString(streams[NamesStreamIndex], "a.cpp");
+
+		// every stream that isn't empty is stored in a block of its own
+		std::vector<uint32_t> directory;
+		directory.push_back(StreamCount);
+		for (uint32_t i = 0u; i < StreamCount; ++i)
+		{
+			directory.push_back(static_cast<uint32_t>(streams[i].size()));
+		}
+
+		uint32_t blockCount = FirstStreamBlock;
+		for (uint32_t i = 0u; i < StreamCount; ++i)
+		{
+			if (!streams[i].empty())
+			{
+				directory.push_back(blockCount++);
+			}
+		}
+
+		std::vector<uint8_t> file(static_cast<size_t>(blockCount) * BlockSize, 0u);
+		memcpy(&file[DirectoryBlock * BlockSize], directory.data(), directory.size() * sizeof(uint32_t));
+		memcpy(&file[DirectoryIndexBlock * BlockSize], &DirectoryBlock, sizeof(DirectoryBlock));
+
+		uint32_t block = FirstStreamBlock;
+		for (uint32_t i = 0u; i < StreamCount; ++i)
+		{
+			if (!streams[i].empty())
+			{
+				memcpy(&file[static_cast<size_t>(block++) * BlockSize], streams[i].data(), streams[i].size());
+			}
+		}
+
+		PDB::SuperBlock* superBlock = reinterpret_cast<PDB::SuperBlock*>(file.data());
+		memcpy(superBlock->fileMagic, PDB::SuperBlock::MAGIC, sizeof(PDB::SuperBlock::MAGIC));
+		superBlock->blockSize = BlockSize;
+		superBlock->freeBlockMapIndex = 1u;
+		superBlock->blockCount = blockCount;
+		superBlock->directorySize = static_cast<uint32_t>(directory.size() * sizeof(uint32_t));
+		superBlock->directoryBlockIndices[0] = DirectoryIndexBlock;
+
+		return file;
+	}
+}
+
+
+bool ExampleHiddenLines(void);
+bool ExampleHiddenLines(void)
+{
+	TimedScope total("\nRunning example \"HiddenLines\"");
+
+	const std::vector<uint8_t> file = BuildFile();
+	if (PDB::ValidateFile(file.data()) != PDB::ErrorCode::Success)
+	{
+		printf("Invalid file\n");
+		total.Done();
+
+		return false;
+	}
+
+	const PDB::RawFile rawFile = PDB::CreateRawFile(file.data());
+	if (PDB::HasValidDBIStream(rawFile) != PDB::ErrorCode::Success)
+	{
+		printf("Invalid DBI stream\n");
+		total.Done();
+
+		return false;
+	}
+
+	const PDB::DBIStream dbiStream = PDB::CreateDBIStream(rawFile);
+	const PDB::ImageSectionStream imageSectionStream = dbiStream.CreateImageSectionStream(rawFile);
+	const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawFile);
+	const PDB::NamesStream namesStream(rawFile, NamesStreamIndex);
+	const PDB::LineIndex lineIndex(rawFile, imageSectionStream, moduleInfoStream, namesStream);
+
+	bool success = true;
+	for (const ExpectedLine& expected : ExpectedLines)
+	{
+		// check the first and the last byte of each line's code
+		for (uint32_t byte = 0u; byte < LineCodeSize; byte += LineCodeSize - 1u)
+		{
+			const uint32_t rva = SectionRVA + expected.offset + byte;
+			const PDB::LineIndex::Line* line = lineIndex.FindLine(rva);
+			const uint32_t lineNumber = line ? line->lineNumber : 0u;
+			if ((lineNumber != expected.lineNumber) || (line && (strcmp(lineIndex.GetFileName(*line), "a.cpp") != 0)))
+			{
+				printf("RVA 0x%X resolved to line %u instead of %u\n", rva, lineNumber, expected.lineNumber);
+				success = false;
+			}
+		}
+	}
+
+	total.Done(lineIndex.GetLines().GetLength());
+
+	return success;
+}
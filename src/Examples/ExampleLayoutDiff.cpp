@@ -0,0 +1,67 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "ExampleParallelFor.h"
+#include "PDB_TPIStream.h"
+#include "PDB_TypeTable.h"
+#include "PDB_TypeLayout.h"
+
+
+namespace
+{
+	static const char* GetDifferenceName(PDB::TypeLayoutDifference::Kind kind)
+	{
+		switch (kind)
+		{
+			case PDB::TypeLayoutDifference::Kind::TypeAdded:				return "type added";
+			case PDB::TypeLayoutDifference::Kind::TypeRemoved:				return "type removed";
+			case PDB::TypeLayoutDifference::Kind::TypeSizeChanged:			return "size changed";
+			case PDB::TypeLayoutDifference::Kind::MemberAdded:				return "member added";
+			case PDB::TypeLayoutDifference::Kind::MemberRemoved:			return "member removed";
+			case PDB::TypeLayoutDifference::Kind::MemberOffsetChanged:		return "member offset changed";
+			case PDB::TypeLayoutDifference::Kind::MemberSizeChanged:		return "member size changed";
+			case PDB::TypeLayoutDifference::Kind::MemberTypeChanged:		return "member type changed";
+			case PDB::TypeLayoutDifference::Kind::MemberBitfieldChanged:	return "member bitfield changed";
+		}
+
+		return "unknown";
+	}
+}
+
+
+void ExampleLayoutDiff(const PDB::TPIStream& tpiStream);
+void ExampleLayoutDiff(const PDB::TPIStream& tpiStream)
+{
+	TimedScope total("\nRunning example \"LayoutDiff\"");
+
+	const PDB::TypeTable typeTable(tpiStream);
+
+	PDB::TypeLayoutMap layoutMap;
+	{
+		TimedScope scope("Building type layouts in parallel");
+		layoutMap = PDB::TypeLayoutMap(typeTable, &ParallelFor, nullptr);
+		scope.Done(layoutMap.GetLayouts().GetLength());
+	}
+
+	// only a single PDB is at hand, so its layouts are compared against themselves. a patch would compare the layouts of
+	// the shipped PDB against the ones of the new PDB instead.
+	PDB::GrowableArray<PDB::TypeLayoutDifference> differences;
+	{
+		TimedScope scope("Comparing type layouts");
+		PDB::DiffTypeLayouts(layoutMap, layoutMap, differences);
+		scope.Done(differences.GetSize());
+	}
+
+	for (size_t i = 0u; i < differences.GetSize(); ++i)
+	{
+		const PDB::TypeLayoutDifference& difference = differences.GetData()[i];
+		const PDB::TypeLayoutMap::Layout* layout = difference.newLayout ? difference.newLayout : difference.oldLayout;
+		const PDB::LayoutMember* member = difference.newMember ? difference.newMember : difference.oldMember;
+
+		printf("%s: %s%s%s\n", GetDifferenceName(difference.kind), layout->name, member ? "::" : "", (member && member->name) ? member->name : "");
+	}
+
+	printf("%zu differences in %zu type layouts\n", differences.GetSize(), layoutMap.GetLayouts().GetLength());
+}
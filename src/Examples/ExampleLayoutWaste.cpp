@@ -0,0 +1,39 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "ExampleParallelFor.h"
+#include "PDB_TPIStream.h"
+#include "PDB_TypeTable.h"
+#include "PDB_TypeLayoutWaste.h"
+#include <cinttypes>
+
+
+void ExampleLayoutWaste(const PDB::TPIStream& tpiStream);
+void ExampleLayoutWaste(const PDB::TPIStream& tpiStream)
+{
+	TimedScope total("\nRunning example \"LayoutWaste\"");
+
+	const PDB::TypeTable typeTable(tpiStream);
+
+	PDB::TypeLayoutWaste layoutWaste;
+	{
+		TimedScope scope("Analyzing type layouts in parallel");
+		layoutWaste = PDB::TypeLayoutWaste(typeTable, &ParallelFor, nullptr);
+		scope.Done(layoutWaste.GetTypes().GetLength());
+	}
+
+	const PDB::ArrayView<PDB::TypeLayoutWaste::Type> types = layoutWaste.GetTypes();
+	const size_t printCount = std::min<size_t>(types.GetLength(), 20u);
+
+	printf("%zu types waste memory, the worst ones are:\n", types.GetLength());
+	for (size_t i = 0u; i < printCount; ++i)
+	{
+		const PDB::TypeLayoutWaste::Type& type = types[i];
+		printf("%s: %" PRIu64 " bytes, %" PRIu64 " bytes padding in %u holes (largest %" PRIu64 "), %" PRIu64 " bytes tail padding, %u unused bitfield bits, "
+			"%u members crossing cache lines, %" PRIu64 " bytes when reordered\n",
+			type.name, type.size, type.paddingBytes, type.holeCount, type.largestHoleBytes, type.tailPaddingBytes, type.unusedBitfieldBits,
+			type.straddlingMemberCount, type.packedSize);
+	}
+}
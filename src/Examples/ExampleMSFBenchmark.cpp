@@ -0,0 +1,239 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_Types.h"
+#include "PDB_Util.h"
+#include "PDB_CoalescedMSFStream.h"
+#include "PDB_DirectMSFStream.h"
+
+#ifndef _WIN32
+#	include <sys/mman.h>
+#endif
+
+
+// Benchmarks the MSF layer on synthetic PDBs larger than 4 GiB, using the block sizes of large PDBs.
+// The file is never written to disk: it lives in virtual memory, and only the pages touched by the benchmark are backed by physical memory.
+namespace
+{
+	static const size_t FileSize = (4ull << 30u) + (512ull << 20u);
+	static const uint32_t StreamSize = 64u << 20u;
+	static const uint32_t StreamCount = 4u;
+	static const uint32_t RandomReadCount = 1u << 20u;
+
+	static void* AllocateVirtualMemory(size_t size)
+	{
+#ifdef _WIN32
+		return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+		void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		return (memory == MAP_FAILED) ? nullptr : memory;
+#endif
+	}
+
+	static void FreeVirtualMemory(void* memory, size_t size)
+	{
+#ifdef _WIN32
+		(void)size;
+		VirtualFree(memory, 0u, MEM_RELEASE);
+#else
+		munmap(memory, size);
+#endif
+	}
+
+	// the value stored at each 32-bit word of a stream, so that reads can be verified
+	static uint32_t GetExpectedWord(uint32_t streamIndex, size_t offset)
+	{
+		return static_cast<uint32_t>(offset / sizeof(uint32_t)) ^ (streamIndex * 0x9E3779B9u);
+	}
+
+	// builds an MSF file with the following streams:
+	//	0: empty
+	//	1: contiguous, straddling the 4 GiB boundary
+	//	2: above 4 GiB, in runs of 4 contiguous blocks whose order is interleaved
+	//	3: above 4 GiB, all blocks in reverse order
+	static void BuildFile(uint8_t* file, uint32_t blockSize)
+	{
+		const uint32_t blockCount = static_cast<uint32_t>(FileSize / blockSize);
+		const uint32_t blocksPerStream = StreamSize / blockSize;
+		const uint32_t firstBlockAbove4GiB = static_cast<uint32_t>((4ull << 30u) / blockSize);
+
+		std::vector<uint32_t> streamBlocks[StreamCount];
+		for (uint32_t i = 0u; i < blocksPerStream; ++i)
+		{
+			streamBlocks[1u].push_back(firstBlockAbove4GiB - blocksPerStream / 2u + i);
+		}
+
+		const uint32_t runCount = blocksPerStream / 4u;
+		for (uint32_t run = 0u; run < runCount; ++run)
+		{
+			const uint32_t interleavedRun = (run % 2u == 0u) ? run / 2u : runCount / 2u + run / 2u;
+			for (uint32_t i = 0u; i < 4u; ++i)
+			{
+				streamBlocks[2u].push_back(firstBlockAbove4GiB + blocksPerStream + interleavedRun * 4u + i);
+			}
+		}
+
+		for (uint32_t i = 0u; i < blocksPerStream; ++i)
+		{
+			streamBlocks[3u].push_back(firstBlockAbove4GiB + 3u * blocksPerStream - 1u - i);
+		}
+
+		// the directory starts at block 3, followed by the blocks storing the indices of directory blocks
+		std::vector<uint32_t> directory;
+		directory.push_back(StreamCount);
+		directory.push_back(0u);
+		directory.push_back(StreamSize);
+		directory.push_back(StreamSize);
+		directory.push_back(StreamSize);
+		for (uint32_t i = 0u; i < StreamCount; ++i)
+		{
+			directory.insert(directory.end(), streamBlocks[i].begin(), streamBlocks[i].end());
+		}
+
+		const uint32_t directorySize = static_cast<uint32_t>(directory.size() * sizeof(uint32_t));
+		const uint32_t directoryBlockCount = PDB::ConvertSizeToBlockCount(directorySize, blockSize);
+		const uint32_t directoryIndexBlockCount = PDB::ConvertSizeToBlockCount(directoryBlockCount * sizeof(uint32_t), blockSize);
+		const uint32_t firstDirectoryBlock = 3u;
+		const uint32_t firstDirectoryIndexBlock = firstDirectoryBlock + directoryBlockCount;
+
+		std::memcpy(file + static_cast<size_t>(firstDirectoryBlock) * blockSize, directory.data(), directorySize);
+
+		uint32_t* directoryIndices = reinterpret_cast<uint32_t*>(file + static_cast<size_t>(firstDirectoryIndexBlock) * blockSize);
+		for (uint32_t i = 0u; i < directoryBlockCount; ++i)
+		{
+			directoryIndices[i] = firstDirectoryBlock + i;
+		}
+
+		PDB::SuperBlock* superBlock = reinterpret_cast<PDB::SuperBlock*>(file);
+		std::memcpy(superBlock->fileMagic, PDB::SuperBlock::MAGIC, sizeof(PDB::SuperBlock::MAGIC));
+		superBlock->blockSize = blockSize;
+		superBlock->freeBlockMapIndex = 1u;
+		superBlock->blockCount = blockCount;
+		superBlock->directorySize = directorySize;
+		for (uint32_t i = 0u; i < directoryIndexBlockCount; ++i)
+		{
+			superBlock->directoryBlockIndices[i] = firstDirectoryIndexBlock + i;
+		}
+
+		// fill the stream data
+		for (uint32_t streamIndex = 1u; streamIndex < StreamCount; ++streamIndex)
+		{
+			for (uint32_t i = 0u; i < blocksPerStream; ++i)
+			{
+				uint32_t* block = reinterpret_cast<uint32_t*>(file + static_cast<size_t>(streamBlocks[streamIndex][i]) * blockSize);
+				for (uint32_t j = 0u; j < blockSize / sizeof(uint32_t); ++j)
+				{
+					block[j] = GetExpectedWord(streamIndex, static_cast<size_t>(i) * blockSize + j * sizeof(uint32_t));
+				}
+			}
+		}
+	}
+
+	static bool RunBenchmark(uint32_t blockSize)
+	{
+		char message[128u];
+		snprintf(message, sizeof(message), "Block size %u KiB, file size %zu MiB", blockSize >> 10u, FileSize >> 20u);
+		TimedScope total(message);
+
+		uint8_t* file = static_cast<uint8_t*>(AllocateVirtualMemory(FileSize));
+		if (!file)
+		{
+			printf("Cannot allocate %zu MiB of virtual memory\n", FileSize >> 20u);
+			total.Done();
+
+			return false;
+		}
+
+		BuildFile(file, blockSize);
+
+		if (PDB::ValidateFile(file) != PDB::ErrorCode::Success)
+		{
+			printf("Invalid file\n");
+			FreeVirtualMemory(file, FileSize);
+			total.Done();
+
+			return false;
+		}
+
+		bool success = true;
+		{
+			TimedScope scope("Creating raw file");
+			const PDB::RawFile rawFile = PDB::CreateRawFile(file);
+			scope.Done(rawFile.GetStreamCount());
+
+			static const char* const streamNames[StreamCount] = { "empty", "contiguous", "runs of 4 blocks", "reversed" };
+			for (uint32_t streamIndex = 1u; streamIndex < StreamCount; ++streamIndex)
+			{
+				// coalesce the whole stream
+				{
+					snprintf(message, sizeof(message), "Coalescing %s stream", streamNames[streamIndex]);
+					TimedScope coalesceScope(message);
+
+					const PDB::CoalescedMSFStream stream = rawFile.CreateMSFStream<PDB::CoalescedMSFStream>(streamIndex);
+					const uint32_t* words = stream.GetDataAtOffset<uint32_t>(0u);
+					for (size_t i = 0u; i < stream.GetSize() / sizeof(uint32_t); ++i)
+					{
+						success &= (words[i] == GetExpectedWord(streamIndex, i * sizeof(uint32_t)));
+					}
+
+					coalesceScope.Done(stream.GetSize());
+				}
+
+				// random reads that frequently straddle block boundaries
+				{
+					snprintf(message, sizeof(message), "Random reads from %s stream", streamNames[streamIndex]);
+					TimedScope readScope(message);
+
+					const PDB::DirectMSFStream stream = rawFile.CreateMSFStream<PDB::DirectMSFStream>(streamIndex);
+
+					uint32_t random = 1u;
+					uint32_t words[64u];
+					for (uint32_t i = 0u; i < RandomReadCount; ++i)
+					{
+						random = random * 1664525u + 1013904223u;
+
+						const size_t offset = (random % (StreamSize - sizeof(words))) & ~static_cast<size_t>(3u);
+						stream.ReadAtOffset(words, sizeof(words), offset);
+						success &= (words[0] == GetExpectedWord(streamIndex, offset));
+						success &= (words[63] == GetExpectedWord(streamIndex, offset + 63u * sizeof(uint32_t)));
+					}
+
+					readScope.Done(RandomReadCount);
+				}
+			}
+		}
+
+		FreeVirtualMemory(file, FileSize);
+
+		if (!success)
+		{
+			printf("Data mismatch\n");
+		}
+
+		total.Done();
+
+		return success;
+	}
+}
+
+
+bool ExampleMSFBenchmark(void);
+bool ExampleMSFBenchmark(void)
+{
+	TimedScope total("\nRunning example \"MSFBenchmark\"");
+
+	// PDBs larger than 4 GiB use block sizes above 4 KiB
+	bool success = true;
+	for (uint32_t blockSize = 4096u; blockSize <= 32768u; blockSize <<= 1u)
+	{
+		success &= RunBenchmark(blockSize);
+	}
+
+	total.Done();
+
+	return success;
+}
@@ -2,8 +2,8 @@
 // See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
 
 #include "Examples_PCH.h"
-#include "ExampleMemoryMappedFile.h"
 #include "PDB.h"
+#include "PDB_MappedFile.h"
 #include "PDB_RawFile.h"
 #include "PDB_InfoStream.h"
 #include "PDB_DBIStream.h"
@@ -42,6 +42,10 @@ namespace
 			case PDB::ErrorCode::UnknownVersion:
 				printf("Unknown version\n");
 				return true;
+
+			case PDB::ErrorCode::ReadError:
+				printf("Cannot read file\n");
+				return true;
 		}
 
 		// only ErrorCode::Success means there wasn't an error, so all other paths have to assume there was an error
@@ -90,39 +94,60 @@ extern void ExampleFunctionSymbols(const PDB::RawFile&, const PDB::DBIStream&);
 extern void ExampleFunctionVariables(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::TPIStream&);
 extern void ExampleLines(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::InfoStream& infoStream);
 extern void ExampleTypes(const PDB::TPIStream&);
+extern void ExampleProgressiveLoading(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const void* pdbData);
+extern void ExampleBlockLoader(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::MappedFile& pdbFile);
+extern void ExampleSharedIndex(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::InfoStream& infoStream);
+extern void ExampleDemangler(const PDB::RawFile&, const PDB::DBIStream&);
+extern void ExampleNameSearch(const PDB::RawFile&, const PDB::DBIStream&);
+extern void ExampleTypeHashes(const PDB::RawFile&, const PDB::TPIStream&);
+extern void ExampleMergedTypes(const PDB::TPIStream&);
+extern void ExampleLayoutDiff(const PDB::TPIStream&);
+extern void ExampleLayoutWaste(const PDB::TPIStream&);
+extern void ExamplePEImage(const PDB::InfoStream& infoStream, const char* imagePath);
+extern bool ExampleMSFBenchmark(void);
+extern bool ExampleHiddenLines(void);
 
 int main(int argc, char** argv)
 {
-	if (argc != 2)
+	if ((argc != 2) && (argc != 3))
 	{
-		printf("Usage: Examples <PDB path>\nError: Incorrect usage\n");
+		printf("Usage: Examples <PDB path> [<image path>]\n       Examples --msf-benchmark\n       Examples --hidden-lines\nError: Incorrect usage\n");
 
 		return 1;
 	}
 
+	// the MSF benchmark doesn't need a PDB, it builds large synthetic ones in memory
+	if (strcmp(argv[1], "--msf-benchmark") == 0)
+	{
+		return ExampleMSFBenchmark() ? 0 : 6;
+	}
+
+	// hidden lines are checked on a small synthetic PDB built in memory
+	if (strcmp(argv[1], "--hidden-lines") == 0)
+	{
+		return ExampleHiddenLines() ? 0 : 6;
+	}
+
 	printf("Opening PDB file %s\n", argv[1]);
 
-	// try to open the PDB file and check whether all the data we need is available
-	MemoryMappedFile::Handle pdbFile = MemoryMappedFile::Open(argv[1]);
-	if (!pdbFile.baseAddress)
+	// try to open the PDB file and check whether all the data we need is available.
+	// the examples walk all streams, so the file is mapped for reading it sequentially. the raw file takes over the mapping.
+	PDB::MappedFile pdbFile(argv[1], PDB::MappedFile::ForIndexBuild());
+	if (!pdbFile.IsOpen())
 	{
 		printf("Cannot memory-map file %s\n", argv[1]);
 
 		return 1;
 	}
 
-	if (IsError(PDB::ValidateFile(pdbFile.baseAddress)))
+	if (IsError(PDB::ValidateFile(pdbFile.GetData())))
 	{
-		MemoryMappedFile::Close(pdbFile);
-
 		return 2;
 	}
 
-	const PDB::RawFile rawPdbFile = PDB::CreateRawFile(pdbFile.baseAddress);
+	const PDB::RawFile rawPdbFile = PDB::CreateRawFile(std::move(pdbFile));
 	if (IsError(PDB::HasValidDBIStream(rawPdbFile)))
 	{
-		MemoryMappedFile::Close(pdbFile);
-
 		return 3;
 	}
 
@@ -131,8 +156,6 @@ int main(int argc, char** argv)
 	{
 		printf("PDB was linked using unsupported option /DEBUG:FASTLINK\n");
 
-		MemoryMappedFile::Close(pdbFile);
-
 		return 4;
 	}
 
@@ -145,16 +168,12 @@ int main(int argc, char** argv)
 	const PDB::DBIStream dbiStream = PDB::CreateDBIStream(rawPdbFile);
 	if (!HasValidDBIStreams(rawPdbFile, dbiStream))
 	{
-		MemoryMappedFile::Close(pdbFile);
-
 		return 5;
 	}
 
 	const PDB::TPIStream tpiStream = PDB::CreateTPIStream(rawPdbFile);
 	if (PDB::HasValidTPIStream(rawPdbFile) != PDB::ErrorCode::Success)
 	{
-		MemoryMappedFile::Close(pdbFile);
-
 		return 5;
 	}
 
@@ -166,10 +185,24 @@ int main(int argc, char** argv)
 	ExampleFunctionVariables(rawPdbFile, dbiStream, tpiStream);
 	ExampleLines(rawPdbFile, dbiStream, infoStream);
 	ExampleTypes(tpiStream);
+	ExampleProgressiveLoading(rawPdbFile, dbiStream, rawPdbFile.GetMappedFile().GetData());
+	ExampleBlockLoader(rawPdbFile, dbiStream, rawPdbFile.GetMappedFile());
+	ExampleSharedIndex(rawPdbFile, dbiStream, infoStream);
+	ExampleDemangler(rawPdbFile, dbiStream);
+	ExampleNameSearch(rawPdbFile, dbiStream);
+	ExampleTypeHashes(rawPdbFile, tpiStream);
+	ExampleMergedTypes(tpiStream);
+	ExampleLayoutDiff(tpiStream);
+	ExampleLayoutWaste(tpiStream);
+
+	// matching an image with its PDB needs the image, e.g. the executable or DLL the PDB was built with
+	if (argc == 3)
+	{
+		ExamplePEImage(infoStream, argv[2]);
+	}
+
 	// uncomment to dump type sizes to a CSV
 	// ExampleTPISize(tpiStream, "output.csv");
 
-	MemoryMappedFile::Close(pdbFile);
-
 	return 0;
 }
@@ -0,0 +1,80 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "ExampleParallelFor.h"
+#include "PDB_TPIStream.h"
+#include "PDB_TypeTable.h"
+#include "PDB_MergedTypeDatabase.h"
+
+
+namespace
+{
+	static size_t GetRecordsSize(const PDB::TypeTable& typeTable)
+	{
+		size_t size = 0u;
+		for (const PDB::CodeView::TPI::Record* record : typeTable.GetTypeRecords())
+		{
+			size += record ? record->header.size + sizeof(uint16_t) : 0u;
+		}
+
+		return size;
+	}
+}
+
+
+void ExampleMergedTypes(const PDB::TPIStream& tpiStream);
+void ExampleMergedTypes(const PDB::TPIStream& tpiStream)
+{
+	TimedScope total("\nRunning example \"MergedTypes\"");
+
+	// only a single PDB is at hand, so it is merged with itself. this mimics many DLLs of the same product, which share most of their
+	// types through common headers.
+	const PDB::TypeTable typeTable(tpiStream);
+	const PDB::TypeTable* typeTables[] = { &typeTable, &typeTable, &typeTable, &typeTable };
+	const size_t typeTableCount = sizeof(typeTables) / sizeof(typeTables[0]);
+
+	PDB::MergedTypeDatabase database;
+	{
+		TimedScope scope("Merging type tables in parallel");
+		database = PDB::MergedTypeDatabase(typeTables, typeTableCount, &ParallelFor, nullptr);
+		scope.Done(database.GetTypeCount());
+	}
+
+	printf("%zu records of %zu bytes merged into %zu records of %zu bytes\n",
+		typeTableCount * typeTable.GetTypeRecords().GetLength(), typeTableCount * GetRecordsSize(typeTable), database.GetTypeCount(), database.GetRecordsSize());
+
+	// write the database into an image, which could be a file mapped by other processes
+	std::vector<PDB::Byte> image;
+	{
+		TimedScope scope("Writing image");
+		image.resize(database.Write(nullptr));
+		const size_t size = database.Write(image.data());
+		scope.Done(size);
+	}
+
+	if (PDB::ValidateMergedTypeDatabase(image.data(), image.size()) != PDB::ErrorCode::Success)
+	{
+		printf("Invalid merged type database image\n");
+		return;
+	}
+
+	// the opened database refers to the image without copying anything
+	const PDB::MergedTypeDatabase openedDatabase(image.data());
+
+	size_t mismatchCount = 0u;
+	for (size_t i = 0u; i < typeTableCount; ++i)
+	{
+		for (uint32_t typeIndex = typeTable.GetFirstTypeIndex(); typeIndex < typeTable.GetLastTypeIndex(); ++typeIndex)
+		{
+			const uint32_t globalTypeIndex = openedDatabase.GetGlobalTypeIndex(i, typeIndex);
+			if ((globalTypeIndex != database.GetGlobalTypeIndex(0u, typeIndex)) || (openedDatabase.FindTypeIndex(openedDatabase.GetTypeHash(globalTypeIndex)) != globalTypeIndex))
+			{
+				++mismatchCount;
+			}
+		}
+	}
+
+	printf("%zu type indices remapped inconsistently\n", mismatchCount);
+}
@@ -0,0 +1,68 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "ExampleParallelFor.h"
+#include "PDB_RawFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_SymbolNameIndex.h"
+
+
+namespace
+{
+	static void RunQuery(const PDB::SymbolNameIndex& index, const std::string& query, PDB::SymbolNameIndex::SearchMode mode, const char* modeName)
+	{
+		PDB::SymbolNameIndex::Match matches[5u];
+		size_t matchCount = 0u;
+		{
+			const std::string message = std::string(modeName) + " query \"" + query + "\"";
+			TimedScope scope(message.c_str());
+			matchCount = index.Search(query.c_str(), mode, matches, 5u);
+			scope.Done(matchCount);
+		}
+
+		for (size_t i = 0u; i < matchCount; ++i)
+		{
+			printf("  %s (%zu symbols)\n", index.GetName(matches[i].nameIndex), index.GetSymbols(matches[i].nameIndex).GetLength());
+		}
+	}
+}
+
+
+void ExampleNameSearch(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream);
+void ExampleNameSearch(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream)
+{
+	TimedScope total("\nRunning example \"NameSearch\"");
+
+	const PDB::CoalescedMSFStream symbolRecordStream = dbiStream.CreateSymbolRecordStream(rawPdbFile);
+	const PDB::PublicSymbolStream publicSymbolStream = dbiStream.CreatePublicSymbolStream(rawPdbFile);
+	const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawPdbFile);
+
+	PDB::SymbolNameIndex index;
+	{
+		TimedScope scope("Building name search index");
+		index = PDB::SymbolNameIndex(rawPdbFile, moduleInfoStream, publicSymbolStream, symbolRecordStream, &ParallelFor, nullptr);
+		scope.Done(index.GetNameCount());
+	}
+
+	if (index.GetNameCount() == 0u)
+	{
+		return;
+	}
+
+	// derive queries from a name in the middle of the index, the way a user would type parts of it
+	const std::string name = index.GetName(static_cast<uint32_t>(index.GetNameCount() / 2u));
+	const std::string prefix = name.substr(0u, 3u);
+	const std::string substring = name.substr(name.length() / 3u, 4u);
+
+	std::string subsequence;
+	for (size_t i = 0u; i < name.length(); i += 3u)
+	{
+		subsequence += name[i];
+	}
+
+	RunQuery(index, prefix, PDB::SymbolNameIndex::SearchMode::Prefix, "Prefix");
+	RunQuery(index, substring, PDB::SymbolNameIndex::SearchMode::Substring, "Substring");
+	RunQuery(index, subsequence, PDB::SymbolNameIndex::SearchMode::Subsequence, "Subsequence");
+}
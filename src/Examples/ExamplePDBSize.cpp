@@ -28,12 +28,20 @@ void ExamplePDBSize(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStr
 	printf("General\n");
 	printf("-------\n");
 	{
+		// compressed MSF files don't consist of blocks
 		const PDB::SuperBlock* superBlock = rawPdbFile.GetSuperBlock();
-		printf("PDB page size (block size): %u\n", superBlock->blockSize);
-		printf("PDB block count: %u\n", superBlock->blockCount);
+		if (superBlock)
+		{
+			printf("PDB page size (block size): %u\n", superBlock->blockSize);
+			printf("PDB block count: %u\n", superBlock->blockCount);
 
-		const size_t rawSize = static_cast<size_t>(superBlock->blockSize) * static_cast<size_t>(superBlock->blockCount);
-		printf("PDB raw size: %zu MiB (%zu GiB)\n", rawSize >> 20u, rawSize >> 30u);
+			const size_t rawSize = static_cast<size_t>(superBlock->blockSize) * static_cast<size_t>(superBlock->blockCount);
+			printf("PDB raw size: %zu MiB (%zu GiB)\n", rawSize >> 20u, rawSize >> 30u);
+		}
+		else
+		{
+			printf("PDB is a compressed MSF (MSFZ) file\n");
+		}
 	}
 
 	// print the sizes of all known streams
@@ -0,0 +1,55 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "PDB_InfoStream.h"
+#include "PDB_MappedFile.h"
+#include "PDB_PEImage.h"
+
+
+void ExamplePEImage(const PDB::InfoStream& infoStream, const char* imagePath);
+void ExamplePEImage(const PDB::InfoStream& infoStream, const char* imagePath)
+{
+	TimedScope total("\nRunning example \"PEImage\"");
+
+	// only the headers and a few directories are read, so there is no point in reading ahead
+	const PDB::MappedFile imageFile(imagePath, PDB::MappedFile::ForPointLookups());
+	if (!imageFile.IsOpen())
+	{
+		printf("Cannot memory-map file %s\n", imagePath);
+		total.Done();
+
+		return;
+	}
+
+	if (PDB::ValidatePEImage(imageFile.GetData(), imageFile.GetSize()) != PDB::ErrorCode::Success)
+	{
+		printf("%s is not a valid PE image\n", imagePath);
+		total.Done();
+
+		return;
+	}
+
+	const PDB::PEImage image(imageFile.GetData(), imageFile.GetSize());
+	printf("Machine 0x%04X, %s, time stamp 0x%08X, size of image 0x%X, %zu sections, %zu debug directory entries, %zu functions\n",
+		static_cast<uint32_t>(image.GetMachine()), image.Is64Bit() ? "PE32+" : "PE32", image.GetTimeDateStamp(), image.GetSizeOfImage(),
+		image.GetSections().GetLength(), image.GetDebugDirectory().GetLength(), image.GetFunctions().GetLength());
+
+	PDB::PEImage::CodeViewRecord record = {};
+	if (image.GetCodeViewRecord(record))
+	{
+		printf("CodeView record: age %u, GUID %08x-%04x-%04x-%02x%02x%02x%02x%02x%02x%02x%02x, PDB path %s\n",
+			record.age, record.guid.Data1, record.guid.Data2, record.guid.Data3,
+			record.guid.Data4[0], record.guid.Data4[1], record.guid.Data4[2], record.guid.Data4[3], record.guid.Data4[4], record.guid.Data4[5], record.guid.Data4[6], record.guid.Data4[7],
+			record.path);
+	}
+	else
+	{
+		printf("Image has no CodeView record\n");
+	}
+
+	printf("Image %s the PDB\n", image.MatchesPDB(*infoStream.GetHeader()) ? "matches" : "does not match");
+
+	total.Done();
+}
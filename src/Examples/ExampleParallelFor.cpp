@@ -0,0 +1,32 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleParallelFor.h"
+
+
+void ParallelFor(void*, uint32_t count, PDB::JobFunction job, void* jobData)
+{
+	std::atomic<uint32_t> nextIndex(0u);
+	const auto worker = [&nextIndex, count, job, jobData]()
+	{
+		for (uint32_t index = nextIndex++; index < count; index = nextIndex++)
+		{
+			job(jobData, index);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	const unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	for (unsigned int i = 1u; i < threadCount; ++i)
+	{
+		threads.emplace_back(worker);
+	}
+
+	worker();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
@@ -0,0 +1,8 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Foundation/PDB_ParallelFor.h"
+
+
+// A minimal parallel loop running the jobs on one thread per core, a real application would hand the jobs to its thread pool instead.
+void ParallelFor(void* userData, uint32_t count, PDB::JobFunction job, void* jobData);
@@ -0,0 +1,103 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "PDB_RawFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_ProgressiveFile.h"
+#include "PDB_Types.h"
+
+
+namespace
+{
+	struct StreamArrival
+	{
+		std::vector<size_t> bytesReceived;
+		size_t currentBytesReceived;
+	};
+
+	static void OnStreamAvailable(void* userData, uint32_t streamIndex)
+	{
+		StreamArrival* arrival = static_cast<StreamArrival*>(userData);
+		arrival->bytesReceived[streamIndex] = arrival->currentBytesReceived;
+	}
+}
+
+
+void ExampleProgressiveLoading(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const void* pdbData);
+void ExampleProgressiveLoading(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const void* pdbData)
+{
+	TimedScope total("\nRunning example \"ProgressiveLoading\"");
+
+	// simulate downloading the PDB file in chunks of 64 KiB, by copying the file into a buffer chunk by chunk.
+	// a real application would write into this buffer as bytes arrive from the network.
+	const PDB::SuperBlock* superBlock = rawPdbFile.GetSuperBlock();
+	if (!superBlock)
+	{
+		printf("Progressive loading is only supported for MSF files\n");
+		total.Done();
+
+		return;
+	}
+
+	const size_t fileSize = static_cast<size_t>(superBlock->blockSize) * static_cast<size_t>(superBlock->blockCount);
+	const size_t chunkSize = 64u * 1024u;
+
+	StreamArrival arrival;
+	arrival.bytesReceived.resize(rawPdbFile.GetStreamCount(), 0u);
+	arrival.currentBytesReceived = 0u;
+
+	std::vector<uint8_t> buffer(fileSize);
+	PDB::ProgressiveFile progressiveFile(buffer.data(), &OnStreamAvailable, &arrival);
+
+	size_t directoryBytesReceived = 0u;
+	for (size_t offset = 0u; offset < fileSize; offset += chunkSize)
+	{
+		const size_t size = std::min(chunkSize, fileSize - offset);
+		std::memcpy(buffer.data() + offset, static_cast<const uint8_t*>(pdbData) + offset, size);
+
+		arrival.currentBytesReceived = offset + size;
+		if (progressiveFile.AddAvailableData(offset, size) != PDB::ErrorCode::Success)
+		{
+			printf("Invalid PDB file\n");
+			total.Done();
+
+			return;
+		}
+
+		if ((directoryBytesReceived == 0u) && progressiveFile.IsDirectoryAvailable())
+		{
+			directoryBytesReceived = offset + size;
+		}
+	}
+
+	// show how much of the file had to be received before the most important streams could be parsed
+	const auto printArrival = [&arrival, fileSize](const char* name, uint32_t streamIndex)
+	{
+		if ((streamIndex == PDB::NilStreamIndex) || (streamIndex >= arrival.bytesReceived.size()))
+		{
+			return;
+		}
+
+		const size_t bytesReceived = arrival.bytesReceived[streamIndex];
+		printf("%s stream available after %zu KiB (%.1f%%)\n", name, bytesReceived >> 10u, 100.0 * static_cast<double>(bytesReceived) / static_cast<double>(fileSize));
+	};
+
+	printf("Directory available after %zu KiB of %zu KiB\n", directoryBytesReceived >> 10u, fileSize >> 10u);
+	printArrival("DBI", 3u);
+	printArrival("TPI", 2u);
+	printArrival("IPI", 4u);
+	printArrival("Public symbol", dbiStream.GetHeader().publicStreamIndex);
+	printArrival("Global symbol", dbiStream.GetHeader().globalStreamIndex);
+	printArrival("Symbol record", dbiStream.GetHeader().symbolRecordStreamIndex);
+
+	const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawPdbFile);
+	const PDB::ArrayView<PDB::ModuleInfoStream::Module> modules = moduleInfoStream.GetModules();
+	if (modules.GetLength() != 0u)
+	{
+		printArrival("First module symbol", modules[0].GetInfo()->moduleSymbolStreamIndex);
+	}
+
+	total.Done();
+}
@@ -0,0 +1,228 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "PDB_RawFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_InfoStream.h"
+#include "PDB_IndexImage.h"
+
+#ifndef _WIN32
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+
+namespace
+{
+	// shared memory holding an index image, with one view for writing it and one read-only view as used by other processes
+	struct SharedMemory
+	{
+#ifdef _WIN32
+		HANDLE mapping;
+#else
+		int fd;
+#endif
+		void* writableView;
+		const void* readOnlyView;
+		size_t size;
+	};
+
+	static bool CreateSharedMemory(SharedMemory& memory, size_t size)
+	{
+		memory.size = size;
+		memory.writableView = nullptr;
+		memory.readOnlyView = nullptr;
+
+#ifdef _WIN32
+		memory.mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(size) >> 32u), static_cast<DWORD>(size), nullptr);
+		if (!memory.mapping)
+		{
+			return false;
+		}
+
+		memory.writableView = MapViewOfFile(memory.mapping, FILE_MAP_WRITE, 0, 0, size);
+		return (memory.writableView != nullptr);
+#elif defined(__linux__)
+		// other processes open the memfd using /proc/<pid>/fd/<fd>, or receive it via a Unix domain socket
+		memory.fd = memfd_create("raw_pdb_index", MFD_CLOEXEC);
+		if (memory.fd == -1)
+		{
+			return false;
+		}
+
+		if (ftruncate(memory.fd, static_cast<off_t>(size)) != 0)
+		{
+			return false;
+		}
+
+		void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, memory.fd, 0);
+		memory.writableView = (view != MAP_FAILED) ? view : nullptr;
+		return (memory.writableView != nullptr);
+#else
+		memory.fd = -1;
+		return false;
+#endif
+	}
+
+	static bool MapReadOnlyView(SharedMemory& memory)
+	{
+#ifdef _WIN32
+		memory.readOnlyView = MapViewOfFile(memory.mapping, FILE_MAP_READ, 0, 0, memory.size);
+#else
+		const void* view = mmap(nullptr, memory.size, PROT_READ, MAP_SHARED, memory.fd, 0);
+		memory.readOnlyView = (view != MAP_FAILED) ? view : nullptr;
+#endif
+
+		return (memory.readOnlyView != nullptr);
+	}
+
+	static void DestroySharedMemory(SharedMemory& memory)
+	{
+#ifdef _WIN32
+		if (memory.readOnlyView)
+		{
+			UnmapViewOfFile(memory.readOnlyView);
+		}
+
+		if (memory.writableView)
+		{
+			UnmapViewOfFile(memory.writableView);
+		}
+
+		if (memory.mapping)
+		{
+			CloseHandle(memory.mapping);
+		}
+#else
+		if (memory.readOnlyView)
+		{
+			munmap(const_cast<void*>(memory.readOnlyView), memory.size);
+		}
+
+		if (memory.writableView)
+		{
+			munmap(memory.writableView, memory.size);
+		}
+
+		if (memory.fd != -1)
+		{
+			close(memory.fd);
+		}
+#endif
+	}
+}
+
+
+void ExampleSharedIndex(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::InfoStream& infoStream);
+void ExampleSharedIndex(const PDB::RawFile& rawPdbFile, const PDB::DBIStream& dbiStream, const PDB::InfoStream& infoStream)
+{
+	if (!infoStream.HasNamesStream())
+	{
+		printf("PDB has no '/names' stream for looking up filenames for lines, skipping \"SharedIndex\" example.\n");
+		return;
+	}
+
+	TimedScope total("\nRunning example \"SharedIndex\"");
+
+	const PDB::ImageSectionStream imageSectionStream = dbiStream.CreateImageSectionStream(rawPdbFile);
+	const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawPdbFile);
+	const PDB::SectionContributionStream sectionContributionStream = dbiStream.CreateSectionContributionStream(rawPdbFile);
+	const PDB::NamesStream namesStream = infoStream.CreateNamesStream(rawPdbFile);
+
+	// the indices are built once, e.g. by the first worker process that needs them
+	TimedScope buildScope("Building indices");
+	const PDB::FunctionIndex functionIndex(rawPdbFile, imageSectionStream, moduleInfoStream);
+	const PDB::LineIndex lineIndex(rawPdbFile, imageSectionStream, moduleInfoStream, namesStream);
+	const PDB::ContributionIndex contributionIndex(imageSectionStream, sectionContributionStream, moduleInfoStream);
+	buildScope.Done(functionIndex.GetCodeRanges().GetLength() + lineIndex.GetLines().GetLength() + contributionIndex.GetContributions().GetLength());
+
+	const PDB::Header* infoHeader = infoStream.GetHeader();
+	const size_t imageSize = PDB::IndexImage::Write(nullptr, infoHeader->guid, infoHeader->age, &functionIndex, &lineIndex, &contributionIndex);
+
+	SharedMemory memory = {};
+	if (!CreateSharedMemory(memory, imageSize))
+	{
+		printf("Cannot create shared memory\n");
+		DestroySharedMemory(memory);
+		total.Done();
+
+		return;
+	}
+
+	TimedScope writeScope("Writing index image into shared memory");
+	(void)PDB::IndexImage::Write(memory.writableView, infoHeader->guid, infoHeader->age, &functionIndex, &lineIndex, &contributionIndex);
+	writeScope.Done(imageSize);
+
+	// every other worker maps the image read-only and uses the indices in place, without building or copying anything
+	TimedScope openScope("Opening index image from a read-only view");
+	if (!MapReadOnlyView(memory))
+	{
+		printf("Cannot map shared memory\n");
+		DestroySharedMemory(memory);
+		openScope.Done();
+		total.Done();
+
+		return;
+	}
+
+	if (PDB::ValidateIndexImage(memory.readOnlyView, memory.size) != PDB::ErrorCode::Success)
+	{
+		printf("Index image is invalid\n");
+		DestroySharedMemory(memory);
+		openScope.Done();
+		total.Done();
+
+		return;
+	}
+
+	const PDB::IndexImage image(memory.readOnlyView);
+	openScope.Done();
+
+	// the shared indices must answer all queries exactly like the ones they were built from
+	TimedScope compareScope("Comparing lookups");
+	size_t mismatchCount = 0u;
+	size_t lookupCount = 0u;
+
+	for (const PDB::FunctionIndex::CodeRange& codeRange : functionIndex.GetCodeRanges())
+	{
+		const PDB::FunctionIndex::Function* expected = functionIndex.FindFunction(codeRange.rva);
+		const PDB::FunctionIndex::Function* actual = image.GetFunctionIndex().FindFunction(codeRange.rva);
+		if (!expected || !actual || (expected->rva != actual->rva) || (strcmp(functionIndex.GetName(*expected), image.GetFunctionIndex().GetName(*actual)) != 0))
+		{
+			++mismatchCount;
+		}
+
+		++lookupCount;
+	}
+
+	for (const PDB::LineIndex::Line& line : lineIndex.GetLines())
+	{
+		const PDB::LineIndex::Line* actual = image.GetLineIndex().FindLine(line.rva);
+		if (!actual || (actual->lineNumber != line.lineNumber) || (strcmp(lineIndex.GetFileName(line), image.GetLineIndex().GetFileName(*actual)) != 0))
+		{
+			++mismatchCount;
+		}
+
+		++lookupCount;
+	}
+
+	for (const PDB::ContributionIndex::Contribution& contribution : contributionIndex.GetContributions())
+	{
+		const PDB::ContributionIndex::Contribution* actual = image.GetContributionIndex().FindContribution(contribution.rva);
+		if (!actual || (actual->moduleIndex != contribution.moduleIndex) || (strcmp(contributionIndex.GetModuleName(contribution), image.GetContributionIndex().GetModuleName(*actual)) != 0))
+		{
+			++mismatchCount;
+		}
+
+		++lookupCount;
+	}
+
+	compareScope.Done(lookupCount);
+
+	printf("Index image has %zu bytes, %zu of %zu lookups differ\n", imageSize, mismatchCount, lookupCount);
+
+	DestroySharedMemory(memory);
+	total.Done();
+}
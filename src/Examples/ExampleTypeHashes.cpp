@@ -0,0 +1,58 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "Examples_PCH.h"
+#include "ExampleTimedScope.h"
+#include "ExampleParallelFor.h"
+#include "PDB_RawFile.h"
+#include "PDB_TPIStream.h"
+#include "PDB_IPIStream.h"
+#include "PDB_TypeTable.h"
+#include "PDB_GlobalTypeHashes.h"
+
+
+namespace
+{
+	static size_t CountDistinctHashes(PDB::ArrayView<uint64_t> hashes)
+	{
+		std::vector<uint64_t> sortedHashes(hashes.begin(), hashes.end());
+		std::sort(sortedHashes.begin(), sortedHashes.end());
+
+		return static_cast<size_t>(std::unique(sortedHashes.begin(), sortedHashes.end()) - sortedHashes.begin());
+	}
+}
+
+
+void ExampleTypeHashes(const PDB::RawFile& rawPdbFile, const PDB::TPIStream& tpiStream);
+void ExampleTypeHashes(const PDB::RawFile& rawPdbFile, const PDB::TPIStream& tpiStream)
+{
+	TimedScope total("\nRunning example \"TypeHashes\"");
+
+	const PDB::TypeTable typeTable(tpiStream);
+
+	const bool hasIPIStream = (PDB::HasValidIPIStream(rawPdbFile) == PDB::ErrorCode::Success);
+	const PDB::IPIStream ipiStream = hasIPIStream ? PDB::CreateIPIStream(rawPdbFile) : PDB::IPIStream();
+
+	PDB::GlobalTypeHashes hashes;
+	{
+		TimedScope scope("Hashing TPI and IPI records on a single thread");
+		hashes = PDB::GlobalTypeHashes(typeTable, hasIPIStream ? &ipiStream : nullptr);
+		scope.Done(hashes.GetTypeHashes().GetLength() + hashes.GetIdHashes().GetLength());
+	}
+
+	PDB::GlobalTypeHashes parallelHashes;
+	{
+		TimedScope scope("Hashing TPI and IPI records in parallel");
+		parallelHashes = PDB::GlobalTypeHashes(typeTable, hasIPIStream ? &ipiStream : nullptr, &ParallelFor, nullptr);
+		scope.Done(parallelHashes.GetTypeHashes().GetLength() + parallelHashes.GetIdHashes().GetLength());
+	}
+
+	const bool isSame =
+		std::equal(hashes.GetTypeHashes().begin(), hashes.GetTypeHashes().end(), parallelHashes.GetTypeHashes().begin()) &&
+		std::equal(hashes.GetIdHashes().begin(), hashes.GetIdHashes().end(), parallelHashes.GetIdHashes().begin());
+	printf("Parallel hashes %s\n", isSame ? "match" : "DO NOT match");
+
+	// structurally identical records share a hash, e.g. forward references to the same class
+	printf("%zu distinct hashes for %zu TPI records\n", CountDistinctHashes(hashes.GetTypeHashes()), hashes.GetTypeHashes().GetLength());
+	printf("%zu distinct hashes for %zu IPI records\n", CountDistinctHashes(hashes.GetIdHashes()), hashes.GetIdHashes().GetLength());
+}
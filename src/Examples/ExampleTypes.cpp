@@ -1,7 +1,7 @@
 
 #include "Examples_PCH.h"
 #include "ExampleTimedScope.h"
-#include "ExampleTypeTable.h"
+#include "PDB_TypeTable.h"
 #include "PDB_RawFile.h"
 #include "PDB_DBIStream.h"
 #include "PDB_TPIStream.h"
@@ -16,7 +16,7 @@ PDB_DISABLE_WARNING_CLANG("-Wswitch-enum")
 PDB_DISABLE_WARNING_MSVC(4774)
 PDB_DISABLE_WARNING_CLANG("-Wformat-nonliteral")
 
-std::string GetTypeName(const TypeTable& typeTable, uint32_t typeIndex);
+std::string GetTypeName(const PDB::TypeTable& typeTable, uint32_t typeIndex);
 
 static uint8_t GetLeafSize(PDB::CodeView::TPI::TypeRecordKind kind)
 {
@@ -57,7 +57,7 @@ static const char* GetLeafName(const char* data, PDB::CodeView::TPI::TypeRecordK
 }
 
 
-static const char* GetTypeName(const TypeTable& typeTable, uint32_t typeIndex, uint8_t& pointerLevel, const PDB::CodeView::TPI::Record** referencedType, const PDB::CodeView::TPI::Record** modifierRecord)
+static const char* GetTypeName(const PDB::TypeTable& typeTable, uint32_t typeIndex, uint8_t& pointerLevel, const PDB::CodeView::TPI::Record** referencedType, const PDB::CodeView::TPI::Record** modifierRecord)
 {
 	const char* typeName = nullptr;
 	const PDB::CodeView::TPI::Record* underlyingType = nullptr;
@@ -368,7 +368,7 @@ static const char* GetModifierName(const PDB::CodeView::TPI::Record* modifierRec
 }
 
 
-static bool GetFunctionPrototype(const TypeTable& typeTable, const PDB::CodeView::TPI::Record* functionRecord, std::string& functionPrototype)
+static bool GetFunctionPrototype(const PDB::TypeTable& typeTable, const PDB::CodeView::TPI::Record* functionRecord, std::string& functionPrototype)
 {
 	PDB_ASSERT(functionRecord->header.kind == PDB::CodeView::TPI::TypeRecordKind::LF_PROCEDURE, "TPI Record kind is 0x%X, expected 0x%X (LF_PROCEDURE)",
 		(uint32_t)functionRecord->header.kind, (uint32_t)PDB::CodeView::TPI::TypeRecordKind::LF_PROCEDURE);
@@ -491,7 +491,7 @@ static bool GetFunctionPrototype(const TypeTable& typeTable, const PDB::CodeView
 }
 
 
-static bool GetMethodPrototype(const TypeTable& typeTable, const PDB::CodeView::TPI::Record* methodRecord, std::string& methodPrototype)
+static bool GetMethodPrototype(const PDB::TypeTable& typeTable, const PDB::CodeView::TPI::Record* methodRecord, std::string& methodPrototype)
 {
 	PDB_ASSERT(methodRecord->header.kind == PDB::CodeView::TPI::TypeRecordKind::LF_MFUNCTION, "TPI Record kind is 0x%X, expected 0x%X (LF_MFUNCTION)",
 		(uint32_t)methodRecord->header.kind, (uint32_t)PDB::CodeView::TPI::TypeRecordKind::LF_MFUNCTION);
@@ -633,7 +633,7 @@ static const char* GetMethodName(const PDB::CodeView::TPI::FieldList* fieldRecor
 }
 
 
-static void DisplayFields(const TypeTable& typeTable, const PDB::CodeView::TPI::Record* record)
+static void DisplayFields(const PDB::TypeTable& typeTable, const PDB::CodeView::TPI::Record* record)
 {
 	const PDB::CodeView::TPI::Record* referencedType = nullptr;
 	const PDB::CodeView::TPI::Record* underlyingType = nullptr;
@@ -881,7 +881,7 @@ static void DisplayFields(const TypeTable& typeTable, const PDB::CodeView::TPI::
 }
 
 // Used in ExamplesFunctionVariables
-std::string GetTypeName(const TypeTable& typeTable, uint32_t typeIndex)
+std::string GetTypeName(const PDB::TypeTable& typeTable, uint32_t typeIndex)
 {
 	uint8_t pointerLevel = 0;
 	const PDB::CodeView::TPI::Record* referencedType = nullptr;
@@ -1007,7 +1007,7 @@ void ExampleTypes(const PDB::TPIStream& tpiStream)
 	TimedScope total("\nRunning example \"Function types\"");
 
 	TimedScope typeTableScope("Create TypeTable");
-	TypeTable typeTable(tpiStream);
+	PDB::TypeTable typeTable(tpiStream);
 	typeTableScope.Done();
 
 	for (const auto& record : typeTable.GetTypeRecords())
@@ -1067,12 +1067,12 @@ void ExampleTypes(const PDB::TPIStream& tpiStream)
 }
 
 template<typename T>
-static void TagRecursively(const TypeTable& typeTable, uint32_t typeIndex, T setName);
+static void TagRecursively(const PDB::TypeTable& typeTable, uint32_t typeIndex, T setName);
 
 #define TAG_AND_CHECK(typeIndex) if (setName(typeIndex)) TagRecursively(typeTable, typeIndex, setName);
 
 template<typename T>
-static void TagChildren(const TypeTable& typeTable, const PDB::CodeView::TPI::Record* record, T setName)
+static void TagChildren(const PDB::TypeTable& typeTable, const PDB::CodeView::TPI::Record* record, T setName)
 {
 	const char* leafName = nullptr;
 	uint16_t offset = 0;
@@ -1208,7 +1208,7 @@ static void TagChildren(const TypeTable& typeTable, const PDB::CodeView::TPI::Re
 }
 
 template<typename T>
-static void TagRecursively(const TypeTable& typeTable, uint32_t typeIndex, T setName)
+static void TagRecursively(const PDB::TypeTable& typeTable, uint32_t typeIndex, T setName)
 {
 	const PDB::CodeView::TPI::Record* record = typeTable.GetTypeRecord(typeIndex);
 	if (!record)
@@ -1276,7 +1276,7 @@ void ExampleTPISize(const PDB::TPIStream& tpiStream, const char* outPath)
 	fprintf(f, "Size;Kind;Name\n");
 
 	TimedScope typeTableScope("Create TypeTable");
-	TypeTable typeTable(tpiStream);
+	PDB::TypeTable typeTable(tpiStream);
 	typeTableScope.Done();
 
 	std::vector<const char*> names;
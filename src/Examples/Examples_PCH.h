@@ -25,9 +25,13 @@
 #	undef cdecl
 #endif
 #	include <vector>
+#	include <atomic>
+#	include <thread>
 #	include <unordered_set>
 #	include <chrono>
 #	include <string>
 #	include <algorithm>
 #	include <cstdarg>
+#	include <cstring>
+#	include <utility>
 #	include "Foundation/PDB_DisableWarningsPop.h"
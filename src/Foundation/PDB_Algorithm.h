@@ -0,0 +1,267 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "PDB_Macros.h"
+
+// third-party includes
+#include "PDB_DisableWarningsPush.h"
+#include <cstddef>
+#include "PDB_DisableWarningsPop.h"
+
+
+// Minimal sorting and searching on plain arrays, so that building indices does not need the STL.
+namespace PDB
+{
+	namespace Algorithm
+	{
+		namespace detail
+		{
+			template <typename T>
+			inline void Swap(T& lhs, T& rhs) PDB_NO_EXCEPT
+			{
+				T temp = static_cast<T&&>(lhs);
+				lhs = static_cast<T&&>(rhs);
+				rhs = static_cast<T&&>(temp);
+			}
+
+			template <typename T, typename Less>
+			void InsertionSort(T* first, T* last, Less& less) PDB_NO_EXCEPT
+			{
+				for (T* i = first + 1; i < last; ++i)
+				{
+					T value = static_cast<T&&>(*i);
+					T* j = i;
+					while ((j > first) && less(value, *(j - 1)))
+					{
+						*j = static_cast<T&&>(*(j - 1));
+						--j;
+					}
+
+					*j = static_cast<T&&>(value);
+				}
+			}
+
+			template <typename T, typename Less>
+			void SiftDown(T* first, size_t root, size_t count, Less& less) PDB_NO_EXCEPT
+			{
+				for (;;)
+				{
+					size_t child = 2u * root + 1u;
+					if (child >= count)
+					{
+						return;
+					}
+
+					if ((child + 1u < count) && less(first[child], first[child + 1u]))
+					{
+						++child;
+					}
+
+					if (!less(first[root], first[child]))
+					{
+						return;
+					}
+
+					Swap(first[root], first[child]);
+					root = child;
+				}
+			}
+
+			template <typename T, typename Less>
+			void HeapSort(T* first, T* last, Less& less) PDB_NO_EXCEPT
+			{
+				const size_t count = static_cast<size_t>(last - first);
+				for (size_t i = count / 2u; i > 0u; --i)
+				{
+					SiftDown(first, i - 1u, count, less);
+				}
+
+				for (size_t i = count; i > 1u; --i)
+				{
+					Swap(first[0], first[i - 1u]);
+					SiftDown(first, 0u, i - 1u, less);
+				}
+			}
+
+			template <typename T, typename Less>
+			void IntroSort(T* first, T* last, unsigned int depthLimit, Less& less) PDB_NO_EXCEPT
+			{
+				while (last - first > 16)
+				{
+					if (depthLimit == 0u)
+					{
+						// too many bad partitions, guarantee O(n log n)
+						HeapSort(first, last, less);
+						return;
+					}
+
+					--depthLimit;
+
+					// median-of-three pivot, moved to the front
+					T* middle = first + (last - first) / 2;
+					if (less(*middle, *first))
+					{
+						Swap(*middle, *first);
+					}
+					if (less(*(last - 1), *middle))
+					{
+						Swap(*(last - 1), *middle);
+						if (less(*middle, *first))
+						{
+							Swap(*middle, *first);
+						}
+					}
+					Swap(*first, *middle);
+
+					// Hoare partition around the pivot
+					T* left = first + 1;
+					T* right = last - 1;
+					for (;;)
+					{
+						while (less(*left, *first))
+						{
+							++left;
+						}
+						while (less(*first, *right))
+						{
+							--right;
+						}
+						if (left >= right)
+						{
+							break;
+						}
+
+						Swap(*left, *right);
+						++left;
+						--right;
+					}
+
+					Swap(*first, *right);
+
+					// recurse into the smaller half, iterate on the larger one
+					if (right - first < last - (right + 1))
+					{
+						IntroSort(first, right, depthLimit, less);
+						first = right + 1;
+					}
+					else
+					{
+						IntroSort(right + 1, last, depthLimit, less);
+						last = right;
+					}
+				}
+
+				InsertionSort(first, last, less);
+			}
+		}
+
+
+		// Sorts the range [first, last) using the given strict weak ordering. The sort is not stable.
+		template <typename T, typename Less>
+		void Sort(T* first, T* last, Less less) PDB_NO_EXCEPT
+		{
+			if (last - first < 2)
+			{
+				return;
+			}
+
+			unsigned int depthLimit = 0u;
+			for (size_t count = static_cast<size_t>(last - first); count > 1u; count >>= 1u)
+			{
+				depthLimit += 2u;
+			}
+
+			detail::IntroSort(first, last, depthLimit, less);
+		}
+
+		// Returns the index of the first element in the sorted array that is greater than the given value, or count if there is none.
+		template <typename T, typename U>
+		PDB_NO_DISCARD inline size_t UpperBound(const T* array, size_t count, const U& value) PDB_NO_EXCEPT
+		{
+			size_t first = 0u;
+			while (count > 0u)
+			{
+				const size_t half = count / 2u;
+				if (!(value < array[first + half]))
+				{
+					first += half + 1u;
+					count -= half + 1u;
+				}
+				else
+				{
+					count = half;
+				}
+			}
+
+			return first;
+		}
+
+		// Returns the index of the first element in the sorted array for which less(value, element) is true, or count if there is none.
+		template <typename T, typename U, typename Less>
+		PDB_NO_DISCARD inline size_t UpperBound(const T* array, size_t count, const U& value, Less less) PDB_NO_EXCEPT
+		{
+			size_t first = 0u;
+			while (count > 0u)
+			{
+				const size_t half = count / 2u;
+				if (!less(value, array[first + half]))
+				{
+					first += half + 1u;
+					count -= half + 1u;
+				}
+				else
+				{
+					count = half;
+				}
+			}
+
+			return first;
+		}
+
+		// Returns the index of the first element in the sorted array that is not less than the given value, or count if there is none.
+		template <typename T, typename U>
+		PDB_NO_DISCARD inline size_t LowerBound(const T* array, size_t count, const U& value) PDB_NO_EXCEPT
+		{
+			size_t first = 0u;
+			while (count > 0u)
+			{
+				const size_t half = count / 2u;
+				if (array[first + half] < value)
+				{
+					first += half + 1u;
+					count -= half + 1u;
+				}
+				else
+				{
+					count = half;
+				}
+			}
+
+			return first;
+		}
+
+		// Returns the index of the first element in the sorted array for which less(element, value) is false, or count if there is none.
+		template <typename T, typename U, typename Less>
+		PDB_NO_DISCARD inline size_t LowerBound(const T* array, size_t count, const U& value, Less less) PDB_NO_EXCEPT
+		{
+			size_t first = 0u;
+			while (count > 0u)
+			{
+				const size_t half = count / 2u;
+				if (less(array[first + half], value))
+				{
+					first += half + 1u;
+					count -= half + 1u;
+				}
+				else
+				{
+					count = half;
+				}
+			}
+
+			return first;
+		}
+	}
+}
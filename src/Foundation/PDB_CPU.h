@@ -0,0 +1,61 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "PDB_Macros.h"
+
+#if PDB_ARCH_X64
+#	include "PDB_DisableWarningsPush.h"
+#	if PDB_COMPILER_MSVC
+#		include <intrin.h>
+#	endif
+#	include <immintrin.h>
+#	include "PDB_DisableWarningsPop.h"
+#endif
+
+
+// Allows a single function to use AVX2 instructions, independent of the instruction set the translation unit is compiled for.
+// Such functions must only be called after checking CPU::SupportsAVX2().
+#if PDB_ARCH_X64 && (PDB_COMPILER_CLANG || PDB_COMPILER_GCC)
+#	define PDB_TARGET_AVX2							__attribute__((target("avx2")))
+#else
+#	define PDB_TARGET_AVX2
+#endif
+
+
+namespace PDB
+{
+	namespace CPU
+	{
+		// Returns whether the CPU and the operating system support AVX2 instructions.
+		PDB_NO_DISCARD inline bool SupportsAVX2(void) PDB_NO_EXCEPT
+		{
+#if PDB_ARCH_X64 && PDB_COMPILER_MSVC
+			int info[4] = {};
+			__cpuid(info, 0);
+			if (info[0] < 7)
+			{
+				return false;
+			}
+
+			// the OS must save the YMM registers on context switches, which is checked using OSXSAVE and XGETBV
+			__cpuid(info, 1);
+			const bool hasOSXSAVE = (info[2] & (1 << 27)) != 0;
+			const bool hasAVX = (info[2] & (1 << 28)) != 0;
+			if (!hasOSXSAVE || !hasAVX || ((_xgetbv(0) & 0x6u) != 0x6u))
+			{
+				return false;
+			}
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+#elif PDB_ARCH_X64
+			// also takes operating system support into account
+			return __builtin_cpu_supports("avx2") != 0;
+#else
+			return false;
+#endif
+		}
+	}
+}
@@ -0,0 +1,113 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "PDB_Macros.h"
+#include "PDB_Memory.h"
+#include "PDB_DisableWarningsPush.h"
+#include <cstring>
+#include "PDB_DisableWarningsPop.h"
+
+
+namespace PDB
+{
+	// A minimal array of trivially copyable elements that grows geometrically, used for building indices
+	// whose number of elements is not known up-front.
+	template <typename T>
+	class PDB_NO_DISCARD GrowableArray
+	{
+	public:
+		GrowableArray(void) PDB_NO_EXCEPT
+			: m_data(nullptr)
+			, m_size(0u)
+			, m_capacity(0u)
+		{
+		}
+
+		~GrowableArray(void) PDB_NO_EXCEPT
+		{
+			PDB_DELETE_ARRAY(m_data);
+		}
+
+		// Appends an element.
+		inline void Add(const T& value) PDB_NO_EXCEPT
+		{
+			Reserve(m_size + 1u);
+			m_data[m_size++] = value;
+		}
+
+		// Appends several elements, returning the index of the first one.
+		inline size_t Append(const T* values, size_t count) PDB_NO_EXCEPT
+		{
+			Reserve(m_size + count);
+			if (count != 0u)
+			{
+				std::memcpy(m_data + m_size, values, count * sizeof(T));
+			}
+
+			const size_t index = m_size;
+			m_size += count;
+			return index;
+		}
+
+		// Makes room for at least the given number of elements.
+		void Reserve(size_t capacity) PDB_NO_EXCEPT
+		{
+			if (capacity <= m_capacity)
+			{
+				return;
+			}
+
+			size_t newCapacity = (m_capacity < 64u) ? 64u : m_capacity * 2u;
+			while (newCapacity < capacity)
+			{
+				newCapacity *= 2u;
+			}
+
+			T* data = PDB_NEW_ARRAY(T, newCapacity);
+			if (m_size != 0u)
+			{
+				std::memcpy(data, m_data, m_size * sizeof(T));
+			}
+
+			PDB_DELETE_ARRAY(m_data);
+			m_data = data;
+			m_capacity = newCapacity;
+		}
+
+		// Removes all elements, keeping the memory for later use.
+		inline void Clear(void) PDB_NO_EXCEPT
+		{
+			m_size = 0u;
+		}
+
+		// Releases ownership of the elements, which have to be freed using PDB_DELETE_ARRAY.
+		PDB_NO_DISCARD inline T* Release(void) PDB_NO_EXCEPT
+		{
+			T* data = m_data;
+			m_data = nullptr;
+			m_size = 0u;
+			m_capacity = 0u;
+
+			return data;
+		}
+
+		PDB_NO_DISCARD inline T* GetData(void) PDB_NO_EXCEPT
+		{
+			return m_data;
+		}
+
+		PDB_NO_DISCARD inline size_t GetSize(void) const PDB_NO_EXCEPT
+		{
+			return m_size;
+		}
+
+	private:
+		T* m_data;
+		size_t m_size;
+		size_t m_capacity;
+
+		PDB_DISABLE_COPY(GrowableArray);
+	};
+}
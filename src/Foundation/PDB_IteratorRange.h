@@ -0,0 +1,48 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "PDB_Macros.h"
+
+// third-party includes
+#include "PDB_DisableWarningsPush.h"
+#include <iterator>
+#include "PDB_DisableWarningsPop.h"
+
+
+namespace PDB
+{
+	// A pair of iterators denoting a range that can be walked using range-based for-loops or standard algorithms.
+	template <typename Iterator>
+	class PDB_NO_DISCARD IteratorRange
+	{
+	public:
+		inline constexpr explicit IteratorRange(Iterator begin, Iterator end) PDB_NO_EXCEPT
+			: m_begin(begin)
+			, m_end(end)
+		{
+		}
+
+		PDB_DEFAULT_COPY_MOVE(IteratorRange);
+
+
+		// ------------------------------------------------------------------------------------------------
+		// Range-based for-loop support
+		// ------------------------------------------------------------------------------------------------
+
+		PDB_NO_DISCARD inline constexpr Iterator begin(void) const PDB_NO_EXCEPT
+		{
+			return m_begin;
+		}
+
+		PDB_NO_DISCARD inline constexpr Iterator end(void) const PDB_NO_EXCEPT
+		{
+			return m_end;
+		}
+
+	private:
+		Iterator m_begin;
+		Iterator m_end;
+	};
+}
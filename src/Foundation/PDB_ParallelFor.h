@@ -0,0 +1,39 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "PDB_Macros.h"
+#include "PDB_DisableWarningsPush.h"
+#include <cstdint>
+#include "PDB_DisableWarningsPop.h"
+
+
+// raw_pdb doesn't create any threads, so parts of the library that can make use of several threads are handed a parallel loop by the user.
+namespace PDB
+{
+	// A job that is run for each index of a parallel loop.
+	typedef void (*JobFunction)(void* jobData, uint32_t index);
+
+	// Runs the given job for all indices in [0, count), potentially in parallel, and returns once all jobs have finished.
+	typedef void (*ParallelForFunction)(void* userData, uint32_t count, JobFunction job, void* jobData);
+
+	// Runs the given job for all indices using the parallel loop, or one after another if there is none.
+	inline void ParallelFor(ParallelForFunction parallelFor, void* userData, uint32_t count, JobFunction job, void* jobData) PDB_NO_EXCEPT
+	{
+		if (count == 0u)
+		{
+			return;
+		}
+		else if (parallelFor && (count > 1u))
+		{
+			parallelFor(userData, count, job, jobData);
+			return;
+		}
+
+		for (uint32_t i = 0u; i < count; ++i)
+		{
+			job(jobData, i);
+		}
+	}
+}
@@ -27,3 +27,22 @@
 #else
 #	define PDB_CPP_17						0
 #endif
+
+// determine the target architecture
+#if defined(_M_X64) || defined(__x86_64__)
+#	define PDB_ARCH_X64						1
+#else
+#	define PDB_ARCH_X64						0
+#endif
+
+// determine the target platform
+#if defined(_WIN32)
+#	define PDB_PLATFORM_WINDOWS				1
+#	define PDB_PLATFORM_LINUX				0
+#elif defined(__linux__)
+#	define PDB_PLATFORM_WINDOWS				0
+#	define PDB_PLATFORM_LINUX				1
+#else
+#	define PDB_PLATFORM_WINDOWS				0
+#	define PDB_PLATFORM_LINUX				0
+#endif
@@ -7,6 +7,7 @@
 #include "PDB_Util.h"
 #include "PDB_RawFile.h"
 #include "Foundation/PDB_PointerUtil.h"
+#include "Foundation/PDB_BitUtil.h"
 #include "Foundation/PDB_DisableWarningsPush.h"
 #include <cstring>
 #include "Foundation/PDB_DisableWarningsPop.h"
@@ -16,6 +17,18 @@
 // ------------------------------------------------------------------------------------------------
 PDB_NO_DISCARD PDB::ErrorCode PDB::ValidateFile(const void* data) PDB_NO_EXCEPT
 {
+	// compressed MSF files start with a different header
+	const MSFZ::FileHeader* msfzHeader = Pointer::Offset<const MSFZ::FileHeader*>(data, 0u);
+	if (std::memcmp(msfzHeader->signature, MSFZ::FileHeader::MAGIC, sizeof(MSFZ::FileHeader::MAGIC)) == 0)
+	{
+		if (msfzHeader->version != MSFZ::FileHeader::Version)
+		{
+			return ErrorCode::UnknownVersion;
+		}
+
+		return ErrorCode::Success;
+	}
+
 	// validate the super block
 	const SuperBlock* superBlock = Pointer::Offset<const SuperBlock*>(data, 0u);
 	{
@@ -25,6 +38,12 @@ PDB_NO_DISCARD PDB::ErrorCode PDB::ValidateFile(const void* data) PDB_NO_EXCEPT
 			return ErrorCode::InvalidSuperBlock;
 		}
 
+		// validate block size. PDBs larger than 4 GiB use blocks bigger than 4 KiB, but offsets are always computed using shifts.
+		if ((superBlock->blockSize < 512u) || !BitUtil::IsPowerOfTwo(superBlock->blockSize))
+		{
+			return ErrorCode::InvalidSuperBlock;
+		}
+
 		// validate free block map.
 		// the free block map should always reside at either index 1 or 2.
 		if (superBlock->freeBlockMapIndex != 1u && superBlock->freeBlockMapIndex != 2u)
@@ -43,3 +62,27 @@ PDB_NO_DISCARD PDB::RawFile PDB::CreateRawFile(const void* data) PDB_NO_EXCEPT
 {
 	return RawFile(data);
 }
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::RawFile PDB::CreateRawFile(const void* data, const MSFZ::Options& options) PDB_NO_EXCEPT
+{
+	return RawFile(data, options);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::RawFile PDB::CreateRawFile(MappedFile&& file) PDB_NO_EXCEPT
+{
+	return RawFile(PDB_MOVE(file));
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::RawFile PDB::CreateRawFile(MappedFile&& file, const MSFZ::Options& options) PDB_NO_EXCEPT
+{
+	return RawFile(PDB_MOVE(file), options);
+}
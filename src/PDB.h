@@ -5,17 +5,28 @@
 
 #include "Foundation/PDB_Macros.h"
 #include "PDB_ErrorCodes.h"
+#include "PDB_MSFZTypes.h"
 
 
 // https://llvm.org/docs/PDB/index.html
 namespace PDB
 {
 	class RawFile;
+	class MappedFile;
 
 
-	// Validates whether a PDB file is valid.
+	// Validates whether a PDB file is valid. Both MSF and compressed MSF (MSFZ) files are accepted.
 	PDB_NO_DISCARD ErrorCode ValidateFile(const void* data) PDB_NO_EXCEPT;
 
 	// Creates a raw PDB file that must have been validated.
 	PDB_NO_DISCARD RawFile CreateRawFile(const void* data) PDB_NO_EXCEPT;
+
+	// Creates a raw PDB file that must have been validated, using the given options for decompressing streams of MSFZ files.
+	PDB_NO_DISCARD RawFile CreateRawFile(const void* data, const MSFZ::Options& options) PDB_NO_EXCEPT;
+
+	// Creates a raw PDB file from a mapped file that must have been validated, taking ownership of the mapping.
+	PDB_NO_DISCARD RawFile CreateRawFile(MappedFile&& file) PDB_NO_EXCEPT;
+
+	// Creates a raw PDB file from a mapped file that must have been validated, taking ownership of the mapping and using the given options for decompressing streams of MSFZ files.
+	PDB_NO_DISCARD RawFile CreateRawFile(MappedFile&& file, const MSFZ::Options& options) PDB_NO_EXCEPT;
 }
@@ -0,0 +1,211 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "PDB_DBITypes.h"
+
+
+// Decoding of the compressed binary annotations stored in S_INLINESITE and S_INLINESITE2 records.
+// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L3808
+namespace PDB
+{
+	namespace BinaryAnnotations
+	{
+		// Reads a compressed unsigned integer, returns false if the data is exhausted or malformed.
+		PDB_NO_DISCARD inline bool ReadUnsigned(const uint8_t*& data, const uint8_t* dataEnd, uint32_t& value) PDB_NO_EXCEPT
+		{
+			if (data >= dataEnd)
+			{
+				return false;
+			}
+
+			const uint8_t first = *data++;
+			if ((first & 0x80u) == 0x00u)
+			{
+				value = first;
+				return true;
+			}
+			else if ((first & 0xC0u) == 0x80u)
+			{
+				if (dataEnd - data < 1)
+				{
+					return false;
+				}
+
+				value = ((first & 0x3Fu) << 8u) | data[0];
+				data += 1;
+				return true;
+			}
+			else if ((first & 0xE0u) == 0xC0u)
+			{
+				if (dataEnd - data < 3)
+				{
+					return false;
+				}
+
+				value = ((first & 0x1Fu) << 24u) | (static_cast<uint32_t>(data[0]) << 16u) | (static_cast<uint32_t>(data[1]) << 8u) | data[2];
+				data += 3;
+				return true;
+			}
+
+			return false;
+		}
+
+		// Converts a compressed unsigned integer into the signed integer it encodes.
+		PDB_NO_DISCARD inline int32_t DecodeSigned(uint32_t value) PDB_NO_EXCEPT
+		{
+			return (value & 1u) ? -static_cast<int32_t>(value >> 1u) : static_cast<int32_t>(value >> 1u);
+		}
+
+		// Returns the binary annotations of an S_INLINESITE or S_INLINESITE2 record.
+		inline void GetInlineSiteAnnotations(const CodeView::DBI::Record* record, const uint8_t*& annotations, const uint8_t*& annotationsEnd) PDB_NO_EXCEPT
+		{
+			// the record size does not include the 2-byte size field itself
+			const uint8_t* recordEnd = reinterpret_cast<const uint8_t*>(record) + sizeof(uint16_t) + record->header.size;
+
+			if (record->header.kind == CodeView::DBI::SymbolRecordKind::S_INLINESITE2)
+			{
+				annotations = record->data.S_INLINESITE2.binaryAnnotations;
+			}
+			else
+			{
+				PDB_ASSERT(record->header.kind == CodeView::DBI::SymbolRecordKind::S_INLINESITE,
+					"Record kind %X is not an inline site", static_cast<uint32_t>(record->header.kind));
+
+				annotations = record->data.S_INLINESITE.binaryAnnotations;
+			}
+
+			annotationsEnd = (annotations < recordEnd) ? recordEnd : annotations;
+		}
+
+		// Calls the functor for each code range [begin, end) covered by an inline site, along with the file and line the code
+		// was generated for. The file is identified by the offset of its checksum in the module's S_FILECHECKSUMS subsection.
+		// The file and line the inlinee starts at are stored in the module's S_INLINEELINES subsection, and must be passed in.
+		// Code offsets are relative to the start of the procedure the inline site was inlined into, even for nested inline sites.
+		// Inline sites in separated code (S_SEPCODE) are relative to the start of the separated code block instead.
+		template <typename F>
+		void ForEachInlineSiteLineRange(const CodeView::DBI::Record* record, uint32_t fileChecksumOffset, uint32_t lineNumber, F&& functor) PDB_NO_EXCEPT
+		{
+			const uint8_t* data = nullptr;
+			const uint8_t* dataEnd = nullptr;
+			GetInlineSiteAnnotations(record, data, dataEnd);
+
+			uint32_t codeOffset = 0u;
+
+			// the start of the code range which has been opened, but not yet been given a length
+			uint32_t rangeStart = 0u;
+			uint32_t rangeFileChecksumOffset = 0u;
+			uint32_t rangeLineNumber = 0u;
+			bool hasOpenRange = false;
+
+			// a new line entry starts a code range, which implicitly ends the previous one
+			auto openRange = [&](uint32_t offset)
+			{
+				if (hasOpenRange && (offset > rangeStart))
+				{
+					functor(rangeStart, offset, rangeFileChecksumOffset, rangeLineNumber);
+				}
+
+				rangeStart = offset;
+				rangeFileChecksumOffset = fileChecksumOffset;
+				rangeLineNumber = lineNumber;
+				hasOpenRange = true;
+			};
+
+			// an explicit code length ends the open range, and advances the code offset past it
+			auto closeRange = [&](uint32_t length)
+			{
+				if (hasOpenRange && (length != 0u))
+				{
+					functor(rangeStart, rangeStart + length, rangeFileChecksumOffset, rangeLineNumber);
+				}
+
+				codeOffset = (hasOpenRange ? rangeStart : codeOffset) + length;
+				hasOpenRange = false;
+			};
+
+			while (data < dataEnd)
+			{
+				const CodeView::DBI::BinaryAnnotationOpcode opcode = static_cast<CodeView::DBI::BinaryAnnotationOpcode>(*data++);
+
+				uint32_t operand = 0u;
+				if ((opcode == CodeView::DBI::BinaryAnnotationOpcode::Invalid) || !ReadUnsigned(data, dataEnd, operand))
+				{
+					// the remaining bytes are padding
+					break;
+				}
+
+				switch (opcode)
+				{
+					case CodeView::DBI::BinaryAnnotationOpcode::CodeOffset:
+						codeOffset = operand;
+						break;
+
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeCodeOffset:
+						codeOffset += operand;
+						openRange(codeOffset);
+						break;
+
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeCodeLength:
+						closeRange(operand);
+						break;
+
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeFile:
+						fileChecksumOffset = operand;
+						break;
+
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeLineOffset:
+						lineNumber += static_cast<uint32_t>(DecodeSigned(operand));
+						break;
+
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeCodeOffsetAndLineOffset:
+						// the lower 4 bits store the code delta, the remaining bits the signed line delta
+						lineNumber += static_cast<uint32_t>(DecodeSigned(operand >> 4u));
+						codeOffset += operand & 0xFu;
+						openRange(codeOffset);
+						break;
+
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeCodeLengthAndCodeOffset:
+					{
+						uint32_t codeDelta = 0u;
+						if (!ReadUnsigned(data, dataEnd, codeDelta))
+						{
+							return;
+						}
+
+						codeOffset += codeDelta;
+						openRange(codeOffset);
+						closeRange(operand);
+						break;
+					}
+
+					case CodeView::DBI::BinaryAnnotationOpcode::Invalid:
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeCodeOffsetBase:
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeLineEndDelta:
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeRangeKind:
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeColumnStart:
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeColumnEndDelta:
+					case CodeView::DBI::BinaryAnnotationOpcode::ChangeColumnEnd:
+					default:
+						// columns and the extent of lines do not affect the code ranges
+						break;
+				}
+			}
+
+			// a range without explicit length at the end of the annotations has unknown extent.
+			// compilers always terminate the last range with a length, so such ranges are dropped.
+		}
+
+		// Calls the functor for each code range [begin, end) covered by an inline site, see ForEachInlineSiteLineRange().
+		template <typename F>
+		void ForEachInlineSiteCodeRange(const CodeView::DBI::Record* record, F&& functor) PDB_NO_EXCEPT
+		{
+			ForEachInlineSiteLineRange(record, 0u, 0u, [&functor](uint32_t codeOffsetBegin, uint32_t codeOffsetEnd, uint32_t, uint32_t)
+			{
+				functor(codeOffsetBegin, codeOffsetEnd);
+			});
+		}
+	}
+}
@@ -0,0 +1,675 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_BlockLoader.h"
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_Util.h"
+#include "PDB_CoalescedMSFStream.h"
+#include "Foundation/PDB_Assert.h"
+#include "Foundation/PDB_BitUtil.h"
+#include "Foundation/PDB_Memory.h"
+#include "Foundation/PDB_Platform.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstring>
+#if !PDB_PLATFORM_WINDOWS
+#	include <cerrno>
+#	include <unistd.h>
+#endif
+#if PDB_PLATFORM_LINUX && defined(__has_include)
+#	if __has_include(<linux/io_uring.h>)
+#		include <linux/io_uring.h>
+#		include <sys/mman.h>
+#		include <sys/syscall.h>
+		// IORING_OP_READ was added in the same kernel version as IORING_FEAT_RW_CUR_POS
+#		if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(IORING_FEAT_RW_CUR_POS)
+#			define PDB_HAS_IO_URING				1
+#		endif
+#	endif
+#endif
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+#ifndef PDB_HAS_IO_URING
+#	define PDB_HAS_IO_URING					0
+#endif
+
+
+namespace
+{
+	// the slot used for reading blocks that don't belong to any stream
+	static const uint32_t NoStream = 0xffffffffu;
+
+	// runs of contiguous blocks are merged into reads of at most this size
+	static const uint32_t MaxRequestSize = 1024u * 1024u;
+}
+
+
+#if PDB_HAS_IO_URING
+// A submission and completion queue shared with the kernel.
+// The library doesn't depend on liburing, the rings are set up using the raw system calls.
+struct PDB::BlockLoader::Ring
+{
+	static Ring* Create(uint32_t entryCount) PDB_NO_EXCEPT;
+	static void Destroy(Ring* ring) PDB_NO_EXCEPT;
+
+	// Reads all requests that aren't done yet. Returns false if io_uring turned out to be unusable, in which case the
+	// remaining requests have to be read using a different mechanism.
+	PDB_NO_DISCARD bool ReadBatch(Batch& batch) PDB_NO_EXCEPT;
+
+	// Queues reading the rest of the request, without submitting it yet.
+	void QueueRead(const Batch& batch, uint32_t requestIndex) PDB_NO_EXCEPT;
+
+	int fd;
+	uint32_t entryCount;
+
+	void* sqRing;
+	size_t sqRingSize;
+	void* cqRing;
+	size_t cqRingSize;
+	io_uring_sqe* sqes;
+	size_t sqesSize;
+
+	uint32_t* sqTail;
+	uint32_t sqMask;
+	uint32_t* sqArray;
+	uint32_t* cqHead;
+	uint32_t* cqTail;
+	uint32_t cqMask;
+	const io_uring_cqe* cqes;
+};
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::BlockLoader::Ring* PDB::BlockLoader::Ring::Create(uint32_t entryCount) PDB_NO_EXCEPT
+{
+	io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+
+	// fails if the kernel is too old, or io_uring has been disabled e.g. by a seccomp filter
+	const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entryCount, &params));
+	if (fd < 0)
+	{
+		return nullptr;
+	}
+
+	Ring* ring = PDB_NEW(Ring);
+	std::memset(ring, 0, sizeof(Ring));
+	ring->fd = fd;
+	ring->entryCount = params.sq_entries;
+
+	ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+	ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+	// newer kernels map both rings at once
+	const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0u;
+	if (singleMap && (ring->cqRingSize > ring->sqRingSize))
+	{
+		ring->sqRingSize = ring->cqRingSize;
+	}
+
+	void* sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	void* cqRing = singleMap ? nullptr : mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+	void* sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	ring->sqRing = (sqRing == MAP_FAILED) ? nullptr : sqRing;
+	ring->cqRing = (cqRing == MAP_FAILED) ? nullptr : cqRing;
+	ring->sqes = (sqes == MAP_FAILED) ? nullptr : static_cast<io_uring_sqe*>(sqes);
+
+	if (!ring->sqRing || (!singleMap && !ring->cqRing) || !ring->sqes)
+	{
+		Destroy(ring);
+
+		return nullptr;
+	}
+
+	Byte* sq = static_cast<Byte*>(ring->sqRing);
+	Byte* cq = singleMap ? sq : static_cast<Byte*>(ring->cqRing);
+	ring->sqTail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+	ring->sqMask = *reinterpret_cast<const uint32_t*>(sq + params.sq_off.ring_mask);
+	ring->sqArray = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+	ring->cqHead = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+	ring->cqTail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+	ring->cqMask = *reinterpret_cast<const uint32_t*>(cq + params.cq_off.ring_mask);
+	ring->cqes = reinterpret_cast<const io_uring_cqe*>(cq + params.cq_off.cqes);
+
+	return ring;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::BlockLoader::Ring::Destroy(Ring* ring) PDB_NO_EXCEPT
+{
+	if (!ring)
+	{
+		return;
+	}
+
+	if (ring->sqes)
+	{
+		munmap(ring->sqes, ring->sqesSize);
+	}
+
+	if (ring->cqRing)
+	{
+		munmap(ring->cqRing, ring->cqRingSize);
+	}
+
+	if (ring->sqRing)
+	{
+		munmap(ring->sqRing, ring->sqRingSize);
+	}
+
+	close(ring->fd);
+	PDB_DELETE(ring);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::BlockLoader::Ring::ReadBatch(Batch& batch) PDB_NO_EXCEPT
+{
+	uint32_t nextRequestIndex = 0u;
+	uint32_t inFlightCount = 0u;
+	uint32_t queuedCount = 0u;
+	bool isUsable = true;
+	bool hasCompletedRead = false;
+
+	for (;;)
+	{
+		// keep the queue as full as possible. the completion queue is twice as large, so it never overflows.
+		while (isUsable && (nextRequestIndex < batch.requestCount) && (inFlightCount < entryCount))
+		{
+			if (!batch.requests[nextRequestIndex].done)
+			{
+				QueueRead(batch, nextRequestIndex);
+				++inFlightCount;
+				++queuedCount;
+			}
+
+			++nextRequestIndex;
+		}
+
+		if (inFlightCount == 0u)
+		{
+			break;
+		}
+
+		// submit all queued reads, and wait for at least one of them to complete
+		const long submittedCount = syscall(__NR_io_uring_enter, fd, queuedCount, 1u, IORING_ENTER_GETEVENTS, nullptr, 0u);
+		if (submittedCount < 0)
+		{
+			if ((errno == EINTR) || (errno == EAGAIN) || (errno == EBUSY))
+			{
+				continue;
+			}
+
+			return false;
+		}
+
+		queuedCount -= static_cast<uint32_t>(submittedCount);
+
+		uint32_t head = *cqHead;
+		const uint32_t tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+		for (/* nothing */; head != tail; ++head)
+		{
+			const io_uring_cqe& cqe = cqes[head & cqMask];
+			const uint32_t requestIndex = static_cast<uint32_t>(cqe.user_data);
+			Request& request = batch.requests[requestIndex];
+
+			if (cqe.res > 0)
+			{
+				hasCompletedRead = true;
+				request.bytesRead += static_cast<uint32_t>(cqe.res);
+				if (request.bytesRead < request.size)
+				{
+					// short read, continue where it left off
+					QueueRead(batch, requestIndex);
+					++queuedCount;
+
+					continue;
+				}
+
+				request.done = true;
+				--inFlightCount;
+				CompleteRequest(batch, request, true);
+			}
+			else if ((cqe.res == -EINTR) || (cqe.res == -EAGAIN))
+			{
+				QueueRead(batch, requestIndex);
+				++queuedCount;
+			}
+			else if (((cqe.res == -EINVAL) || (cqe.res == -EOPNOTSUPP)) && !hasCompletedRead)
+			{
+				// the kernel supports io_uring, but not IORING_OP_READ. wait for all other reads, and leave this one to the caller.
+				isUsable = false;
+				--inFlightCount;
+			}
+			else
+			{
+				// either an error, or the end of the file was reached before reading all blocks
+				request.done = true;
+				--inFlightCount;
+				CompleteRequest(batch, request, false);
+			}
+		}
+
+		__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+	}
+
+	return isUsable;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::BlockLoader::Ring::QueueRead(const Batch& batch, uint32_t requestIndex) PDB_NO_EXCEPT
+{
+	const Request& request = batch.requests[requestIndex];
+	const uint64_t offset = request.offset + request.bytesRead;
+
+	// only this thread writes the tail, so there is no need for an atomic load
+	const uint32_t tail = *sqTail;
+	const uint32_t index = tail & sqMask;
+
+	io_uring_sqe& sqe = sqes[index];
+	std::memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = IORING_OP_READ;
+	sqe.fd = static_cast<int>(batch.loader->m_file);
+	sqe.off = offset;
+	sqe.addr = reinterpret_cast<uintptr_t>(batch.loader->m_image + offset);
+	sqe.len = request.size - request.bytesRead;
+	sqe.user_data = requestIndex;
+
+	sqArray[index] = index;
+	__atomic_store_n(sqTail, tail + 1u, __ATOMIC_RELEASE);
+}
+#else
+// io_uring is not available on this platform, all reads go through the parallel loop.
+struct PDB::BlockLoader::Ring
+{
+	static Ring* Create(uint32_t) PDB_NO_EXCEPT
+	{
+		return nullptr;
+	}
+
+	static void Destroy(Ring*) PDB_NO_EXCEPT
+	{
+	}
+
+	PDB_NO_DISCARD bool ReadBatch(Batch&) PDB_NO_EXCEPT
+	{
+		return false;
+	}
+};
+#endif
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::BlockLoader::BlockLoader(intptr_t file, void* image, size_t imageSize, const Options& options) PDB_NO_EXCEPT
+	: m_file(file)
+	, m_image(static_cast<Byte*>(image))
+	, m_imageSize(imageSize)
+	, m_options(options)
+	, m_ring(options.useIoUring ? Ring::Create(options.queueDepth) : nullptr)
+	, m_superBlock(nullptr)
+	, m_blockSizeLog2(0u)
+	, m_rawFile(nullptr)
+	, m_loadedStreams(nullptr)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::BlockLoader::~BlockLoader(void) PDB_NO_EXCEPT
+{
+	Ring::Destroy(m_ring);
+	PDB_DELETE(m_rawFile);
+	PDB_DELETE_ARRAY(m_loadedStreams);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::BlockLoader::LoadDirectory(void) PDB_NO_EXCEPT
+{
+	if (m_rawFile)
+	{
+		return ErrorCode::Success;
+	}
+
+	if (m_imageSize < sizeof(SuperBlock))
+	{
+		return ErrorCode::InvalidSuperBlock;
+	}
+
+	if (!Read(m_image, sizeof(SuperBlock), 0u))
+	{
+		return ErrorCode::ReadError;
+	}
+
+	// compressed MSF files don't consist of blocks
+	const SuperBlock* superBlock = reinterpret_cast<const SuperBlock*>(m_image);
+	if (std::memcmp(superBlock->fileMagic, SuperBlock::MAGIC, sizeof(SuperBlock::MAGIC)) != 0)
+	{
+		return ErrorCode::InvalidSuperBlock;
+	}
+
+	const ErrorCode error = ValidateFile(m_image);
+	if (error != ErrorCode::Success)
+	{
+		return error;
+	}
+
+	const uint32_t blockSize = superBlock->blockSize;
+	const uint32_t directoryBlockCount = ConvertSizeToBlockCount(superBlock->directorySize, blockSize);
+	const uint32_t directoryIndexBlockCount = ConvertSizeToBlockCount(directoryBlockCount * sizeof(uint32_t), blockSize);
+	if ((superBlock->blockCount > (m_imageSize >> BitUtil::FindFirstSetBit(blockSize))) || (sizeof(SuperBlock) + directoryIndexBlockCount * sizeof(uint32_t) > blockSize))
+	{
+		return ErrorCode::InvalidSuperBlock;
+	}
+
+	m_superBlock = superBlock;
+	m_blockSizeLog2 = BitUtil::FindFirstSetBit(blockSize);
+
+	// the rest of the first block stores the indices of blocks storing the directory indices, see RawFile
+	if (!Read(m_image + sizeof(SuperBlock), blockSize - sizeof(SuperBlock), sizeof(SuperBlock)))
+	{
+		return ErrorCode::ReadError;
+	}
+
+	const ErrorCode indicesError = ReadBlocks(superBlock->directoryBlockIndices, directoryIndexBlockCount);
+	if (indicesError != ErrorCode::Success)
+	{
+		return indicesError;
+	}
+
+	const CoalescedMSFStream directoryIndicesStream(m_image, blockSize, superBlock->directoryBlockIndices, directoryBlockCount * sizeof(uint32_t));
+	const ErrorCode directoryError = ReadBlocks(directoryIndicesStream.GetDataAtOffset<uint32_t>(0u), directoryBlockCount);
+	if (directoryError != ErrorCode::Success)
+	{
+		return directoryError;
+	}
+
+	m_rawFile = PDB_NEW(RawFile)(m_image);
+
+	const uint32_t streamCount = m_rawFile->GetStreamCount();
+	m_loadedStreams = PDB_NEW_ARRAY(bool, streamCount);
+	std::memset(m_loadedStreams, 0, streamCount * sizeof(bool));
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::BlockLoader::LoadStreams(const uint32_t* streamIndices, uint32_t count, StreamLoadedFunction streamLoaded, void* userData) PDB_NO_EXCEPT
+{
+	PDB_ASSERT(m_rawFile != nullptr, "The directory must be loaded before loading any streams.");
+
+	const uint32_t streamCount = m_rawFile->GetStreamCount();
+	const uint32_t blockSize = m_superBlock->blockSize;
+
+	// streams requested more than once are only read and reported once
+	bool* isRequested = PDB_NEW_ARRAY(bool, streamCount);
+	std::memset(isRequested, 0, streamCount * sizeof(bool));
+
+	Slot* slots = PDB_NEW_ARRAY(Slot, count);
+	uint32_t slotCount = 0u;
+	GrowableArray<Request> requests;
+
+	ErrorCode result = ErrorCode::Success;
+	for (uint32_t i = 0u; i < count; ++i)
+	{
+		const uint32_t streamIndex = streamIndices[i];
+		if (streamIndex >= streamCount)
+		{
+			result = ErrorCode::InvalidStreamIndex;
+			streamLoaded(userData, streamIndex, result);
+
+			continue;
+		}
+		else if (isRequested[streamIndex])
+		{
+			continue;
+		}
+
+		isRequested[streamIndex] = true;
+
+		const uint32_t* blockIndices = m_rawFile->GetStreamBlockIndices(streamIndex);
+		const uint32_t blockCount = ConvertSizeToBlockCount(m_rawFile->GetStreamSize(streamIndex), blockSize);
+		if (m_loadedStreams[streamIndex] || (blockCount == 0u))
+		{
+			m_loadedStreams[streamIndex] = true;
+			streamLoaded(userData, streamIndex, ErrorCode::Success);
+
+			continue;
+		}
+
+		bool hasValidBlocks = true;
+		for (uint32_t j = 0u; j < blockCount; ++j)
+		{
+			hasValidBlocks &= (blockIndices[j] < m_superBlock->blockCount);
+		}
+
+		if (!hasValidBlocks)
+		{
+			result = ErrorCode::InvalidStream;
+			streamLoaded(userData, streamIndex, result);
+
+			continue;
+		}
+
+		const size_t firstRequest = requests.GetSize();
+		AddBlockRequests(requests, blockIndices, blockCount, slotCount);
+
+		Slot& slot = slots[slotCount];
+		slot.streamIndex = streamIndex;
+		slot.pendingRequestCount = static_cast<uint32_t>(requests.GetSize() - firstRequest);
+		slot.failed = false;
+
+		++slotCount;
+	}
+
+	Batch batch = { this, requests.GetData(), static_cast<uint32_t>(requests.GetSize()), slots, streamLoaded, userData };
+	ReadBatch(batch);
+
+	for (uint32_t i = 0u; i < slotCount; ++i)
+	{
+		if (slots[i].failed && (result == ErrorCode::Success))
+		{
+			result = ErrorCode::ReadError;
+		}
+	}
+
+	PDB_DELETE_ARRAY(slots);
+	PDB_DELETE_ARRAY(isRequested);
+
+	return result;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::BlockLoader::IsStreamLoaded(uint32_t streamIndex) const PDB_NO_EXCEPT
+{
+	if (!m_rawFile || (streamIndex >= m_rawFile->GetStreamCount()))
+	{
+		return false;
+	}
+
+	return m_loadedStreams[streamIndex];
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::BlockLoader::AddBlockRequests(GrowableArray<Request>& requests, const uint32_t* blockIndices, uint32_t blockCount, uint32_t slotIndex) const PDB_NO_EXCEPT
+{
+	const uint32_t maxBlocksPerRequest = (MaxRequestSize >> m_blockSizeLog2) ? (MaxRequestSize >> m_blockSizeLog2) : 1u;
+
+	for (uint32_t i = 0u; i < blockCount; /* nothing */)
+	{
+		const uint32_t firstBlockIndex = blockIndices[i];
+
+		uint32_t runLength = 1u;
+		while ((i + runLength < blockCount) && (runLength < maxBlocksPerRequest) && (blockIndices[i + runLength] == firstBlockIndex + runLength))
+		{
+			++runLength;
+		}
+
+		const Request request = { static_cast<uint64_t>(firstBlockIndex) << m_blockSizeLog2, runLength << m_blockSizeLog2, 0u, slotIndex, false };
+		requests.Add(request);
+
+		i += runLength;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::BlockLoader::ReadBatch(Batch& batch) PDB_NO_EXCEPT
+{
+	if (m_ring && !m_ring->ReadBatch(batch))
+	{
+		// don't try again for subsequent batches
+		Ring::Destroy(m_ring);
+		m_ring = nullptr;
+	}
+
+	if (!m_ring)
+	{
+		ReadBatchUsingParallelFor(batch);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::BlockLoader::ReadBatchUsingParallelFor(Batch& batch) PDB_NO_EXCEPT
+{
+	ParallelFor(m_options.parallelFor, m_options.userData, batch.requestCount, &BlockLoader::ReadRequestJob, &batch);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::BlockLoader::ReadBlocks(const uint32_t* blockIndices, uint32_t blockCount) PDB_NO_EXCEPT
+{
+	for (uint32_t i = 0u; i < blockCount; ++i)
+	{
+		if (blockIndices[i] >= m_superBlock->blockCount)
+		{
+			return ErrorCode::InvalidStream;
+		}
+	}
+
+	GrowableArray<Request> requests;
+	AddBlockRequests(requests, blockIndices, blockCount, 0u);
+
+	Slot slot;
+	slot.streamIndex = NoStream;
+	slot.pendingRequestCount = static_cast<uint32_t>(requests.GetSize());
+	slot.failed = false;
+
+	Batch batch = { this, requests.GetData(), static_cast<uint32_t>(requests.GetSize()), &slot, nullptr, nullptr };
+	ReadBatch(batch);
+
+	return slot.failed ? ErrorCode::ReadError : ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::BlockLoader::ReadRequestJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+{
+	Batch& batch = *static_cast<Batch*>(jobData);
+	Request& request = batch.requests[index];
+	if (request.done)
+	{
+		return;
+	}
+
+	const uint64_t offset = request.offset + request.bytesRead;
+	const bool success = batch.loader->Read(batch.loader->m_image + offset, request.size - request.bytesRead, offset);
+
+	request.done = true;
+	CompleteRequest(batch, request, success);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::BlockLoader::CompleteRequest(Batch& batch, const Request& request, bool success) PDB_NO_EXCEPT
+{
+	Slot& slot = batch.slots[request.slotIndex];
+	if (!success)
+	{
+		slot.failed = true;
+	}
+
+	// the last request of a stream to complete reports the stream
+	if (--slot.pendingRequestCount != 0u)
+	{
+		return;
+	}
+
+	if (slot.streamIndex == NoStream)
+	{
+		return;
+	}
+
+	const bool failed = slot.failed;
+	batch.loader->m_loadedStreams[slot.streamIndex] = !failed;
+	batch.streamLoaded(batch.userData, slot.streamIndex, failed ? ErrorCode::ReadError : ErrorCode::Success);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::BlockLoader::Read(void* buffer, size_t size, uint64_t offset) const PDB_NO_EXCEPT
+{
+	if (m_options.read)
+	{
+		return m_options.read(m_options.userData, m_file, buffer, size, offset);
+	}
+
+#if PDB_PLATFORM_WINDOWS
+	// there is no portable way of reading from a HANDLE without pulling in Windows.h
+	(void)buffer;
+	(void)size;
+	(void)offset;
+
+	return false;
+#else
+	Byte* destination = static_cast<Byte*>(buffer);
+	while (size != 0u)
+	{
+		const ssize_t bytesRead = pread(static_cast<int>(m_file), destination, size, static_cast<off_t>(offset));
+		if (bytesRead < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return false;
+		}
+		else if (bytesRead == 0)
+		{
+			// unexpected end of file
+			return false;
+		}
+
+		destination += bytesRead;
+		size -= static_cast<size_t>(bytesRead);
+		offset += static_cast<uint64_t>(bytesRead);
+	}
+
+	return true;
+#endif
+}
@@ -0,0 +1,145 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_ParallelFor.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <atomic>
+#include "Foundation/PDB_DisableWarningsPop.h"
+#include "PDB_ErrorCodes.h"
+#include "PDB_Types.h"
+
+
+namespace PDB
+{
+	class RawFile;
+
+
+	// Reads the blocks of an MSF file on demand, instead of memory-mapping the whole file and faulting in one page at a time.
+	// All blocks of the requested streams are submitted at once, so that the storage device sees a deep queue of large reads
+	// when the file is not in the page cache.
+	// On Linux, reads are submitted using io_uring. Everywhere else, or if io_uring is unavailable, the blocks are read
+	// using a user-provided parallel loop, which the caller would typically run on a thread pool.
+	// Blocks are read into a caller-provided buffer holding the file image, at their offset in the file. The RawFile returned
+	// by GetRawFile() reads from that buffer, so streams must only be accessed once they have been loaded.
+	// Only MSF files can be loaded this way. Member functions must not be called concurrently.
+	class PDB_NO_DISCARD BlockLoader
+	{
+	public:
+		// Called once for each requested stream as soon as all its blocks have been read, or reading one of them failed.
+		// When using the parallel loop, this is called from the threads running the loop.
+		typedef void (*StreamLoadedFunction)(void* userData, uint32_t streamIndex, ErrorCode error);
+
+		// Reads exactly size bytes at the given offset of the file. Called from several threads at once if a parallel loop is provided.
+		typedef bool (*ReadFunction)(void* userData, intptr_t file, void* buffer, size_t size, uint64_t offset);
+
+		struct Options
+		{
+			// without a function, pread() is used on POSIX systems. must be provided on Windows.
+			ReadFunction read = nullptr;
+
+			// without a function, blocks are read one after another if io_uring cannot be used
+			ParallelForFunction parallelFor = nullptr;
+
+			void* userData = nullptr;
+
+			// maximum number of reads that are in flight at the same time when using io_uring
+			uint32_t queueDepth = 256u;
+
+			// io_uring reads from the file descriptor directly, so it must be disabled if the file can only be read using the read function
+			bool useIoUring = true;
+		};
+
+		// The file is a POSIX file descriptor or a Windows HANDLE, which is only ever used by the read function.
+		// The image must be large enough to hold the whole file.
+		explicit BlockLoader(intptr_t file, void* image, size_t imageSize, const Options& options) PDB_NO_EXCEPT;
+		~BlockLoader(void) PDB_NO_EXCEPT;
+
+		// Reads the SuperBlock and the stream directory, which is needed before any stream can be loaded.
+		PDB_NO_DISCARD ErrorCode LoadDirectory(void) PDB_NO_EXCEPT;
+
+		// Reads all blocks of the given streams, and returns once all of them have been loaded or failed.
+		// The callback is invoked for each stream, including streams that were loaded before. Returns ErrorCode::ReadError
+		// if reading any of the streams failed.
+		PDB_NO_DISCARD ErrorCode LoadStreams(const uint32_t* streamIndices, uint32_t count, StreamLoadedFunction streamLoaded, void* userData) PDB_NO_EXCEPT;
+
+		// Returns whether all blocks of the given stream have been read.
+		PDB_NO_DISCARD bool IsStreamLoaded(uint32_t streamIndex) const PDB_NO_EXCEPT;
+
+		// Returns the raw file, which can only be used once the directory has been loaded.
+		PDB_NO_DISCARD inline const RawFile& GetRawFile(void) const PDB_NO_EXCEPT
+		{
+			return *m_rawFile;
+		}
+
+		// Returns whether reads are submitted using io_uring.
+		PDB_NO_DISCARD inline bool IsUsingIoUring(void) const PDB_NO_EXCEPT
+		{
+			return (m_ring != nullptr);
+		}
+
+	private:
+		struct Ring;
+
+		// A contiguous range of the file, covering one or more blocks of a single stream.
+		struct Request
+		{
+			uint64_t offset;
+			uint32_t size;
+			uint32_t bytesRead;
+			uint32_t slotIndex;
+			bool done;
+		};
+
+		// A stream being loaded by the current batch of requests.
+		struct Slot
+		{
+			uint32_t streamIndex;
+			std::atomic<uint32_t> pendingRequestCount;
+			std::atomic<bool> failed;
+		};
+
+		struct Batch
+		{
+			BlockLoader* loader;
+			Request* requests;
+			uint32_t requestCount;
+			Slot* slots;
+			StreamLoadedFunction streamLoaded;
+			void* userData;
+		};
+
+		// Adds the requests for reading the given blocks, merging runs of contiguous blocks.
+		void AddBlockRequests(GrowableArray<Request>& requests, const uint32_t* blockIndices, uint32_t blockCount, uint32_t slotIndex) const PDB_NO_EXCEPT;
+
+		// Reads all requests of the batch, using io_uring if possible.
+		void ReadBatch(Batch& batch) PDB_NO_EXCEPT;
+		void ReadBatchUsingParallelFor(Batch& batch) PDB_NO_EXCEPT;
+
+		// Reads the given blocks without any stream being involved, e.g. for reading the directory.
+		PDB_NO_DISCARD ErrorCode ReadBlocks(const uint32_t* blockIndices, uint32_t blockCount) PDB_NO_EXCEPT;
+
+		static void ReadRequestJob(void* jobData, uint32_t index) PDB_NO_EXCEPT;
+		static void CompleteRequest(Batch& batch, const Request& request, bool success) PDB_NO_EXCEPT;
+
+		PDB_NO_DISCARD bool Read(void* buffer, size_t size, uint64_t offset) const PDB_NO_EXCEPT;
+
+		intptr_t m_file;
+		Byte* m_image;
+		size_t m_imageSize;
+		Options m_options;
+		Ring* m_ring;
+
+		const SuperBlock* m_superBlock;
+		uint32_t m_blockSizeLog2;
+		RawFile* m_rawFile;
+
+		// whether each stream has been loaded, once the directory is available
+		bool* m_loadedStreams;
+
+		PDB_DISABLE_COPY_MOVE(BlockLoader);
+	};
+}
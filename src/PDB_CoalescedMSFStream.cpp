@@ -7,6 +7,7 @@
 #include "PDB_DirectMSFStream.h"
 #include "Foundation/PDB_PointerUtil.h"
 #include "Foundation/PDB_Memory.h"
+#include "Foundation/PDB_BitUtil.h"
 #include "Foundation/PDB_DisableWarningsPush.h"
 #include <cstring>
 #include "Foundation/PDB_DisableWarningsPop.h"
@@ -16,13 +17,13 @@ namespace
 {
 	// ------------------------------------------------------------------------------------------------
 	// ------------------------------------------------------------------------------------------------
-	PDB_NO_DISCARD static bool AreBlockIndicesContiguous(const uint32_t* blockIndices, uint32_t blockSize, uint32_t streamSize) PDB_NO_EXCEPT
+	PDB_NO_DISCARD static bool AreBlockIndicesContiguous(const uint32_t* blockIndices, uint32_t blockSize, size_t streamSize) PDB_NO_EXCEPT
 	{
-		const uint32_t blockCount = PDB::ConvertSizeToBlockCount(streamSize, blockSize);
+		const size_t blockCount = (streamSize + blockSize - 1u) / blockSize;
 
 		// start with the first index, checking if all following indices are contiguous (N, N+1, N+2, ...)
 		uint32_t expectedIndex = blockIndices[0];
-		for (uint32_t i = 1u; i < blockCount; ++i)
+		for (size_t i = 1u; i < blockCount; ++i)
 		{
 			++expectedIndex;
 			if (blockIndices[i] != expectedIndex)
@@ -97,36 +98,36 @@ PDB::CoalescedMSFStream::CoalescedMSFStream(const void* data, uint32_t blockSize
 	}
 	else
 	{
-		// slower path, we need to copy disjunct blocks into our own data array, block by block
+		// slower path, we need to copy disjunct blocks into our own data array.
+		// runs of blocks that are contiguous in the file are copied at once.
 		m_ownedData = PDB_NEW_ARRAY(Byte, streamSize);
 		m_data = m_ownedData;
 
 		Byte* destination = m_ownedData;
 
-		// copy full blocks first
-		const uint32_t fullBlockCount = streamSize / blockSize;
-		for (uint32_t i = 0u; i < fullBlockCount; ++i)
-		{
-			const uint32_t index = blockIndices[i];
-
-			// read one single block at the correct offset in the stream
-			const size_t fileOffset = PDB::ConvertBlockIndexToFileOffset(index, blockSize);
-			const void* sourceData = Pointer::Offset<const void*>(data, fileOffset);
-			std::memcpy(destination, sourceData, blockSize);
-
-			destination += blockSize;
-		}
+		const uint32_t blockSizeLog2 = BitUtil::FindFirstSetBit(blockSize);
+		const uint32_t blockCount = PDB::ConvertSizeToBlockCount(streamSize, blockSize);
 
-		// account for non-full blocks
-		const uint32_t remainingBytes = streamSize - (fullBlockCount * blockSize);
-		if (remainingBytes != 0u)
+		size_t bytesLeftToRead = streamSize;
+		for (uint32_t i = 0u; i < blockCount; /* nothing */)
 		{
-			const uint32_t index = blockIndices[fullBlockCount];
+			uint32_t runLength = 1u;
+			while ((i + runLength < blockCount) && (blockIndices[i + runLength] == blockIndices[i] + runLength))
+			{
+				++runLength;
+			}
+
+			// file offsets can exceed 4 GiB, the last block of the stream is not necessarily full
+			const size_t fileOffset = static_cast<size_t>(blockIndices[i]) << blockSizeLog2;
+			const size_t runSize = static_cast<size_t>(runLength) << blockSizeLog2;
+			const size_t bytesToRead = (runSize < bytesLeftToRead) ? runSize : bytesLeftToRead;
 
-			// read remaining bytes at correct offset in the stream
-			const size_t fileOffset = PDB::ConvertBlockIndexToFileOffset(index, blockSize);
 			const void* sourceData = Pointer::Offset<const void*>(data, fileOffset);
-			std::memcpy(destination, sourceData, remainingBytes);
+			std::memcpy(destination, sourceData, bytesToRead);
+
+			destination += bytesToRead;
+			bytesLeftToRead -= bytesToRead;
+			i += runLength;
 		}
 	}
 }
@@ -134,7 +135,7 @@ PDB::CoalescedMSFStream::CoalescedMSFStream(const void* data, uint32_t blockSize
 
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
-PDB::CoalescedMSFStream::CoalescedMSFStream(const DirectMSFStream& directStream, uint32_t size, uint32_t offset) PDB_NO_EXCEPT
+PDB::CoalescedMSFStream::CoalescedMSFStream(const DirectMSFStream& directStream, size_t size, size_t offset) PDB_NO_EXCEPT
 	: m_ownedData(nullptr)
 	, m_data(nullptr)
 	, m_size(size)
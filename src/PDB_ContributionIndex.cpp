@@ -0,0 +1,226 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_ContributionIndex.h"
+#include "PDB_IndexImage.h"
+#include "PDB_ImageSectionStream.h"
+#include "PDB_ModuleInfoStream.h"
+#include "PDB_SectionContributionStream.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ContributionIndex::ContributionIndex(void) PDB_NO_EXCEPT
+	: m_contributionRVAs(nullptr)
+	, m_contributions(nullptr)
+	, m_contributionCount(0u)
+	, m_moduleNameOffsets(nullptr)
+	, m_moduleCount(0u)
+	, m_moduleNames(nullptr)
+	, m_moduleNamesSize(0u)
+	, m_ownsData(true)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ContributionIndex::ContributionIndex(ContributionIndex&& other) PDB_NO_EXCEPT
+	: m_contributionRVAs(PDB_MOVE(other.m_contributionRVAs))
+	, m_contributions(PDB_MOVE(other.m_contributions))
+	, m_contributionCount(PDB_MOVE(other.m_contributionCount))
+	, m_moduleNameOffsets(PDB_MOVE(other.m_moduleNameOffsets))
+	, m_moduleCount(PDB_MOVE(other.m_moduleCount))
+	, m_moduleNames(PDB_MOVE(other.m_moduleNames))
+	, m_moduleNamesSize(PDB_MOVE(other.m_moduleNamesSize))
+	, m_ownsData(PDB_MOVE(other.m_ownsData))
+{
+	other.m_contributionRVAs = nullptr;
+	other.m_contributions = nullptr;
+	other.m_contributionCount = 0u;
+	other.m_moduleNameOffsets = nullptr;
+	other.m_moduleCount = 0u;
+	other.m_moduleNames = nullptr;
+	other.m_moduleNamesSize = 0u;
+	other.m_ownsData = true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ContributionIndex& PDB::ContributionIndex::operator=(ContributionIndex&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		if (m_ownsData)
+		{
+			PDB_DELETE_ARRAY(m_contributionRVAs);
+			PDB_DELETE_ARRAY(m_contributions);
+			PDB_DELETE_ARRAY(m_moduleNameOffsets);
+			PDB_DELETE_ARRAY(m_moduleNames);
+		}
+
+		m_contributionRVAs = PDB_MOVE(other.m_contributionRVAs);
+		m_contributions = PDB_MOVE(other.m_contributions);
+		m_contributionCount = PDB_MOVE(other.m_contributionCount);
+		m_moduleNameOffsets = PDB_MOVE(other.m_moduleNameOffsets);
+		m_moduleCount = PDB_MOVE(other.m_moduleCount);
+		m_moduleNames = PDB_MOVE(other.m_moduleNames);
+		m_moduleNamesSize = PDB_MOVE(other.m_moduleNamesSize);
+		m_ownsData = PDB_MOVE(other.m_ownsData);
+
+		other.m_contributionRVAs = nullptr;
+		other.m_contributions = nullptr;
+		other.m_contributionCount = 0u;
+		other.m_moduleNameOffsets = nullptr;
+		other.m_moduleCount = 0u;
+		other.m_moduleNames = nullptr;
+		other.m_moduleNamesSize = 0u;
+		other.m_ownsData = true;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ContributionIndex::ContributionIndex(const ImageSectionStream& imageSectionStream, const SectionContributionStream& sectionContributionStream, const ModuleInfoStream& moduleInfoStream) PDB_NO_EXCEPT
+	: m_contributionRVAs(nullptr)
+	, m_contributions(nullptr)
+	, m_contributionCount(0u)
+	, m_moduleNameOffsets(nullptr)
+	, m_moduleCount(0u)
+	, m_moduleNames(nullptr)
+	, m_moduleNamesSize(0u)
+	, m_ownsData(true)
+{
+	const ArrayView<DBI::SectionContribution> sectionContributions = sectionContributionStream.GetContributions();
+	Contribution* contributions = PDB_NEW_ARRAY(Contribution, sectionContributions.GetLength());
+
+	size_t contributionCount = 0u;
+	for (const DBI::SectionContribution& sectionContribution : sectionContributions)
+	{
+		const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(sectionContribution.section, sectionContribution.offset);
+		if ((rva == 0u) || (sectionContribution.size == 0u))
+		{
+			continue;
+		}
+
+		contributions[contributionCount++] = Contribution { rva, sectionContribution.size, sectionContribution.characteristics, sectionContribution.moduleIndex };
+	}
+
+	Algorithm::Sort(contributions, contributions + contributionCount, [](const Contribution& lhs, const Contribution& rhs)
+	{
+		return lhs.rva < rhs.rva;
+	});
+
+	// identical COMDATs contributed by several modules end up at the same RVA
+	size_t uniqueCount = 0u;
+	for (size_t i = 0u; i < contributionCount; ++i)
+	{
+		if ((uniqueCount != 0u) && (contributions[uniqueCount - 1u].rva == contributions[i].rva))
+		{
+			continue;
+		}
+
+		contributions[uniqueCount++] = contributions[i];
+	}
+
+	uint32_t* contributionRVAs = PDB_NEW_ARRAY(uint32_t, uniqueCount);
+	for (size_t i = 0u; i < uniqueCount; ++i)
+	{
+		contributionRVAs[i] = contributions[i].rva;
+	}
+
+	m_contributionRVAs = contributionRVAs;
+	m_contributions = contributions;
+	m_contributionCount = uniqueCount;
+
+	const ArrayView<ModuleInfoStream::Module> modules = moduleInfoStream.GetModules();
+	GrowableArray<char> moduleNameArray;
+	uint32_t* moduleNameOffsets = PDB_NEW_ARRAY(uint32_t, modules.GetLength());
+	for (size_t i = 0u; i < modules.GetLength(); ++i)
+	{
+		const ArrayView<char> name = modules[i].GetName();
+		moduleNameOffsets[i] = static_cast<uint32_t>(moduleNameArray.Append(name.Decay(), name.GetLength()));
+		moduleNameArray.Add('\0');
+	}
+
+	m_moduleNameOffsets = moduleNameOffsets;
+	m_moduleCount = modules.GetLength();
+	m_moduleNamesSize = moduleNameArray.GetSize();
+	m_moduleNames = moduleNameArray.Release();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ContributionIndex::ContributionIndex(IndexImageReader& reader) PDB_NO_EXCEPT
+	: m_contributionRVAs(nullptr)
+	, m_contributions(nullptr)
+	, m_contributionCount(0u)
+	, m_moduleNameOffsets(nullptr)
+	, m_moduleCount(0u)
+	, m_moduleNames(nullptr)
+	, m_moduleNamesSize(0u)
+	, m_ownsData(false)
+{
+	size_t contributionRVACount = 0u;
+	m_contributionRVAs = reader.ReadArray<uint32_t>(contributionRVACount);
+	m_contributions = reader.ReadArray<Contribution>(m_contributionCount);
+	m_moduleNameOffsets = reader.ReadArray<uint32_t>(m_moduleCount);
+	m_moduleNames = reader.ReadArray<char>(m_moduleNamesSize);
+
+	if (!reader.IsValid() || (contributionRVACount != m_contributionCount))
+	{
+		// without contributions FindContribution() never succeeds, and without modules GetModuleName() never reads a name offset
+		m_contributionCount = 0u;
+		m_moduleCount = 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ContributionIndex::~ContributionIndex(void) PDB_NO_EXCEPT
+{
+	if (m_ownsData)
+	{
+		PDB_DELETE_ARRAY(m_contributionRVAs);
+		PDB_DELETE_ARRAY(m_contributions);
+		PDB_DELETE_ARRAY(m_moduleNameOffsets);
+		PDB_DELETE_ARRAY(m_moduleNames);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::ContributionIndex::Serialize(IndexImageWriter& writer) const PDB_NO_EXCEPT
+{
+	writer.WriteArray(m_contributionRVAs, m_contributionCount);
+	writer.WriteArray(m_contributions, m_contributionCount);
+	writer.WriteArray(m_moduleNameOffsets, m_moduleCount);
+	writer.WriteArray(m_moduleNames, m_moduleNamesSize);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::ContributionIndex::Contribution* PDB::ContributionIndex::FindContribution(uint32_t rva) const PDB_NO_EXCEPT
+{
+	// find the last contribution starting at or before the RVA
+	const size_t index = Algorithm::UpperBound(m_contributionRVAs, m_contributionCount, rva);
+	if (index == 0u)
+	{
+		return nullptr;
+	}
+
+	const Contribution& contribution = m_contributions[index - 1u];
+	return (rva - contribution.rva < contribution.size) ? &contribution : nullptr;
+}
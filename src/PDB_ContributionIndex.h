@@ -0,0 +1,81 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstdint>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+namespace PDB
+{
+	class ImageSectionStream;
+	class ModuleInfoStream;
+	class SectionContributionStream;
+	class IndexImageWriter;
+	class IndexImageReader;
+
+
+	// An index of all section contributions, answering "which module contributed the code or data at this RVA?" with a
+	// single binary search over a tightly packed array of RVAs.
+	// Once built, the index is immutable and can be queried from several threads.
+	class PDB_NO_DISCARD ContributionIndex
+	{
+	public:
+		struct Contribution
+		{
+			uint32_t rva;
+			uint32_t size;
+			uint32_t characteristics;							// characteristics of the section, e.g. IMAGE_SCN_CNT_CODE
+			uint32_t moduleIndex;
+		};
+
+		ContributionIndex(void) PDB_NO_EXCEPT;
+		ContributionIndex(ContributionIndex&& other) PDB_NO_EXCEPT;
+		ContributionIndex& operator=(ContributionIndex&& other) PDB_NO_EXCEPT;
+
+		explicit ContributionIndex(const ImageSectionStream& imageSectionStream, const SectionContributionStream& sectionContributionStream, const ModuleInfoStream& moduleInfoStream) PDB_NO_EXCEPT;
+
+		// Creates an index referring to serialized data, see IndexImage. The data must outlive the index.
+		explicit ContributionIndex(IndexImageReader& reader) PDB_NO_EXCEPT;
+		~ContributionIndex(void) PDB_NO_EXCEPT;
+
+		// Serializes the index into a position-independent layout, see IndexImage.
+		void Serialize(IndexImageWriter& writer) const PDB_NO_EXCEPT;
+
+		// Returns the contribution containing the given RVA, or nullptr if there is none.
+		PDB_NO_DISCARD const Contribution* FindContribution(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the name of the module that made the given contribution, or an empty string if the module is unknown.
+		PDB_NO_DISCARD inline const char* GetModuleName(const Contribution& contribution) const PDB_NO_EXCEPT
+		{
+			return (contribution.moduleIndex < m_moduleCount) ? &m_moduleNames[m_moduleNameOffsets[contribution.moduleIndex]] : "";
+		}
+
+		// Returns a view of all contributions, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<Contribution> GetContributions(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Contribution>(m_contributions, m_contributionCount);
+		}
+
+	private:
+		// the RVAs are stored separately from the contributions so that the binary search touches as few cache lines as possible
+		const uint32_t* m_contributionRVAs;
+		const Contribution* m_contributions;
+		size_t m_contributionCount;
+
+		// names of all modules, copied because the module info stream is only alive while the index is built
+		const uint32_t* m_moduleNameOffsets;
+		size_t m_moduleCount;
+		const char* m_moduleNames;
+		size_t m_moduleNamesSize;
+
+		// indices referring to serialized data don't own any memory
+		bool m_ownsData;
+
+		PDB_DISABLE_COPY(ContributionIndex);
+	};
+}
@@ -74,6 +74,25 @@ namespace
 	{
 		return dbiHeader.optionalDebugHeaderSize != 0u;
 	}
+
+
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	PDB_NO_DISCARD static PDB::DBI::DebugHeader ReadDebugHeader(const PDB::DirectMSFStream& stream, const PDB::DBI::StreamHeader& dbiHeader) PDB_NO_EXCEPT
+	{
+		// the debug header sub-stream is optional, and older toolchains write fewer stream indices.
+		// stream indices that are not stored in the sub-stream are invalid.
+		PDB::DBI::DebugHeader debugHeader;
+		std::memset(&debugHeader, 0xFF, sizeof(PDB::DBI::DebugHeader));
+
+		if (HasDebugHeaderSubstream(dbiHeader))
+		{
+			const size_t size = (dbiHeader.optionalDebugHeaderSize < sizeof(PDB::DBI::DebugHeader)) ? dbiHeader.optionalDebugHeaderSize : sizeof(PDB::DBI::DebugHeader);
+			stream.ReadAtOffset(&debugHeader, size, GetDebugHeaderSubstreamOffset(dbiHeader));
+		}
+
+		return debugHeader;
+	}
 }
 
 
@@ -143,16 +162,83 @@ PDB_NO_DISCARD PDB::ErrorCode PDB::DBIStream::HasValidSymbolRecordStream(const R
 PDB_NO_DISCARD PDB::ErrorCode PDB::DBIStream::HasValidImageSectionStream(const RawFile& /* file */) const PDB_NO_EXCEPT
 {
 	// the debug header stream is optional. if it's not there, we can't get the image section stream either.
-	if (!HasDebugHeaderSubstream(m_header))
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+	if (debugHeader.sectionHeaderStreamIndex == DBI::DebugHeader::InvalidStreamIndex)
 	{
 		return ErrorCode::InvalidStreamIndex;
 	}
 
-	// find the debug header sub-stream
-	const uint32_t debugHeaderOffset = GetDebugHeaderSubstreamOffset(m_header);
-	const DBI::DebugHeader& debugHeader = m_stream.ReadAtOffset<DBI::DebugHeader>(debugHeaderOffset);
+	return ErrorCode::Success;
+}
+
 
-	if (debugHeader.sectionHeaderStreamIndex == DBI::DebugHeader::InvalidStreamIndex)
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::DBIStream::HasValidFixupStream(const RawFile& /* file */) const PDB_NO_EXCEPT
+{
+	// the fixup stream is only referenced by the optional debug header
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+	if (debugHeader.fixupDataStreamIndex == DBI::DebugHeader::InvalidStreamIndex)
+	{
+		return ErrorCode::InvalidStreamIndex;
+	}
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::DBIStream::HasValidFPOStream(const RawFile& /* file */) const PDB_NO_EXCEPT
+{
+	// the FPO stream is only referenced by the optional debug header, and only present for x86 images
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+	if (debugHeader.fpoDataStreamIndex == DBI::DebugHeader::InvalidStreamIndex)
+	{
+		return ErrorCode::InvalidStreamIndex;
+	}
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::DBIStream::HasValidFrameDataStream(const RawFile& /* file */) const PDB_NO_EXCEPT
+{
+	// the new FPO stream is only referenced by the optional debug header, and only present for x86 images
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+	if (debugHeader.newFpoDataStreamIndex == DBI::DebugHeader::InvalidStreamIndex)
+	{
+		return ErrorCode::InvalidStreamIndex;
+	}
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::DBIStream::HasValidPDataStream(const RawFile& /* file */) const PDB_NO_EXCEPT
+{
+	// the pdata stream is only referenced by the optional debug header, and only present for x64 images
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+	if (debugHeader.pdataStreamIndex == DBI::DebugHeader::InvalidStreamIndex)
+	{
+		return ErrorCode::InvalidStreamIndex;
+	}
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::DBIStream::HasValidXDataStream(const RawFile& /* file */) const PDB_NO_EXCEPT
+{
+	// the xdata stream is only referenced by the optional debug header, and only present for x64 images
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+	if (debugHeader.xdataStreamIndex == DBI::DebugHeader::InvalidStreamIndex)
 	{
 		return ErrorCode::InvalidStreamIndex;
 	}
@@ -245,12 +331,60 @@ PDB_NO_DISCARD PDB::CoalescedMSFStream PDB::DBIStream::CreateSymbolRecordStream(
 // ------------------------------------------------------------------------------------------------
 PDB_NO_DISCARD PDB::ImageSectionStream PDB::DBIStream::CreateImageSectionStream(const RawFile& file) const PDB_NO_EXCEPT
 {
-	// find the debug header sub-stream
-	const uint32_t debugHeaderOffset = GetDebugHeaderSubstreamOffset(m_header);
-	const DBI::DebugHeader& debugHeader = m_stream.ReadAtOffset<DBI::DebugHeader>(debugHeaderOffset);
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+
+	// the original section headers are only stored for images that were rearranged after linking, e.g. using OMAP
+	return ImageSectionStream(file, debugHeader.sectionHeaderStreamIndex, debugHeader.originalSectionHeaderDataStreamIndex);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::FixupStream PDB::DBIStream::CreateFixupStream(const RawFile& file) const PDB_NO_EXCEPT
+{
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+
+	return FixupStream(file, debugHeader.fixupDataStreamIndex);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::FPOStream PDB::DBIStream::CreateFPOStream(const RawFile& file) const PDB_NO_EXCEPT
+{
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+
+	return FPOStream(file, debugHeader.fpoDataStreamIndex);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::FrameDataStream PDB::DBIStream::CreateFrameDataStream(const RawFile& file) const PDB_NO_EXCEPT
+{
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+
+	return FrameDataStream(file, debugHeader.newFpoDataStreamIndex);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::PDataStream PDB::DBIStream::CreatePDataStream(const RawFile& file) const PDB_NO_EXCEPT
+{
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
+
+	return PDataStream(file, debugHeader.pdataStreamIndex);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::XDataStream PDB::DBIStream::CreateXDataStream(const RawFile& file) const PDB_NO_EXCEPT
+{
+	const DBI::DebugHeader debugHeader = ReadDebugHeader(m_stream, m_header);
 
-	// from there, grab the section header stream
-	return ImageSectionStream(file, debugHeader.sectionHeaderStreamIndex);
+	return XDataStream(file, debugHeader.xdataStreamIndex);
 }
 
 
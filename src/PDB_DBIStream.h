@@ -9,6 +9,11 @@
 #include "PDB_CoalescedMSFStream.h"
 #include "PDB_DirectMSFStream.h"
 #include "PDB_ImageSectionStream.h"
+#include "PDB_FixupStream.h"
+#include "PDB_FPOStream.h"
+#include "PDB_FrameDataStream.h"
+#include "PDB_PDataStream.h"
+#include "PDB_XDataStream.h"
 #include "PDB_PublicSymbolStream.h"
 #include "PDB_GlobalSymbolStream.h"
 #include "PDB_SourceFileStream.h"
@@ -33,12 +38,22 @@ namespace PDB
 
 		PDB_NO_DISCARD ErrorCode HasValidSymbolRecordStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD ErrorCode HasValidImageSectionStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD ErrorCode HasValidFixupStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD ErrorCode HasValidFPOStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD ErrorCode HasValidFrameDataStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD ErrorCode HasValidPDataStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD ErrorCode HasValidXDataStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD ErrorCode HasValidPublicSymbolStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD ErrorCode HasValidGlobalSymbolStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD ErrorCode HasValidSectionContributionStream(const RawFile& file) const PDB_NO_EXCEPT;
 
 		PDB_NO_DISCARD CoalescedMSFStream CreateSymbolRecordStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD ImageSectionStream CreateImageSectionStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD FixupStream CreateFixupStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD FPOStream CreateFPOStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD FrameDataStream CreateFrameDataStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD PDataStream CreatePDataStream(const RawFile& file) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD XDataStream CreateXDataStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD PublicSymbolStream CreatePublicSymbolStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD GlobalSymbolStream CreateGlobalSymbolStream(const RawFile& file) const PDB_NO_EXCEPT;
 		PDB_NO_DISCARD SourceFileStream CreateSourceFileStream(const RawFile& file) const PDB_NO_EXCEPT;
@@ -7,3 +7,5 @@
 
 const uint32_t PDB::DBI::StreamHeader::Signature = 0xffffffffu;
 const uint16_t PDB::DBI::DebugHeader::InvalidStreamIndex = 0xFFFFu;
+const uint32_t PDB::CodeView::DBI::Line::HiddenLineNumber = 0xFEEFEEu;
+const uint32_t PDB::CodeView::DBI::Line::AlternateHiddenLineNumber = 0xF00F00u;
@@ -66,9 +66,66 @@ namespace PDB
 			uint16_t xdataStreamIndex;
 			uint16_t pdataStreamIndex;
 			uint16_t newFpoDataStreamIndex;
-			uint16_t originalSectionHeaderDataStreamIndex;
+			uint16_t originalSectionHeaderDataStreamIndex;		// section headers before the image was rearranged after linking, e.g. using OMAP
 		};
 
+		// an entry of the fixup stream (XFIXUP_DATA), one for each relocation the linker applied to the image
+		struct FixupData
+		{
+			uint16_t type;										// IMAGE_REL_* relocation type of the target machine
+			uint16_t extra;
+			uint32_t rva;										// RVA of the fixed up location
+			uint32_t rvaTarget;									// RVA the fixed up location refers to
+		};
+
+		// an entry of the FPO stream (FPO_DATA), describing the stack frame of an x86 function
+		// https://learn.microsoft.com/en-us/windows/win32/api/winnt/ns-winnt-fpo_data
+		struct FPOData
+		{
+			enum class PDB_NO_DISCARD FrameType : uint16_t
+			{
+				FPO = 0u,
+				Trap = 1u,
+				TSS = 2u,
+				NonFPO = 3u
+			};
+
+			uint32_t offsetStart;								// RVA of the first byte of the function
+			uint32_t procedureSize;
+			uint32_t localCount;								// in DWORDs
+			uint16_t parameterCount;							// in DWORDs
+			uint16_t prologSize : 8;
+			uint16_t savedRegisterCount : 3;
+			uint16_t hasSEH : 1;
+			uint16_t usesBasePointer : 1;
+			uint16_t reserved : 1;
+			uint16_t frameType : 2;								// one of FrameType
+		};
+
+		// an entry of the new FPO stream (FRAMEDATA), describing the stack frame of an x86 function using a program string
+		// https://llvm.org/docs/PDB/CodeViewSymbols.html#s-frameproc-0x1012
+		struct FrameData
+		{
+			enum class PDB_NO_DISCARD Flags : uint32_t
+			{
+				None = 0u,
+				HasSEH = 1u << 0u,
+				HasEH = 1u << 1u,
+				IsFunctionStart = 1u << 2u
+			};
+
+			uint32_t rvaStart;
+			uint32_t codeSize;
+			uint32_t localSize;									// in bytes
+			uint32_t parameterSize;								// in bytes
+			uint32_t maxStackSize;
+			uint32_t frameFunction;								// offset of the program string in the /names stream, 0 if there is none
+			uint16_t prologSize;
+			uint16_t savedRegisterSize;							// in bytes
+			Flags flags;
+		};
+		PDB_DEFINE_BIT_OPERATORS(FrameData::Flags);
+
 		// https://llvm.org/docs/PDB/DbiStream.html#section-contribution-substream
 		struct SectionContribution
 		{
@@ -260,6 +317,16 @@ namespace PDB
 			PDB_DEFINE_BIT_OPERATORS(CompileSymbolFlags);
 
 
+			// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h
+			enum class PDB_NO_DISCARD SeparatedCodeFlags : uint32_t
+			{
+				None = 0u,
+				IsLexicalScope = 1u << 0u,			// S_SEPCODE doubles as lexical scope
+				ReturnsToParent = 1u << 1u			// code frag returns to parent
+			};
+			PDB_DEFINE_BIT_OPERATORS(SeparatedCodeFlags);
+
+
 			// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvconst.h#L324
 			enum class PDB_NO_DISCARD CPUType : uint16_t
 			{
@@ -439,6 +506,7 @@ namespace PDB
 					{
 						uint16_t sectionNumber;
 						uint8_t alignment;
+						uint8_t reserved;
 						uint32_t rva;
 						uint32_t length;
 						uint32_t characteristics;
@@ -515,6 +583,19 @@ namespace PDB
 						PDB_FLEXIBLE_ARRAY_MEMBER(char, name);
 					} S_BLOCK32;
 
+					// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h
+					struct
+					{
+						uint32_t parent;				// offset of the enclosing scope
+						uint32_t end;					// offset of the matching S_END
+						uint32_t length;				// size of the separated code block in bytes
+						SeparatedCodeFlags flags;
+						uint32_t offset;				// section offset of the separated code block
+						uint32_t parentOffset;			// section offset of the enclosing procedure
+						uint16_t section;
+						uint16_t parentSection;
+					} S_SEPCODE;
+
 					struct
 					{
 						uint32_t offset;
@@ -543,6 +624,15 @@ namespace PDB
 						PDB_FLEXIBLE_ARRAY_MEMBER(uint8_t, binaryAnnotations);
 					} S_INLINESITE;
 
+					struct
+					{
+						uint32_t parent; // pointer to the inliner
+						uint32_t end; // pointer to this block's end
+						uint32_t inlinee; // CV_ItemId of inlinee
+						uint32_t invocations; // entry count
+						PDB_FLEXIBLE_ARRAY_MEMBER(uint8_t, binaryAnnotations);
+					} S_INLINESITE2;
+
 					// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L4199
 					struct
 					{
@@ -715,6 +805,26 @@ namespace PDB
 				} data;
 			};
 
+			// opcodes of the compressed binary annotations stored in S_INLINESITE records.
+			// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L3808
+			enum class PDB_NO_DISCARD BinaryAnnotationOpcode : uint8_t
+			{
+				Invalid = 0u,							// link time pdb contains PADDINGs
+				CodeOffset = 1u,						// param : start offset
+				ChangeCodeOffsetBase = 2u,				// param : nth separated code chunk (main code chunk == 0)
+				ChangeCodeOffset = 3u,					// param : delta of offset
+				ChangeCodeLength = 4u,					// param : length of code, default next start
+				ChangeFile = 5u,						// param : fileId
+				ChangeLineOffset = 6u,					// param : line offset (signed)
+				ChangeLineEndDelta = 7u,				// param : how many lines, default 1
+				ChangeRangeKind = 8u,					// param : either 1 (default, for statement) or 0 (for expression)
+				ChangeColumnStart = 9u,					// param : start column number, 0 means no column info
+				ChangeColumnEndDelta = 10u,				// param : end column number delta (signed)
+				ChangeCodeOffsetAndLineOffset = 11u,	// param : ((sourceDelta << 4) | CodeDelta)
+				ChangeCodeLengthAndCodeOffset = 12u,	// param : codeLength, codeOffset
+				ChangeColumnEnd = 13u					// param : end column number
+			};
+
 			// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L4576
 			enum class PDB_NO_DISCARD DebugSubsectionKind : uint32_t 
 			{
@@ -747,6 +857,10 @@ namespace PDB
 			// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L4617
 			struct Line
 			{
+				// line numbers the compiler uses for code that doesn't belong to any line of source code
+				static const uint32_t HiddenLineNumber;
+				static const uint32_t AlternateHiddenLineNumber;
+
 				uint32_t offset;             // Offset to start of code bytes for line number
 				uint32_t linenumStart : 24;  // line where statement/expression starts
 				uint32_t deltaLineEnd : 7;   // delta to line where statement ends (optional)
@@ -0,0 +1,231 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_DataSymbolIndex.h"
+#include "PDB_RawFile.h"
+#include "PDB_ImageSectionStream.h"
+#include "PDB_CoalescedMSFStream.h"
+#include "PDB_GlobalSymbolStream.h"
+#include "PDB_ModuleInfoStream.h"
+#include "PDB_ModuleSymbolStream.h"
+#include "PDB_TypeTable.h"
+#include "PDB_Types.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	PDB_NO_DISCARD static bool IsDataSymbol(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return (kind == SymbolRecordKind::S_GDATA32) || (kind == SymbolRecordKind::S_LDATA32) ||
+			(kind == SymbolRecordKind::S_GTHREAD32) || (kind == SymbolRecordKind::S_LTHREAD32);
+	}
+
+
+	static void AddDataSymbol(const PDB::CodeView::DBI::Record* record, const PDB::ImageSectionStream& imageSectionStream, const PDB::TypeTable& typeTable,
+		PDB::GrowableArray<PDB::DataSymbolIndex::Symbol>& symbols, PDB::GrowableArray<char>& names) PDB_NO_EXCEPT
+	{
+		// all four data record kinds share the same layout
+		const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_GDATA32.section, record->data.S_GDATA32.offset);
+		if (rva == 0u)
+		{
+			// certain symbols (e.g. linker-generated symbols) don't have a valid RVA, ignore those
+			return;
+		}
+
+		const uint64_t typeSize = typeTable.GetTypeSize(record->data.S_GDATA32.typeIndex);
+		const char* name = record->data.S_GDATA32.name;
+
+		PDB::DataSymbolIndex::Symbol symbol = {};
+		symbol.rva = rva;
+		symbol.size = (typeSize > 0xFFFFFFFFu) ? 0xFFFFFFFFu : static_cast<uint32_t>(typeSize);
+		symbol.typeIndex = record->data.S_GDATA32.typeIndex;
+		symbol.nameOffset = static_cast<uint32_t>(names.Append(name, std::strlen(name) + 1u));
+		symbol.kind = record->header.kind;
+		symbols.Add(symbol);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DataSymbolIndex::DataSymbolIndex(void) PDB_NO_EXCEPT
+	: m_rvas(nullptr)
+	, m_symbols(nullptr)
+	, m_symbolCount(0u)
+	, m_names(nullptr)
+	, m_namesSize(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DataSymbolIndex::DataSymbolIndex(DataSymbolIndex&& other) PDB_NO_EXCEPT
+	: m_rvas(PDB_MOVE(other.m_rvas))
+	, m_symbols(PDB_MOVE(other.m_symbols))
+	, m_symbolCount(PDB_MOVE(other.m_symbolCount))
+	, m_names(PDB_MOVE(other.m_names))
+	, m_namesSize(PDB_MOVE(other.m_namesSize))
+{
+	other.m_rvas = nullptr;
+	other.m_symbols = nullptr;
+	other.m_symbolCount = 0u;
+	other.m_names = nullptr;
+	other.m_namesSize = 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DataSymbolIndex& PDB::DataSymbolIndex::operator=(DataSymbolIndex&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_rvas);
+		PDB_DELETE_ARRAY(m_symbols);
+		PDB_DELETE_ARRAY(m_names);
+
+		m_rvas = PDB_MOVE(other.m_rvas);
+		m_symbols = PDB_MOVE(other.m_symbols);
+		m_symbolCount = PDB_MOVE(other.m_symbolCount);
+		m_names = PDB_MOVE(other.m_names);
+		m_namesSize = PDB_MOVE(other.m_namesSize);
+
+		other.m_rvas = nullptr;
+		other.m_symbols = nullptr;
+		other.m_symbolCount = 0u;
+		other.m_names = nullptr;
+		other.m_namesSize = 0u;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DataSymbolIndex::DataSymbolIndex(const RawFile& file, const ImageSectionStream& imageSectionStream, const CoalescedMSFStream& symbolRecordStream,
+	const GlobalSymbolStream& globalSymbolStream, const ModuleInfoStream& moduleInfoStream, const TypeTable& typeTable) PDB_NO_EXCEPT
+	: m_rvas(nullptr)
+	, m_symbols(nullptr)
+	, m_symbolCount(0u)
+	, m_names(nullptr)
+	, m_namesSize(0u)
+{
+	GrowableArray<Symbol> symbolArray;
+	GrowableArray<char> nameArray;
+
+	// global and file-static variables are referenced by the global symbol stream
+	for (const HashRecord& hashRecord : globalSymbolStream.GetRecords())
+	{
+		const CodeView::DBI::Record* record = globalSymbolStream.GetRecord(symbolRecordStream, hashRecord);
+		if (IsDataSymbol(record->header.kind))
+		{
+			AddDataSymbol(record, imageSectionStream, typeTable, symbolArray, nameArray);
+		}
+	}
+
+	// function-static variables only live in the module symbol streams, which also repeat many of the global symbols
+	for (const ModuleInfoStream::Module& module : moduleInfoStream.GetModules())
+	{
+		if (!module.HasSymbolStream())
+		{
+			continue;
+		}
+
+		const ModuleSymbolStream moduleSymbolStream = module.CreateSymbolStream(file);
+		for (const CodeView::DBI::Record* record : moduleSymbolStream.GetSymbols())
+		{
+			if (IsDataSymbol(record->header.kind))
+			{
+				AddDataSymbol(record, imageSectionStream, typeTable, symbolArray, nameArray);
+			}
+		}
+	}
+
+	const size_t symbolCount = symbolArray.GetSize();
+	Symbol* symbols = symbolArray.Release();
+	m_namesSize = nameArray.GetSize();
+	m_names = nameArray.Release();
+
+	// sort by RVA and name, so that duplicates become neighbours
+	const char* names = m_names;
+	Algorithm::Sort(symbols, symbols + symbolCount, [names](const Symbol& lhs, const Symbol& rhs)
+	{
+		if (lhs.rva != rhs.rva)
+		{
+			return lhs.rva < rhs.rva;
+		}
+
+		return std::strcmp(&names[lhs.nameOffset], &names[rhs.nameOffset]) < 0;
+	});
+
+	// remove duplicates, keeping the first symbol of each run
+	size_t uniqueCount = 0u;
+	for (size_t i = 0u; i < symbolCount; ++i)
+	{
+		if ((uniqueCount != 0u) && (symbols[uniqueCount - 1u].rva == symbols[i].rva) &&
+			(std::strcmp(&names[symbols[uniqueCount - 1u].nameOffset], &names[symbols[i].nameOffset]) == 0))
+		{
+			continue;
+		}
+
+		symbols[uniqueCount++] = symbols[i];
+	}
+
+	m_symbols = symbols;
+	m_symbolCount = uniqueCount;
+	m_rvas = PDB_NEW_ARRAY(uint32_t, m_symbolCount);
+	for (size_t i = 0u; i < m_symbolCount; ++i)
+	{
+		m_rvas[i] = m_symbols[i].rva;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DataSymbolIndex::~DataSymbolIndex(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_rvas);
+	PDB_DELETE_ARRAY(m_symbols);
+	PDB_DELETE_ARRAY(m_names);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::DataSymbolIndex::Symbol* PDB::DataSymbolIndex::FindSymbol(uint32_t rva) const PDB_NO_EXCEPT
+{
+	const size_t index = FindFirstSymbolIndex(rva);
+	if ((index == m_symbolCount) || (m_rvas[index] > rva))
+	{
+		return nullptr;
+	}
+
+	return &m_symbols[index];
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD size_t PDB::DataSymbolIndex::FindFirstSymbolIndex(uint32_t rva) const PDB_NO_EXCEPT
+{
+	// find the last symbol starting at or before the RVA. data symbols laid out by the linker do not overlap,
+	// so no earlier symbol can contain the RVA if this one doesn't.
+	const size_t index = Algorithm::UpperBound(m_rvas, m_symbolCount, rva);
+	if (index == 0u)
+	{
+		return 0u;
+	}
+
+	const Symbol& symbol = m_symbols[index - 1u];
+	const uint64_t symbolEnd = static_cast<uint64_t>(symbol.rva) + ((symbol.size == 0u) ? 1u : symbol.size);
+	return (rva < symbolEnd) ? index - 1u : index;
+}
@@ -0,0 +1,87 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_DBITypes.h"
+
+
+namespace PDB
+{
+	class RawFile;
+	class ImageSectionStream;
+	class CoalescedMSFStream;
+	class GlobalSymbolStream;
+	class ModuleInfoStream;
+	class TypeTable;
+
+
+	// An index of all global, static and thread-local data symbols (S_GDATA32, S_LDATA32, S_GTHREAD32 and S_LTHREAD32),
+	// answering "which variable contains this RVA?" with a single binary search over a tightly packed array of RVAs.
+	// Symbols are gathered from the global symbol stream and all module symbol streams, and their sizes are taken from
+	// the TPI type referenced by each symbol. Constants (S_CONSTANT) do not occupy memory and are therefore not indexed.
+	// Once built, the index is immutable and can be queried from several threads.
+	class PDB_NO_DISCARD DataSymbolIndex
+	{
+	public:
+		struct Symbol
+		{
+			uint32_t rva;
+			uint32_t size;										// size of the symbol's type in bytes, 0 if it is unknown
+			uint32_t typeIndex;
+			uint32_t nameOffset;								// offset of the name, use GetName() to retrieve it
+			CodeView::DBI::SymbolRecordKind kind;
+		};
+
+		DataSymbolIndex(void) PDB_NO_EXCEPT;
+		DataSymbolIndex(DataSymbolIndex&& other) PDB_NO_EXCEPT;
+		DataSymbolIndex& operator=(DataSymbolIndex&& other) PDB_NO_EXCEPT;
+
+		explicit DataSymbolIndex(const RawFile& file, const ImageSectionStream& imageSectionStream, const CoalescedMSFStream& symbolRecordStream,
+			const GlobalSymbolStream& globalSymbolStream, const ModuleInfoStream& moduleInfoStream, const TypeTable& typeTable) PDB_NO_EXCEPT;
+		~DataSymbolIndex(void) PDB_NO_EXCEPT;
+
+		// Returns the symbol whose memory contains the given RVA, or nullptr if there is none.
+		// Symbols of unknown size only contain the RVA they start at.
+		PDB_NO_DISCARD const Symbol* FindSymbol(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Calls the functor for each symbol overlapping the range [rvaBegin, rvaEnd), in ascending order of RVAs.
+		template <typename F>
+		void ForEachSymbolInRange(uint32_t rvaBegin, uint32_t rvaEnd, F&& functor) const PDB_NO_EXCEPT
+		{
+			for (size_t i = FindFirstSymbolIndex(rvaBegin); (i < m_symbolCount) && (m_rvas[i] < rvaEnd); ++i)
+			{
+				functor(m_symbols[i]);
+			}
+		}
+
+		// Returns the name of the given symbol.
+		PDB_NO_DISCARD inline const char* GetName(const Symbol& symbol) const PDB_NO_EXCEPT
+		{
+			return &m_names[symbol.nameOffset];
+		}
+
+		// Returns a view of all symbols, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<Symbol> GetSymbols(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Symbol>(m_symbols, m_symbolCount);
+		}
+
+	private:
+		// Returns the index of the first symbol that ends after the given RVA.
+		PDB_NO_DISCARD size_t FindFirstSymbolIndex(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// the RVAs are stored separately from the symbols so that the binary search touches as few cache lines as possible
+		uint32_t* m_rvas;
+		Symbol* m_symbols;
+		size_t m_symbolCount;
+
+		// names of all symbols, copied because module symbol streams are only alive while the index is built
+		char* m_names;
+		size_t m_namesSize;
+
+		PDB_DISABLE_COPY(DataSymbolIndex);
+	};
+}
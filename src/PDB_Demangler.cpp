@@ -0,0 +1,3398 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_Demangler.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	static constexpr const size_t ArenaChunkSize = 64u * 1024u;
+	static constexpr const size_t InitialCacheCapacity = 1024u;
+	static constexpr const size_t InitialOutputCapacity = 1024u;
+	static constexpr const size_t NodesPerChunk = 256u;
+
+	// the grammar allows at most 10 back-references to names and parameters each
+	static constexpr const size_t MaxBackReferenceCount = 10u;
+
+	// legitimate names nest far less deeply, anything deeper is a malformed name that must not exhaust the stack
+	static constexpr const unsigned int MaxRecursionDepth = 128u;
+
+
+	// 32-bit FNV-1a
+	PDB_NO_DISCARD static uint32_t HashName(const char* name) PDB_NO_EXCEPT
+	{
+		uint32_t hash = 2166136261u;
+		while (*name != '\0')
+		{
+			hash ^= static_cast<uint8_t>(*name++);
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+
+	PDB_NO_DISCARD static bool IsDigit(char c) PDB_NO_EXCEPT
+	{
+		return (c >= '0') && (c <= '9');
+	}
+
+
+	PDB_NO_DISCARD static bool IsAlphaNumeric(char c) PDB_NO_EXCEPT
+	{
+		return IsDigit(c) || ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z'));
+	}
+
+
+	enum class NodeKind : uint8_t
+	{
+		// item: element, next: next list node
+		List,
+
+		// list: identifiers, outermost scope first
+		QualifiedName,
+
+		// identifiers may carry template arguments in their list of templateArguments
+		Identifier,								// text: name
+		ConversionOperator,						// type: target type
+		Structor,								// child: identifier of the class, flag: destructor
+		DynamicStructor,						// child: variable symbol, or name: function name, flag: destructor
+		LocalStaticGuard,						// number: scope index, flag: thread guard
+		LocalScope,								// child: enclosing function symbol, number: scope index
+		VcallThunk,								// number: offset into the vtable
+		RttiBaseClassDescriptor,				// offsets: member displacement, vbtable displacement and offset, attributes
+		LiteralOperator,						// text: literal suffix
+
+		// types carry cv-qualifiers
+		PrimitiveType,							// text: name
+		TagType,								// tagKind, name
+		CustomType,								// child: identifier
+		PointerType,							// affinity, type: pointee, name: class for pointers to members
+		FunctionType,							// type: return type, list: parameters, flag: variadic
+		ArrayType,								// type: element type, list: dimensions
+
+		// non-type template arguments
+		IntegerLiteral,							// number, flag: negative
+		SymbolReference,						// child: symbol, affinity, offsets
+
+		// symbols
+		FunctionSymbol,							// name, type: function type
+		VariableSymbol,							// name, type (optional), storageClass
+		SpecialTableSymbol,						// name, child: qualified name of the target (optional)
+		Literal									// text
+	};
+
+	enum class PDB_NO_DISCARD Qualifiers : uint8_t
+	{
+		None = 0u,
+		Const = 1u << 0u,
+		Volatile = 1u << 1u,
+		Restrict = 1u << 2u,
+		Unaligned = 1u << 3u,
+		Pointer64 = 1u << 4u
+	};
+	PDB_DEFINE_BIT_OPERATORS(Qualifiers);
+
+	enum class PDB_NO_DISCARD FunctionClass : uint16_t
+	{
+		None = 0u,
+		Public = 1u << 0u,
+		Protected = 1u << 1u,
+		Private = 1u << 2u,
+		Global = 1u << 3u,
+		Static = 1u << 4u,
+		Virtual = 1u << 5u,
+		Far = 1u << 6u,
+		ExternC = 1u << 7u,
+		NoParameterList = 1u << 8u,
+		VirtualThisAdjust = 1u << 9u,
+		VirtualThisAdjustEx = 1u << 10u,
+		StaticThisAdjust = 1u << 11u,
+		Thunk = 1u << 12u
+	};
+	PDB_DEFINE_BIT_OPERATORS(FunctionClass);
+
+	enum class TagKind : uint8_t
+	{
+		Class,
+		Struct,
+		Union,
+		Enum
+	};
+
+	enum class PointerAffinity : uint8_t
+	{
+		None,
+		Pointer,
+		Reference,
+		RValueReference
+	};
+
+	enum class StorageClass : uint8_t
+	{
+		None,
+		PrivateStatic,
+		ProtectedStatic,
+		PublicStatic,
+		Global,
+		FunctionLocalStatic
+	};
+
+	enum class CallingConvention : uint8_t
+	{
+		None,
+		Cdecl,
+		Pascal,
+		Thiscall,
+		Stdcall,
+		Fastcall,
+		Clrcall,
+		Eabi,
+		Vectorcall,
+		Swift,
+		SwiftAsync
+	};
+
+	enum class QualifierMode : uint8_t
+	{
+		Drop,
+		Mangle,
+		Result
+	};
+
+
+	template <typename T>
+	PDB_NO_DISCARD static bool IsSet(T value, T bits) PDB_NO_EXCEPT
+	{
+		return (value & bits) != T::None;
+	}
+
+
+	// operators encoded as ?<code>
+	static const char* const BasicOperators[36] =
+	{
+		nullptr, nullptr, "operator new", "operator delete", "operator=", "operator>>", "operator<<", "operator!", "operator==", "operator!=",
+		"operator[]", nullptr, "operator->", "operator*", "operator++", "operator--", "operator-", "operator+", "operator&", "operator->*",
+		"operator/", "operator%", "operator<", "operator<=", "operator>", "operator>=", "operator,", "operator()", "operator~", "operator^",
+		"operator|", "operator&&", "operator||", "operator*=", "operator+=", "operator-="
+	};
+
+	// operators and compiler-generated functions encoded as ?_<code>
+	static const char* const UnderscoreOperators[36] =
+	{
+		"operator/=", "operator%=", "operator>>=", "operator<<=", "operator&=", "operator|=", "operator^=", "`vftable'", "`vbtable'", "`vcall'",
+		"`typeof'", "`local static guard'", "`string'", "`vbase dtor'", "`vector deleting dtor'", "`default ctor closure'", "`scalar deleting dtor'",
+		"`vector ctor iterator'", "`vector dtor iterator'", "`vector vbase ctor iterator'", "`virtual displacement map'", "`eh vector ctor iterator'",
+		"`eh vector dtor iterator'", "`eh vector vbase ctor iterator'", "`copy ctor closure'", "`udt returning'", nullptr, nullptr, "`local vftable'",
+		"`local vftable ctor closure'", "operator new[]", "operator delete[]", "`omni callsig'", "`placement delete closure'",
+		"`placement delete[] closure'", nullptr
+	};
+
+	// operators and compiler-generated functions encoded as ?__<code>
+	static const char* const DoubleUnderscoreOperators[36] =
+	{
+		nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+		"`managed vector ctor iterator'", "`managed vector dtor iterator'", "`EH vector copy ctor iterator'", "`EH vector vbase copy ctor iterator'",
+		nullptr, nullptr, "`vector copy ctor iterator'", "`vector vbase copy constructor iterator'", "`managed vector vbase copy constructor iterator'",
+		nullptr, nullptr, "operator co_await", "operator<=>", nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+		nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+	};
+
+
+	// Returns the operator encoded by a single digit or uppercase letter, or nullptr for unknown codes.
+	PDB_NO_DISCARD static const char* LookupOperator(const char* const (&operators)[36], char code) PDB_NO_EXCEPT
+	{
+		if (IsDigit(code))
+		{
+			return operators[code - '0'];
+		}
+		else if ((code >= 'A') && (code <= 'Z'))
+		{
+			return operators[10 + code - 'A'];
+		}
+
+		return nullptr;
+	}
+}
+
+
+struct PDB::Demangler::Node
+{
+	NodeKind kind;
+	Qualifiers qualifiers;
+	TagKind tagKind;
+	PointerAffinity affinity;
+	StorageClass storageClass;
+	CallingConvention callingConvention;
+	PointerAffinity refQualifier;				// Reference or RValueReference for ref-qualified member functions
+	bool flag;
+	bool isNoexcept;
+	bool hasTemplateArguments;
+	uint8_t offsetCount;
+	FunctionClass functionClass;
+
+	// the mangled text of an identifier, used to find existing back-references
+	const char* key;
+	size_t keyLength;
+
+	const char* text;
+	size_t textLength;
+	uint64_t number;
+	int64_t offsets[4u];
+
+	Node* item;
+	Node* next;
+	Node* list;
+	Node* templateArguments;
+	Node* name;
+	Node* type;
+	Node* child;
+};
+
+
+struct PDB::Demangler::NodeChunk
+{
+	NodeChunk* next;
+	Node nodes[NodesPerChunk];
+};
+
+
+// A recursive descent parser for the grammar of decorated names, which builds a tree of nodes that is output
+// afterwards. The output puts types around the declarator, e.g. "int (__cdecl *x)(int)", so a function signature
+// is output in two parts before and after the name it declares.
+struct PDB::Demangler::Parser
+{
+	struct BackReferences
+	{
+		Node* names[MaxBackReferenceCount];
+		size_t nameCount;
+		Node* parameters[MaxBackReferenceCount];
+		size_t parameterCount;
+	};
+
+	struct DepthGuard
+	{
+		explicit DepthGuard(unsigned int& depth) PDB_NO_EXCEPT
+			: m_depth(depth)
+		{
+			++m_depth;
+		}
+
+		~DepthGuard(void) PDB_NO_EXCEPT
+		{
+			--m_depth;
+		}
+
+		unsigned int& m_depth;
+
+		PDB_DISABLE_COPY_MOVE(DepthGuard);
+	};
+
+	Parser(Demangler& demangler, const char* name) PDB_NO_EXCEPT;
+
+	// input
+	PDB_NO_DISCARD bool StartsWith(const char* prefix) const PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool Consume(char c) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool Consume(const char* prefix) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD char Next(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* Fail(void) PDB_NO_EXCEPT;
+
+	// nodes
+	PDB_NO_DISCARD Node* NewNode(NodeKind kind) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* NewIdentifier(const char* text) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* NewQualifiedName(Node* identifier) PDB_NO_EXCEPT;
+	void Append(Node**& tail, Node* item) PDB_NO_EXCEPT;
+	void Memorize(Node* identifier) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD static Node* GetUnqualifiedIdentifier(const Node* qualifiedName) PDB_NO_EXCEPT;
+
+	// numbers
+	PDB_NO_DISCARD bool ParseNumber(uint64_t& value, bool& isNegative) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool ParseSigned(int64_t& value) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool ParseUnsigned(uint64_t& value) PDB_NO_EXCEPT;
+
+	// symbols
+	PDB_NO_DISCARD Node* ParseTopLevelSymbol(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseSymbol(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseSpecialIntrinsic(bool& isSpecialIntrinsic) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseDeclarator(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseEncodedSymbol(Node* name) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseVariableEncoding(StorageClass storageClass) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseFunctionEncoding(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseSpecialTableSymbol(const char* text) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseVcallThunk(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseLocalStaticGuard(bool isThread) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseUntypedVariable(const char* text) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseRttiTypeDescriptor(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseRttiBaseClassDescriptor(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseInitFiniStub(bool isDestructor) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseStringLiteral(void) PDB_NO_EXCEPT;
+
+	// names
+	PDB_NO_DISCARD Node* ParseFullyQualifiedSymbolName(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseFullyQualifiedTypeName(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseUnqualifiedSymbolName(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseUnqualifiedTypeName(bool memorize) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseNameScopeChain(Node* identifier) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseNameScopePiece(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseTemplateInstantiationName(bool memorize) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseSimpleName(bool memorize) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseBackReferenceName(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseAnonymousNamespaceName(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseLocallyScopedNamePiece(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseOperatorName(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseTemplateArguments(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool IsLocalScopePattern(void) const PDB_NO_EXCEPT;
+
+	// types
+	PDB_NO_DISCARD Node* ParseType(QualifierMode mode) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParsePrimitiveType(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseTagType(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseCustomType(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParsePointerType(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseMemberPointerType(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseArrayType(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseFunctionType(bool hasThisQualifiers) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Node* ParseParameterList(bool& isVariadic) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool IsMemberPointer(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool ParseQualifiers(Qualifiers& qualifiers, bool& isMember) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD bool ParsePointerQualifiers(Qualifiers& qualifiers, PointerAffinity& affinity) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD Qualifiers ParsePointerExtendedQualifiers(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD FunctionClass ParseFunctionClass(void) PDB_NO_EXCEPT;
+	PDB_NO_DISCARD CallingConvention ParseCallingConvention(void) PDB_NO_EXCEPT;
+
+	// output
+	void Output(const char* text) PDB_NO_EXCEPT;
+	void Output(const char* text, size_t length) PDB_NO_EXCEPT;
+	void OutputUnsigned(uint64_t value) PDB_NO_EXCEPT;
+	void OutputSigned(int64_t value) PDB_NO_EXCEPT;
+	void OutputSpaceIfNecessary(void) PDB_NO_EXCEPT;
+	void OutputQualifiers(Qualifiers qualifiers, bool spaceBefore, bool spaceAfter) PDB_NO_EXCEPT;
+	void OutputCallingConvention(CallingConvention callingConvention) PDB_NO_EXCEPT;
+	void OutputSymbol(const Node* symbol) PDB_NO_EXCEPT;
+	void OutputQualifiedName(const Node* name) PDB_NO_EXCEPT;
+	void OutputIdentifier(const Node* identifier) PDB_NO_EXCEPT;
+	void OutputTemplateArguments(const Node* identifier) PDB_NO_EXCEPT;
+	void OutputList(const Node* list, const char* separator) PDB_NO_EXCEPT;
+	void OutputNode(const Node* node) PDB_NO_EXCEPT;
+	void OutputTypePre(const Node* type) PDB_NO_EXCEPT;
+	void OutputTypePost(const Node* type) PDB_NO_EXCEPT;
+	void OutputFunctionPre(const Node* function, bool omitCallingConvention) PDB_NO_EXCEPT;
+	void OutputFunctionPost(const Node* function) PDB_NO_EXCEPT;
+
+	Demangler& m_demangler;
+	const char* m_position;
+	BackReferences m_backReferences;
+	unsigned int m_depth;
+	bool m_error;
+
+	PDB_DISABLE_COPY_MOVE(Parser);
+};
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::Demangler::Parser::Parser(Demangler& demangler, const char* name) PDB_NO_EXCEPT
+	: m_demangler(demangler)
+	, m_position(name)
+	, m_backReferences()
+	, m_depth(0u)
+	, m_error(false)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::StartsWith(const char* prefix) const PDB_NO_EXCEPT
+{
+	// the name is null-terminated, so a mismatch is found before reading past its end
+	const char* position = m_position;
+	while (*prefix != '\0')
+	{
+		if (*position++ != *prefix++)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::Consume(char c) PDB_NO_EXCEPT
+{
+	if ((*m_position != c) || (c == '\0'))
+	{
+		return false;
+	}
+
+	++m_position;
+
+	return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::Consume(const char* prefix) PDB_NO_EXCEPT
+{
+	if (!StartsWith(prefix))
+	{
+		return false;
+	}
+
+	m_position += std::strlen(prefix);
+
+	return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD char PDB::Demangler::Parser::Next(void) PDB_NO_EXCEPT
+{
+	const char c = *m_position;
+	if (c != '\0')
+	{
+		++m_position;
+	}
+
+	return c;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::Fail(void) PDB_NO_EXCEPT
+{
+	m_error = true;
+
+	return nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::NewNode(NodeKind kind) PDB_NO_EXCEPT
+{
+	if (m_demangler.m_currentChunkUsed == NodesPerChunk)
+	{
+		// chunks are kept across names, so this only allocates for names larger than any name before
+		NodeChunk* chunk = m_demangler.m_currentChunk;
+		if (!chunk->next)
+		{
+			chunk->next = PDB_NEW(NodeChunk);
+			chunk->next->next = nullptr;
+		}
+
+		m_demangler.m_currentChunk = chunk->next;
+		m_demangler.m_currentChunkUsed = 0u;
+	}
+
+	Node* node = &m_demangler.m_currentChunk->nodes[m_demangler.m_currentChunkUsed++];
+	std::memset(node, 0, sizeof(Node));
+	node->kind = kind;
+
+	return node;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::NewIdentifier(const char* text) PDB_NO_EXCEPT
+{
+	Node* identifier = NewNode(NodeKind::Identifier);
+	identifier->text = text;
+	identifier->textLength = std::strlen(text);
+
+	return identifier;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::NewQualifiedName(Node* identifier) PDB_NO_EXCEPT
+{
+	Node* list = NewNode(NodeKind::List);
+	list->item = identifier;
+
+	Node* name = NewNode(NodeKind::QualifiedName);
+	name->list = list;
+
+	return name;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::Append(Node**& tail, Node* item) PDB_NO_EXCEPT
+{
+	// nodes can be referenced from several places through back-references, so lists use nodes of their own
+	Node* list = NewNode(NodeKind::List);
+	list->item = item;
+
+	*tail = list;
+	tail = &list->next;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::Memorize(Node* identifier) PDB_NO_EXCEPT
+{
+	BackReferences& backReferences = m_backReferences;
+	if (backReferences.nameCount >= MaxBackReferenceCount)
+	{
+		return;
+	}
+
+	for (size_t i = 0u; i < backReferences.nameCount; ++i)
+	{
+		const Node* existing = backReferences.names[i];
+		if ((existing->keyLength == identifier->keyLength) && (std::memcmp(existing->key, identifier->key, identifier->keyLength) == 0))
+		{
+			return;
+		}
+	}
+
+	// template instantiations attach their arguments to the identifier of their name, which can be memorized
+	// in their own set of back-references. store a copy, so that a back-reference never refers to itself.
+	Node* copy = NewNode(identifier->kind);
+	std::memcpy(copy, identifier, sizeof(Node));
+	backReferences.names[backReferences.nameCount++] = copy;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::GetUnqualifiedIdentifier(const Node* qualifiedName) PDB_NO_EXCEPT
+{
+	const Node* list = qualifiedName->list;
+	while (list->next)
+	{
+		list = list->next;
+	}
+
+	return list->item;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::ParseNumber(uint64_t& value, bool& isNegative) PDB_NO_EXCEPT
+{
+	// <number> ::= [?] <decimal digit>		# 1 to 10
+	//          ::= [?] <hex digit>+ @		# with hex digits A to P
+	isNegative = Consume('?');
+
+	const char c = *m_position;
+	if (IsDigit(c))
+	{
+		value = static_cast<uint64_t>(c - '0') + 1u;
+		++m_position;
+
+		return true;
+	}
+
+	value = 0u;
+	for (;;)
+	{
+		const char hexDigit = *m_position;
+		if (hexDigit == '@')
+		{
+			++m_position;
+
+			return true;
+		}
+		else if ((hexDigit >= 'A') && (hexDigit <= 'P'))
+		{
+			value = (value << 4u) + static_cast<uint64_t>(hexDigit - 'A');
+			++m_position;
+		}
+		else
+		{
+			m_error = true;
+
+			return false;
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::ParseSigned(int64_t& value) PDB_NO_EXCEPT
+{
+	uint64_t number = 0u;
+	bool isNegative = false;
+	if (!ParseNumber(number, isNegative))
+	{
+		return false;
+	}
+
+	// signed numbers are 32-bit, negative values are either encoded with a sign or as their two's complement
+	const int64_t truncated = static_cast<int32_t>(static_cast<uint32_t>(number));
+	value = isNegative ? -truncated : truncated;
+
+	return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::ParseUnsigned(uint64_t& value) PDB_NO_EXCEPT
+{
+	bool isNegative = false;
+	if (!ParseNumber(value, isNegative))
+	{
+		return false;
+	}
+	else if (isNegative)
+	{
+		m_error = true;
+
+		return false;
+	}
+
+	return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseTopLevelSymbol(void) PDB_NO_EXCEPT
+{
+	if (Consume('.'))
+	{
+		// type names stored in RTTI type descriptors, e.g. ".?AVFoo@@"
+		Node* type = ParseType(QualifierMode::Result);
+		if (m_error || (*m_position != '\0'))
+		{
+			return Fail();
+		}
+
+		Node* variable = NewNode(NodeKind::VariableSymbol);
+		variable->name = NewQualifiedName(NewIdentifier("`RTTI Type Descriptor Name'"));
+		variable->type = type;
+
+		return variable;
+	}
+
+	return ParseSymbol();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseSymbol(void) PDB_NO_EXCEPT
+{
+	DepthGuard guard(m_depth);
+	if ((m_depth > MaxRecursionDepth) || !Consume('?'))
+	{
+		return Fail();
+	}
+
+	bool isSpecialIntrinsic = false;
+	Node* symbol = ParseSpecialIntrinsic(isSpecialIntrinsic);
+	if (isSpecialIntrinsic)
+	{
+		return symbol;
+	}
+
+	return ParseDeclarator();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseSpecialIntrinsic(bool& isSpecialIntrinsic) PDB_NO_EXCEPT
+{
+	isSpecialIntrinsic = true;
+
+	if (Consume("?_7"))
+	{
+		return ParseSpecialTableSymbol("`vftable'");
+	}
+	else if (Consume("?_8"))
+	{
+		return ParseSpecialTableSymbol("`vbtable'");
+	}
+	else if (Consume("?_9"))
+	{
+		return ParseVcallThunk();
+	}
+	else if (Consume("?_B"))
+	{
+		return ParseLocalStaticGuard(false);
+	}
+	else if (Consume("?_C"))
+	{
+		return ParseStringLiteral();
+	}
+	else if (Consume("?_R0"))
+	{
+		return ParseRttiTypeDescriptor();
+	}
+	else if (Consume("?_R1"))
+	{
+		return ParseRttiBaseClassDescriptor();
+	}
+	else if (Consume("?_R2"))
+	{
+		return ParseUntypedVariable("`RTTI Base Class Array'");
+	}
+	else if (Consume("?_R3"))
+	{
+		return ParseUntypedVariable("`RTTI Class Hierarchy Descriptor'");
+	}
+	else if (Consume("?_R4"))
+	{
+		return ParseSpecialTableSymbol("`RTTI Complete Object Locator'");
+	}
+	else if (Consume("?_S"))
+	{
+		return ParseSpecialTableSymbol("`local vftable'");
+	}
+	else if (Consume("?__E"))
+	{
+		return ParseInitFiniStub(false);
+	}
+	else if (Consume("?__F"))
+	{
+		return ParseInitFiniStub(true);
+	}
+	else if (Consume("?__J"))
+	{
+		return ParseLocalStaticGuard(true);
+	}
+	else if (StartsWith("?_A") || StartsWith("?_P"))
+	{
+		// typeof and udt returning are not produced by any known compiler
+		return Fail();
+	}
+
+	isSpecialIntrinsic = false;
+
+	return nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseDeclarator(void) PDB_NO_EXCEPT
+{
+	Node* name = ParseFullyQualifiedSymbolName();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	Node* symbol = ParseEncodedSymbol(name);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	symbol->name = name;
+
+	const Node* identifier = GetUnqualifiedIdentifier(name);
+	if ((identifier->kind == NodeKind::ConversionOperator) && !identifier->type)
+	{
+		// conversion operators are functions, their target type is the return type
+		return Fail();
+	}
+
+	return symbol;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseEncodedSymbol(Node* name) PDB_NO_EXCEPT
+{
+	switch (*m_position)
+	{
+		case '0':
+			++m_position;
+			return ParseVariableEncoding(StorageClass::PrivateStatic);
+
+		case '1':
+			++m_position;
+			return ParseVariableEncoding(StorageClass::ProtectedStatic);
+
+		case '2':
+			++m_position;
+			return ParseVariableEncoding(StorageClass::PublicStatic);
+
+		case '3':
+			++m_position;
+			return ParseVariableEncoding(StorageClass::Global);
+
+		case '4':
+			++m_position;
+			return ParseVariableEncoding(StorageClass::FunctionLocalStatic);
+
+		default:
+			break;
+	}
+
+	Node* function = ParseFunctionEncoding();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	Node* identifier = GetUnqualifiedIdentifier(name);
+	if (identifier->kind == NodeKind::ConversionOperator)
+	{
+		identifier->type = function->type->type;
+	}
+
+	return function;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseVariableEncoding(StorageClass storageClass) PDB_NO_EXCEPT
+{
+	Node* type = ParseType(QualifierMode::Drop);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	Qualifiers qualifiers = Qualifiers::None;
+	bool isMember = false;
+	if (type->kind == NodeKind::PointerType)
+	{
+		// pointers store the qualifiers of the pointee after the pointer itself
+		type->qualifiers = type->qualifiers | ParsePointerExtendedQualifiers();
+		if (!ParseQualifiers(qualifiers, isMember))
+		{
+			return nullptr;
+		}
+
+		if (type->name)
+		{
+			// pointers to members repeat the name of the class
+			(void)ParseFullyQualifiedTypeName();
+			if (m_error)
+			{
+				return nullptr;
+			}
+		}
+
+		type->type->qualifiers = type->type->qualifiers | qualifiers;
+	}
+	else
+	{
+		if (!ParseQualifiers(qualifiers, isMember))
+		{
+			return nullptr;
+		}
+
+		type->qualifiers = qualifiers;
+	}
+
+	Node* variable = NewNode(NodeKind::VariableSymbol);
+	variable->storageClass = storageClass;
+	variable->type = type;
+
+	return variable;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseFunctionEncoding(void) PDB_NO_EXCEPT
+{
+	const FunctionClass externC = Consume("$$J0") ? FunctionClass::ExternC : FunctionClass::None;
+	const FunctionClass functionClass = ParseFunctionClass() | externC;
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	// thunks adjusting the this pointer store the adjustment before the signature
+	int64_t offsets[4u] = {};
+	if (IsSet(functionClass, FunctionClass::StaticThisAdjust))
+	{
+		if (!ParseSigned(offsets[3u]))
+		{
+			return nullptr;
+		}
+	}
+	else if (IsSet(functionClass, FunctionClass::VirtualThisAdjust))
+	{
+		if (IsSet(functionClass, FunctionClass::VirtualThisAdjustEx) && (!ParseSigned(offsets[0u]) || !ParseSigned(offsets[1u])))
+		{
+			return nullptr;
+		}
+
+		if (!ParseSigned(offsets[2u]) || !ParseSigned(offsets[3u]))
+		{
+			return nullptr;
+		}
+	}
+
+	Node* signature = nullptr;
+	if (IsSet(functionClass, FunctionClass::NoParameterList))
+	{
+		// local symbols of extern "C" functions do not mangle the full signature of the function
+		signature = NewNode(NodeKind::FunctionType);
+	}
+	else
+	{
+		const bool hasThisQualifiers = !IsSet(functionClass, FunctionClass::Global | FunctionClass::Static);
+		signature = ParseFunctionType(hasThisQualifiers);
+		if (m_error)
+		{
+			return nullptr;
+		}
+	}
+
+	signature->functionClass = functionClass;
+	if (IsSet(functionClass, FunctionClass::StaticThisAdjust | FunctionClass::VirtualThisAdjust))
+	{
+		signature->functionClass = signature->functionClass | FunctionClass::Thunk;
+		std::memcpy(signature->offsets, offsets, sizeof(offsets));
+	}
+
+	Node* function = NewNode(NodeKind::FunctionSymbol);
+	function->type = signature;
+
+	return function;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseSpecialTableSymbol(const char* text) PDB_NO_EXCEPT
+{
+	Node* name = ParseNameScopeChain(NewIdentifier(text));
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	const char c = Next();
+	if ((c != '6') && (c != '7'))
+	{
+		return Fail();
+	}
+
+	Node* table = NewNode(NodeKind::SpecialTableSymbol);
+	table->name = name;
+
+	bool isMember = false;
+	if (!ParseQualifiers(table->qualifiers, isMember))
+	{
+		return nullptr;
+	}
+
+	if (!Consume('@'))
+	{
+		// the table belongs to a base class, e.g. "const Foo::`vftable'{for `Bar'}"
+		table->child = ParseFullyQualifiedTypeName();
+		if (m_error)
+		{
+			return nullptr;
+		}
+	}
+
+	return table;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseVcallThunk(void) PDB_NO_EXCEPT
+{
+	Node* identifier = NewNode(NodeKind::VcallThunk);
+	Node* name = ParseNameScopeChain(identifier);
+	if (m_error || !Consume("$B") || !ParseUnsigned(identifier->number) || !Consume('A'))
+	{
+		return Fail();
+	}
+
+	Node* signature = NewNode(NodeKind::FunctionType);
+	signature->functionClass = FunctionClass::NoParameterList | FunctionClass::Thunk;
+	signature->callingConvention = ParseCallingConvention();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	Node* function = NewNode(NodeKind::FunctionSymbol);
+	function->name = name;
+	function->type = signature;
+
+	return function;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseLocalStaticGuard(bool isThread) PDB_NO_EXCEPT
+{
+	Node* identifier = NewNode(NodeKind::LocalStaticGuard);
+	identifier->flag = isThread;
+
+	Node* name = ParseNameScopeChain(identifier);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	if (!Consume("4IA") && !Consume('5'))
+	{
+		return Fail();
+	}
+
+	if ((*m_position != '\0') && !ParseUnsigned(identifier->number))
+	{
+		return nullptr;
+	}
+
+	Node* variable = NewNode(NodeKind::VariableSymbol);
+	variable->name = name;
+
+	return variable;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseUntypedVariable(const char* text) PDB_NO_EXCEPT
+{
+	Node* name = ParseNameScopeChain(NewIdentifier(text));
+	if (m_error || !Consume('8'))
+	{
+		return Fail();
+	}
+
+	Node* variable = NewNode(NodeKind::VariableSymbol);
+	variable->name = name;
+
+	return variable;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseRttiTypeDescriptor(void) PDB_NO_EXCEPT
+{
+	Node* type = ParseType(QualifierMode::Result);
+	if (m_error || !Consume("@8") || (*m_position != '\0'))
+	{
+		return Fail();
+	}
+
+	Node* variable = NewNode(NodeKind::VariableSymbol);
+	variable->name = NewQualifiedName(NewIdentifier("`RTTI Type Descriptor'"));
+	variable->type = type;
+
+	return variable;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseRttiBaseClassDescriptor(void) PDB_NO_EXCEPT
+{
+	Node* identifier = NewNode(NodeKind::RttiBaseClassDescriptor);
+
+	uint64_t memberDisplacement = 0u;
+	uint64_t vbtableOffset = 0u;
+	uint64_t attributes = 0u;
+	if (!ParseUnsigned(memberDisplacement) || !ParseSigned(identifier->offsets[1u]) || !ParseUnsigned(vbtableOffset) || !ParseUnsigned(attributes))
+	{
+		return nullptr;
+	}
+
+	identifier->offsets[0u] = static_cast<int64_t>(memberDisplacement);
+	identifier->offsets[2u] = static_cast<int64_t>(vbtableOffset);
+	identifier->offsets[3u] = static_cast<int64_t>(attributes);
+	identifier->offsetCount = 4u;
+
+	Node* name = ParseNameScopeChain(identifier);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	(void)Consume('8');
+
+	Node* variable = NewNode(NodeKind::VariableSymbol);
+	variable->name = name;
+
+	return variable;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseInitFiniStub(bool isDestructor) PDB_NO_EXCEPT
+{
+	Node* identifier = NewNode(NodeKind::DynamicStructor);
+	identifier->flag = isDestructor;
+
+	const bool isStaticDataMember = Consume('?');
+	Node* symbol = ParseDeclarator();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	Node* function = nullptr;
+	if (symbol->kind == NodeKind::VariableSymbol)
+	{
+		// the name of the variable is followed by the signature of the stub.
+		// static data members are terminated by two @, older compilers only emit a single one.
+		identifier->child = symbol;
+		if (!Consume('@') || (isStaticDataMember && !Consume('@')))
+		{
+			return Fail();
+		}
+
+		function = ParseFunctionEncoding();
+		if (m_error)
+		{
+			return nullptr;
+		}
+	}
+	else
+	{
+		if (isStaticDataMember)
+		{
+			return Fail();
+		}
+
+		function = symbol;
+		identifier->name = symbol->name;
+	}
+
+	function->name = NewQualifiedName(identifier);
+
+	return function;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseStringLiteral(void) PDB_NO_EXCEPT
+{
+	// <string literal> ::= @_ <char type> <length> <crc> @ <encoded characters> @
+	// the encoded characters are often truncated, so like UnDecorateSymbolName we don't decode them.
+	uint64_t length = 0u;
+	if (!Consume("@_") || (Next() == '\0') || !ParseUnsigned(length))
+	{
+		return Fail();
+	}
+
+	for (unsigned int i = 0u; i < 2u; ++i)
+	{
+		const char* at = std::strchr(m_position, '@');
+		if (!at)
+		{
+			return Fail();
+		}
+
+		m_position = at + 1;
+	}
+
+	Node* literal = NewNode(NodeKind::Literal);
+	literal->text = "`string'";
+	literal->textLength = 8u;
+
+	return literal;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseFullyQualifiedSymbolName(void) PDB_NO_EXCEPT
+{
+	Node* identifier = ParseUnqualifiedSymbolName();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	Node* name = ParseNameScopeChain(identifier);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	if (identifier->kind == NodeKind::Structor)
+	{
+		// constructors and destructors are named after their class, which is the enclosing scope
+		const Node* list = name->list;
+		if (!list->next)
+		{
+			return Fail();
+		}
+
+		while (list->next->next)
+		{
+			list = list->next;
+		}
+
+		identifier->child = list->item;
+	}
+
+	return name;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseFullyQualifiedTypeName(void) PDB_NO_EXCEPT
+{
+	Node* identifier = ParseUnqualifiedTypeName(true);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	return ParseNameScopeChain(identifier);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseUnqualifiedSymbolName(void) PDB_NO_EXCEPT
+{
+	if (IsDigit(*m_position))
+	{
+		return ParseBackReferenceName();
+	}
+	else if (StartsWith("?$"))
+	{
+		// template instantiations are only memorized when used as a scope or type
+		return ParseTemplateInstantiationName(false);
+	}
+	else if (*m_position == '?')
+	{
+		return ParseOperatorName();
+	}
+
+	return ParseSimpleName(true);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseUnqualifiedTypeName(bool memorize) PDB_NO_EXCEPT
+{
+	if (IsDigit(*m_position))
+	{
+		return ParseBackReferenceName();
+	}
+	else if (StartsWith("?$"))
+	{
+		return ParseTemplateInstantiationName(true);
+	}
+
+	return ParseSimpleName(memorize);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseNameScopeChain(Node* identifier) PDB_NO_EXCEPT
+{
+	// scopes are stored innermost first, so the list of identifiers is built back to front
+	Node* list = NewNode(NodeKind::List);
+	list->item = identifier;
+
+	while (!Consume('@'))
+	{
+		if (*m_position == '\0')
+		{
+			return Fail();
+		}
+
+		Node* scope = ParseNameScopePiece();
+		if (m_error)
+		{
+			return nullptr;
+		}
+
+		Node* head = NewNode(NodeKind::List);
+		head->item = scope;
+		head->next = list;
+		list = head;
+	}
+
+	Node* name = NewNode(NodeKind::QualifiedName);
+	name->list = list;
+
+	return name;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseNameScopePiece(void) PDB_NO_EXCEPT
+{
+	if (IsDigit(*m_position))
+	{
+		return ParseBackReferenceName();
+	}
+	else if (StartsWith("?$"))
+	{
+		return ParseTemplateInstantiationName(true);
+	}
+	else if (StartsWith("?A"))
+	{
+		return ParseAnonymousNamespaceName();
+	}
+	else if (IsLocalScopePattern())
+	{
+		return ParseLocallyScopedNamePiece();
+	}
+
+	return ParseSimpleName(true);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseTemplateInstantiationName(bool memorize) PDB_NO_EXCEPT
+{
+	// template instantiations start with a fresh set of back-references
+	const char* start = m_position;
+	m_position += 2;
+
+	DepthGuard guard(m_depth);
+	if (m_depth > MaxRecursionDepth)
+	{
+		return Fail();
+	}
+
+	const BackReferences outerBackReferences = m_backReferences;
+	m_backReferences = BackReferences();
+
+	Node* identifier = ParseUnqualifiedSymbolName();
+	if (!m_error)
+	{
+		identifier->templateArguments = ParseTemplateArguments();
+		identifier->hasTemplateArguments = true;
+	}
+
+	m_backReferences = outerBackReferences;
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	identifier->key = start;
+	identifier->keyLength = static_cast<size_t>(m_position - start);
+	if (memorize)
+	{
+		Memorize(identifier);
+	}
+
+	return identifier;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseSimpleName(bool memorize) PDB_NO_EXCEPT
+{
+	const char* at = std::strchr(m_position, '@');
+	if (!at || (at == m_position))
+	{
+		return Fail();
+	}
+
+	Node* identifier = NewNode(NodeKind::Identifier);
+	identifier->text = m_position;
+	identifier->textLength = static_cast<size_t>(at - m_position);
+	identifier->key = identifier->text;
+	identifier->keyLength = identifier->textLength;
+	m_position = at + 1;
+
+	if (memorize)
+	{
+		Memorize(identifier);
+	}
+
+	return identifier;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseBackReferenceName(void) PDB_NO_EXCEPT
+{
+	const size_t index = static_cast<size_t>(*m_position - '0');
+	if (index >= m_backReferences.nameCount)
+	{
+		return Fail();
+	}
+
+	++m_position;
+
+	return m_backReferences.names[index];
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseAnonymousNamespaceName(void) PDB_NO_EXCEPT
+{
+	// ?A0x<hash>@
+	m_position += 2;
+
+	const char* at = std::strchr(m_position, '@');
+	if (!at)
+	{
+		return Fail();
+	}
+
+	Node* identifier = NewIdentifier("`anonymous namespace'");
+	identifier->key = m_position;
+	identifier->keyLength = static_cast<size_t>(at - m_position);
+	m_position = at + 1;
+
+	Memorize(identifier);
+
+	return identifier;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseLocallyScopedNamePiece(void) PDB_NO_EXCEPT
+{
+	// ?<number>?<enclosing symbol>, e.g. "`void __cdecl foo(void)'::`2'"
+	const char* start = m_position;
+	++m_position;
+
+	Node* scope = NewNode(NodeKind::LocalScope);
+	bool isNegative = false;
+	if (!ParseNumber(scope->number, isNegative) || isNegative || !Consume('?'))
+	{
+		return Fail();
+	}
+
+	scope->child = ParseSymbol();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	scope->key = start;
+	scope->keyLength = static_cast<size_t>(m_position - start);
+
+	return scope;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseOperatorName(void) PDB_NO_EXCEPT
+{
+	const char* start = m_position;
+	++m_position;
+
+	Node* identifier = nullptr;
+	if (Consume("__"))
+	{
+		if (Consume('K'))
+		{
+			// user-defined literal operator, e.g. operator ""_x
+			identifier = ParseSimpleName(false);
+			if (m_error)
+			{
+				return nullptr;
+			}
+
+			identifier->kind = NodeKind::LiteralOperator;
+		}
+		else
+		{
+			const char* text = LookupOperator(DoubleUnderscoreOperators, Next());
+			if (!text)
+			{
+				return Fail();
+			}
+
+			identifier = NewIdentifier(text);
+		}
+	}
+	else if (Consume('_'))
+	{
+		const char* text = LookupOperator(UnderscoreOperators, Next());
+		if (!text)
+		{
+			return Fail();
+		}
+
+		identifier = NewIdentifier(text);
+	}
+	else
+	{
+		const char code = Next();
+		if ((code == '0') || (code == '1'))
+		{
+			identifier = NewNode(NodeKind::Structor);
+			identifier->flag = (code == '1');
+		}
+		else if (code == 'B')
+		{
+			identifier = NewNode(NodeKind::ConversionOperator);
+		}
+		else
+		{
+			const char* text = LookupOperator(BasicOperators, code);
+			if (!text)
+			{
+				return Fail();
+			}
+
+			identifier = NewIdentifier(text);
+		}
+	}
+
+	identifier->key = start;
+	identifier->keyLength = static_cast<size_t>(m_position - start);
+
+	return identifier;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseTemplateArguments(void) PDB_NO_EXCEPT
+{
+	Node* head = nullptr;
+	Node** tail = &head;
+
+	while (!Consume('@'))
+	{
+		if (*m_position == '\0')
+		{
+			return Fail();
+		}
+
+		// empty parameter packs and pack separators
+		if (Consume("$S") || Consume("$$V") || Consume("$$$V") || Consume("$$Z"))
+		{
+			continue;
+		}
+
+		Node* argument = nullptr;
+		if (Consume("$$Y"))
+		{
+			// alias template
+			argument = ParseFullyQualifiedTypeName();
+		}
+		else if (Consume("$$B"))
+		{
+			argument = ParseType(QualifierMode::Drop);
+		}
+		else if (Consume("$$C"))
+		{
+			argument = ParseType(QualifierMode::Mangle);
+		}
+		else if (StartsWith("$1") || StartsWith("$H") || StartsWith("$I") || StartsWith("$J"))
+		{
+			// pointer to a symbol or member function, the latter with up to three adjustments of the this pointer
+			++m_position;
+			const char inheritance = Next();
+
+			argument = NewNode(NodeKind::SymbolReference);
+			argument->affinity = PointerAffinity::Pointer;
+			if (*m_position == '?')
+			{
+				argument->child = ParseSymbol();
+				if (m_error)
+				{
+					return nullptr;
+				}
+
+				if (argument->child->name)
+				{
+					Memorize(GetUnqualifiedIdentifier(argument->child->name));
+				}
+			}
+
+			const uint8_t offsetCount = (inheritance == 'J') ? 3u : (inheritance == 'I') ? 2u : (inheritance == 'H') ? 1u : 0u;
+			for (uint8_t i = 0u; i < offsetCount; ++i)
+			{
+				if (!ParseSigned(argument->offsets[argument->offsetCount++]))
+				{
+					return nullptr;
+				}
+			}
+		}
+		else if (StartsWith("$E?"))
+		{
+			// reference to a symbol
+			m_position += 2;
+
+			argument = NewNode(NodeKind::SymbolReference);
+			argument->affinity = PointerAffinity::Reference;
+			argument->child = ParseSymbol();
+		}
+		else if (StartsWith("$F") || StartsWith("$G"))
+		{
+			// pointer to a data member, with two or three offsets
+			++m_position;
+			const char inheritance = Next();
+
+			argument = NewNode(NodeKind::SymbolReference);
+			const uint8_t offsetCount = (inheritance == 'G') ? 3u : 2u;
+			for (uint8_t i = 0u; i < offsetCount; ++i)
+			{
+				if (!ParseSigned(argument->offsets[argument->offsetCount++]))
+				{
+					return nullptr;
+				}
+			}
+		}
+		else if (Consume("$0"))
+		{
+			argument = NewNode(NodeKind::IntegerLiteral);
+			(void)ParseNumber(argument->number, argument->flag);
+		}
+		else
+		{
+			argument = ParseType(QualifierMode::Drop);
+		}
+
+		if (m_error)
+		{
+			return nullptr;
+		}
+
+		Append(tail, argument);
+	}
+
+	return head;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::IsLocalScopePattern(void) const PDB_NO_EXCEPT
+{
+	// ?<number>? where the number is either a single digit, @ for zero, or hex digits B-P A-P* terminated by @
+	if (*m_position != '?')
+	{
+		return false;
+	}
+
+	const char* candidate = m_position + 1;
+	const char* end = std::strchr(candidate, '?');
+	if (!end || (end == candidate))
+	{
+		return false;
+	}
+
+	if (end - candidate == 1)
+	{
+		return (*candidate == '@') || IsDigit(*candidate);
+	}
+
+	if ((end[-1] != '@') || (*candidate < 'B') || (*candidate > 'P'))
+	{
+		return false;
+	}
+
+	for (const char* c = candidate + 1; c < end - 1; ++c)
+	{
+		if ((*c < 'A') || (*c > 'P'))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseType(QualifierMode mode) PDB_NO_EXCEPT
+{
+	DepthGuard guard(m_depth);
+	if (m_depth > MaxRecursionDepth)
+	{
+		return Fail();
+	}
+
+	Qualifiers qualifiers = Qualifiers::None;
+	bool isMember = false;
+	if ((mode == QualifierMode::Mangle) || ((mode == QualifierMode::Result) && Consume('?')))
+	{
+		if (!ParseQualifiers(qualifiers, isMember))
+		{
+			return nullptr;
+		}
+	}
+
+	Node* type = nullptr;
+	const char c = *m_position;
+	if (Consume("$$A8@@"))
+	{
+		type = ParseFunctionType(true);
+	}
+	else if ((c == 'T') || (c == 'U') || (c == 'V') || (c == 'W'))
+	{
+		type = ParseTagType();
+	}
+	else if (StartsWith("$$Q") || StartsWith("$$R") || (c == 'A') || (c == 'P') || (c == 'Q') || (c == 'R') || (c == 'S'))
+	{
+		const bool isMemberPointer = IsMemberPointer();
+		if (m_error)
+		{
+			return nullptr;
+		}
+
+		type = isMemberPointer ? ParseMemberPointerType() : ParsePointerType();
+	}
+	else if (c == 'Y')
+	{
+		type = ParseArrayType();
+	}
+	else if (Consume("$$A6"))
+	{
+		type = ParseFunctionType(false);
+	}
+	else if (c == '?')
+	{
+		type = ParseCustomType();
+	}
+	else
+	{
+		type = ParsePrimitiveType();
+	}
+
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	type->qualifiers = type->qualifiers | qualifiers;
+
+	return type;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParsePrimitiveType(void) PDB_NO_EXCEPT
+{
+	const char* text = nullptr;
+	if (Consume("$$T"))
+	{
+		text = "std::nullptr_t";
+	}
+	else
+	{
+		switch (Next())
+		{
+			case 'X': text = "void"; break;
+			case 'C': text = "signed char"; break;
+			case 'D': text = "char"; break;
+			case 'E': text = "unsigned char"; break;
+			case 'F': text = "short"; break;
+			case 'G': text = "unsigned short"; break;
+			case 'H': text = "int"; break;
+			case 'I': text = "unsigned int"; break;
+			case 'J': text = "long"; break;
+			case 'K': text = "unsigned long"; break;
+			case 'M': text = "float"; break;
+			case 'N': text = "double"; break;
+			case 'O': text = "long double"; break;
+
+			case '_':
+			{
+				switch (Next())
+				{
+					case 'J': text = "__int64"; break;
+					case 'K': text = "unsigned __int64"; break;
+					case 'L': text = "__int128"; break;
+					case 'M': text = "unsigned __int128"; break;
+					case 'N': text = "bool"; break;
+					case 'Q': text = "char8_t"; break;
+					case 'S': text = "char16_t"; break;
+					case 'U': text = "char32_t"; break;
+					case 'W': text = "wchar_t"; break;
+					default: return Fail();
+				}
+				break;
+			}
+
+			default:
+				return Fail();
+		}
+	}
+
+	Node* type = NewNode(NodeKind::PrimitiveType);
+	type->text = text;
+	type->textLength = std::strlen(text);
+
+	return type;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseTagType(void) PDB_NO_EXCEPT
+{
+	Node* type = NewNode(NodeKind::TagType);
+	switch (Next())
+	{
+		case 'T':
+			type->tagKind = TagKind::Union;
+			break;
+
+		case 'U':
+			type->tagKind = TagKind::Struct;
+			break;
+
+		case 'V':
+			type->tagKind = TagKind::Class;
+			break;
+
+		default:
+			// enums are always encoded as W4, other underlying types are no longer emitted
+			if (!Consume('4'))
+			{
+				return Fail();
+			}
+
+			type->tagKind = TagKind::Enum;
+			break;
+	}
+
+	type->name = ParseFullyQualifiedTypeName();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	return type;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseCustomType(void) PDB_NO_EXCEPT
+{
+	++m_position;
+
+	Node* type = NewNode(NodeKind::CustomType);
+	type->child = ParseUnqualifiedTypeName(true);
+	if (m_error || !Consume('@'))
+	{
+		return Fail();
+	}
+
+	return type;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParsePointerType(void) PDB_NO_EXCEPT
+{
+	Node* pointer = NewNode(NodeKind::PointerType);
+	if (!ParsePointerQualifiers(pointer->qualifiers, pointer->affinity))
+	{
+		return nullptr;
+	}
+
+	if (Consume('6'))
+	{
+		pointer->type = ParseFunctionType(false);
+	}
+	else
+	{
+		pointer->qualifiers = pointer->qualifiers | ParsePointerExtendedQualifiers();
+		pointer->type = ParseType(QualifierMode::Mangle);
+	}
+
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	return pointer;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseMemberPointerType(void) PDB_NO_EXCEPT
+{
+	Node* pointer = NewNode(NodeKind::PointerType);
+	if (!ParsePointerQualifiers(pointer->qualifiers, pointer->affinity))
+	{
+		return nullptr;
+	}
+
+	pointer->qualifiers = pointer->qualifiers | ParsePointerExtendedQualifiers();
+
+	if (Consume('8'))
+	{
+		// pointer to member function
+		pointer->name = ParseFullyQualifiedTypeName();
+		if (m_error)
+		{
+			return nullptr;
+		}
+
+		pointer->type = ParseFunctionType(true);
+	}
+	else
+	{
+		// pointer to data member
+		Qualifiers pointeeQualifiers = Qualifiers::None;
+		bool isMember = false;
+		if (!ParseQualifiers(pointeeQualifiers, isMember))
+		{
+			return nullptr;
+		}
+
+		pointer->name = ParseFullyQualifiedTypeName();
+		if (m_error)
+		{
+			return nullptr;
+		}
+
+		pointer->type = ParseType(QualifierMode::Drop);
+		if (pointer->type)
+		{
+			pointer->type->qualifiers = pointeeQualifiers;
+		}
+	}
+
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	return pointer;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseArrayType(void) PDB_NO_EXCEPT
+{
+	// Y <rank> <dimension>+ [$$C <qualifiers>] <element type>
+	++m_position;
+
+	uint64_t rank = 0u;
+	bool isNegative = false;
+	if (!ParseNumber(rank, isNegative) || isNegative || (rank == 0u))
+	{
+		return Fail();
+	}
+
+	Node* array = NewNode(NodeKind::ArrayType);
+	Node** tail = &array->list;
+	for (uint64_t i = 0u; i < rank; ++i)
+	{
+		Node* dimension = NewNode(NodeKind::IntegerLiteral);
+		if (!ParseNumber(dimension->number, isNegative) || isNegative)
+		{
+			return Fail();
+		}
+
+		Append(tail, dimension);
+	}
+
+	if (Consume("$$C"))
+	{
+		bool isMember = false;
+		if (!ParseQualifiers(array->qualifiers, isMember) || isMember)
+		{
+			return Fail();
+		}
+	}
+
+	array->type = ParseType(QualifierMode::Drop);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	return array;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseFunctionType(bool hasThisQualifiers) PDB_NO_EXCEPT
+{
+	Node* function = NewNode(NodeKind::FunctionType);
+	if (hasThisQualifiers)
+	{
+		function->qualifiers = ParsePointerExtendedQualifiers();
+		if (Consume('G'))
+		{
+			function->refQualifier = PointerAffinity::Reference;
+		}
+		else if (Consume('H'))
+		{
+			function->refQualifier = PointerAffinity::RValueReference;
+		}
+
+		Qualifiers qualifiers = Qualifiers::None;
+		bool isMember = false;
+		if (!ParseQualifiers(qualifiers, isMember))
+		{
+			return nullptr;
+		}
+
+		function->qualifiers = function->qualifiers | qualifiers;
+	}
+
+	function->callingConvention = ParseCallingConvention();
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	// constructors and destructors have no return type
+	if (!Consume('@'))
+	{
+		function->type = ParseType(QualifierMode::Result);
+		if (m_error)
+		{
+			return nullptr;
+		}
+	}
+
+	function->list = ParseParameterList(function->flag);
+	if (m_error)
+	{
+		return nullptr;
+	}
+
+	// throw specification
+	if (Consume("_E"))
+	{
+		function->isNoexcept = true;
+	}
+	else if (!Consume('Z'))
+	{
+		return Fail();
+	}
+
+	return function;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::Demangler::Node* PDB::Demangler::Parser::ParseParameterList(bool& isVariadic) PDB_NO_EXCEPT
+{
+	if (Consume('X'))
+	{
+		// (void)
+		return nullptr;
+	}
+
+	Node* head = nullptr;
+	Node** tail = &head;
+	while ((*m_position != '@') && (*m_position != 'Z'))
+	{
+		if (*m_position == '\0')
+		{
+			return Fail();
+		}
+
+		if (IsDigit(*m_position))
+		{
+			const size_t index = static_cast<size_t>(*m_position - '0');
+			if (index >= m_backReferences.parameterCount)
+			{
+				return Fail();
+			}
+
+			++m_position;
+			Append(tail, m_backReferences.parameters[index]);
+
+			continue;
+		}
+
+		const char* start = m_position;
+		Node* type = ParseType(QualifierMode::Drop);
+		if (m_error)
+		{
+			return nullptr;
+		}
+
+		Append(tail, type);
+
+		// single-letter types are not memorized, because a back-reference would not save anything
+		if ((m_backReferences.parameterCount < MaxBackReferenceCount) && (m_position - start > 1))
+		{
+			m_backReferences.parameters[m_backReferences.parameterCount++] = type;
+		}
+	}
+
+	// a non-empty parameter list is terminated by @, or by Z for variadic functions
+	if (Next() == 'Z')
+	{
+		isVariadic = true;
+	}
+
+	return head;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::IsMemberPointer(void) PDB_NO_EXCEPT
+{
+	const char* position = m_position;
+	switch (*position)
+	{
+		case '$':
+			// rvalue references cannot refer to members
+		case 'A':
+			return false;
+
+		case 'P':
+		case 'Q':
+		case 'R':
+		case 'S':
+			break;
+
+		default:
+			m_error = true;
+			return false;
+	}
+
+	++position;
+
+	// pointers to functions and member functions
+	if (IsDigit(*position))
+	{
+		if ((*position != '6') && (*position != '8'))
+		{
+			m_error = true;
+			return false;
+		}
+
+		return (*position == '8');
+	}
+
+	// skip the extended qualifiers, which appear on both kinds of pointers
+	position += (*position == 'E') ? 1 : 0;
+	position += (*position == 'I') ? 1 : 0;
+	position += (*position == 'F') ? 1 : 0;
+
+	switch (*position)
+	{
+		case 'A':
+		case 'B':
+		case 'C':
+		case 'D':
+			return false;
+
+		case 'Q':
+		case 'R':
+		case 'S':
+		case 'T':
+			return true;
+
+		default:
+			m_error = true;
+			return false;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::ParseQualifiers(Qualifiers& qualifiers, bool& isMember) PDB_NO_EXCEPT
+{
+	// A-D for non-members, Q-T for members
+	switch (Next())
+	{
+		case 'A': qualifiers = Qualifiers::None; isMember = false; return true;
+		case 'B': qualifiers = Qualifiers::Const; isMember = false; return true;
+		case 'C': qualifiers = Qualifiers::Volatile; isMember = false; return true;
+		case 'D': qualifiers = Qualifiers::Const | Qualifiers::Volatile; isMember = false; return true;
+		case 'Q': qualifiers = Qualifiers::None; isMember = true; return true;
+		case 'R': qualifiers = Qualifiers::Const; isMember = true; return true;
+		case 'S': qualifiers = Qualifiers::Volatile; isMember = true; return true;
+		case 'T': qualifiers = Qualifiers::Const | Qualifiers::Volatile; isMember = true; return true;
+
+		default:
+			m_error = true;
+			return false;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::Parser::ParsePointerQualifiers(Qualifiers& qualifiers, PointerAffinity& affinity) PDB_NO_EXCEPT
+{
+	if (Consume("$$Q"))
+	{
+		qualifiers = Qualifiers::None;
+		affinity = PointerAffinity::RValueReference;
+
+		return true;
+	}
+	else if (Consume("$$R"))
+	{
+		qualifiers = Qualifiers::Volatile;
+		affinity = PointerAffinity::RValueReference;
+
+		return true;
+	}
+
+	switch (Next())
+	{
+		case 'A': qualifiers = Qualifiers::None; affinity = PointerAffinity::Reference; return true;
+		case 'P': qualifiers = Qualifiers::None; affinity = PointerAffinity::Pointer; return true;
+		case 'Q': qualifiers = Qualifiers::Const; affinity = PointerAffinity::Pointer; return true;
+		case 'R': qualifiers = Qualifiers::Volatile; affinity = PointerAffinity::Pointer; return true;
+		case 'S': qualifiers = Qualifiers::Const | Qualifiers::Volatile; affinity = PointerAffinity::Pointer; return true;
+
+		default:
+			m_error = true;
+			return false;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD Qualifiers PDB::Demangler::Parser::ParsePointerExtendedQualifiers(void) PDB_NO_EXCEPT
+{
+	Qualifiers qualifiers = Qualifiers::None;
+	if (Consume('E'))
+	{
+		qualifiers = qualifiers | Qualifiers::Pointer64;
+	}
+
+	if (Consume('I'))
+	{
+		qualifiers = qualifiers | Qualifiers::Restrict;
+	}
+
+	if (Consume('F'))
+	{
+		qualifiers = qualifiers | Qualifiers::Unaligned;
+	}
+
+	return qualifiers;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD FunctionClass PDB::Demangler::Parser::ParseFunctionClass(void) PDB_NO_EXCEPT
+{
+	switch (Next())
+	{
+		case '9': return FunctionClass::ExternC | FunctionClass::NoParameterList;
+		case 'A': return FunctionClass::Private;
+		case 'B': return FunctionClass::Private | FunctionClass::Far;
+		case 'C': return FunctionClass::Private | FunctionClass::Static;
+		case 'D': return FunctionClass::Private | FunctionClass::Static | FunctionClass::Far;
+		case 'E': return FunctionClass::Private | FunctionClass::Virtual;
+		case 'F': return FunctionClass::Private | FunctionClass::Virtual | FunctionClass::Far;
+		case 'G': return FunctionClass::Private | FunctionClass::StaticThisAdjust;
+		case 'H': return FunctionClass::Private | FunctionClass::StaticThisAdjust | FunctionClass::Far;
+		case 'I': return FunctionClass::Protected;
+		case 'J': return FunctionClass::Protected | FunctionClass::Far;
+		case 'K': return FunctionClass::Protected | FunctionClass::Static;
+		case 'L': return FunctionClass::Protected | FunctionClass::Static | FunctionClass::Far;
+		case 'M': return FunctionClass::Protected | FunctionClass::Virtual;
+		case 'N': return FunctionClass::Protected | FunctionClass::Virtual | FunctionClass::Far;
+		case 'O': return FunctionClass::Protected | FunctionClass::Virtual | FunctionClass::StaticThisAdjust;
+		case 'P': return FunctionClass::Protected | FunctionClass::Virtual | FunctionClass::StaticThisAdjust | FunctionClass::Far;
+		case 'Q': return FunctionClass::Public;
+		case 'R': return FunctionClass::Public | FunctionClass::Far;
+		case 'S': return FunctionClass::Public | FunctionClass::Static;
+		case 'T': return FunctionClass::Public | FunctionClass::Static | FunctionClass::Far;
+		case 'U': return FunctionClass::Public | FunctionClass::Virtual;
+		case 'V': return FunctionClass::Public | FunctionClass::Virtual | FunctionClass::Far;
+		case 'W': return FunctionClass::Public | FunctionClass::Virtual | FunctionClass::StaticThisAdjust;
+		case 'X': return FunctionClass::Public | FunctionClass::Virtual | FunctionClass::StaticThisAdjust | FunctionClass::Far;
+		case 'Y': return FunctionClass::Global;
+		case 'Z': return FunctionClass::Global | FunctionClass::Far;
+
+		case '$':
+		{
+			// virtual functions adjusting the this pointer using a vtordisp, optionally via the vbtable
+			FunctionClass adjust = FunctionClass::VirtualThisAdjust;
+			if (Consume('R'))
+			{
+				adjust = adjust | FunctionClass::VirtualThisAdjustEx;
+			}
+
+			switch (Next())
+			{
+				case '0': return FunctionClass::Private | FunctionClass::Virtual | adjust;
+				case '1': return FunctionClass::Private | FunctionClass::Virtual | adjust | FunctionClass::Far;
+				case '2': return FunctionClass::Protected | FunctionClass::Virtual | adjust;
+				case '3': return FunctionClass::Protected | FunctionClass::Virtual | adjust | FunctionClass::Far;
+				case '4': return FunctionClass::Public | FunctionClass::Virtual | adjust;
+				case '5': return FunctionClass::Public | FunctionClass::Virtual | adjust | FunctionClass::Far;
+				default: break;
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	m_error = true;
+
+	return FunctionClass::None;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD CallingConvention PDB::Demangler::Parser::ParseCallingConvention(void) PDB_NO_EXCEPT
+{
+	switch (Next())
+	{
+		case 'A':
+		case 'B':
+			return CallingConvention::Cdecl;
+
+		case 'C':
+		case 'D':
+			return CallingConvention::Pascal;
+
+		case 'E':
+		case 'F':
+			return CallingConvention::Thiscall;
+
+		case 'G':
+		case 'H':
+			return CallingConvention::Stdcall;
+
+		case 'I':
+		case 'J':
+			return CallingConvention::Fastcall;
+
+		case 'M':
+		case 'N':
+			return CallingConvention::Clrcall;
+
+		case 'O':
+		case 'P':
+			return CallingConvention::Eabi;
+
+		case 'Q':
+			return CallingConvention::Vectorcall;
+
+		case 'S':
+			return CallingConvention::Swift;
+
+		case 'W':
+			return CallingConvention::SwiftAsync;
+
+		default:
+			m_error = true;
+			return CallingConvention::None;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::Output(const char* text) PDB_NO_EXCEPT
+{
+	Output(text, std::strlen(text));
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::Output(const char* text, size_t length) PDB_NO_EXCEPT
+{
+	Demangler& demangler = m_demangler;
+
+	// leave room for the null terminator
+	const size_t requiredCapacity = demangler.m_outputSize + length + 1u;
+	if (requiredCapacity > demangler.m_outputCapacity)
+	{
+		size_t capacity = demangler.m_outputCapacity * 2u;
+		while (capacity < requiredCapacity)
+		{
+			capacity *= 2u;
+		}
+
+		char* output = PDB_NEW_ARRAY(char, capacity);
+		std::memcpy(output, demangler.m_output, demangler.m_outputSize);
+		PDB_DELETE_ARRAY(demangler.m_output);
+
+		demangler.m_output = output;
+		demangler.m_outputCapacity = capacity;
+	}
+
+	std::memcpy(demangler.m_output + demangler.m_outputSize, text, length);
+	demangler.m_outputSize += length;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputUnsigned(uint64_t value) PDB_NO_EXCEPT
+{
+	char digits[20u];
+	size_t count = 0u;
+	do
+	{
+		digits[sizeof(digits) - ++count] = static_cast<char>('0' + value % 10u);
+		value /= 10u;
+	}
+	while (value != 0u);
+
+	Output(digits + sizeof(digits) - count, count);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputSigned(int64_t value) PDB_NO_EXCEPT
+{
+	if (value < 0)
+	{
+		Output("-", 1u);
+		OutputUnsigned(0u - static_cast<uint64_t>(value));
+	}
+	else
+	{
+		OutputUnsigned(static_cast<uint64_t>(value));
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputSpaceIfNecessary(void) PDB_NO_EXCEPT
+{
+	const Demangler& demangler = m_demangler;
+	if (demangler.m_outputSize == 0u)
+	{
+		return;
+	}
+
+	const char last = demangler.m_output[demangler.m_outputSize - 1u];
+	if (IsAlphaNumeric(last) || (last == '>'))
+	{
+		Output(" ", 1u);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputQualifiers(Qualifiers qualifiers, bool spaceBefore, bool spaceAfter) PDB_NO_EXCEPT
+{
+	static const Qualifiers printedQualifiers[3u] = { Qualifiers::Const, Qualifiers::Volatile, Qualifiers::Restrict };
+	static const char* const names[3u] = { "const", "volatile", "__restrict" };
+
+	bool hasOutput = false;
+	for (size_t i = 0u; i < 3u; ++i)
+	{
+		if (!IsSet(qualifiers, printedQualifiers[i]))
+		{
+			continue;
+		}
+
+		if (spaceBefore || hasOutput)
+		{
+			Output(" ", 1u);
+		}
+
+		Output(names[i]);
+		hasOutput = true;
+	}
+
+	if (spaceAfter && hasOutput)
+	{
+		Output(" ", 1u);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputCallingConvention(CallingConvention callingConvention) PDB_NO_EXCEPT
+{
+	OutputSpaceIfNecessary();
+
+	switch (callingConvention)
+	{
+		case CallingConvention::Cdecl: Output("__cdecl"); break;
+		case CallingConvention::Pascal: Output("__pascal"); break;
+		case CallingConvention::Thiscall: Output("__thiscall"); break;
+		case CallingConvention::Stdcall: Output("__stdcall"); break;
+		case CallingConvention::Fastcall: Output("__fastcall"); break;
+		case CallingConvention::Clrcall: Output("__clrcall"); break;
+		case CallingConvention::Eabi: Output("__eabi"); break;
+		case CallingConvention::Vectorcall: Output("__vectorcall"); break;
+		case CallingConvention::Swift: Output("__attribute__((__swiftcall__)) "); break;
+		case CallingConvention::SwiftAsync: Output("__attribute__((__swiftasynccall__)) "); break;
+		case CallingConvention::None: break;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputSymbol(const Node* symbol) PDB_NO_EXCEPT
+{
+	switch (symbol->kind)
+	{
+		case NodeKind::FunctionSymbol:
+			OutputFunctionPre(symbol->type, false);
+			OutputSpaceIfNecessary();
+			OutputQualifiedName(symbol->name);
+			OutputFunctionPost(symbol->type);
+			break;
+
+		case NodeKind::VariableSymbol:
+		{
+			switch (symbol->storageClass)
+			{
+				case StorageClass::PrivateStatic:
+					Output("private: static ");
+					break;
+
+				case StorageClass::ProtectedStatic:
+					Output("protected: static ");
+					break;
+
+				case StorageClass::PublicStatic:
+					Output("public: static ");
+					break;
+
+				case StorageClass::None:
+				case StorageClass::Global:
+				case StorageClass::FunctionLocalStatic:
+					break;
+			}
+
+			if (symbol->type)
+			{
+				OutputTypePre(symbol->type);
+				OutputSpaceIfNecessary();
+			}
+
+			OutputQualifiedName(symbol->name);
+
+			if (symbol->type)
+			{
+				OutputTypePost(symbol->type);
+			}
+			break;
+		}
+
+		case NodeKind::SpecialTableSymbol:
+			OutputQualifiers(symbol->qualifiers, false, true);
+			OutputQualifiedName(symbol->name);
+			if (symbol->child)
+			{
+				Output("{for `");
+				OutputQualifiedName(symbol->child);
+				Output("'}");
+			}
+			break;
+
+		case NodeKind::Literal:
+			Output(symbol->text, symbol->textLength);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputQualifiedName(const Node* name) PDB_NO_EXCEPT
+{
+	for (const Node* list = name->list; list; list = list->next)
+	{
+		if (list != name->list)
+		{
+			Output("::", 2u);
+		}
+
+		OutputIdentifier(list->item);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputIdentifier(const Node* identifier) PDB_NO_EXCEPT
+{
+	switch (identifier->kind)
+	{
+		case NodeKind::Identifier:
+			Output(identifier->text, identifier->textLength);
+			break;
+
+		case NodeKind::ConversionOperator:
+			// the template arguments of conversion operator templates come before the target type
+			Output("operator");
+			OutputTemplateArguments(identifier);
+			Output(" ", 1u);
+			OutputNode(identifier->type);
+			return;
+
+		case NodeKind::Structor:
+			if (identifier->flag)
+			{
+				Output("~", 1u);
+			}
+			OutputIdentifier(identifier->child);
+			break;
+
+		case NodeKind::DynamicStructor:
+			Output(identifier->flag ? "`dynamic atexit destructor for " : "`dynamic initializer for ");
+			if (identifier->child)
+			{
+				Output("`", 1u);
+				OutputSymbol(identifier->child);
+			}
+			else
+			{
+				Output("'", 1u);
+				OutputQualifiedName(identifier->name);
+			}
+			Output("''", 2u);
+			break;
+
+		case NodeKind::LocalStaticGuard:
+			Output(identifier->flag ? "`local static thread guard'" : "`local static guard'");
+			if (identifier->number != 0u)
+			{
+				Output("{", 1u);
+				OutputUnsigned(identifier->number);
+				Output("}", 1u);
+			}
+			break;
+
+		case NodeKind::LocalScope:
+			Output("`", 1u);
+			OutputSymbol(identifier->child);
+			Output("'::`");
+			OutputUnsigned(identifier->number);
+			Output("'", 1u);
+			break;
+
+		case NodeKind::VcallThunk:
+			Output("`vcall'{");
+			OutputUnsigned(identifier->number);
+			Output(", {flat}}");
+			break;
+
+		case NodeKind::RttiBaseClassDescriptor:
+			Output("`RTTI Base Class Descriptor at (");
+			for (uint8_t i = 0u; i < identifier->offsetCount; ++i)
+			{
+				if (i != 0u)
+				{
+					Output(", ", 2u);
+				}
+
+				OutputSigned(identifier->offsets[i]);
+			}
+			Output(")'", 2u);
+			break;
+
+		case NodeKind::LiteralOperator:
+			Output("operator \"\"");
+			Output(identifier->text, identifier->textLength);
+			break;
+
+		default:
+			break;
+	}
+
+	OutputTemplateArguments(identifier);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputTemplateArguments(const Node* identifier) PDB_NO_EXCEPT
+{
+	if (!identifier->hasTemplateArguments)
+	{
+		return;
+	}
+
+	Output("<", 1u);
+	OutputList(identifier->templateArguments, ", ");
+	Output(">", 1u);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputList(const Node* list, const char* separator) PDB_NO_EXCEPT
+{
+	for (const Node* element = list; element; element = element->next)
+	{
+		if (element != list)
+		{
+			Output(separator);
+		}
+
+		OutputNode(element->item);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputNode(const Node* node) PDB_NO_EXCEPT
+{
+	switch (node->kind)
+	{
+		case NodeKind::QualifiedName:
+			OutputQualifiedName(node);
+			break;
+
+		case NodeKind::IntegerLiteral:
+			if (node->flag)
+			{
+				Output("-", 1u);
+			}
+			OutputUnsigned(node->number);
+			break;
+
+		case NodeKind::SymbolReference:
+			if (node->offsetCount != 0u)
+			{
+				Output("{", 1u);
+			}
+			else if (node->affinity == PointerAffinity::Pointer)
+			{
+				Output("&", 1u);
+			}
+
+			if (node->child)
+			{
+				OutputSymbol(node->child);
+				if (node->offsetCount != 0u)
+				{
+					Output(", ", 2u);
+				}
+			}
+
+			for (uint8_t i = 0u; i < node->offsetCount; ++i)
+			{
+				if (i != 0u)
+				{
+					Output(", ", 2u);
+				}
+
+				OutputSigned(node->offsets[i]);
+			}
+
+			if (node->offsetCount != 0u)
+			{
+				Output("}", 1u);
+			}
+			break;
+
+		default:
+			OutputTypePre(node);
+			OutputTypePost(node);
+			break;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputTypePre(const Node* type) PDB_NO_EXCEPT
+{
+	switch (type->kind)
+	{
+		case NodeKind::PrimitiveType:
+			Output(type->text, type->textLength);
+			OutputQualifiers(type->qualifiers, true, false);
+			break;
+
+		case NodeKind::TagType:
+		{
+			static const char* const keywords[4u] = { "class ", "struct ", "union ", "enum " };
+			Output(keywords[PDB_AS_UNDERLYING(type->tagKind)]);
+			OutputQualifiedName(type->name);
+			OutputQualifiers(type->qualifiers, true, false);
+			break;
+		}
+
+		case NodeKind::CustomType:
+			OutputIdentifier(type->child);
+			break;
+
+		case NodeKind::PointerType:
+		{
+			// pointers to functions and arrays put the declarator into parentheses, e.g. "int (__cdecl *)(int)"
+			const Node* pointee = type->type;
+			const bool isFunctionPointer = (pointee->kind == NodeKind::FunctionType);
+			if (isFunctionPointer)
+			{
+				OutputFunctionPre(pointee, true);
+			}
+			else
+			{
+				OutputTypePre(pointee);
+			}
+
+			OutputSpaceIfNecessary();
+
+			if (IsSet(type->qualifiers, Qualifiers::Unaligned))
+			{
+				Output("__unaligned ");
+			}
+
+			if (pointee->kind == NodeKind::ArrayType)
+			{
+				Output("(", 1u);
+			}
+			else if (isFunctionPointer)
+			{
+				Output("(", 1u);
+				OutputCallingConvention(pointee->callingConvention);
+				Output(" ", 1u);
+			}
+
+			if (type->name)
+			{
+				OutputQualifiedName(type->name);
+				Output("::", 2u);
+			}
+
+			switch (type->affinity)
+			{
+				case PointerAffinity::Pointer:
+					Output("*", 1u);
+					break;
+
+				case PointerAffinity::Reference:
+					Output("&", 1u);
+					break;
+
+				case PointerAffinity::RValueReference:
+					Output("&&", 2u);
+					break;
+
+				case PointerAffinity::None:
+					break;
+			}
+
+			OutputQualifiers(type->qualifiers, false, false);
+			break;
+		}
+
+		case NodeKind::FunctionType:
+			OutputFunctionPre(type, false);
+			break;
+
+		case NodeKind::ArrayType:
+			OutputTypePre(type->type);
+			OutputQualifiers(type->qualifiers, true, false);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputTypePost(const Node* type) PDB_NO_EXCEPT
+{
+	switch (type->kind)
+	{
+		case NodeKind::PointerType:
+			if ((type->type->kind == NodeKind::ArrayType) || (type->type->kind == NodeKind::FunctionType))
+			{
+				Output(")", 1u);
+			}
+			OutputTypePost(type->type);
+			break;
+
+		case NodeKind::FunctionType:
+			OutputFunctionPost(type);
+			break;
+
+		case NodeKind::ArrayType:
+			Output("[", 1u);
+			OutputList(type->list, "][");
+			Output("]", 1u);
+			OutputTypePost(type->type);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputFunctionPre(const Node* function, bool omitCallingConvention) PDB_NO_EXCEPT
+{
+	const FunctionClass functionClass = function->functionClass;
+	if (IsSet(functionClass, FunctionClass::Thunk))
+	{
+		Output("[thunk]: ");
+	}
+
+	if (IsSet(functionClass, FunctionClass::Public))
+	{
+		Output("public: ");
+	}
+	else if (IsSet(functionClass, FunctionClass::Protected))
+	{
+		Output("protected: ");
+	}
+	else if (IsSet(functionClass, FunctionClass::Private))
+	{
+		Output("private: ");
+	}
+
+	if (!IsSet(functionClass, FunctionClass::Global) && IsSet(functionClass, FunctionClass::Static))
+	{
+		Output("static ");
+	}
+
+	if (IsSet(functionClass, FunctionClass::Virtual))
+	{
+		Output("virtual ");
+	}
+
+	if (IsSet(functionClass, FunctionClass::ExternC))
+	{
+		Output("extern \"C\" ");
+	}
+
+	if (function->type)
+	{
+		OutputTypePre(function->type);
+		Output(" ", 1u);
+	}
+
+	if (!omitCallingConvention)
+	{
+		OutputCallingConvention(function->callingConvention);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::Parser::OutputFunctionPost(const Node* function) PDB_NO_EXCEPT
+{
+	const FunctionClass functionClass = function->functionClass;
+	if (IsSet(functionClass, FunctionClass::Thunk))
+	{
+		const int64_t* offsets = function->offsets;
+		if (IsSet(functionClass, FunctionClass::StaticThisAdjust))
+		{
+			Output("`adjustor{");
+			OutputSigned(offsets[3u]);
+			Output("}'", 2u);
+		}
+		else if (IsSet(functionClass, FunctionClass::VirtualThisAdjust))
+		{
+			const bool isExtended = IsSet(functionClass, FunctionClass::VirtualThisAdjustEx);
+			Output(isExtended ? "`vtordispex{" : "`vtordisp{");
+			for (size_t i = isExtended ? 0u : 2u; i < 4u; ++i)
+			{
+				OutputSigned(offsets[i]);
+				Output((i == 3u) ? "}'" : ", ", 2u);
+			}
+		}
+	}
+
+	if (!IsSet(functionClass, FunctionClass::NoParameterList))
+	{
+		Output("(", 1u);
+		if (function->list)
+		{
+			OutputList(function->list, ", ");
+		}
+		else if (!function->flag)
+		{
+			Output("void");
+		}
+
+		if (function->flag)
+		{
+			if (m_demangler.m_output[m_demangler.m_outputSize - 1u] != '(')
+			{
+				Output(", ", 2u);
+			}
+
+			Output("...");
+		}
+
+		Output(")", 1u);
+	}
+
+	OutputQualifiers(function->qualifiers, true, false);
+	if (IsSet(function->qualifiers, Qualifiers::Unaligned))
+	{
+		Output(" __unaligned");
+	}
+
+	if (function->isNoexcept)
+	{
+		Output(" noexcept");
+	}
+
+	if (function->refQualifier == PointerAffinity::Reference)
+	{
+		Output(" &", 2u);
+	}
+	else if (function->refQualifier == PointerAffinity::RValueReference)
+	{
+		Output(" &&", 3u);
+	}
+
+	if (function->type)
+	{
+		OutputTypePost(function->type);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+struct PDB::DemangleArena::Chunk
+{
+	Chunk* previous;
+	char* data;
+	size_t capacity;
+	size_t used;
+};
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DemangleArena::DemangleArena(void) PDB_NO_EXCEPT
+	: m_chunks(nullptr)
+	, m_size(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DemangleArena::~DemangleArena(void) PDB_NO_EXCEPT
+{
+	while (m_chunks)
+	{
+		Chunk* previous = m_chunks->previous;
+		PDB_DELETE_ARRAY(m_chunks->data);
+		PDB_DELETE(m_chunks);
+		m_chunks = previous;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const char* PDB::DemangleArena::Store(const char* string, size_t length) PDB_NO_EXCEPT
+{
+	const size_t size = length + 1u;
+	if (!m_chunks || (m_chunks->used + size > m_chunks->capacity))
+	{
+		// strings larger than a chunk get a chunk of their own
+		Chunk* chunk = PDB_NEW(Chunk);
+		chunk->previous = m_chunks;
+		chunk->capacity = (size > ArenaChunkSize) ? size : ArenaChunkSize;
+		chunk->data = PDB_NEW_ARRAY(char, chunk->capacity);
+		chunk->used = 0u;
+		m_chunks = chunk;
+	}
+
+	char* copy = m_chunks->data + m_chunks->used;
+	std::memcpy(copy, string, length);
+	copy[length] = '\0';
+
+	m_chunks->used += size;
+	m_size += size;
+
+	return copy;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::DemangleArena::Reset(void) PDB_NO_EXCEPT
+{
+	if (!m_chunks)
+	{
+		return;
+	}
+
+	Chunk* previous = m_chunks->previous;
+	while (previous)
+	{
+		Chunk* next = previous->previous;
+		PDB_DELETE_ARRAY(previous->data);
+		PDB_DELETE(previous);
+		previous = next;
+	}
+
+	m_chunks->previous = nullptr;
+	m_chunks->used = 0u;
+	m_size = 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DemangleCache::DemangleCache(void) PDB_NO_EXCEPT
+	: m_entries(PDB_NEW_ARRAY(Entry, InitialCacheCapacity))
+	, m_entryMask(InitialCacheCapacity - 1u)
+	, m_entryCount(0u)
+{
+	std::memset(m_entries, 0, sizeof(Entry) * InitialCacheCapacity);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::DemangleCache::~DemangleCache(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_entries);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const char* PDB::DemangleCache::Find(const char* decoratedName) const PDB_NO_EXCEPT
+{
+	return Find(decoratedName, HashName(decoratedName));
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::DemangleCache::Insert(const char* decoratedName, const char* demangledName) PDB_NO_EXCEPT
+{
+	Insert(decoratedName, demangledName, HashName(decoratedName));
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const char* PDB::DemangleCache::Find(const char* decoratedName, uint32_t hash) const PDB_NO_EXCEPT
+{
+	for (size_t i = hash & m_entryMask; m_entries[i].decoratedName; i = (i + 1u) & m_entryMask)
+	{
+		const Entry& entry = m_entries[i];
+
+		// interned names are found without comparing their contents
+		if ((entry.hash == hash) && ((entry.decoratedName == decoratedName) || (std::strcmp(entry.decoratedName, decoratedName) == 0)))
+		{
+			return entry.demangledName;
+		}
+	}
+
+	return nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::DemangleCache::Insert(const char* decoratedName, const char* demangledName, uint32_t hash) PDB_NO_EXCEPT
+{
+	if ((m_entryCount + 1u) * 2u > m_entryMask + 1u)
+	{
+		// grow the table, keeping it at most half full
+		const size_t capacity = (m_entryMask + 1u) * 2u;
+		Entry* entries = PDB_NEW_ARRAY(Entry, capacity);
+		std::memset(entries, 0, sizeof(Entry) * capacity);
+
+		for (size_t i = 0u; i <= m_entryMask; ++i)
+		{
+			const Entry& entry = m_entries[i];
+			if (!entry.decoratedName)
+			{
+				continue;
+			}
+
+			size_t index = entry.hash & (capacity - 1u);
+			while (entries[index].decoratedName)
+			{
+				index = (index + 1u) & (capacity - 1u);
+			}
+
+			entries[index] = entry;
+		}
+
+		PDB_DELETE_ARRAY(m_entries);
+		m_entries = entries;
+		m_entryMask = capacity - 1u;
+	}
+
+	size_t index = hash & m_entryMask;
+	while (m_entries[index].decoratedName)
+	{
+		index = (index + 1u) & m_entryMask;
+	}
+
+	m_entries[index].decoratedName = decoratedName;
+	m_entries[index].demangledName = demangledName;
+	m_entries[index].hash = hash;
+	++m_entryCount;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::Demangler::Demangler(void) PDB_NO_EXCEPT
+	: m_firstChunk(PDB_NEW(NodeChunk))
+	, m_currentChunk(m_firstChunk)
+	, m_currentChunkUsed(0u)
+	, m_output(PDB_NEW_ARRAY(char, InitialOutputCapacity))
+	, m_outputSize(0u)
+	, m_outputCapacity(InitialOutputCapacity)
+{
+	m_firstChunk->next = nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::Demangler::~Demangler(void) PDB_NO_EXCEPT
+{
+	while (m_firstChunk)
+	{
+		NodeChunk* next = m_firstChunk->next;
+		PDB_DELETE(m_firstChunk);
+		m_firstChunk = next;
+	}
+
+	PDB_DELETE_ARRAY(m_output);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::Demangler::IsDecoratedName(const char* name) PDB_NO_EXCEPT
+{
+	// names hashed with MD5 because of their length (??@) cannot be demangled
+	if (name[0] == '?')
+	{
+		return !((name[1] == '?') && (name[2] == '@'));
+	}
+
+	// type names stored in RTTI type descriptors
+	return (name[0] == '.') && (name[1] == '?');
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const char* PDB::Demangler::Demangle(const char* name, Flags flags) PDB_NO_EXCEPT
+{
+	if (!IsDecoratedName(name))
+	{
+		return name;
+	}
+
+	// rewind the scratch memory of the previous name
+	m_currentChunk = m_firstChunk;
+	m_currentChunkUsed = 0u;
+	m_outputSize = 0u;
+
+	Parser parser(*this, name);
+	const Node* symbol = parser.ParseTopLevelSymbol();
+	if (parser.m_error)
+	{
+		return name;
+	}
+
+	if (((flags & Flags::NameOnly) != Flags::None) && symbol->name)
+	{
+		parser.OutputQualifiedName(symbol->name);
+	}
+	else
+	{
+		parser.OutputSymbol(symbol);
+	}
+
+	// output always leaves room for the terminator
+	parser.Output("", 0u);
+	m_output[m_outputSize] = '\0';
+
+	return m_output;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::Demangler::DemangleBatch(const char* const* names, size_t count, const char** results, DemangleArena& arena, DemangleCache* cache, Flags flags) PDB_NO_EXCEPT
+{
+	for (size_t i = 0u; i < count; ++i)
+	{
+		const char* name = names[i];
+		if (!IsDecoratedName(name))
+		{
+			results[i] = name;
+			continue;
+		}
+
+		uint32_t hash = 0u;
+		if (cache)
+		{
+			hash = HashName(name);
+
+			const char* cachedName = cache->Find(name, hash);
+			if (cachedName)
+			{
+				results[i] = cachedName;
+				continue;
+			}
+		}
+
+		const char* demangledName = Demangle(name, flags);
+		if (demangledName != name)
+		{
+			demangledName = arena.Store(demangledName, m_outputSize);
+		}
+
+		results[i] = demangledName;
+
+		if (cache)
+		{
+			cache->Insert(name, demangledName, hash);
+		}
+	}
+}
@@ -0,0 +1,140 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_BitOperators.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstddef>
+#include <cstdint>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+namespace PDB
+{
+	// Stores demangled names in large chunks of memory, so that storing a name does not allocate.
+	// Stored names never move, and stay valid until the arena is reset or destroyed.
+	class PDB_NO_DISCARD DemangleArena
+	{
+	public:
+		DemangleArena(void) PDB_NO_EXCEPT;
+		~DemangleArena(void) PDB_NO_EXCEPT;
+
+		// Copies a string of the given length into the arena, adding a null terminator.
+		PDB_NO_DISCARD const char* Store(const char* string, size_t length) PDB_NO_EXCEPT;
+
+		// Discards all stored strings, keeping the most recently allocated chunk for reuse.
+		void Reset(void) PDB_NO_EXCEPT;
+
+		// Returns the number of bytes stored in the arena, including null terminators.
+		PDB_NO_DISCARD inline size_t GetSize(void) const PDB_NO_EXCEPT
+		{
+			return m_size;
+		}
+
+	private:
+		struct Chunk;
+
+		Chunk* m_chunks;
+		size_t m_size;
+
+		PDB_DISABLE_COPY_MOVE(DemangleArena);
+	};
+
+
+	// Maps decorated names to demangled names, so that names shared by many symbols are demangled only once.
+	// Neither the decorated nor the demangled names are copied, they must outlive the cache. Decorated names
+	// usually point into a stream of the PDB, and demangled names into a DemangleArena.
+	class PDB_NO_DISCARD DemangleCache
+	{
+	public:
+		DemangleCache(void) PDB_NO_EXCEPT;
+		~DemangleCache(void) PDB_NO_EXCEPT;
+
+		// Returns the demangled name stored for a decorated name, or nullptr if the name is not in the cache.
+		PDB_NO_DISCARD const char* Find(const char* decoratedName) const PDB_NO_EXCEPT;
+
+		// Stores the demangled name for a decorated name that is not yet in the cache.
+		void Insert(const char* decoratedName, const char* demangledName) PDB_NO_EXCEPT;
+
+		// Returns the number of names in the cache.
+		PDB_NO_DISCARD inline size_t GetSize(void) const PDB_NO_EXCEPT
+		{
+			return m_entryCount;
+		}
+
+	private:
+		struct Entry
+		{
+			const char* decoratedName;
+			const char* demangledName;
+			uint32_t hash;
+		};
+
+		PDB_NO_DISCARD const char* Find(const char* decoratedName, uint32_t hash) const PDB_NO_EXCEPT;
+		void Insert(const char* decoratedName, const char* demangledName, uint32_t hash) PDB_NO_EXCEPT;
+
+		// open-addressing hash table, growing once it is half full
+		Entry* m_entries;
+		size_t m_entryMask;
+		size_t m_entryCount;
+
+		friend class Demangler;
+
+		PDB_DISABLE_COPY_MOVE(DemangleCache);
+	};
+
+
+	// Undecorates names mangled by the Microsoft Visual C++ compiler, e.g. the names of public symbols and the
+	// type names stored in RTTI descriptors, following the output of LLVM's llvm-undname.
+	// The demangler keeps its scratch memory across calls, so that demangling a name does not allocate once the
+	// scratch memory has grown large enough. A demangler must not be used by several threads at the same time.
+	class PDB_NO_DISCARD Demangler
+	{
+	public:
+		enum class PDB_NO_DISCARD Flags : uint32_t
+		{
+			None = 0u,
+
+			// only output the fully qualified name of a symbol, omitting its type, access and calling convention
+			NameOnly = 1u << 0u
+		};
+
+		Demangler(void) PDB_NO_EXCEPT;
+		~Demangler(void) PDB_NO_EXCEPT;
+
+		// Returns whether a name is decorated by the Microsoft Visual C++ compiler.
+		PDB_NO_DISCARD static bool IsDecoratedName(const char* name) PDB_NO_EXCEPT;
+
+		// Demangles a single name. The returned string is owned by the demangler and stays valid until the next call.
+		// Names that are not decorated or cannot be demangled are returned as they are.
+		PDB_NO_DISCARD const char* Demangle(const char* name, Flags flags = Flags::None) PDB_NO_EXCEPT;
+
+		// Demangles an array of names, storing the demangled names in the given arena and pointers to them in the
+		// results array. Names that are not decorated or cannot be demangled are not copied, their result points to
+		// the original name instead.
+		// If a cache is given, names that are found in the cache are not demangled again, and all other names are
+		// added to it. A cache must only be used with one set of flags.
+		void DemangleBatch(const char* const* names, size_t count, const char** results, DemangleArena& arena, DemangleCache* cache, Flags flags = Flags::None) PDB_NO_EXCEPT;
+
+	private:
+		struct Node;
+		struct NodeChunk;
+		struct Parser;
+
+		// nodes are allocated from a list of chunks that is rewound for each name
+		NodeChunk* m_firstChunk;
+		NodeChunk* m_currentChunk;
+		size_t m_currentChunkUsed;
+
+		// the output of the most recently demangled name
+		char* m_output;
+		size_t m_outputSize;
+		size_t m_outputCapacity;
+
+		PDB_DISABLE_COPY_MOVE(Demangler);
+	};
+
+	PDB_DEFINE_BIT_OPERATORS(Demangler::Flags);
+}
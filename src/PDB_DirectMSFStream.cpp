@@ -17,8 +17,8 @@ PDB::DirectMSFStream::DirectMSFStream(void) PDB_NO_EXCEPT
 	: m_data(nullptr)
 	, m_blockIndices(nullptr)
 	, m_blockSize(0u)
-	, m_size(0u)
 	, m_blockSizeLog2(0u)
+	, m_size(0u)
 {
 }
 
@@ -29,8 +29,8 @@ PDB::DirectMSFStream::DirectMSFStream(const void* data, uint32_t blockSize, cons
 	: m_data(data)
 	, m_blockIndices(blockIndices)
 	, m_blockSize(blockSize)
-	, m_size(streamSize)
 	, m_blockSizeLog2(BitUtil::FindFirstSetBit(blockSize))
+	, m_size(streamSize)
 {
 	PDB_ASSERT(BitUtil::IsPowerOfTwo(blockSize), "MSF block size must be a power of two.");
 }
@@ -74,21 +74,21 @@ void PDB::DirectMSFStream::ReadAtOffset(void* destination, size_t size, size_t o
 			++blockIndex;
 			offsetWithinData = static_cast<size_t>(m_blockIndices[blockIndex]) << m_blockSizeLog2;
 
+			// blocks that are contiguous in the file are copied at once, which mostly pays off for larger block sizes
+			size_t bytesToRead = (bytesLeftToRead > m_blockSize) ? m_blockSize : bytesLeftToRead;
+			while ((bytesToRead < bytesLeftToRead) && (m_blockIndices[blockIndex + 1u] == m_blockIndices[blockIndex] + 1u))
+			{
+				++blockIndex;
+
+				const size_t bytesLeftAfterRun = bytesLeftToRead - bytesToRead;
+				bytesToRead += (bytesLeftAfterRun > m_blockSize) ? m_blockSize : bytesLeftAfterRun;
+			}
+
 			void* const destinationData = Pointer::Offset<void*>(destination, size - bytesLeftToRead);
 			const void* const sourceData = Pointer::Offset<const void*>(m_data, offsetWithinData);
+			std::memcpy(destinationData, sourceData, bytesToRead);
 
-			if (bytesLeftToRead > m_blockSize)
-			{
-				// copy a whole block at once
-				std::memcpy(destinationData, sourceData, m_blockSize);
-				bytesLeftToRead -= m_blockSize;
-			}
-			else
-			{
-				// copy remaining bytes
-				std::memcpy(destinationData, sourceData, bytesLeftToRead);
-				bytesLeftToRead -= bytesLeftToRead;
-			}
+			bytesLeftToRead -= bytesToRead;
 		}
 	}
 }
@@ -96,11 +96,11 @@ void PDB::DirectMSFStream::ReadAtOffset(void* destination, size_t size, size_t o
 
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
-PDB_NO_DISCARD PDB::DirectMSFStream::IndexAndOffset PDB::DirectMSFStream::GetBlockIndexForOffset(uint32_t offset) const PDB_NO_EXCEPT
+PDB_NO_DISCARD PDB::DirectMSFStream::IndexAndOffset PDB::DirectMSFStream::GetBlockIndexForOffset(size_t offset) const PDB_NO_EXCEPT
 {
 	// work out which block and offset within the block the offset corresponds to
-	const uint32_t blockIndex = offset >> m_blockSizeLog2;
-	const uint32_t offsetWithinBlock = offset & (m_blockSize - 1u);
+	const uint32_t blockIndex = static_cast<uint32_t>(offset >> m_blockSizeLog2);
+	const uint32_t offsetWithinBlock = static_cast<uint32_t>(offset & (m_blockSize - 1u));
 
 	return IndexAndOffset { blockIndex, offsetWithinBlock };
 }
@@ -44,7 +44,7 @@ namespace PDB
 		}
 
 		// Returns the size of the stream.
-		PDB_NO_DISCARD inline uint32_t GetSize(void) const PDB_NO_EXCEPT
+		PDB_NO_DISCARD inline size_t GetSize(void) const PDB_NO_EXCEPT
 		{
 			return m_size;
 		}
@@ -59,7 +59,7 @@ namespace PDB
 		};
 
 		// Returns the block index and offset within the block that correspond to the given offset.
-		PDB_NO_DISCARD IndexAndOffset GetBlockIndexForOffset(uint32_t offset) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD IndexAndOffset GetBlockIndexForOffset(size_t offset) const PDB_NO_EXCEPT;
 
 		// Returns the offset into the data that corresponds to the given indices and offset within a block.
 		PDB_NO_DISCARD size_t GetDataOffsetForIndexAndOffset(const IndexAndOffset& indexAndOffset) const PDB_NO_EXCEPT;
@@ -79,9 +79,11 @@ namespace PDB
 		const void* m_data;
 		const uint32_t* m_blockIndices;
 		uint32_t m_blockSize;
-		uint32_t m_size;
 		uint32_t m_blockSizeLog2;
 
+		// offsets into the memory-mapped data can exceed 4 GiB for large PDBs, so all offset math is done in size_t
+		size_t m_size;
+
 		PDB_DISABLE_COPY(DirectMSFStream);
 	};
 }
@@ -20,6 +20,9 @@ namespace PDB
 		InvalidStream,
 		InvalidSignature,
 		InvalidStreamIndex,
-		UnknownVersion
+		UnknownVersion,
+
+		// loading files
+		ReadError
 	};
 }
@@ -0,0 +1,26 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_FPOStream.h"
+#include "PDB_RawFile.h"
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FPOStream::FPOStream(void) PDB_NO_EXCEPT
+	: m_stream()
+	, m_fpoData(nullptr)
+	, m_count(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FPOStream::FPOStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT
+	: m_stream(file.CreateMSFStream<CoalescedMSFStream>(streamIndex))
+	, m_fpoData(m_stream.GetDataAtOffset<DBI::FPOData>(0u))
+	, m_count(m_stream.GetSize() / sizeof(DBI::FPOData))
+{
+}
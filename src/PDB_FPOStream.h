@@ -0,0 +1,40 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_DBITypes.h"
+#include "PDB_CoalescedMSFStream.h"
+
+
+namespace PDB
+{
+	class RawFile;
+
+
+	// A view of the frame pointer omission data of x86 images (FPO_DATA), as stored in the FPO debug stream.
+	// Only older toolchains describe stack frames this way, newer ones use the new FPO stream instead.
+	class PDB_NO_DISCARD FPOStream
+	{
+	public:
+		FPOStream(void) PDB_NO_EXCEPT;
+		explicit FPOStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT;
+
+		PDB_DEFAULT_MOVE(FPOStream);
+
+		// Returns a view of all entries in the stream, in the order they were written by the linker.
+		PDB_NO_DISCARD inline ArrayView<DBI::FPOData> GetFPOData(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<DBI::FPOData>(m_fpoData, m_count);
+		}
+
+	private:
+		CoalescedMSFStream m_stream;
+		const DBI::FPOData* m_fpoData;
+		size_t m_count;
+
+		PDB_DISABLE_COPY(FPOStream);
+	};
+}
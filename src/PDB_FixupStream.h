@@ -0,0 +1,40 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_DBITypes.h"
+#include "PDB_CoalescedMSFStream.h"
+
+
+namespace PDB
+{
+	class RawFile;
+
+
+	// A view of the fixups the linker applied to the image, as stored in the fixup debug stream.
+	// Tools that rebase or rearrange an image use them to find all locations referring to other parts of the image.
+	class PDB_NO_DISCARD FixupStream
+	{
+	public:
+		FixupStream(void) PDB_NO_EXCEPT;
+		explicit FixupStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT;
+
+		PDB_DEFAULT_MOVE(FixupStream);
+
+		// Returns a view of all fixups in the stream, in the order they were written by the linker.
+		PDB_NO_DISCARD inline ArrayView<DBI::FixupData> GetFixups(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<DBI::FixupData>(m_fixups, m_count);
+		}
+
+	private:
+		CoalescedMSFStream m_stream;
+		const DBI::FixupData* m_fixups;
+		size_t m_count;
+
+		PDB_DISABLE_COPY(FixupStream);
+	};
+}
@@ -0,0 +1,36 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_FrameDataStream.h"
+#include "PDB_RawFile.h"
+
+
+namespace
+{
+	// the linker stores the RVA the frame data was relocated to in front of the entries, unless the stream only consists of entries
+	PDB_NO_DISCARD static size_t GetFrameDataOffset(size_t streamSize) PDB_NO_EXCEPT
+	{
+		return (((streamSize % sizeof(PDB::DBI::FrameData)) != 0u) && (streamSize >= sizeof(uint32_t))) ? sizeof(uint32_t) : 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FrameDataStream::FrameDataStream(void) PDB_NO_EXCEPT
+	: m_stream()
+	, m_frameData(nullptr)
+	, m_count(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FrameDataStream::FrameDataStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT
+	: m_stream(file.CreateMSFStream<CoalescedMSFStream>(streamIndex))
+	, m_frameData(m_stream.GetDataAtOffset<DBI::FrameData>(GetFrameDataOffset(m_stream.GetSize())))
+	, m_count((m_stream.GetSize() - GetFrameDataOffset(m_stream.GetSize())) / sizeof(DBI::FrameData))
+{
+}
@@ -0,0 +1,40 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_DBITypes.h"
+#include "PDB_CoalescedMSFStream.h"
+
+
+namespace PDB
+{
+	class RawFile;
+
+
+	// A view of the frame data of x86 images (FRAMEDATA), as stored in the new FPO debug stream.
+	// Each entry describes how to unwind a range of code using a program string stored in the /names stream.
+	class PDB_NO_DISCARD FrameDataStream
+	{
+	public:
+		FrameDataStream(void) PDB_NO_EXCEPT;
+		explicit FrameDataStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT;
+
+		PDB_DEFAULT_MOVE(FrameDataStream);
+
+		// Returns a view of all entries in the stream, in the order they were written by the linker.
+		PDB_NO_DISCARD inline ArrayView<DBI::FrameData> GetFrameData(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<DBI::FrameData>(m_frameData, m_count);
+		}
+
+	private:
+		CoalescedMSFStream m_stream;
+		const DBI::FrameData* m_frameData;
+		size_t m_count;
+
+		PDB_DISABLE_COPY(FrameDataStream);
+	};
+}
@@ -0,0 +1,326 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_FunctionIndex.h"
+#include "PDB_IndexImage.h"
+#include "PDB_RawFile.h"
+#include "PDB_ImageSectionStream.h"
+#include "PDB_ModuleInfoStream.h"
+#include "PDB_ModuleSymbolStream.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	struct SeparatedCode
+	{
+		uint32_t rva;
+		uint32_t size;
+		uint32_t parentRVA;
+	};
+
+
+	PDB_NO_DISCARD static bool IsProcedure(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return (kind == SymbolRecordKind::S_LPROC32) || (kind == SymbolRecordKind::S_GPROC32) ||
+			(kind == SymbolRecordKind::S_LPROC32_ID) || (kind == SymbolRecordKind::S_GPROC32_ID) ||
+			(kind == SymbolRecordKind::S_LPROC32_DPC) || (kind == SymbolRecordKind::S_LPROC32_DPC_ID);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FunctionIndex::FunctionIndex(void) PDB_NO_EXCEPT
+	: m_functions(nullptr)
+	, m_functionCount(0u)
+	, m_codeRangeRVAs(nullptr)
+	, m_codeRanges(nullptr)
+	, m_codeRangeCount(0u)
+	, m_names(nullptr)
+	, m_namesSize(0u)
+	, m_ownsData(true)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FunctionIndex::FunctionIndex(FunctionIndex&& other) PDB_NO_EXCEPT
+	: m_functions(PDB_MOVE(other.m_functions))
+	, m_functionCount(PDB_MOVE(other.m_functionCount))
+	, m_codeRangeRVAs(PDB_MOVE(other.m_codeRangeRVAs))
+	, m_codeRanges(PDB_MOVE(other.m_codeRanges))
+	, m_codeRangeCount(PDB_MOVE(other.m_codeRangeCount))
+	, m_names(PDB_MOVE(other.m_names))
+	, m_namesSize(PDB_MOVE(other.m_namesSize))
+	, m_ownsData(PDB_MOVE(other.m_ownsData))
+{
+	other.m_functions = nullptr;
+	other.m_functionCount = 0u;
+	other.m_codeRangeRVAs = nullptr;
+	other.m_codeRanges = nullptr;
+	other.m_codeRangeCount = 0u;
+	other.m_names = nullptr;
+	other.m_namesSize = 0u;
+	other.m_ownsData = true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FunctionIndex& PDB::FunctionIndex::operator=(FunctionIndex&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		if (m_ownsData)
+		{
+			PDB_DELETE_ARRAY(m_functions);
+			PDB_DELETE_ARRAY(m_codeRangeRVAs);
+			PDB_DELETE_ARRAY(m_codeRanges);
+			PDB_DELETE_ARRAY(m_names);
+		}
+
+		m_functions = PDB_MOVE(other.m_functions);
+		m_functionCount = PDB_MOVE(other.m_functionCount);
+		m_codeRangeRVAs = PDB_MOVE(other.m_codeRangeRVAs);
+		m_codeRanges = PDB_MOVE(other.m_codeRanges);
+		m_codeRangeCount = PDB_MOVE(other.m_codeRangeCount);
+		m_names = PDB_MOVE(other.m_names);
+		m_namesSize = PDB_MOVE(other.m_namesSize);
+		m_ownsData = PDB_MOVE(other.m_ownsData);
+
+		other.m_functions = nullptr;
+		other.m_functionCount = 0u;
+		other.m_codeRangeRVAs = nullptr;
+		other.m_codeRanges = nullptr;
+		other.m_codeRangeCount = 0u;
+		other.m_names = nullptr;
+		other.m_namesSize = 0u;
+		other.m_ownsData = true;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FunctionIndex::FunctionIndex(const RawFile& file, const ImageSectionStream& imageSectionStream, const ModuleInfoStream& moduleInfoStream) PDB_NO_EXCEPT
+	: m_functions(nullptr)
+	, m_functionCount(0u)
+	, m_codeRangeRVAs(nullptr)
+	, m_codeRanges(nullptr)
+	, m_codeRangeCount(0u)
+	, m_names(nullptr)
+	, m_namesSize(0u)
+	, m_ownsData(true)
+{
+	GrowableArray<Function> functionArray;
+	GrowableArray<SeparatedCode> separatedCodeArray;
+	GrowableArray<char> nameArray;
+
+	const ArrayView<ModuleInfoStream::Module> modules = moduleInfoStream.GetModules();
+	for (size_t moduleIndex = 0u; moduleIndex < modules.GetLength(); ++moduleIndex)
+	{
+		const ModuleInfoStream::Module& module = modules[moduleIndex];
+		if (!module.HasSymbolStream())
+		{
+			continue;
+		}
+
+		const ModuleSymbolStream moduleSymbolStream = module.CreateSymbolStream(file);
+		for (ModuleSymbolStream::SymbolIterator it = moduleSymbolStream.GetSymbols().begin(), end = moduleSymbolStream.GetSymbols().end(); it != end; ++it)
+		{
+			const CodeView::DBI::Record* record = *it;
+			const CodeView::DBI::SymbolRecordKind kind = record->header.kind;
+
+			if (IsProcedure(kind))
+			{
+				// all procedure record kinds share the same layout
+				const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_GPROC32.section, record->data.S_GPROC32.offset);
+				if (rva == 0u)
+				{
+					continue;
+				}
+
+				const char* name = record->data.S_GPROC32.name;
+				const size_t nameOffset = nameArray.Append(name, std::strlen(name) + 1u);
+				functionArray.Add(Function { rva, record->data.S_GPROC32.codeSize, static_cast<uint32_t>(nameOffset), static_cast<uint32_t>(moduleIndex), it.GetOffset(), kind, false });
+			}
+			else if (kind == CodeView::DBI::SymbolRecordKind::S_SEPCODE)
+			{
+				const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_SEPCODE.section, record->data.S_SEPCODE.offset);
+				const uint32_t parentRVA = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_SEPCODE.parentSection, record->data.S_SEPCODE.parentOffset);
+				if ((rva == 0u) || (parentRVA == 0u))
+				{
+					continue;
+				}
+
+				separatedCodeArray.Add(SeparatedCode { rva, record->data.S_SEPCODE.length, parentRVA });
+			}
+		}
+	}
+
+	m_functionCount = functionArray.GetSize();
+	m_namesSize = nameArray.GetSize();
+	m_names = nameArray.Release();
+
+	// sort functions by RVA, and remove functions that were folded into the same code by the linker.
+	// the remaining function remembers that it was folded, unless all others are the same function found in other modules.
+	Function* functions = functionArray.Release();
+	Algorithm::Sort(functions, functions + m_functionCount, [](const Function& lhs, const Function& rhs)
+	{
+		return lhs.rva < rhs.rva;
+	});
+
+	size_t uniqueCount = 0u;
+	for (size_t i = 0u; i < m_functionCount; ++i)
+	{
+		if ((uniqueCount != 0u) && (functions[uniqueCount - 1u].rva == functions[i].rva))
+		{
+			Function& function = functions[uniqueCount - 1u];
+			function.isFolded |= (std::strcmp(&m_names[function.nameOffset], &m_names[functions[i].nameOffset]) != 0);
+			continue;
+		}
+
+		functions[uniqueCount++] = functions[i];
+	}
+
+	m_functions = functions;
+	m_functionCount = uniqueCount;
+
+	uint32_t* functionRVAs = PDB_NEW_ARRAY(uint32_t, m_functionCount);
+	for (size_t i = 0u; i < m_functionCount; ++i)
+	{
+		functionRVAs[i] = m_functions[i].rva;
+	}
+
+	// every function contributes its main part, every separated code block is attributed to the function starting at its parent's RVA
+	const size_t separatedCodeCount = separatedCodeArray.GetSize();
+	const SeparatedCode* separatedCode = separatedCodeArray.GetData();
+
+	CodeRange* codeRanges = PDB_NEW_ARRAY(CodeRange, m_functionCount + separatedCodeCount);
+	size_t codeRangeCount = 0u;
+	for (size_t i = 0u; i < m_functionCount; ++i)
+	{
+		codeRanges[codeRangeCount++] = CodeRange { m_functions[i].rva, m_functions[i].size, static_cast<uint32_t>(i), m_functions[i].kind };
+	}
+
+	for (size_t i = 0u; i < separatedCodeCount; ++i)
+	{
+		const size_t functionIndex = Algorithm::LowerBound(functionRVAs, m_functionCount, separatedCode[i].parentRVA);
+		if ((functionIndex == m_functionCount) || (functionRVAs[functionIndex] != separatedCode[i].parentRVA))
+		{
+			// the parent procedure is unknown, nothing to attribute the code to
+			continue;
+		}
+
+		codeRanges[codeRangeCount++] = CodeRange { separatedCode[i].rva, separatedCode[i].size, static_cast<uint32_t>(functionIndex), CodeView::DBI::SymbolRecordKind::S_SEPCODE };
+	}
+
+	PDB_DELETE_ARRAY(functionRVAs);
+
+	Algorithm::Sort(codeRanges, codeRanges + codeRangeCount, [](const CodeRange& lhs, const CodeRange& rhs)
+	{
+		return lhs.rva < rhs.rva;
+	});
+
+	// separated code repeated in several modules ends up at the same RVA
+	uniqueCount = 0u;
+	for (size_t i = 0u; i < codeRangeCount; ++i)
+	{
+		if ((uniqueCount != 0u) && (codeRanges[uniqueCount - 1u].rva == codeRanges[i].rva))
+		{
+			continue;
+		}
+
+		codeRanges[uniqueCount++] = codeRanges[i];
+	}
+
+	m_codeRanges = codeRanges;
+	m_codeRangeCount = uniqueCount;
+
+	uint32_t* codeRangeRVAs = PDB_NEW_ARRAY(uint32_t, m_codeRangeCount);
+	for (size_t i = 0u; i < m_codeRangeCount; ++i)
+	{
+		codeRangeRVAs[i] = m_codeRanges[i].rva;
+	}
+
+	m_codeRangeRVAs = codeRangeRVAs;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FunctionIndex::FunctionIndex(IndexImageReader& reader) PDB_NO_EXCEPT
+	: m_functions(nullptr)
+	, m_functionCount(0u)
+	, m_codeRangeRVAs(nullptr)
+	, m_codeRanges(nullptr)
+	, m_codeRangeCount(0u)
+	, m_names(nullptr)
+	, m_namesSize(0u)
+	, m_ownsData(false)
+{
+	size_t codeRangeRVACount = 0u;
+	m_functions = reader.ReadArray<Function>(m_functionCount);
+	m_codeRangeRVAs = reader.ReadArray<uint32_t>(codeRangeRVACount);
+	m_codeRanges = reader.ReadArray<CodeRange>(m_codeRangeCount);
+	m_names = reader.ReadArray<char>(m_namesSize);
+
+	if (!reader.IsValid() || (codeRangeRVACount != m_codeRangeCount))
+	{
+		// code ranges are found through their RVAs and refer to functions by index, so neither can be used if any array is
+		// truncated or the RVAs don't match the code ranges.
+		m_functionCount = 0u;
+		m_codeRangeCount = 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::FunctionIndex::~FunctionIndex(void) PDB_NO_EXCEPT
+{
+	if (m_ownsData)
+	{
+		PDB_DELETE_ARRAY(m_functions);
+		PDB_DELETE_ARRAY(m_codeRangeRVAs);
+		PDB_DELETE_ARRAY(m_codeRanges);
+		PDB_DELETE_ARRAY(m_names);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::FunctionIndex::Serialize(IndexImageWriter& writer) const PDB_NO_EXCEPT
+{
+	writer.WriteArray(m_functions, m_functionCount);
+	writer.WriteArray(m_codeRangeRVAs, m_codeRangeCount);
+	writer.WriteArray(m_codeRanges, m_codeRangeCount);
+	writer.WriteArray(m_names, m_namesSize);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::FunctionIndex::CodeRange* PDB::FunctionIndex::FindCodeRange(uint32_t rva) const PDB_NO_EXCEPT
+{
+	// find the last code range starting at or before the RVA. code ranges never overlap.
+	const size_t index = Algorithm::UpperBound(m_codeRangeRVAs, m_codeRangeCount, rva);
+	if (index == 0u)
+	{
+		return nullptr;
+	}
+
+	const CodeRange& codeRange = m_codeRanges[index - 1u];
+	const uint32_t size = (codeRange.size == 0u) ? 1u : codeRange.size;
+	return (rva - codeRange.rva < size) ? &codeRange : nullptr;
+}
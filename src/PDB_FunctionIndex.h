@@ -0,0 +1,113 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_DBITypes.h"
+
+
+namespace PDB
+{
+	class RawFile;
+	class ImageSectionStream;
+	class ModuleInfoStream;
+	class IndexImageWriter;
+	class IndexImageReader;
+
+
+	// An index of all procedures in the module symbol streams, answering "which function contains this RVA?" with a single
+	// binary search over a tightly packed array of RVAs.
+	// Functions that were split into several parts (e.g. hot/cold splitting in PGO builds) store each separated part in an
+	// S_SEPCODE record. Every such part is stored as a code range of its own that maps back to its parent function, so that
+	// addresses in cold code resolve to the function they belong to instead of the function located in front of them.
+	// Once built, the index is immutable and can be queried from several threads.
+	class PDB_NO_DISCARD FunctionIndex
+	{
+	public:
+		struct Function
+		{
+			uint32_t rva;
+			uint32_t size;										// size of the function's main part, excluding separated code
+			uint32_t nameOffset;								// offset of the name, use GetName() to retrieve it
+			uint32_t moduleIndex;
+			uint32_t recordOffset;								// offset of the S_*PROC32* record in the module symbol stream
+			CodeView::DBI::SymbolRecordKind kind;
+			bool isFolded;										// true if the linker folded other functions into the same code
+		};
+
+		struct CodeRange
+		{
+			uint32_t rva;
+			uint32_t size;
+			uint32_t functionIndex;								// index of the function the code belongs to
+			CodeView::DBI::SymbolRecordKind kind;				// S_SEPCODE for separated code, the kind of the procedure record otherwise
+		};
+
+		FunctionIndex(void) PDB_NO_EXCEPT;
+		FunctionIndex(FunctionIndex&& other) PDB_NO_EXCEPT;
+		FunctionIndex& operator=(FunctionIndex&& other) PDB_NO_EXCEPT;
+
+		explicit FunctionIndex(const RawFile& file, const ImageSectionStream& imageSectionStream, const ModuleInfoStream& moduleInfoStream) PDB_NO_EXCEPT;
+
+		// Creates an index referring to serialized data, see IndexImage. The data must outlive the index.
+		explicit FunctionIndex(IndexImageReader& reader) PDB_NO_EXCEPT;
+		~FunctionIndex(void) PDB_NO_EXCEPT;
+
+		// Serializes the index into a position-independent layout, see IndexImage.
+		void Serialize(IndexImageWriter& writer) const PDB_NO_EXCEPT;
+
+		// Returns the code range containing the given RVA, or nullptr if there is none.
+		PDB_NO_DISCARD const CodeRange* FindCodeRange(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the function containing the given RVA, including its separated code, or nullptr if there is none.
+		PDB_NO_DISCARD inline const Function* FindFunction(uint32_t rva) const PDB_NO_EXCEPT
+		{
+			const CodeRange* codeRange = FindCodeRange(rva);
+			return codeRange ? &m_functions[codeRange->functionIndex] : nullptr;
+		}
+
+		// Returns the function a code range belongs to.
+		PDB_NO_DISCARD inline const Function& GetFunction(const CodeRange& codeRange) const PDB_NO_EXCEPT
+		{
+			return m_functions[codeRange.functionIndex];
+		}
+
+		// Returns the name of the given function.
+		PDB_NO_DISCARD inline const char* GetName(const Function& function) const PDB_NO_EXCEPT
+		{
+			return &m_names[function.nameOffset];
+		}
+
+		// Returns a view of all functions, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<Function> GetFunctions(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Function>(m_functions, m_functionCount);
+		}
+
+		// Returns a view of all code ranges, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<CodeRange> GetCodeRanges(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<CodeRange>(m_codeRanges, m_codeRangeCount);
+		}
+
+	private:
+		const Function* m_functions;
+		size_t m_functionCount;
+
+		// the RVAs are stored separately from the code ranges so that the binary search touches as few cache lines as possible
+		const uint32_t* m_codeRangeRVAs;
+		const CodeRange* m_codeRanges;
+		size_t m_codeRangeCount;
+
+		// names of all functions, copied because module symbol streams are only alive while the index is built
+		const char* m_names;
+		size_t m_namesSize;
+
+		// indices referring to serialized data don't own any memory
+		bool m_ownsData;
+
+		PDB_DISABLE_COPY(FunctionIndex);
+	};
+}
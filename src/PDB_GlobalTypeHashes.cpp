@@ -0,0 +1,500 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_GlobalTypeHashes.h"
+#include "PDB_TypeTable.h"
+#include "PDB_IPIStream.h"
+#include "PDB_TypeReferences.h"
+#include "PDB_Types.h"
+#include "Foundation/PDB_CPU.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	// records are gathered and hashed in chunks, depths with fewer records are hashed without going through the parallel loop
+	static constexpr const uint32_t RecordsPerJob = 4096u;
+
+	// the hash consumes stripes of 32 bytes in four independent 64-bit lanes, so that the lanes can be processed in a single AVX2 register
+	static constexpr const size_t StripeSize = 32u;
+	static constexpr const size_t LaneCount = 4u;
+
+	static constexpr const uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+	static constexpr const uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+	static constexpr const uint64_t Prime3 = 0x165667B19E3779F9ull;
+
+	// each stripe uses different keys, so that swapping stripes changes the hash
+	static constexpr const uint64_t StripeKeyStep = 0x27D4EB2F165667C5ull;
+	alignas(32) static const uint64_t LaneKeys[LaneCount] = { 0x1CAD21F72C81017Cull, 0xDB979083E96DD4DEull, 0x1F67B3B7A4A44072ull, 0x78E5C0CC4EE679CBull };
+	alignas(32) static const uint64_t InitialAccumulators[LaneCount] = { Prime3, Prime2, Prime1, Prime3 ^ Prime2 };
+
+	typedef void (*AccumulateFunction)(uint64_t* accumulators, const PDB::Byte* data, size_t stripeCount);
+
+
+	struct GatherContext
+	{
+		const PDB::Byte* const* records;
+		size_t recordCount;
+		uint32_t indexBegin;
+		bool isIdStream;
+		uint32_t* referenceEnds;							// end of the references of each record in the references of its job
+		PDB::GrowableArray<uint32_t>* jobReferences;		// positions of the records referenced from within the same stream
+	};
+
+	struct HashContext
+	{
+		const PDB::Byte* const* records;
+		size_t recordCount;
+		uint32_t indexBegin;
+		bool isIdStream;
+		const uint32_t* order;								// positions of all records, ordered by depth
+		size_t first;										// first and number of records of the current depth in the order
+		size_t count;
+		uint64_t* hashes;
+		const uint64_t* typeHashes;							// hashes of the TPI records referenced by IPI records
+		size_t typeCount;
+		uint32_t typeIndexBegin;
+		AccumulateFunction accumulate;
+	};
+
+
+	PDB_NO_DISCARD static inline uint64_t ReadUInt64(const PDB::Byte* data) PDB_NO_EXCEPT
+	{
+		uint64_t value = 0u;
+		std::memcpy(&value, data, sizeof(value));
+
+		return value;
+	}
+
+
+	// the finalizer of MurmurHash3
+	PDB_NO_DISCARD static inline uint64_t Mix(uint64_t value) PDB_NO_EXCEPT
+	{
+		value ^= value >> 33u;
+		value *= 0xFF51AFD7ED558CCDull;
+		value ^= value >> 33u;
+		value *= 0xC4CEB9FE1A85EC53ull;
+		value ^= value >> 33u;
+
+		return value;
+	}
+
+
+	// Each lane adds the product of the lower and upper half of its keyed data, and its unkeyed data to the neighbouring lane.
+	static void AccumulateScalar(uint64_t* accumulators, const PDB::Byte* data, size_t stripeCount) PDB_NO_EXCEPT
+	{
+		for (size_t stripe = 0u; stripe < stripeCount; ++stripe)
+		{
+			const uint64_t stripeKey = static_cast<uint64_t>(stripe) * StripeKeyStep;
+			for (size_t lane = 0u; lane < LaneCount; ++lane)
+			{
+				const uint64_t value = ReadUInt64(data + stripe * StripeSize + lane * sizeof(uint64_t));
+				const uint64_t keyed = value ^ (LaneKeys[lane] + stripeKey);
+				accumulators[lane] += (keyed & 0xFFFFFFFFull) * (keyed >> 32u);
+				accumulators[lane ^ 1u] += value;
+			}
+		}
+	}
+
+
+#if PDB_ARCH_X64
+	PDB_TARGET_AVX2 static void AccumulateAVX2(uint64_t* accumulators, const PDB::Byte* data, size_t stripeCount) PDB_NO_EXCEPT
+	{
+		__m256i accumulator = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulators));
+		__m256i keys = _mm256_load_si256(reinterpret_cast<const __m256i*>(LaneKeys));
+		const __m256i keyStep = _mm256_set1_epi64x(static_cast<long long>(StripeKeyStep));
+
+		for (size_t stripe = 0u; stripe < stripeCount; ++stripe)
+		{
+			const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + stripe * StripeSize));
+			const __m256i keyed = _mm256_xor_si256(value, keys);
+
+			// multiplies the lower 32 bits of both operands, and swaps the 64-bit lanes of each 128-bit half
+			const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+			const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+			accumulator = _mm256_add_epi64(accumulator, _mm256_add_epi64(product, swapped));
+
+			keys = _mm256_add_epi64(keys, keyStep);
+		}
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulators), accumulator);
+	}
+#endif
+
+
+	PDB_NO_DISCARD static AccumulateFunction SelectAccumulateFunction(void) PDB_NO_EXCEPT
+	{
+#if PDB_ARCH_X64
+		if (PDB::CPU::SupportsAVX2())
+		{
+			return &AccumulateAVX2;
+		}
+#endif
+
+		return &AccumulateScalar;
+	}
+
+
+	PDB_NO_DISCARD static uint64_t HashBytes(const PDB::Byte* data, size_t size, AccumulateFunction accumulate) PDB_NO_EXCEPT
+	{
+		uint64_t hash = static_cast<uint64_t>(size) * Prime1;
+
+		// most records are shorter than a single stripe
+		const size_t stripeCount = size / StripeSize;
+		if (stripeCount != 0u)
+		{
+			uint64_t accumulators[LaneCount] = { InitialAccumulators[0], InitialAccumulators[1], InitialAccumulators[2], InitialAccumulators[3] };
+			accumulate(accumulators, data, stripeCount);
+
+			for (size_t lane = 0u; lane < LaneCount; ++lane)
+			{
+				hash = Mix(hash ^ Mix(accumulators[lane]));
+			}
+		}
+
+		size_t offset = stripeCount * StripeSize;
+		for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t))
+		{
+			hash = Mix(hash ^ (ReadUInt64(data + offset) * Prime2));
+		}
+
+		if (offset != size)
+		{
+			uint64_t value = 0u;
+			std::memcpy(&value, data + offset, size - offset);
+			hash = Mix(hash ^ (value * Prime3));
+		}
+
+		return hash;
+	}
+
+
+	static void GetReferences(const PDB::Byte* record, bool isIdStream, PDB::GrowableArray<PDB::TypeReference>& references) PDB_NO_EXCEPT
+	{
+		if (isIdStream)
+		{
+			PDB::GetTypeReferences(reinterpret_cast<const PDB::CodeView::IPI::Record*>(record), references);
+		}
+		else
+		{
+			PDB::GetTypeReferences(reinterpret_cast<const PDB::CodeView::TPI::Record*>(record), references);
+		}
+	}
+
+
+	PDB_NO_DISCARD static inline uint32_t ReadTypeIndex(const PDB::Byte* record, const PDB::TypeReference& reference) PDB_NO_EXCEPT
+	{
+		uint32_t typeIndex = 0u;
+		std::memcpy(&typeIndex, record + reference.offset, sizeof(typeIndex));
+
+		return typeIndex;
+	}
+
+
+	// Gathers the records referenced by a chunk of records from within the same stream. Only records with a lower index can be referenced.
+	static void GatherReferencesJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const GatherContext& context = *static_cast<const GatherContext*>(jobData);
+		PDB::GrowableArray<uint32_t>& jobReferences = context.jobReferences[index];
+		PDB::GrowableArray<PDB::TypeReference> references;
+
+		const PDB::TypeReference::Kind ownKind = context.isIdStream ? PDB::TypeReference::Kind::Id : PDB::TypeReference::Kind::Type;
+		const size_t first = static_cast<size_t>(index) * RecordsPerJob;
+		const size_t last = (first + RecordsPerJob < context.recordCount) ? first + RecordsPerJob : context.recordCount;
+		for (size_t position = first; position < last; ++position)
+		{
+			const PDB::Byte* record = context.records[position];
+			if (record)
+			{
+				references.Clear();
+				GetReferences(record, context.isIdStream, references);
+
+				const PDB::TypeReference* recordReferences = references.GetData();
+				for (size_t i = 0u; i < references.GetSize(); ++i)
+				{
+					const uint32_t typeIndex = ReadTypeIndex(record, recordReferences[i]);
+					if ((recordReferences[i].kind == ownKind) && (typeIndex >= context.indexBegin) && (typeIndex - context.indexBegin < position))
+					{
+						jobReferences.Add(typeIndex - context.indexBegin);
+					}
+				}
+			}
+
+			context.referenceEnds[position] = static_cast<uint32_t>(jobReferences.GetSize());
+		}
+	}
+
+
+	// Hashes a chunk of records of the same depth, all of whose references have already been hashed.
+	static void HashRecordsJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const HashContext& context = *static_cast<const HashContext*>(jobData);
+		PDB::GrowableArray<PDB::TypeReference> references;
+		PDB::GrowableArray<PDB::Byte> buffer;
+
+		const PDB::TypeReference::Kind ownKind = context.isIdStream ? PDB::TypeReference::Kind::Id : PDB::TypeReference::Kind::Type;
+		const size_t first = static_cast<size_t>(index) * RecordsPerJob;
+		const size_t last = (first + RecordsPerJob < context.count) ? first + RecordsPerJob : context.count;
+		for (size_t i = first; i < last; ++i)
+		{
+			const uint32_t position = context.order[context.first + i];
+			const PDB::Byte* record = context.records[position];
+			if (!record)
+			{
+				context.hashes[position] = 0u;
+				continue;
+			}
+
+			references.Clear();
+			GetReferences(record, context.isIdStream, references);
+
+			// hash the kind and data of the record, replacing each type index with the hash of the referenced record.
+			// type indices that cannot be resolved, e.g. of simple types, are hashed as they are.
+			uint16_t recordSize = 0u;
+			std::memcpy(&recordSize, record, sizeof(recordSize));
+			const uint32_t recordEnd = static_cast<uint32_t>(recordSize) + sizeof(uint16_t);
+
+			buffer.Clear();
+			uint32_t offset = sizeof(uint16_t);
+			const PDB::TypeReference* recordReferences = references.GetData();
+			for (size_t j = 0u; j < references.GetSize(); ++j)
+			{
+				const PDB::TypeReference& reference = recordReferences[j];
+				const uint32_t typeIndex = ReadTypeIndex(record, reference);
+
+				uint64_t hash = typeIndex;
+				if (reference.kind == ownKind)
+				{
+					if ((typeIndex >= context.indexBegin) && (typeIndex - context.indexBegin < position))
+					{
+						hash = context.hashes[typeIndex - context.indexBegin];
+					}
+				}
+				else if ((typeIndex >= context.typeIndexBegin) && (typeIndex - context.typeIndexBegin < context.typeCount))
+				{
+					hash = context.typeHashes[typeIndex - context.typeIndexBegin];
+				}
+
+				buffer.Append(record + offset, reference.offset - offset);
+				buffer.Append(reinterpret_cast<const PDB::Byte*>(&hash), sizeof(hash));
+				offset = reference.offset + sizeof(uint32_t);
+			}
+
+			buffer.Append(record + offset, recordEnd - offset);
+			context.hashes[position] = HashBytes(buffer.GetData(), buffer.GetSize(), context.accumulate);
+		}
+	}
+
+
+	// Hashes all records of a stream, bottom-up by their depth in the graph of references.
+	static void HashStream(HashContext& context, PDB::ParallelForFunction parallelFor, void* userData) PDB_NO_EXCEPT
+	{
+		const size_t recordCount = context.recordCount;
+		if (recordCount == 0u)
+		{
+			return;
+		}
+
+		// gather the references of all records in parallel
+		const uint32_t jobCount = static_cast<uint32_t>((recordCount + RecordsPerJob - 1u) / RecordsPerJob);
+		uint32_t* referenceEnds = PDB_NEW_ARRAY(uint32_t, recordCount);
+		PDB::GrowableArray<uint32_t>* jobReferences = PDB_NEW_ARRAY(PDB::GrowableArray<uint32_t>, jobCount);
+		{
+			GatherContext gatherContext = { context.records, recordCount, context.indexBegin, context.isIdStream, referenceEnds, jobReferences };
+			PDB::ParallelFor(parallelFor, userData, jobCount, &GatherReferencesJob, &gatherContext);
+		}
+
+		// the depth of a record is one more than the largest depth of the records it references
+		uint32_t* depths = PDB_NEW_ARRAY(uint32_t, recordCount);
+		uint32_t maxDepth = 0u;
+		for (uint32_t job = 0u; job < jobCount; ++job)
+		{
+			const uint32_t* references = jobReferences[job].GetData();
+			uint32_t referenceBegin = 0u;
+
+			const size_t first = static_cast<size_t>(job) * RecordsPerJob;
+			const size_t last = (first + RecordsPerJob < recordCount) ? first + RecordsPerJob : recordCount;
+			for (size_t position = first; position < last; ++position)
+			{
+				uint32_t depth = 0u;
+				for (uint32_t i = referenceBegin; i < referenceEnds[position]; ++i)
+				{
+					const uint32_t referencedDepth = depths[references[i]] + 1u;
+					depth = (referencedDepth > depth) ? referencedDepth : depth;
+				}
+
+				depths[position] = depth;
+				maxDepth = (depth > maxDepth) ? depth : maxDepth;
+				referenceBegin = referenceEnds[position];
+			}
+		}
+
+		PDB_DELETE_ARRAY(jobReferences);
+		PDB_DELETE_ARRAY(referenceEnds);
+
+		// order the records by depth using a counting sort
+		size_t* depthOffsets = PDB_NEW_ARRAY(size_t, maxDepth + 2u);
+		std::memset(depthOffsets, 0, (maxDepth + 2u) * sizeof(size_t));
+		for (size_t position = 0u; position < recordCount; ++position)
+		{
+			++depthOffsets[depths[position] + 1u];
+		}
+
+		for (uint32_t depth = 0u; depth <= maxDepth; ++depth)
+		{
+			depthOffsets[depth + 1u] += depthOffsets[depth];
+		}
+
+		uint32_t* order = PDB_NEW_ARRAY(uint32_t, recordCount);
+		{
+			size_t* nextOffsets = PDB_NEW_ARRAY(size_t, maxDepth + 1u);
+			std::memcpy(nextOffsets, depthOffsets, (maxDepth + 1u) * sizeof(size_t));
+			for (size_t position = 0u; position < recordCount; ++position)
+			{
+				order[nextOffsets[depths[position]]++] = static_cast<uint32_t>(position);
+			}
+
+			PDB_DELETE_ARRAY(nextOffsets);
+		}
+
+		PDB_DELETE_ARRAY(depths);
+
+		// all records of the same depth only reference records of lower depths, and can be hashed in parallel
+		context.order = order;
+		for (uint32_t depth = 0u; depth <= maxDepth; ++depth)
+		{
+			context.first = depthOffsets[depth];
+			context.count = depthOffsets[depth + 1u] - depthOffsets[depth];
+
+			const uint32_t depthJobCount = static_cast<uint32_t>((context.count + RecordsPerJob - 1u) / RecordsPerJob);
+			PDB::ParallelFor(parallelFor, userData, depthJobCount, &HashRecordsJob, &context);
+		}
+
+		context.order = nullptr;
+
+		PDB_DELETE_ARRAY(order);
+		PDB_DELETE_ARRAY(depthOffsets);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::GlobalTypeHashes::GlobalTypeHashes(void) PDB_NO_EXCEPT
+	: m_typeHashes(nullptr)
+	, m_typeCount(0u)
+	, m_typeIndexBegin(0u)
+	, m_idHashes(nullptr)
+	, m_idCount(0u)
+	, m_idIndexBegin(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::GlobalTypeHashes::GlobalTypeHashes(GlobalTypeHashes&& other) PDB_NO_EXCEPT
+	: m_typeHashes(PDB_MOVE(other.m_typeHashes))
+	, m_typeCount(PDB_MOVE(other.m_typeCount))
+	, m_typeIndexBegin(PDB_MOVE(other.m_typeIndexBegin))
+	, m_idHashes(PDB_MOVE(other.m_idHashes))
+	, m_idCount(PDB_MOVE(other.m_idCount))
+	, m_idIndexBegin(PDB_MOVE(other.m_idIndexBegin))
+{
+	other.m_typeHashes = nullptr;
+	other.m_typeCount = 0u;
+	other.m_typeIndexBegin = 0u;
+	other.m_idHashes = nullptr;
+	other.m_idCount = 0u;
+	other.m_idIndexBegin = 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::GlobalTypeHashes& PDB::GlobalTypeHashes::operator=(GlobalTypeHashes&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_typeHashes);
+		PDB_DELETE_ARRAY(m_idHashes);
+
+		m_typeHashes = PDB_MOVE(other.m_typeHashes);
+		m_typeCount = PDB_MOVE(other.m_typeCount);
+		m_typeIndexBegin = PDB_MOVE(other.m_typeIndexBegin);
+		m_idHashes = PDB_MOVE(other.m_idHashes);
+		m_idCount = PDB_MOVE(other.m_idCount);
+		m_idIndexBegin = PDB_MOVE(other.m_idIndexBegin);
+
+		other.m_typeHashes = nullptr;
+		other.m_typeCount = 0u;
+		other.m_typeIndexBegin = 0u;
+		other.m_idHashes = nullptr;
+		other.m_idCount = 0u;
+		other.m_idIndexBegin = 0u;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::GlobalTypeHashes::GlobalTypeHashes(const TypeTable& typeTable, const IPIStream* ipiStream, ParallelForFunction parallelFor, void* userData) PDB_NO_EXCEPT
+	: m_typeHashes(nullptr)
+	, m_typeCount(typeTable.GetTypeRecords().GetLength())
+	, m_typeIndexBegin(typeTable.GetFirstTypeIndex())
+	, m_idHashes(nullptr)
+	, m_idCount(ipiStream ? ipiStream->GetTypeRecords().GetLength() : 0u)
+	, m_idIndexBegin(ipiStream ? ipiStream->GetFirstTypeIndex() : 0u)
+{
+	m_typeHashes = PDB_NEW_ARRAY(uint64_t, m_typeCount);
+	m_idHashes = PDB_NEW_ARRAY(uint64_t, m_idCount);
+
+	const AccumulateFunction accumulate = SelectAccumulateFunction();
+
+	// IPI records refer to TPI records, which are therefore hashed first
+	HashContext typeContext = {};
+	typeContext.records = reinterpret_cast<const Byte* const*>(typeTable.GetTypeRecords().Decay());
+	typeContext.recordCount = m_typeCount;
+	typeContext.indexBegin = m_typeIndexBegin;
+	typeContext.isIdStream = false;
+	typeContext.hashes = m_typeHashes;
+	typeContext.typeHashes = m_typeHashes;
+	typeContext.typeCount = m_typeCount;
+	typeContext.typeIndexBegin = m_typeIndexBegin;
+	typeContext.accumulate = accumulate;
+	HashStream(typeContext, parallelFor, userData);
+
+	if (ipiStream)
+	{
+		HashContext idContext = typeContext;
+		idContext.records = reinterpret_cast<const Byte* const*>(ipiStream->GetTypeRecords().Decay());
+		idContext.recordCount = m_idCount;
+		idContext.indexBegin = m_idIndexBegin;
+		idContext.isIdStream = true;
+		idContext.hashes = m_idHashes;
+		HashStream(idContext, parallelFor, userData);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::GlobalTypeHashes::~GlobalTypeHashes(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_typeHashes);
+	PDB_DELETE_ARRAY(m_idHashes);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint64_t PDB::GlobalTypeHashes::HashBytes(const void* data, size_t size) PDB_NO_EXCEPT
+{
+	static const AccumulateFunction accumulate = SelectAccumulateFunction();
+
+	return ::HashBytes(static_cast<const Byte*>(data), size, accumulate);
+}
@@ -0,0 +1,87 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_ParallelFor.h"
+
+
+namespace PDB
+{
+	class TypeTable;
+	class IPIStream;
+
+
+	// Structural 64-bit hashes of all TPI and IPI records, in the spirit of the global type hashes (GHASH) used by linkers.
+	// The hash of a record covers its kind and contents, with each type index it stores replaced by the hash of the referenced
+	// record. Hashes therefore only depend on the structure of a type, and are the same for identical types in different PDBs.
+	// Records only refer to records with lower indices, so hashes are computed bottom-up: records are grouped by their depth in
+	// the graph of references, and all records of the same depth are hashed in parallel.
+	// Simple types (indices below the first type index) hash to their index.
+	class PDB_NO_DISCARD GlobalTypeHashes
+	{
+	public:
+		GlobalTypeHashes(void) PDB_NO_EXCEPT;
+		GlobalTypeHashes(GlobalTypeHashes&& other) PDB_NO_EXCEPT;
+		GlobalTypeHashes& operator=(GlobalTypeHashes&& other) PDB_NO_EXCEPT;
+
+		// Hashes all records, running jobs for records of the same depth in parallel if a parallel loop is given.
+		// The IPI stream is optional, IPI records are not hashed without it.
+		explicit GlobalTypeHashes(const TypeTable& typeTable, const IPIStream* ipiStream, ParallelForFunction parallelFor = nullptr, void* userData = nullptr) PDB_NO_EXCEPT;
+		~GlobalTypeHashes(void) PDB_NO_EXCEPT;
+
+		// Returns the hash of the TPI record with the given type index, or of the simple type.
+		PDB_NO_DISCARD inline uint64_t GetTypeHash(uint32_t typeIndex) const PDB_NO_EXCEPT
+		{
+			return GetHash(m_typeHashes, m_typeIndexBegin, m_typeCount, typeIndex);
+		}
+
+		// Returns the hash of the IPI record with the given index.
+		PDB_NO_DISCARD inline uint64_t GetIdHash(uint32_t idIndex) const PDB_NO_EXCEPT
+		{
+			return GetHash(m_idHashes, m_idIndexBegin, m_idCount, idIndex);
+		}
+
+		// Returns the hashes of all TPI records, indexed by "typeIndex - firstTypeIndex".
+		PDB_NO_DISCARD inline ArrayView<uint64_t> GetTypeHashes(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<uint64_t>(m_typeHashes, m_typeCount);
+		}
+
+		// Returns the hashes of all IPI records, indexed by "idIndex - firstIdIndex".
+		PDB_NO_DISCARD inline ArrayView<uint64_t> GetIdHashes(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<uint64_t>(m_idHashes, m_idCount);
+		}
+
+		// Hashes the given bytes, using AVX2 if available. The result does not depend on the instruction set.
+		PDB_NO_DISCARD static uint64_t HashBytes(const void* data, size_t size) PDB_NO_EXCEPT;
+
+	private:
+		PDB_NO_DISCARD static inline uint64_t GetHash(const uint64_t* hashes, uint32_t indexBegin, size_t count, uint32_t index) PDB_NO_EXCEPT
+		{
+			if (index < indexBegin)
+			{
+				return index;
+			}
+			else if (index - indexBegin >= count)
+			{
+				return 0u;
+			}
+
+			return hashes[index - indexBegin];
+		}
+
+		uint64_t* m_typeHashes;
+		size_t m_typeCount;
+		uint32_t m_typeIndexBegin;
+
+		uint64_t* m_idHashes;
+		size_t m_idCount;
+		uint32_t m_idIndexBegin;
+
+		PDB_DISABLE_COPY(GlobalTypeHashes);
+	};
+}
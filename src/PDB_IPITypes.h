@@ -107,6 +107,22 @@ namespace PDB
 						uint16_t count;
 						PDB_FLEXIBLE_ARRAY_MEMBER(uint32_t, typeIndices);
 					} LF_BUILDINFO;
+
+					// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L1650
+					struct
+					{
+						uint32_t scopeId;		// parent scope of the ID, 0 if global
+						uint32_t typeIndex;		// function type
+						PDB_FLEXIBLE_ARRAY_MEMBER(char, name);
+					} LF_FUNC_ID;
+
+					// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L1658
+					struct
+					{
+						uint32_t parentTypeIndex;	// type index of the parent class
+						uint32_t typeIndex;			// function type
+						PDB_FLEXIBLE_ARRAY_MEMBER(char, name);
+					} LF_MFUNC_ID;
 #pragma pack(pop)
 				} data;
 			};
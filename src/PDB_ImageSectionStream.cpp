@@ -4,6 +4,54 @@
 #include "PDB_PCH.h"
 #include "PDB_ImageSectionStream.h"
 #include "PDB_RawFile.h"
+#include "Foundation/PDB_CPU.h"
+
+
+namespace
+{
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	static inline void ConvertSectionOffsetsToRVAsScalar(const uint32_t* virtualAddresses, size_t sectionCount, const uint16_t* oneBasedSectionIndices, const uint32_t* offsetsInSection, uint32_t* rvas, size_t count) PDB_NO_EXCEPT
+	{
+		// the loop body is branch-free: invalid section indices (including 0, which wraps around) are clamped to the
+		// first table entry, and their result is masked to 0 afterwards.
+		for (size_t i = 0u; i < count; ++i)
+		{
+			const uint32_t sectionIndex = oneBasedSectionIndices[i];
+			const uint32_t isValid = static_cast<uint32_t>(sectionIndex - 1u < sectionCount);
+			const uint32_t mask = 0u - isValid;
+
+			rvas[i] = (virtualAddresses[sectionIndex & mask] + offsetsInSection[i]) & mask;
+		}
+	}
+
+
+#if PDB_ARCH_X64
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	PDB_TARGET_AVX2 static size_t ConvertSectionOffsetsToRVAsAVX2(const uint32_t* virtualAddresses, size_t sectionCount, const uint16_t* oneBasedSectionIndices, const uint32_t* offsetsInSection, uint32_t* rvas, size_t count) PDB_NO_EXCEPT
+	{
+		// same as the scalar version, converting 8 offsets at a time. returns the number of converted offsets.
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i end = _mm256_set1_epi32(static_cast<int>(sectionCount + 1u));
+
+		size_t i = 0u;
+		for (/* nothing */; i + 8u <= count; i += 8u)
+		{
+			const __m256i sectionIndices = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(oneBasedSectionIndices + i)));
+			const __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsetsInSection + i));
+
+			// section indices are 16-bit values, so signed comparisons are fine
+			const __m256i mask = _mm256_and_si256(_mm256_cmpgt_epi32(sectionIndices, zero), _mm256_cmpgt_epi32(end, sectionIndices));
+			const __m256i addresses = _mm256_i32gather_epi32(reinterpret_cast<const int*>(virtualAddresses), _mm256_and_si256(sectionIndices, mask), 4);
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(rvas + i), _mm256_and_si256(_mm256_add_epi32(addresses, offsets), mask));
+		}
+
+		return i;
+	}
+#endif
+}
 
 
 // ------------------------------------------------------------------------------------------------
@@ -12,6 +60,9 @@ PDB::ImageSectionStream::ImageSectionStream(void) PDB_NO_EXCEPT
 	: m_stream()
 	, m_headers(nullptr)
 	, m_count(0u)
+	, m_originalStream()
+	, m_originalHeaders(nullptr)
+	, m_originalCount(0u)
 {
 }
 
@@ -22,20 +73,42 @@ PDB::ImageSectionStream::ImageSectionStream(const RawFile& file, uint16_t stream
 	: m_stream(file.CreateMSFStream<CoalescedMSFStream>(streamIndex))
 	, m_headers(m_stream.GetDataAtOffset<IMAGE_SECTION_HEADER>(0u))
 	, m_count(m_stream.GetSize() / sizeof(IMAGE_SECTION_HEADER))
+	, m_originalStream()
+	, m_originalHeaders(m_headers)
+	, m_originalCount(m_count)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ImageSectionStream::ImageSectionStream(const RawFile& file, uint16_t streamIndex, uint16_t originalStreamIndex) PDB_NO_EXCEPT
+	: ImageSectionStream(file, streamIndex)
 {
+	if (originalStreamIndex == NilStreamIndex)
+	{
+		return;
+	}
+
+	m_originalStream = file.CreateMSFStream<CoalescedMSFStream>(originalStreamIndex);
+	m_originalHeaders = m_originalStream.GetDataAtOffset<IMAGE_SECTION_HEADER>(0u);
+	m_originalCount = m_originalStream.GetSize() / sizeof(IMAGE_SECTION_HEADER);
 }
 
 
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
-PDB_NO_DISCARD uint32_t PDB::ImageSectionStream::ConvertSectionOffsetToRVA(uint16_t oneBasedSectionIndex, uint32_t offsetInSection) const PDB_NO_EXCEPT
+PDB_NO_DISCARD uint32_t PDB::ImageSectionStream::ConvertSectionOffsetToRVA(uint16_t oneBasedSectionIndex, uint32_t offsetInSection, Headers headers) const PDB_NO_EXCEPT
 {
+	const IMAGE_SECTION_HEADER* sectionHeaders = (headers == Headers::Original) ? m_originalHeaders : m_headers;
+	const size_t count = (headers == Headers::Original) ? m_originalCount : m_count;
+
 	if (oneBasedSectionIndex == 0u)
 	{
 		// should never happen, but prevent underflow
 		return 0u;
 	}
-	else if (oneBasedSectionIndex > m_count)
+	else if (oneBasedSectionIndex > count)
 	{
 		// this symbol is "contained" in a section that is neither part of the PDB, nor the EXE.
 		// it is a special compiler-generated or linker-generated symbol such as CFG symbols (e.g. __guard_fids_count, __guard_flags).
@@ -43,5 +116,43 @@ PDB_NO_DISCARD uint32_t PDB::ImageSectionStream::ConvertSectionOffsetToRVA(uint1
 		return 0u;
 	}
 
-	return m_headers[oneBasedSectionIndex - 1u].VirtualAddress + offsetInSection;
+	return sectionHeaders[oneBasedSectionIndex - 1u].VirtualAddress + offsetInSection;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::ImageSectionStream::ConvertSectionOffsetsToRVAs(const uint16_t* oneBasedSectionIndices, const uint32_t* offsetsInSection, uint32_t* rvas, size_t count, Headers headers) const PDB_NO_EXCEPT
+{
+	const IMAGE_SECTION_HEADER* sectionHeaders = (headers == Headers::Original) ? m_originalHeaders : m_headers;
+	const size_t sectionCount = (headers == Headers::Original) ? m_originalCount : m_count;
+
+	if (sectionCount > MaxBatchSectionCount)
+	{
+		for (size_t i = 0u; i < count; ++i)
+		{
+			rvas[i] = ConvertSectionOffsetToRVA(oneBasedSectionIndices[i], offsetsInSection[i], headers);
+		}
+
+		return;
+	}
+
+	// gather the section addresses into a local table indexed by the one-based section index. entry 0 is a dummy
+	// entry that invalid section indices are clamped to, so that no conversion ever needs to branch.
+	uint32_t virtualAddresses[MaxBatchSectionCount + 1u];
+	virtualAddresses[0u] = 0u;
+	for (size_t i = 0u; i < sectionCount; ++i)
+	{
+		virtualAddresses[i + 1u] = sectionHeaders[i].VirtualAddress;
+	}
+
+	size_t convertedCount = 0u;
+#if PDB_ARCH_X64
+	if (CPU::SupportsAVX2())
+	{
+		convertedCount = ConvertSectionOffsetsToRVAsAVX2(virtualAddresses, sectionCount, oneBasedSectionIndices, offsetsInSection, rvas, count);
+	}
+#endif
+
+	ConvertSectionOffsetsToRVAsScalar(virtualAddresses, sectionCount, oneBasedSectionIndices + convertedCount, offsetsInSection + convertedCount, rvas + convertedCount, count - convertedCount);
 }
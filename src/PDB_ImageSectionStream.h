@@ -18,13 +18,40 @@ namespace PDB
 	class PDB_NO_DISCARD ImageSectionStream
 	{
 	public:
+		// Images that were rearranged after linking (e.g. using OMAP) store both the original section headers, which section
+		// offsets in symbol records refer to, and the final section headers of the image.
+		// All other images only store the final section headers, which are also used when asking for the original ones.
+		enum class PDB_NO_DISCARD Headers : uint8_t
+		{
+			Final,
+			Original
+		};
+
 		ImageSectionStream(void) PDB_NO_EXCEPT;
 		explicit ImageSectionStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT;
+		explicit ImageSectionStream(const RawFile& file, uint16_t streamIndex, uint16_t originalStreamIndex) PDB_NO_EXCEPT;
 
 		PDB_DEFAULT_MOVE(ImageSectionStream);
 
-		// Converts a one-based section offset into an RVA.
-		PDB_NO_DISCARD uint32_t ConvertSectionOffsetToRVA(uint16_t oneBasedSectionIndex, uint32_t offsetInSection) const PDB_NO_EXCEPT;
+		// Converts a one-based section offset into an RVA, using the final section headers.
+		PDB_NO_DISCARD inline uint32_t ConvertSectionOffsetToRVA(uint16_t oneBasedSectionIndex, uint32_t offsetInSection) const PDB_NO_EXCEPT
+		{
+			return ConvertSectionOffsetToRVA(oneBasedSectionIndex, offsetInSection, Headers::Final);
+		}
+
+		// Converts a one-based section offset into an RVA, using the given section headers.
+		PDB_NO_DISCARD uint32_t ConvertSectionOffsetToRVA(uint16_t oneBasedSectionIndex, uint32_t offsetInSection, Headers headers) const PDB_NO_EXCEPT;
+
+		// Converts a batch of one-based section offsets into RVAs, using the given section headers.
+		// Offsets that cannot be converted yield an RVA of 0, same as ConvertSectionOffsetToRVA().
+		// Uses AVX2 gathers if the CPU supports them, and branch-free scalar code otherwise.
+		void ConvertSectionOffsetsToRVAs(const uint16_t* oneBasedSectionIndices, const uint32_t* offsetsInSection, uint32_t* rvas, size_t count, Headers headers) const PDB_NO_EXCEPT;
+
+		// Returns whether the original section headers are stored separately from the final ones.
+		PDB_NO_DISCARD inline bool HasOriginalImageSections(void) const PDB_NO_EXCEPT
+		{
+			return m_originalHeaders != m_headers;
+		}
 
 		// Returns a view of all the sections in the stream.
 		PDB_NO_DISCARD inline ArrayView<IMAGE_SECTION_HEADER> GetImageSections(void) const PDB_NO_EXCEPT
@@ -32,11 +59,25 @@ namespace PDB
 			return ArrayView<IMAGE_SECTION_HEADER>(m_headers, m_count);
 		}
 
+		// Returns a view of all the original sections in the stream.
+		PDB_NO_DISCARD inline ArrayView<IMAGE_SECTION_HEADER> GetOriginalImageSections(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<IMAGE_SECTION_HEADER>(m_originalHeaders, m_originalCount);
+		}
+
 	private:
+		// images with more sections than this are converted one offset at a time
+		static const size_t MaxBatchSectionCount = 128u;
+
 		CoalescedMSFStream m_stream;
 		const IMAGE_SECTION_HEADER* m_headers;
 		size_t m_count;
 
+		// points to the final section headers if the image wasn't rearranged
+		CoalescedMSFStream m_originalStream;
+		const IMAGE_SECTION_HEADER* m_originalHeaders;
+		size_t m_originalCount;
+
 		PDB_DISABLE_COPY(ImageSectionStream);
 	};
 }
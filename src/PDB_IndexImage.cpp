@@ -0,0 +1,176 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_IndexImage.h"
+#include "Foundation/PDB_PointerUtil.h"
+
+
+const char PDB::IndexImage::Header::MAGIC[8u] = { 'R', 'P', 'D', 'B', 'I', 'D', 'X', '\0' };
+
+
+namespace
+{
+	// Returns the offset of the next index, which is aligned to 8 bytes so that all arrays stay aligned.
+	PDB_NO_DISCARD static inline uint64_t AlignOffset(uint64_t offset) PDB_NO_EXCEPT
+	{
+		return (offset + 7u) & ~static_cast<uint64_t>(7u);
+	}
+
+
+	// Serializes a single index at the given offset, returning the offset behind it.
+	template <typename T>
+	PDB_NO_DISCARD static uint64_t WriteIndex(PDB::Byte* image, uint64_t offset, const T& index) PDB_NO_EXCEPT
+	{
+		PDB::IndexImageWriter writer(image ? image + offset : nullptr);
+		index.Serialize(writer);
+
+		return AlignOffset(offset + writer.GetSize());
+	}
+
+
+	// Returns whether an index stored at the given offset lies completely within the image.
+	template <typename T>
+	PDB_NO_DISCARD static bool IsIndexValid(const PDB::Byte* image, uint64_t size, uint64_t offset) PDB_NO_EXCEPT
+	{
+		if (offset == 0u)
+		{
+			return true;
+		}
+
+		if ((offset < sizeof(PDB::IndexImage::Header)) || (offset >= size) || ((offset & 7u) != 0u))
+		{
+			return false;
+		}
+
+		PDB::IndexImageReader reader(image + offset, static_cast<size_t>(size - offset));
+		const T index(reader);
+
+		return reader.IsValid();
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD size_t PDB::IndexImage::Write(void* buffer, const GUID& guid, uint32_t age, const FunctionIndex* functionIndex, const LineIndex* lineIndex, const ContributionIndex* contributionIndex) PDB_NO_EXCEPT
+{
+	Byte* image = static_cast<Byte*>(buffer);
+
+	Header header = {};
+	std::memcpy(header.magic, Header::MAGIC, sizeof(Header::MAGIC));
+	header.version = Header::Version;
+	header.age = age;
+	header.guid = guid;
+
+	uint64_t offset = AlignOffset(sizeof(Header));
+	if (functionIndex)
+	{
+		header.functionIndexOffset = offset;
+		offset = WriteIndex(image, offset, *functionIndex);
+	}
+
+	if (lineIndex)
+	{
+		header.lineIndexOffset = offset;
+		offset = WriteIndex(image, offset, *lineIndex);
+	}
+
+	if (contributionIndex)
+	{
+		header.contributionIndexOffset = offset;
+		offset = WriteIndex(image, offset, *contributionIndex);
+	}
+
+	header.size = offset;
+	if (image)
+	{
+		// the header is written last, so that readers never see a complete header in front of incomplete indices
+		std::memcpy(image, &header, sizeof(Header));
+	}
+
+	return static_cast<size_t>(offset);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::IndexImage::IndexImage(void) PDB_NO_EXCEPT
+	: m_header(nullptr)
+	, m_functionIndex()
+	, m_lineIndex()
+	, m_contributionIndex()
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::IndexImage::IndexImage(const void* data) PDB_NO_EXCEPT
+	: m_header(static_cast<const Header*>(data))
+	, m_functionIndex()
+	, m_lineIndex()
+	, m_contributionIndex()
+{
+	const Byte* image = static_cast<const Byte*>(data);
+	const size_t size = static_cast<size_t>(m_header->size);
+
+	if (m_header->functionIndexOffset != 0u)
+	{
+		const size_t offset = static_cast<size_t>(m_header->functionIndexOffset);
+		IndexImageReader reader(image + offset, size - offset);
+		m_functionIndex = FunctionIndex(reader);
+	}
+
+	if (m_header->lineIndexOffset != 0u)
+	{
+		const size_t offset = static_cast<size_t>(m_header->lineIndexOffset);
+		IndexImageReader reader(image + offset, size - offset);
+		m_lineIndex = LineIndex(reader);
+	}
+
+	if (m_header->contributionIndexOffset != 0u)
+	{
+		const size_t offset = static_cast<size_t>(m_header->contributionIndexOffset);
+		IndexImageReader reader(image + offset, size - offset);
+		m_contributionIndex = ContributionIndex(reader);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::ValidateIndexImage(const void* data, size_t size) PDB_NO_EXCEPT
+{
+	if (size < sizeof(IndexImage::Header))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	const IndexImage::Header* header = static_cast<const IndexImage::Header*>(data);
+	if (std::memcmp(header->magic, IndexImage::Header::MAGIC, sizeof(IndexImage::Header::MAGIC)) != 0)
+	{
+		return ErrorCode::InvalidSignature;
+	}
+
+	if (header->version != IndexImage::Header::Version)
+	{
+		return ErrorCode::UnknownVersion;
+	}
+
+	if ((header->size < sizeof(IndexImage::Header)) || (header->size > size))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	// the contents of the arrays are not validated, images are expected to be written by a trusted process
+	const Byte* image = static_cast<const Byte*>(data);
+	if (!IsIndexValid<FunctionIndex>(image, header->size, header->functionIndexOffset) ||
+		!IsIndexValid<LineIndex>(image, header->size, header->lineIndexOffset) ||
+		!IsIndexValid<ContributionIndex>(image, header->size, header->contributionIndexOffset))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	return ErrorCode::Success;
+}
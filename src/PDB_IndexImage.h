@@ -0,0 +1,212 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstring>
+#include "Foundation/PDB_DisableWarningsPop.h"
+#include "PDB_ErrorCodes.h"
+#include "PDB_FunctionIndex.h"
+#include "PDB_LineIndex.h"
+#include "PDB_ContributionIndex.h"
+#include "PDB_Types.h"
+
+
+namespace PDB
+{
+	// Serializes the arrays of an index one after another, each one preceded by its number of elements and aligned to 8 bytes.
+	// Without a buffer, the writer only computes the size needed for all arrays.
+	class PDB_NO_DISCARD IndexImageWriter
+	{
+	public:
+		explicit IndexImageWriter(void* buffer) PDB_NO_EXCEPT
+			: m_buffer(static_cast<Byte*>(buffer))
+			, m_offset(0u)
+		{
+		}
+
+		template <typename T>
+		void WriteArray(const T* values, size_t count) PDB_NO_EXCEPT
+		{
+			static_assert(alignof(T) <= 8u, "Arrays are only aligned to 8 bytes.");
+
+			const uint64_t count64 = count;
+			Write(&count64, sizeof(count64));
+			Write(values, count * sizeof(T));
+		}
+
+		// Returns the number of bytes written so far.
+		PDB_NO_DISCARD inline size_t GetSize(void) const PDB_NO_EXCEPT
+		{
+			return m_offset;
+		}
+
+	private:
+		inline void Write(const void* data, size_t size) PDB_NO_EXCEPT
+		{
+			if (m_buffer && (size != 0u))
+			{
+				std::memcpy(m_buffer + m_offset, data, size);
+			}
+
+			// pad with zeroes, so that images built from the same indices are identical
+			const size_t paddedSize = (size + 7u) & ~static_cast<size_t>(7u);
+			if (m_buffer && (paddedSize != size))
+			{
+				std::memset(m_buffer + m_offset + size, 0, paddedSize - size);
+			}
+
+			m_offset += paddedSize;
+		}
+
+		Byte* m_buffer;
+		size_t m_offset;
+
+		PDB_DISABLE_COPY_MOVE(IndexImageWriter);
+	};
+
+
+	// Reads arrays written by an IndexImageWriter without copying them. Reading past the end of the data yields empty arrays
+	// and marks the reader as invalid.
+	class PDB_NO_DISCARD IndexImageReader
+	{
+	public:
+		explicit IndexImageReader(const void* data, size_t size) PDB_NO_EXCEPT
+			: m_data(static_cast<const Byte*>(data))
+			, m_size(size)
+			, m_offset(0u)
+			, m_isValid(true)
+		{
+		}
+
+		template <typename T>
+		PDB_NO_DISCARD const T* ReadArray(size_t& count) PDB_NO_EXCEPT
+		{
+			count = 0u;
+
+			uint64_t count64 = 0u;
+			if (!m_isValid || (m_size - m_offset < sizeof(count64)))
+			{
+				m_isValid = false;
+				return nullptr;
+			}
+
+			std::memcpy(&count64, m_data + m_offset, sizeof(count64));
+			m_offset += sizeof(count64);
+
+			if (count64 > (m_size - m_offset) / sizeof(T))
+			{
+				m_isValid = false;
+				return nullptr;
+			}
+
+			const T* values = reinterpret_cast<const T*>(m_data + m_offset);
+			count = static_cast<size_t>(count64);
+			m_offset += (count * sizeof(T) + 7u) & ~static_cast<size_t>(7u);
+			if (m_offset > m_size)
+			{
+				m_offset = m_size;
+			}
+
+			return values;
+		}
+
+		// Returns whether all arrays read so far were stored completely.
+		PDB_NO_DISCARD inline bool IsValid(void) const PDB_NO_EXCEPT
+		{
+			return m_isValid;
+		}
+
+	private:
+		const Byte* m_data;
+		size_t m_size;
+		size_t m_offset;
+		bool m_isValid;
+
+		PDB_DISABLE_COPY_MOVE(IndexImageReader);
+	};
+
+
+	// An image holding built indices in a position-independent layout, so that the indices can be built once and then shared
+	// by several processes, e.g. by writing the image into a memfd or file that other processes map read-only.
+	// Opening an image doesn't copy any data, the indices refer to the image directly.
+	class PDB_NO_DISCARD IndexImage
+	{
+	public:
+		struct Header
+		{
+			static const char MAGIC[8u];
+			static const uint32_t Version = 2u;
+
+			char magic[8u];
+			uint32_t version;
+			uint32_t age;										// age and GUID of the PDB the indices were built from
+			GUID guid;
+			uint64_t size;										// size of the whole image including the header
+
+			// offsets of the serialized indices relative to the start of the image, 0 if an index is not stored
+			uint64_t functionIndexOffset;
+			uint64_t lineIndexOffset;
+			uint64_t contributionIndexOffset;
+		};
+
+		// Writes the given indices into the buffer, each of them can be nullptr. Returns the size of the image.
+		// Pass a nullptr buffer to compute the size of the image without writing it.
+		PDB_NO_DISCARD static size_t Write(void* buffer, const GUID& guid, uint32_t age, const FunctionIndex* functionIndex, const LineIndex* lineIndex, const ContributionIndex* contributionIndex) PDB_NO_EXCEPT;
+
+		IndexImage(void) PDB_NO_EXCEPT;
+		PDB_DEFAULT_MOVE(IndexImage);
+
+		// The image must have been validated using ValidateIndexImage(), and must outlive the indices.
+		explicit IndexImage(const void* data) PDB_NO_EXCEPT;
+
+		PDB_NO_DISCARD inline const Header* GetHeader(void) const PDB_NO_EXCEPT
+		{
+			return m_header;
+		}
+
+		// Returns whether the image stores each index. Indices that are not stored are empty.
+		PDB_NO_DISCARD inline bool HasFunctionIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_header && (m_header->functionIndexOffset != 0u);
+		}
+
+		PDB_NO_DISCARD inline bool HasLineIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_header && (m_header->lineIndexOffset != 0u);
+		}
+
+		PDB_NO_DISCARD inline bool HasContributionIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_header && (m_header->contributionIndexOffset != 0u);
+		}
+
+		PDB_NO_DISCARD inline const FunctionIndex& GetFunctionIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_functionIndex;
+		}
+
+		PDB_NO_DISCARD inline const LineIndex& GetLineIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_lineIndex;
+		}
+
+		PDB_NO_DISCARD inline const ContributionIndex& GetContributionIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_contributionIndex;
+		}
+
+	private:
+		const Header* m_header;
+		FunctionIndex m_functionIndex;
+		LineIndex m_lineIndex;
+		ContributionIndex m_contributionIndex;
+
+		PDB_DISABLE_COPY(IndexImage);
+	};
+
+	// Validates the header of an image and whether all indices are stored completely, e.g. before using an image mapped from shared memory.
+	PDB_NO_DISCARD ErrorCode ValidateIndexImage(const void* data, size_t size) PDB_NO_EXCEPT;
+}
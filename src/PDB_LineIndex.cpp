@@ -0,0 +1,317 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_LineIndex.h"
+#include "PDB_IndexImage.h"
+#include "PDB_RawFile.h"
+#include "PDB_ImageSectionStream.h"
+#include "PDB_ModuleInfoStream.h"
+#include "PDB_ModuleLineStream.h"
+#include "PDB_NamesStream.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+#include "Foundation/PDB_PointerUtil.h"
+
+
+namespace
+{
+	// a line as stored in a line stream, before the size of its code is known
+	struct PendingLine
+	{
+		uint32_t rva;
+		uint32_t sectionEndRVA;								// end of the code described by the S_LINES subsection the line is stored in
+		uint32_t lineNumber;
+		uint32_t namesFilenameOffset;						// offset of the file name in the /names stream
+	};
+
+
+	// Returns the S_FILECHECKSUMS subsection of a module, which is needed for finding the files referenced by blocks of lines.
+	PDB_NO_DISCARD static const PDB::CodeView::DBI::LineSection* FindFileChecksumSection(const PDB::ModuleLineStream& moduleLineStream) PDB_NO_EXCEPT
+	{
+		for (const PDB::CodeView::DBI::LineSection* section : moduleLineStream.GetSections())
+		{
+			if (section->header.kind == PDB::CodeView::DBI::DebugSubsectionKind::S_FILECHECKSUMS)
+			{
+				return section;
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LineIndex::LineIndex(void) PDB_NO_EXCEPT
+	: m_lineRVAs(nullptr)
+	, m_lines(nullptr)
+	, m_lineCount(0u)
+	, m_fileNames(nullptr)
+	, m_fileNamesSize(0u)
+	, m_ownsData(true)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LineIndex::LineIndex(LineIndex&& other) PDB_NO_EXCEPT
+	: m_lineRVAs(PDB_MOVE(other.m_lineRVAs))
+	, m_lines(PDB_MOVE(other.m_lines))
+	, m_lineCount(PDB_MOVE(other.m_lineCount))
+	, m_fileNames(PDB_MOVE(other.m_fileNames))
+	, m_fileNamesSize(PDB_MOVE(other.m_fileNamesSize))
+	, m_ownsData(PDB_MOVE(other.m_ownsData))
+{
+	other.m_lineRVAs = nullptr;
+	other.m_lines = nullptr;
+	other.m_lineCount = 0u;
+	other.m_fileNames = nullptr;
+	other.m_fileNamesSize = 0u;
+	other.m_ownsData = true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LineIndex& PDB::LineIndex::operator=(LineIndex&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		if (m_ownsData)
+		{
+			PDB_DELETE_ARRAY(m_lineRVAs);
+			PDB_DELETE_ARRAY(m_lines);
+			PDB_DELETE_ARRAY(m_fileNames);
+		}
+
+		m_lineRVAs = PDB_MOVE(other.m_lineRVAs);
+		m_lines = PDB_MOVE(other.m_lines);
+		m_lineCount = PDB_MOVE(other.m_lineCount);
+		m_fileNames = PDB_MOVE(other.m_fileNames);
+		m_fileNamesSize = PDB_MOVE(other.m_fileNamesSize);
+		m_ownsData = PDB_MOVE(other.m_ownsData);
+
+		other.m_lineRVAs = nullptr;
+		other.m_lines = nullptr;
+		other.m_lineCount = 0u;
+		other.m_fileNames = nullptr;
+		other.m_fileNamesSize = 0u;
+		other.m_ownsData = true;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LineIndex::LineIndex(const RawFile& file, const ImageSectionStream& imageSectionStream, const ModuleInfoStream& moduleInfoStream, const NamesStream& namesStream) PDB_NO_EXCEPT
+	: m_lineRVAs(nullptr)
+	, m_lines(nullptr)
+	, m_lineCount(0u)
+	, m_fileNames(nullptr)
+	, m_fileNamesSize(0u)
+	, m_ownsData(true)
+{
+	GrowableArray<PendingLine> pendingLineArray;
+
+	const ArrayView<ModuleInfoStream::Module> modules = moduleInfoStream.GetModules();
+	for (const ModuleInfoStream::Module& module : modules)
+	{
+		if (!module.HasLineStream())
+		{
+			continue;
+		}
+
+		const ModuleLineStream moduleLineStream = module.CreateLineStream(file);
+		const CodeView::DBI::LineSection* fileChecksumSection = FindFileChecksumSection(moduleLineStream);
+		if (!fileChecksumSection)
+		{
+			continue;
+		}
+
+		for (const CodeView::DBI::LineSection* section : moduleLineStream.GetSections())
+		{
+			if (section->header.kind != CodeView::DBI::DebugSubsectionKind::S_LINES)
+			{
+				continue;
+			}
+
+			const uint32_t sectionRVA = imageSectionStream.ConvertSectionOffsetToRVA(section->linesHeader.sectionIndex, section->linesHeader.sectionOffset);
+			if (sectionRVA == 0u)
+			{
+				continue;
+			}
+
+			const uint32_t sectionEndRVA = sectionRVA + section->linesHeader.codeSize;
+			for (const ModuleLineStream::LinesBlock& block : moduleLineStream.GetLinesBlocks(section))
+			{
+				// blocks refer to their file by the offset of its checksum in the module's S_FILECHECKSUMS subsection
+				const uint32_t fileChecksumOffset = block.header->fileChecksumOffset;
+				if (fileChecksumOffset >= fileChecksumSection->header.size)
+				{
+					continue;
+				}
+
+				const CodeView::DBI::FileChecksumHeader* fileChecksumHeader = Pointer::Offset<const CodeView::DBI::FileChecksumHeader*>(&fileChecksumSection->checksumHeader, fileChecksumOffset);
+				for (uint32_t i = 0u; i < block.header->numLines; ++i)
+				{
+					const CodeView::DBI::Line& line = block.lines[i];
+					pendingLineArray.Add(PendingLine { sectionRVA + line.offset, sectionEndRVA, line.linenumStart, fileChecksumHeader->filenameOffset });
+				}
+			}
+		}
+	}
+
+	const size_t pendingLineCount = pendingLineArray.GetSize();
+	PendingLine* pendingLines = pendingLineArray.Release();
+
+	// sort lines by RVA, and remove lines that were folded into the same code by the linker
+	Algorithm::Sort(pendingLines, pendingLines + pendingLineCount, [](const PendingLine& lhs, const PendingLine& rhs)
+	{
+		return lhs.rva < rhs.rva;
+	});
+
+	size_t uniqueCount = 0u;
+	for (size_t i = 0u; i < pendingLineCount; ++i)
+	{
+		if ((uniqueCount != 0u) && (pendingLines[uniqueCount - 1u].rva == pendingLines[i].rva))
+		{
+			continue;
+		}
+
+		pendingLines[uniqueCount++] = pendingLines[i];
+	}
+
+	// each file is stored once, so gather all distinct files first
+	uint32_t* namesFilenameOffsets = PDB_NEW_ARRAY(uint32_t, uniqueCount);
+	for (size_t i = 0u; i < uniqueCount; ++i)
+	{
+		namesFilenameOffsets[i] = pendingLines[i].namesFilenameOffset;
+	}
+
+	Algorithm::Sort(namesFilenameOffsets, namesFilenameOffsets + uniqueCount, [](uint32_t lhs, uint32_t rhs)
+	{
+		return lhs < rhs;
+	});
+
+	size_t fileCount = 0u;
+	for (size_t i = 0u; i < uniqueCount; ++i)
+	{
+		if ((fileCount == 0u) || (namesFilenameOffsets[fileCount - 1u] != namesFilenameOffsets[i]))
+		{
+			namesFilenameOffsets[fileCount++] = namesFilenameOffsets[i];
+		}
+	}
+
+	GrowableArray<char> fileNameArray;
+	uint32_t* fileNameOffsets = PDB_NEW_ARRAY(uint32_t, fileCount);
+	for (size_t i = 0u; i < fileCount; ++i)
+	{
+		const char* fileName = namesStream.GetFilename(namesFilenameOffsets[i]);
+		fileNameOffsets[i] = static_cast<uint32_t>(fileNameArray.Append(fileName, std::strlen(fileName) + 1u));
+	}
+
+	// a line ends where the next one starts, but never extends beyond the code described by its subsection.
+	// hidden lines end the code of the line before them, so they are only dropped once the size of that line is known.
+	// the code they cover doesn't belong to any line.
+	Line* lines = PDB_NEW_ARRAY(Line, uniqueCount);
+	uint32_t* lineRVAs = PDB_NEW_ARRAY(uint32_t, uniqueCount);
+	size_t lineCount = 0u;
+	for (size_t i = 0u; i < uniqueCount; ++i)
+	{
+		const PendingLine& pendingLine = pendingLines[i];
+		if ((pendingLine.lineNumber == CodeView::DBI::Line::HiddenLineNumber) || (pendingLine.lineNumber == CodeView::DBI::Line::AlternateHiddenLineNumber))
+		{
+			continue;
+		}
+
+		uint32_t endRVA = pendingLine.sectionEndRVA;
+		if ((i + 1u < uniqueCount) && (pendingLines[i + 1u].rva < endRVA))
+		{
+			endRVA = pendingLines[i + 1u].rva;
+		}
+
+		const size_t fileIndex = Algorithm::LowerBound(namesFilenameOffsets, fileCount, pendingLine.namesFilenameOffset);
+		lines[lineCount] = Line { pendingLine.rva, (endRVA > pendingLine.rva) ? endRVA - pendingLine.rva : 0u, pendingLine.lineNumber, fileNameOffsets[fileIndex] };
+		lineRVAs[lineCount] = pendingLine.rva;
+		++lineCount;
+	}
+
+	PDB_DELETE_ARRAY(fileNameOffsets);
+	PDB_DELETE_ARRAY(namesFilenameOffsets);
+	PDB_DELETE_ARRAY(pendingLines);
+
+	m_lineRVAs = lineRVAs;
+	m_lines = lines;
+	m_lineCount = lineCount;
+	m_fileNamesSize = fileNameArray.GetSize();
+	m_fileNames = fileNameArray.Release();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LineIndex::LineIndex(IndexImageReader& reader) PDB_NO_EXCEPT
+	: m_lineRVAs(nullptr)
+	, m_lines(nullptr)
+	, m_lineCount(0u)
+	, m_fileNames(nullptr)
+	, m_fileNamesSize(0u)
+	, m_ownsData(false)
+{
+	size_t lineRVACount = 0u;
+	m_lineRVAs = reader.ReadArray<uint32_t>(lineRVACount);
+	m_lines = reader.ReadArray<Line>(m_lineCount);
+	m_fileNames = reader.ReadArray<char>(m_fileNamesSize);
+
+	if (!reader.IsValid() || (lineRVACount != m_lineCount))
+	{
+		// FindLine() searches the RVAs and returns the line at the same index, so both arrays must hold m_lineCount entries.
+		// an empty index lets every lookup fail instead.
+		m_lineCount = 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LineIndex::~LineIndex(void) PDB_NO_EXCEPT
+{
+	if (m_ownsData)
+	{
+		PDB_DELETE_ARRAY(m_lineRVAs);
+		PDB_DELETE_ARRAY(m_lines);
+		PDB_DELETE_ARRAY(m_fileNames);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::LineIndex::Serialize(IndexImageWriter& writer) const PDB_NO_EXCEPT
+{
+	writer.WriteArray(m_lineRVAs, m_lineCount);
+	writer.WriteArray(m_lines, m_lineCount);
+	writer.WriteArray(m_fileNames, m_fileNamesSize);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::LineIndex::Line* PDB::LineIndex::FindLine(uint32_t rva) const PDB_NO_EXCEPT
+{
+	// find the last line starting at or before the RVA. lines never overlap.
+	const size_t index = Algorithm::UpperBound(m_lineRVAs, m_lineCount, rva);
+	if (index == 0u)
+	{
+		return nullptr;
+	}
+
+	const Line& line = m_lines[index - 1u];
+	return (rva - line.rva < line.size) ? &line : nullptr;
+}
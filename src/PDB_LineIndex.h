@@ -0,0 +1,81 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstdint>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+namespace PDB
+{
+	class RawFile;
+	class ImageSectionStream;
+	class ModuleInfoStream;
+	class NamesStream;
+	class IndexImageWriter;
+	class IndexImageReader;
+
+
+	// An index of the lines stored in all module line streams, answering "which source line does this RVA belong to?" with a
+	// single binary search over a tightly packed array of RVAs.
+	// File names are looked up in the /names stream and stored once per file, no matter how many modules refer to them.
+	// Once built, the index is immutable and can be queried from several threads.
+	class PDB_NO_DISCARD LineIndex
+	{
+	public:
+		struct Line
+		{
+			uint32_t rva;
+			uint32_t size;										// number of code bytes generated for the line
+			uint32_t lineNumber;
+			uint32_t fileNameOffset;							// offset of the file name, use GetFileName() to retrieve it
+		};
+
+		LineIndex(void) PDB_NO_EXCEPT;
+		LineIndex(LineIndex&& other) PDB_NO_EXCEPT;
+		LineIndex& operator=(LineIndex&& other) PDB_NO_EXCEPT;
+
+		explicit LineIndex(const RawFile& file, const ImageSectionStream& imageSectionStream, const ModuleInfoStream& moduleInfoStream, const NamesStream& namesStream) PDB_NO_EXCEPT;
+
+		// Creates an index referring to serialized data, see IndexImage. The data must outlive the index.
+		explicit LineIndex(IndexImageReader& reader) PDB_NO_EXCEPT;
+		~LineIndex(void) PDB_NO_EXCEPT;
+
+		// Serializes the index into a position-independent layout, see IndexImage.
+		void Serialize(IndexImageWriter& writer) const PDB_NO_EXCEPT;
+
+		// Returns the line whose code contains the given RVA, or nullptr if there is none.
+		PDB_NO_DISCARD const Line* FindLine(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the name of the file the given line belongs to.
+		PDB_NO_DISCARD inline const char* GetFileName(const Line& line) const PDB_NO_EXCEPT
+		{
+			return &m_fileNames[line.fileNameOffset];
+		}
+
+		// Returns a view of all lines, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<Line> GetLines(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Line>(m_lines, m_lineCount);
+		}
+
+	private:
+		// the RVAs are stored separately from the lines so that the binary search touches as few cache lines as possible
+		const uint32_t* m_lineRVAs;
+		const Line* m_lines;
+		size_t m_lineCount;
+
+		// names of all files, copied because the /names stream is only alive while the index is built
+		const char* m_fileNames;
+		size_t m_fileNamesSize;
+
+		// indices referring to serialized data don't own any memory
+		bool m_ownsData;
+
+		PDB_DISABLE_COPY(LineIndex);
+	};
+}
@@ -0,0 +1,279 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_LinkerLayout.h"
+#include "PDB_RawFile.h"
+#include "PDB_ImageSectionStream.h"
+#include "PDB_ModuleInfoStream.h"
+#include "PDB_ModuleSymbolStream.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	// Sorts entries by RVA. Entries starting at the same RVA are sorted by size, so that the largest one is found by a lookup.
+	template <typename T>
+	static void SortByRVA(T* entries, size_t count) PDB_NO_EXCEPT
+	{
+		PDB::Algorithm::Sort(entries, entries + count, [](const T& lhs, const T& rhs)
+		{
+			if (lhs.rva != rhs.rva)
+			{
+				return lhs.rva < rhs.rva;
+			}
+
+			return lhs.size < rhs.size;
+		});
+	}
+
+
+	template <typename T>
+	PDB_NO_DISCARD static uint32_t* CreateRVAs(const T* entries, size_t count) PDB_NO_EXCEPT
+	{
+		uint32_t* rvas = PDB_NEW_ARRAY(uint32_t, count);
+		for (size_t i = 0u; i < count; ++i)
+		{
+			rvas[i] = entries[i].rva;
+		}
+
+		return rvas;
+	}
+
+
+	// Returns the entry containing the given RVA, assuming that entries don't overlap.
+	template <typename T>
+	PDB_NO_DISCARD static const T* FindEntry(const uint32_t* rvas, const T* entries, size_t count, uint32_t rva) PDB_NO_EXCEPT
+	{
+		const size_t index = PDB::Algorithm::UpperBound(rvas, count, rva);
+		if (index == 0u)
+		{
+			return nullptr;
+		}
+
+		const T& entry = entries[index - 1u];
+		return (rva - entry.rva < entry.size) ? &entry : nullptr;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LinkerLayout::LinkerLayout(void) PDB_NO_EXCEPT
+	: m_sectionRVAs(nullptr)
+	, m_sections(nullptr)
+	, m_sectionCount(0u)
+	, m_coffGroupRVAs(nullptr)
+	, m_coffGroups(nullptr)
+	, m_coffGroupCount(0u)
+	, m_thunkRVAs(nullptr)
+	, m_thunks(nullptr)
+	, m_thunkCount(0u)
+	, m_names(nullptr)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LinkerLayout::LinkerLayout(LinkerLayout&& other) PDB_NO_EXCEPT
+	: m_sectionRVAs(PDB_MOVE(other.m_sectionRVAs))
+	, m_sections(PDB_MOVE(other.m_sections))
+	, m_sectionCount(PDB_MOVE(other.m_sectionCount))
+	, m_coffGroupRVAs(PDB_MOVE(other.m_coffGroupRVAs))
+	, m_coffGroups(PDB_MOVE(other.m_coffGroups))
+	, m_coffGroupCount(PDB_MOVE(other.m_coffGroupCount))
+	, m_thunkRVAs(PDB_MOVE(other.m_thunkRVAs))
+	, m_thunks(PDB_MOVE(other.m_thunks))
+	, m_thunkCount(PDB_MOVE(other.m_thunkCount))
+	, m_names(PDB_MOVE(other.m_names))
+{
+	other.m_sectionRVAs = nullptr;
+	other.m_sections = nullptr;
+	other.m_sectionCount = 0u;
+	other.m_coffGroupRVAs = nullptr;
+	other.m_coffGroups = nullptr;
+	other.m_coffGroupCount = 0u;
+	other.m_thunkRVAs = nullptr;
+	other.m_thunks = nullptr;
+	other.m_thunkCount = 0u;
+	other.m_names = nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LinkerLayout& PDB::LinkerLayout::operator=(LinkerLayout&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_sectionRVAs);
+		PDB_DELETE_ARRAY(m_sections);
+		PDB_DELETE_ARRAY(m_coffGroupRVAs);
+		PDB_DELETE_ARRAY(m_coffGroups);
+		PDB_DELETE_ARRAY(m_thunkRVAs);
+		PDB_DELETE_ARRAY(m_thunks);
+		PDB_DELETE_ARRAY(m_names);
+
+		m_sectionRVAs = PDB_MOVE(other.m_sectionRVAs);
+		m_sections = PDB_MOVE(other.m_sections);
+		m_sectionCount = PDB_MOVE(other.m_sectionCount);
+		m_coffGroupRVAs = PDB_MOVE(other.m_coffGroupRVAs);
+		m_coffGroups = PDB_MOVE(other.m_coffGroups);
+		m_coffGroupCount = PDB_MOVE(other.m_coffGroupCount);
+		m_thunkRVAs = PDB_MOVE(other.m_thunkRVAs);
+		m_thunks = PDB_MOVE(other.m_thunks);
+		m_thunkCount = PDB_MOVE(other.m_thunkCount);
+		m_names = PDB_MOVE(other.m_names);
+
+		other.m_sectionRVAs = nullptr;
+		other.m_sections = nullptr;
+		other.m_sectionCount = 0u;
+		other.m_coffGroupRVAs = nullptr;
+		other.m_coffGroups = nullptr;
+		other.m_coffGroupCount = 0u;
+		other.m_thunkRVAs = nullptr;
+		other.m_thunks = nullptr;
+		other.m_thunkCount = 0u;
+		other.m_names = nullptr;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LinkerLayout::LinkerLayout(const RawFile& file, const ImageSectionStream& imageSectionStream, const ModuleInfoStream& moduleInfoStream) PDB_NO_EXCEPT
+	: m_sectionRVAs(nullptr)
+	, m_sections(nullptr)
+	, m_sectionCount(0u)
+	, m_coffGroupRVAs(nullptr)
+	, m_coffGroups(nullptr)
+	, m_coffGroupCount(0u)
+	, m_thunkRVAs(nullptr)
+	, m_thunks(nullptr)
+	, m_thunkCount(0u)
+	, m_names(nullptr)
+{
+	GrowableArray<Section> sectionArray;
+	GrowableArray<COFFGroup> coffGroupArray;
+	GrowableArray<Thunk> thunkArray;
+	GrowableArray<char> nameArray;
+
+	// the first name is the empty name used by entries that don't have one
+	nameArray.Add('\0');
+
+	const ModuleInfoStream::Module* linkerModule = moduleInfoStream.FindLinkerModule();
+	if (linkerModule && linkerModule->HasSymbolStream())
+	{
+		const ModuleSymbolStream moduleSymbolStream = linkerModule->CreateSymbolStream(file);
+		for (const CodeView::DBI::Record* record : moduleSymbolStream.GetSymbols())
+		{
+			const CodeView::DBI::SymbolRecordKind kind = record->header.kind;
+			if (kind == CodeView::DBI::SymbolRecordKind::S_SECTION)
+			{
+				const char* name = record->data.S_SECTION.name;
+				const uint32_t nameOffset = static_cast<uint32_t>(nameArray.Append(name, std::strlen(name) + 1u));
+				sectionArray.Add(Section { record->data.S_SECTION.rva, record->data.S_SECTION.length, record->data.S_SECTION.characteristics,
+					nameOffset, record->data.S_SECTION.sectionNumber, record->data.S_SECTION.alignment });
+			}
+			else if (kind == CodeView::DBI::SymbolRecordKind::S_COFFGROUP)
+			{
+				const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_COFFGROUP.section, record->data.S_COFFGROUP.offset);
+				if (rva == 0u)
+				{
+					continue;
+				}
+
+				const char* name = record->data.S_COFFGROUP.name;
+				const uint32_t nameOffset = static_cast<uint32_t>(nameArray.Append(name, std::strlen(name) + 1u));
+				coffGroupArray.Add(COFFGroup { rva, record->data.S_COFFGROUP.size, record->data.S_COFFGROUP.characteristics, nameOffset });
+			}
+			else if (kind == CodeView::DBI::SymbolRecordKind::S_TRAMPOLINE)
+			{
+				const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_TRAMPOLINE.thunkSection, record->data.S_TRAMPOLINE.thunkOffset);
+				if (rva == 0u)
+				{
+					continue;
+				}
+
+				const uint32_t targetRVA = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_TRAMPOLINE.targetSection, record->data.S_TRAMPOLINE.targetOffset);
+				const CodeView::DBI::ThunkOrdinal ordinal = (record->data.S_TRAMPOLINE.type == CodeView::DBI::TrampolineType::BranchIsland)
+					? CodeView::DBI::ThunkOrdinal::TrampolineBranchIsland
+					: CodeView::DBI::ThunkOrdinal::TrampolineIncremental;
+
+				thunkArray.Add(Thunk { rva, record->data.S_TRAMPOLINE.size, targetRVA, 0u, ordinal });
+			}
+			else if (kind == CodeView::DBI::SymbolRecordKind::S_THUNK32)
+			{
+				const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_THUNK32.section, record->data.S_THUNK32.offset);
+				if (rva == 0u)
+				{
+					continue;
+				}
+
+				const char* name = record->data.S_THUNK32.name;
+				const uint32_t nameOffset = static_cast<uint32_t>(nameArray.Append(name, std::strlen(name) + 1u));
+				thunkArray.Add(Thunk { rva, record->data.S_THUNK32.length, 0u, nameOffset, record->data.S_THUNK32.thunk });
+			}
+		}
+	}
+
+	m_sectionCount = sectionArray.GetSize();
+	m_sections = sectionArray.Release();
+	SortByRVA(m_sections, m_sectionCount);
+	m_sectionRVAs = CreateRVAs(m_sections, m_sectionCount);
+
+	m_coffGroupCount = coffGroupArray.GetSize();
+	m_coffGroups = coffGroupArray.Release();
+	SortByRVA(m_coffGroups, m_coffGroupCount);
+	m_coffGroupRVAs = CreateRVAs(m_coffGroups, m_coffGroupCount);
+
+	m_thunkCount = thunkArray.GetSize();
+	m_thunks = thunkArray.Release();
+	SortByRVA(m_thunks, m_thunkCount);
+	m_thunkRVAs = CreateRVAs(m_thunks, m_thunkCount);
+
+	m_names = nameArray.Release();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::LinkerLayout::~LinkerLayout(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_sectionRVAs);
+	PDB_DELETE_ARRAY(m_sections);
+	PDB_DELETE_ARRAY(m_coffGroupRVAs);
+	PDB_DELETE_ARRAY(m_coffGroups);
+	PDB_DELETE_ARRAY(m_thunkRVAs);
+	PDB_DELETE_ARRAY(m_thunks);
+	PDB_DELETE_ARRAY(m_names);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::LinkerLayout::Section* PDB::LinkerLayout::FindSection(uint32_t rva) const PDB_NO_EXCEPT
+{
+	return FindEntry(m_sectionRVAs, m_sections, m_sectionCount, rva);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::LinkerLayout::COFFGroup* PDB::LinkerLayout::FindCOFFGroup(uint32_t rva) const PDB_NO_EXCEPT
+{
+	return FindEntry(m_coffGroupRVAs, m_coffGroups, m_coffGroupCount, rva);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::LinkerLayout::Thunk* PDB::LinkerLayout::FindThunk(uint32_t rva) const PDB_NO_EXCEPT
+{
+	return FindEntry(m_thunkRVAs, m_thunks, m_thunkCount, rva);
+}
@@ -0,0 +1,121 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_DBITypes.h"
+
+
+namespace PDB
+{
+	class RawFile;
+	class ImageSectionStream;
+	class ModuleInfoStream;
+
+
+	// Decodes the layout of the image as described by the symbols of the linker module ("* Linker *"): the image sections (S_SECTION),
+	// the COFF groups they were merged from (S_COFFGROUP, e.g. .text$mn or .rdata$r), and the thunks generated by the linker
+	// (S_TRAMPOLINE and S_THUNK32), such as incremental linking thunks and branch islands.
+	// All tables are sorted by RVA, and lookups by RVA are a single binary search.
+	// Once built, the layout is immutable and can be queried from several threads.
+	class PDB_NO_DISCARD LinkerLayout
+	{
+	public:
+		struct Section
+		{
+			uint32_t rva;
+			uint32_t size;
+			uint32_t characteristics;
+			uint32_t nameOffset;								// offset of the name, use GetName() to retrieve it
+			uint16_t sectionNumber;
+			uint8_t alignment;									// alignment as a power of two
+		};
+
+		struct COFFGroup
+		{
+			uint32_t rva;
+			uint32_t size;
+			uint32_t characteristics;
+			uint32_t nameOffset;								// offset of the name, use GetName() to retrieve it
+		};
+
+		struct Thunk
+		{
+			uint32_t rva;
+			uint32_t size;
+			uint32_t targetRVA;									// RVA the thunk jumps to, 0 if it is not known
+			uint32_t nameOffset;								// offset of the name, use GetName() to retrieve it. trampolines have an empty name.
+			CodeView::DBI::ThunkOrdinal ordinal;
+		};
+
+		LinkerLayout(void) PDB_NO_EXCEPT;
+		LinkerLayout(LinkerLayout&& other) PDB_NO_EXCEPT;
+		LinkerLayout& operator=(LinkerLayout&& other) PDB_NO_EXCEPT;
+
+		// The layout is empty if the PDB doesn't contain a linker module.
+		explicit LinkerLayout(const RawFile& file, const ImageSectionStream& imageSectionStream, const ModuleInfoStream& moduleInfoStream) PDB_NO_EXCEPT;
+		~LinkerLayout(void) PDB_NO_EXCEPT;
+
+		// Returns the image section containing the given RVA, or nullptr if there is none.
+		PDB_NO_DISCARD const Section* FindSection(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the COFF group containing the given RVA, or nullptr if there is none.
+		PDB_NO_DISCARD const COFFGroup* FindCOFFGroup(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the thunk containing the given RVA, or nullptr if there is none.
+		PDB_NO_DISCARD const Thunk* FindThunk(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the target of the thunk containing the given RVA, or the RVA itself if it doesn't belong to a thunk with a known target.
+		PDB_NO_DISCARD inline uint32_t ResolveThunkTarget(uint32_t rva) const PDB_NO_EXCEPT
+		{
+			const Thunk* thunk = FindThunk(rva);
+			return (thunk && (thunk->targetRVA != 0u)) ? thunk->targetRVA : rva;
+		}
+
+		// Returns the name of the given section, COFF group or thunk.
+		template <typename T>
+		PDB_NO_DISCARD inline const char* GetName(const T& entry) const PDB_NO_EXCEPT
+		{
+			return &m_names[entry.nameOffset];
+		}
+
+		// Returns a view of all image sections, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<Section> GetSections(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Section>(m_sections, m_sectionCount);
+		}
+
+		// Returns a view of all COFF groups, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<COFFGroup> GetCOFFGroups(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<COFFGroup>(m_coffGroups, m_coffGroupCount);
+		}
+
+		// Returns a view of all thunks, sorted by RVA.
+		PDB_NO_DISCARD inline ArrayView<Thunk> GetThunks(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Thunk>(m_thunks, m_thunkCount);
+		}
+
+	private:
+		// the RVAs of each table are stored separately so that the binary search touches as few cache lines as possible
+		uint32_t* m_sectionRVAs;
+		Section* m_sections;
+		size_t m_sectionCount;
+
+		uint32_t* m_coffGroupRVAs;
+		COFFGroup* m_coffGroups;
+		size_t m_coffGroupCount;
+
+		uint32_t* m_thunkRVAs;
+		Thunk* m_thunks;
+		size_t m_thunkCount;
+
+		// names of all entries, copied because the linker module's symbol stream is only alive while the layout is built
+		char* m_names;
+
+		PDB_DISABLE_COPY(LinkerLayout);
+	};
+}
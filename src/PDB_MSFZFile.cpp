@@ -0,0 +1,596 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_MSFZFile.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_Assert.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	PDB_NO_DISCARD static inline bool IsStoredInChunk(const PDB::MSFZ::Fragment& fragment) PDB_NO_EXCEPT
+	{
+		return (fragment.locationHigh & PDB::MSFZ::Fragment::ChunkBit) != 0u;
+	}
+
+
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	PDB_NO_DISCARD static inline uint32_t GetChunkIndex(const PDB::MSFZ::Fragment& fragment) PDB_NO_EXCEPT
+	{
+		return fragment.locationHigh & ~PDB::MSFZ::Fragment::ChunkBit;
+	}
+
+
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	PDB_NO_DISCARD static inline uint32_t ReadDirectoryWord(const PDB::Byte* directory, size_t wordIndex) PDB_NO_EXCEPT
+	{
+		// the directory is not necessarily aligned within the file
+		uint32_t word = 0u;
+		std::memcpy(&word, directory + wordIndex * sizeof(uint32_t), sizeof(uint32_t));
+
+		return word;
+	}
+
+
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	static void SortAndRemoveDuplicates(PDB::GrowableArray<uint32_t>& array, uint32_t*& data, uint32_t& count) PDB_NO_EXCEPT
+	{
+		data = const_cast<uint32_t*>(array.GetData());
+		PDB::Algorithm::Sort(data, data + array.GetSize(), [](uint32_t lhs, uint32_t rhs)
+		{
+			return lhs < rhs;
+		});
+
+		count = 0u;
+		for (size_t i = 0u; i < array.GetSize(); ++i)
+		{
+			if ((count == 0u) || (data[count - 1u] != data[i]))
+			{
+				data[count++] = data[i];
+			}
+		}
+	}
+}
+
+
+// state shared by all jobs of a single call to LoadStreams()
+struct PDB::MSFZFile::LoadContext
+{
+	const MSFZFile* file;
+
+	// streams to be assembled, and their assembled data
+	const uint32_t* streamIndices;
+	uint32_t streamCount;
+	Byte** streamData;
+
+	// compressed chunks needed by the streams, sorted by chunk index
+	const uint32_t* chunkIndices;
+	uint32_t chunkCount;
+	const Byte** chunkData;
+
+	// chunks that weren't cached and need to be decompressed, as indices into the chunk arrays above
+	const uint32_t* decompressIndices;
+	Byte** decompressedData;
+
+	// each job only writes its own entry
+	bool* chunkFailed;
+	bool* streamFailed;
+};
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MSFZFile::MSFZFile(const void* data, const MSFZ::Options& options) PDB_NO_EXCEPT
+	: m_data(static_cast<const Byte*>(data))
+	, m_options(options)
+	, m_chunks(nullptr)
+	, m_chunkCount(0u)
+	, m_streamCount(0u)
+	, m_streamSizes(nullptr)
+	, m_fragments(nullptr)
+	, m_streamFragmentOffsets(nullptr)
+	, m_streamData(nullptr)
+	, m_ownedStreamData(nullptr)
+	, m_lock()
+	, m_cachedChunks(nullptr)
+	, m_cachedChunkReferenceCounts(nullptr)
+	, m_cachedChunkLastUse(nullptr)
+	, m_cachedSize(0u)
+	, m_useCounter(0u)
+{
+	m_lock.clear();
+
+	const MSFZ::FileHeader* header = reinterpret_cast<const MSFZ::FileHeader*>(m_data);
+
+	m_chunks = reinterpret_cast<const MSFZ::ChunkEntry*>(m_data + header->chunkTableOffset);
+	m_chunkCount = header->chunkCount;
+	if (m_chunkCount > header->chunkTableSize / sizeof(MSFZ::ChunkEntry))
+	{
+		m_chunkCount = header->chunkTableSize / static_cast<uint32_t>(sizeof(MSFZ::ChunkEntry));
+	}
+
+	m_cachedChunks = PDB_NEW_ARRAY(Byte*, m_chunkCount);
+	m_cachedChunkReferenceCounts = PDB_NEW_ARRAY(uint32_t, m_chunkCount);
+	m_cachedChunkLastUse = PDB_NEW_ARRAY(uint64_t, m_chunkCount);
+	for (uint32_t i = 0u; i < m_chunkCount; ++i)
+	{
+		m_cachedChunks[i] = nullptr;
+		m_cachedChunkReferenceCounts[i] = 0u;
+		m_cachedChunkLastUse[i] = 0u;
+	}
+
+	// the stream directory itself can be compressed
+	const Byte* directory = m_data + header->streamDirectoryOffset;
+	Byte* decompressedDirectory = nullptr;
+	if (header->streamDirectoryCompression != MSFZ::Compression::None)
+	{
+		decompressedDirectory = PDB_NEW_ARRAY(Byte, header->streamDirectoryUncompressedSize);
+		if (!m_options.decompress || !m_options.decompress(m_options.userData, header->streamDirectoryCompression, directory, header->streamDirectoryCompressedSize, decompressedDirectory, header->streamDirectoryUncompressedSize))
+		{
+			PDB_DELETE_ARRAY(decompressedDirectory);
+			return;
+		}
+
+		directory = decompressedDirectory;
+	}
+
+	const size_t directoryWordCount = header->streamDirectoryUncompressedSize / sizeof(uint32_t);
+
+	// walk the directory once to find out how many fragments there are
+	size_t fragmentCount = 0u;
+	uint32_t streamCount = 0u;
+	{
+		size_t wordIndex = 0u;
+		for (/* nothing */; (streamCount < header->streamCount) && (wordIndex < directoryWordCount); ++streamCount)
+		{
+			uint32_t size = ReadDirectoryWord(directory, wordIndex++);
+			if (size == MSFZ::Fragment::NilStreamSize)
+			{
+				continue;
+			}
+
+			while ((size != 0u) && (wordIndex + 3u <= directoryWordCount))
+			{
+				++fragmentCount;
+				wordIndex += 2u;
+				size = ReadDirectoryWord(directory, wordIndex++);
+			}
+		}
+	}
+
+	m_streamCount = streamCount;
+	m_streamSizes = PDB_NEW_ARRAY(uint32_t, m_streamCount);
+	m_fragments = PDB_NEW_ARRAY(MSFZ::Fragment, fragmentCount);
+	m_streamFragmentOffsets = PDB_NEW_ARRAY(uint32_t, m_streamCount + 1u);
+
+	{
+		size_t wordIndex = 0u;
+		uint32_t fragmentIndex = 0u;
+		for (uint32_t i = 0u; i < m_streamCount; ++i)
+		{
+			m_streamFragmentOffsets[i] = fragmentIndex;
+
+			uint32_t size = ReadDirectoryWord(directory, wordIndex++);
+			if (size == MSFZ::Fragment::NilStreamSize)
+			{
+				m_streamSizes[i] = NilPageSize;
+				continue;
+			}
+
+			uint32_t streamSize = 0u;
+			while ((size != 0u) && (wordIndex + 3u <= directoryWordCount))
+			{
+				MSFZ::Fragment& fragment = m_fragments[fragmentIndex++];
+				fragment.size = size;
+				fragment.locationLow = ReadDirectoryWord(directory, wordIndex++);
+				fragment.locationHigh = ReadDirectoryWord(directory, wordIndex++);
+
+				streamSize += size;
+				size = ReadDirectoryWord(directory, wordIndex++);
+			}
+
+			m_streamSizes[i] = streamSize;
+		}
+
+		m_streamFragmentOffsets[m_streamCount] = fragmentIndex;
+	}
+
+	PDB_DELETE_ARRAY(decompressedDirectory);
+
+	m_streamData = PDB_NEW_ARRAY(std::atomic<const Byte*>, m_streamCount);
+	m_ownedStreamData = PDB_NEW_ARRAY(Byte*, m_streamCount);
+	for (uint32_t i = 0u; i < m_streamCount; ++i)
+	{
+		m_streamData[i].store(nullptr, std::memory_order_relaxed);
+		m_ownedStreamData[i] = nullptr;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MSFZFile::~MSFZFile(void) PDB_NO_EXCEPT
+{
+	for (uint32_t i = 0u; i < m_streamCount; ++i)
+	{
+		PDB_DELETE_ARRAY(m_ownedStreamData[i]);
+	}
+
+	for (uint32_t i = 0u; i < m_chunkCount; ++i)
+	{
+		PDB_DELETE_ARRAY(m_cachedChunks[i]);
+	}
+
+	PDB_DELETE_ARRAY(m_streamSizes);
+	PDB_DELETE_ARRAY(m_fragments);
+	PDB_DELETE_ARRAY(m_streamFragmentOffsets);
+	PDB_DELETE_ARRAY(m_streamData);
+	PDB_DELETE_ARRAY(m_ownedStreamData);
+	PDB_DELETE_ARRAY(m_cachedChunks);
+	PDB_DELETE_ARRAY(m_cachedChunkReferenceCounts);
+	PDB_DELETE_ARRAY(m_cachedChunkLastUse);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::MSFZFile::LoadStreams(const uint32_t* streamIndices, size_t count) const PDB_NO_EXCEPT
+{
+	// find the streams that still need to be assembled. streams that consist of a single fragment stored contiguously
+	// in the file can be used as they are.
+	GrowableArray<uint32_t> streamArray;
+	for (size_t i = 0u; i < count; ++i)
+	{
+		const uint32_t streamIndex = streamIndices[i];
+		PDB_ASSERT(streamIndex < m_streamCount, "Invalid stream index.");
+
+		if (m_streamData[streamIndex].load(std::memory_order_acquire) != nullptr)
+		{
+			continue;
+		}
+
+		const uint32_t firstFragment = m_streamFragmentOffsets[streamIndex];
+		const uint32_t fragmentCount = m_streamFragmentOffsets[streamIndex + 1u] - firstFragment;
+		if (fragmentCount == 0u)
+		{
+			// nil or empty stream, any valid pointer will do
+			m_streamData[streamIndex].store(m_data, std::memory_order_release);
+			continue;
+		}
+		else if (fragmentCount == 1u)
+		{
+			const Byte* data = GetFragmentDataInFile(m_fragments[firstFragment]);
+			if (data)
+			{
+				m_streamData[streamIndex].store(data, std::memory_order_release);
+				continue;
+			}
+		}
+
+		streamArray.Add(streamIndex);
+	}
+
+	LoadContext context = {};
+	context.file = this;
+	{
+		uint32_t* data = nullptr;
+		SortAndRemoveDuplicates(streamArray, data, context.streamCount);
+		context.streamIndices = data;
+	}
+
+	if (context.streamCount == 0u)
+	{
+		return ErrorCode::Success;
+	}
+
+	// gather all compressed chunks needed by these streams
+	GrowableArray<uint32_t> chunkArray;
+	for (uint32_t i = 0u; i < context.streamCount; ++i)
+	{
+		const uint32_t streamIndex = context.streamIndices[i];
+		for (uint32_t j = m_streamFragmentOffsets[streamIndex]; j < m_streamFragmentOffsets[streamIndex + 1u]; ++j)
+		{
+			if (!GetFragmentDataInFile(m_fragments[j]) && (GetChunkIndex(m_fragments[j]) < m_chunkCount))
+			{
+				chunkArray.Add(GetChunkIndex(m_fragments[j]));
+			}
+		}
+	}
+
+	{
+		uint32_t* data = nullptr;
+		SortAndRemoveDuplicates(chunkArray, data, context.chunkCount);
+		context.chunkIndices = data;
+	}
+
+	// use cached chunks where possible, and decompress all others in parallel
+	context.chunkData = PDB_NEW_ARRAY(const Byte*, context.chunkCount);
+	context.chunkFailed = PDB_NEW_ARRAY(bool, context.chunkCount);
+	uint32_t* decompressIndices = PDB_NEW_ARRAY(uint32_t, context.chunkCount);
+	uint32_t decompressCount = 0u;
+	for (uint32_t i = 0u; i < context.chunkCount; ++i)
+	{
+		context.chunkData[i] = AcquireCachedChunk(context.chunkIndices[i]);
+		context.chunkFailed[i] = false;
+		if (!context.chunkData[i])
+		{
+			decompressIndices[decompressCount++] = i;
+		}
+	}
+
+	context.decompressIndices = decompressIndices;
+	context.decompressedData = PDB_NEW_ARRAY(Byte*, decompressCount);
+	ParallelFor(m_options.parallelFor, m_options.userData, decompressCount, &MSFZFile::DecompressChunkJob, &context);
+
+	// assemble all streams from their fragments in parallel
+	context.streamData = PDB_NEW_ARRAY(Byte*, context.streamCount);
+	context.streamFailed = PDB_NEW_ARRAY(bool, context.streamCount);
+	ParallelFor(m_options.parallelFor, m_options.userData, context.streamCount, &MSFZFile::AssembleStreamJob, &context);
+
+	bool anyStreamFailed = false;
+	for (uint32_t i = 0u; i < context.streamCount; ++i)
+	{
+		anyStreamFailed |= context.streamFailed[i];
+
+		// another thread might have loaded the same stream in the meantime
+		const uint32_t streamIndex = context.streamIndices[i];
+		const Byte* expected = nullptr;
+		if (m_streamData[streamIndex].compare_exchange_strong(expected, context.streamData[i], std::memory_order_acq_rel))
+		{
+			m_ownedStreamData[streamIndex] = context.streamData[i];
+		}
+		else
+		{
+			PDB_DELETE_ARRAY(context.streamData[i]);
+		}
+	}
+
+	// release the chunks taken from the cache, and hand the decompressed chunks over to it so that other streams can make use of them.
+	// both the chunks and the indices of decompressed chunks are sorted, so the chunks taken from the cache are the ones in between.
+	for (uint32_t i = 0u, j = 0u; i < context.chunkCount; ++i)
+	{
+		if ((j < decompressCount) && (decompressIndices[j] == i))
+		{
+			++j;
+			continue;
+		}
+
+		ReleaseCachedChunk(context.chunkIndices[i]);
+	}
+
+	for (uint32_t i = 0u; i < decompressCount; ++i)
+	{
+		if (context.chunkFailed[decompressIndices[i]])
+		{
+			PDB_DELETE_ARRAY(context.decompressedData[i]);
+		}
+		else
+		{
+			AddToCache(context.chunkIndices[decompressIndices[i]], context.decompressedData[i]);
+		}
+	}
+
+	PDB_DELETE_ARRAY(context.chunkData);
+	PDB_DELETE_ARRAY(context.chunkFailed);
+	PDB_DELETE_ARRAY(decompressIndices);
+	PDB_DELETE_ARRAY(context.decompressedData);
+	PDB_DELETE_ARRAY(context.streamData);
+	PDB_DELETE_ARRAY(context.streamFailed);
+
+	return anyStreamFailed ? ErrorCode::InvalidStream : ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const void* PDB::MSFZFile::GetStreamData(uint32_t streamIndex) const PDB_NO_EXCEPT
+{
+	const Byte* data = m_streamData[streamIndex].load(std::memory_order_acquire);
+	if (data)
+	{
+		return data;
+	}
+
+	const ErrorCode error = LoadStreams(&streamIndex, 1u);
+	PDB_ASSERT(error == ErrorCode::Success, "Stream %u could not be decompressed.", streamIndex);
+	(void)error;
+
+	return m_streamData[streamIndex].load(std::memory_order_acquire);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::Byte* PDB::MSFZFile::GetFragmentDataInFile(const MSFZ::Fragment& fragment) const PDB_NO_EXCEPT
+{
+	if (!IsStoredInChunk(fragment))
+	{
+		const uint64_t fileOffset = (static_cast<uint64_t>(fragment.locationHigh) << 32u) | fragment.locationLow;
+		return m_data + fileOffset;
+	}
+
+	// fragments of chunks that are stored without compression can be used directly, too
+	const uint32_t chunkIndex = GetChunkIndex(fragment);
+	if ((chunkIndex < m_chunkCount) && (m_chunks[chunkIndex].compression == MSFZ::Compression::None) && (static_cast<uint64_t>(fragment.locationLow) + fragment.size <= m_chunks[chunkIndex].compressedSize))
+	{
+		return m_data + m_chunks[chunkIndex].fileOffset + fragment.locationLow;
+	}
+
+	return nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::Byte* PDB::MSFZFile::AcquireCachedChunk(uint32_t chunkIndex) const PDB_NO_EXCEPT
+{
+	Lock();
+
+	const Byte* data = m_cachedChunks[chunkIndex];
+	if (data)
+	{
+		++m_cachedChunkReferenceCounts[chunkIndex];
+		m_cachedChunkLastUse[chunkIndex] = ++m_useCounter;
+	}
+
+	Unlock();
+
+	return data;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MSFZFile::ReleaseCachedChunk(uint32_t chunkIndex) const PDB_NO_EXCEPT
+{
+	Lock();
+
+	PDB_ASSERT(m_cachedChunkReferenceCounts[chunkIndex] != 0u, "Chunk %u is not referenced.", chunkIndex);
+	--m_cachedChunkReferenceCounts[chunkIndex];
+
+	Unlock();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MSFZFile::AddToCache(uint32_t chunkIndex, Byte* data) const PDB_NO_EXCEPT
+{
+	Lock();
+
+	if (m_cachedChunks[chunkIndex])
+	{
+		// another thread decompressed the same chunk in the meantime
+		Unlock();
+		PDB_DELETE_ARRAY(data);
+
+		return;
+	}
+
+	m_cachedChunks[chunkIndex] = data;
+	m_cachedChunkLastUse[chunkIndex] = ++m_useCounter;
+	m_cachedSize += m_chunks[chunkIndex].uncompressedSize;
+
+	// evict the least recently used chunks that are not in use by any thread
+	while (m_cachedSize > m_options.chunkCacheCapacity)
+	{
+		uint32_t evictIndex = m_chunkCount;
+		for (uint32_t i = 0u; i < m_chunkCount; ++i)
+		{
+			if (m_cachedChunks[i] && (m_cachedChunkReferenceCounts[i] == 0u) && ((evictIndex == m_chunkCount) || (m_cachedChunkLastUse[i] < m_cachedChunkLastUse[evictIndex])))
+			{
+				evictIndex = i;
+			}
+		}
+
+		if (evictIndex == m_chunkCount)
+		{
+			break;
+		}
+
+		PDB_DELETE_ARRAY(m_cachedChunks[evictIndex]);
+		m_cachedChunks[evictIndex] = nullptr;
+		m_cachedSize -= m_chunks[evictIndex].uncompressedSize;
+	}
+
+	Unlock();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MSFZFile::Lock(void) const PDB_NO_EXCEPT
+{
+	// the lock is only ever held for a few instructions, decompression happens outside of it
+	while (m_lock.test_and_set(std::memory_order_acquire))
+	{
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MSFZFile::Unlock(void) const PDB_NO_EXCEPT
+{
+	m_lock.clear(std::memory_order_release);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MSFZFile::DecompressChunkJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+{
+	LoadContext& context = *static_cast<LoadContext*>(jobData);
+	const MSFZFile& file = *context.file;
+
+	const uint32_t chunkDataIndex = context.decompressIndices[index];
+	const MSFZ::ChunkEntry& chunk = file.m_chunks[context.chunkIndices[chunkDataIndex]];
+
+	Byte* data = PDB_NEW_ARRAY(Byte, chunk.uncompressedSize);
+	const MSFZ::Options& options = file.m_options;
+	if (!options.decompress || !options.decompress(options.userData, chunk.compression, file.m_data + chunk.fileOffset, chunk.compressedSize, data, chunk.uncompressedSize))
+	{
+		context.chunkFailed[chunkDataIndex] = true;
+	}
+
+	context.decompressedData[index] = data;
+	context.chunkData[chunkDataIndex] = data;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MSFZFile::AssembleStreamJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+{
+	LoadContext& context = *static_cast<LoadContext*>(jobData);
+	const MSFZFile& file = *context.file;
+
+	const uint32_t streamIndex = context.streamIndices[index];
+	const uint32_t streamSize = file.m_streamSizes[streamIndex];
+
+	Byte* data = PDB_NEW_ARRAY(Byte, streamSize);
+	bool failed = false;
+
+	size_t offset = 0u;
+	for (uint32_t i = file.m_streamFragmentOffsets[streamIndex]; i < file.m_streamFragmentOffsets[streamIndex + 1u]; ++i)
+	{
+		const MSFZ::Fragment& fragment = file.m_fragments[i];
+
+		const Byte* source = file.GetFragmentDataInFile(fragment);
+		if (!source)
+		{
+			const uint32_t chunkIndex = GetChunkIndex(fragment);
+			const size_t chunkDataIndex = Algorithm::LowerBound(context.chunkIndices, context.chunkCount, chunkIndex);
+			if ((chunkDataIndex != context.chunkCount) && (context.chunkIndices[chunkDataIndex] == chunkIndex) && !context.chunkFailed[chunkDataIndex] &&
+				(static_cast<uint64_t>(fragment.locationLow) + fragment.size <= file.m_chunks[chunkIndex].uncompressedSize))
+			{
+				source = context.chunkData[chunkDataIndex] + fragment.locationLow;
+			}
+		}
+
+		if (!source)
+		{
+			failed = true;
+			break;
+		}
+
+		std::memcpy(data + offset, source, fragment.size);
+		offset += fragment.size;
+	}
+
+	if (failed)
+	{
+		std::memset(data, 0, streamSize);
+	}
+
+	context.streamData[index] = data;
+	context.streamFailed[index] = failed;
+}
@@ -0,0 +1,93 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <atomic>
+#include "Foundation/PDB_DisableWarningsPop.h"
+#include "PDB_ErrorCodes.h"
+#include "PDB_MSFZTypes.h"
+#include "PDB_Types.h"
+
+
+namespace PDB
+{
+	// Provides the streams of a compressed MSF container.
+	// Streams are assembled from their fragments the first time they are needed, and stay alive as long as the file.
+	// Chunks needed by several streams are decompressed once and kept in a cache of bounded size.
+	// All member functions can be called from several threads at once.
+	class PDB_NO_DISCARD MSFZFile
+	{
+	public:
+		explicit MSFZFile(const void* data, const MSFZ::Options& options) PDB_NO_EXCEPT;
+		~MSFZFile(void) PDB_NO_EXCEPT;
+
+		// Loads the given streams, decompressing all chunks they need in parallel.
+		// Streams that are already loaded are skipped. Returns an error if any chunk could not be decompressed.
+		PDB_NO_DISCARD ErrorCode LoadStreams(const uint32_t* streamIndices, size_t count) const PDB_NO_EXCEPT;
+
+		// Returns the contiguous data of the given stream, loading it if necessary.
+		// The data of streams that could not be decompressed is zero-filled.
+		PDB_NO_DISCARD const void* GetStreamData(uint32_t streamIndex) const PDB_NO_EXCEPT;
+
+		// Returns the number of streams in the file.
+		PDB_NO_DISCARD inline uint32_t GetStreamCount(void) const PDB_NO_EXCEPT
+		{
+			return m_streamCount;
+		}
+
+		// Returns the sizes of all streams, NilPageSize for nil streams.
+		PDB_NO_DISCARD inline const uint32_t* GetStreamSizes(void) const PDB_NO_EXCEPT
+		{
+			return m_streamSizes;
+		}
+
+	private:
+		struct LoadContext;
+
+		// Returns the data of a fragment if it is stored contiguously in the file, or nullptr if it is part of a compressed chunk.
+		PDB_NO_DISCARD const Byte* GetFragmentDataInFile(const MSFZ::Fragment& fragment) const PDB_NO_EXCEPT;
+
+		// Returns the cached data of a decompressed chunk and keeps it alive until released, or nullptr if it is not cached.
+		PDB_NO_DISCARD const Byte* AcquireCachedChunk(uint32_t chunkIndex) const PDB_NO_EXCEPT;
+		void ReleaseCachedChunk(uint32_t chunkIndex) const PDB_NO_EXCEPT;
+
+		// Hands ownership of a decompressed chunk to the cache, evicting the least recently used chunks that exceed the capacity.
+		void AddToCache(uint32_t chunkIndex, Byte* data) const PDB_NO_EXCEPT;
+
+		void Lock(void) const PDB_NO_EXCEPT;
+		void Unlock(void) const PDB_NO_EXCEPT;
+
+		static void DecompressChunkJob(void* jobData, uint32_t index) PDB_NO_EXCEPT;
+		static void AssembleStreamJob(void* jobData, uint32_t index) PDB_NO_EXCEPT;
+
+		const Byte* m_data;
+		MSFZ::Options m_options;
+
+		const MSFZ::ChunkEntry* m_chunks;
+		uint32_t m_chunkCount;
+
+		// fragments of all streams, stream i owns the fragments [m_streamFragmentOffsets[i], m_streamFragmentOffsets[i + 1])
+		uint32_t m_streamCount;
+		uint32_t* m_streamSizes;
+		MSFZ::Fragment* m_fragments;
+		uint32_t* m_streamFragmentOffsets;
+
+		// loaded streams, published atomically. streams either point into the file or into memory owned by the loading thread
+		// that published them.
+		mutable std::atomic<const Byte*>* m_streamData;
+		mutable Byte** m_ownedStreamData;
+
+		// chunk cache, guarded by a spin lock
+		mutable std::atomic_flag m_lock;
+		mutable Byte** m_cachedChunks;
+		mutable uint32_t* m_cachedChunkReferenceCounts;
+		mutable uint64_t* m_cachedChunkLastUse;
+		mutable size_t m_cachedSize;
+		mutable uint64_t m_useCounter;
+
+		PDB_DISABLE_COPY_MOVE(MSFZFile);
+	};
+}
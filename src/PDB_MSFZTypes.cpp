@@ -0,0 +1,12 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_MSFZTypes.h"
+
+
+const char PDB::MSFZ::FileHeader::MAGIC[32u] = { 'M', 'i', 'c', 'r', 'o', 's', 'o', 'f', 't', ' ', 'M', 'S', 'F', 'Z', ' ', 'C', 'o', 'n', 't', 'a', 'i', 'n', 'e', 'r', '\r', '\n', '\x1a', 'A', 'L', 'D', '\0', '\0' };
+const uint64_t PDB::MSFZ::FileHeader::Version = 0u;
+
+const uint32_t PDB::MSFZ::Fragment::NilStreamSize = 0xffffffffu;
+const uint32_t PDB::MSFZ::Fragment::ChunkBit = 0x80000000u;
@@ -0,0 +1,91 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ParallelFor.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstdint>
+#include <cstddef>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+// Compressed MSF container (MSFZ). Instead of fixed-size blocks, streams consist of fragments that are either stored
+// uncompressed in the file, or as part of a compressed chunk.
+// https://github.com/microsoft/pdb-rs/tree/main/msfz
+namespace PDB
+{
+	namespace MSFZ
+	{
+		enum class PDB_NO_DISCARD Compression : uint32_t
+		{
+			None = 0u,
+			Zstd = 1u,
+			Deflate = 2u
+		};
+
+		struct FileHeader
+		{
+			static const char MAGIC[32u];
+			static const uint64_t Version;
+
+			char signature[32u];
+			uint64_t version;
+			uint64_t streamDirectoryOffset;
+			uint64_t chunkTableOffset;
+			uint32_t streamCount;
+			Compression streamDirectoryCompression;
+			uint32_t streamDirectoryCompressedSize;
+			uint32_t streamDirectoryUncompressedSize;
+			uint32_t chunkCount;
+			uint32_t chunkTableSize;
+		};
+
+		static_assert(sizeof(FileHeader) == 80u, "Size mismatch.");
+
+#pragma pack(push, 1)
+		struct ChunkEntry
+		{
+			uint64_t fileOffset;
+			Compression compression;
+			uint32_t compressedSize;
+			uint32_t uncompressedSize;
+		};
+#pragma pack(pop)
+
+		static_assert(sizeof(ChunkEntry) == 20u, "Size mismatch.");
+
+		// the stream directory stores a list of fragments for each stream, terminated by a fragment of size 0.
+		// nil streams are stored as a single size of NilStreamSize, without any fragments.
+		struct Fragment
+		{
+			static const uint32_t NilStreamSize;
+			static const uint32_t ChunkBit;
+
+			uint32_t size;
+			uint32_t locationLow;
+			uint32_t locationHigh;								// if ChunkBit is set, the fragment is stored at offset locationLow in chunk (locationHigh & ~ChunkBit)
+		};
+
+		static_assert(sizeof(Fragment) == 12u, "Size mismatch.");
+
+		// Decompresses a chunk of data. Returns whether the data could be decompressed into exactly uncompressedSize bytes.
+		typedef bool (*DecompressFunction)(void* userData, Compression compression, const void* compressedData, uint32_t compressedSize, void* uncompressedData, uint32_t uncompressedSize);
+
+		// raw_pdb doesn't depend on any compression library or threading facility, both are provided by the user.
+		struct Options
+		{
+			// called from several threads at once if a parallel loop is provided. without a function, only uncompressed chunks can be read.
+			DecompressFunction decompress = nullptr;
+
+			// without a function, chunks are decompressed one after another
+			ParallelForFunction parallelFor = nullptr;
+
+			void* userData = nullptr;
+
+			// maximum number of bytes of decompressed chunks that are kept around for loading further streams
+			size_t chunkCacheCapacity = 64u * 1024u * 1024u;
+		};
+	}
+}
@@ -0,0 +1,372 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_MappedFile.h"
+#include "Foundation/PDB_Platform.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#if PDB_PLATFORM_WINDOWS
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	ifndef WIN32_LEAN_AND_MEAN
+#		define WIN32_LEAN_AND_MEAN
+#	endif
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+namespace
+{
+	// both a POSIX file descriptor of -1 and INVALID_HANDLE_VALUE
+	static constexpr const intptr_t InvalidFile = -1;
+
+#if !PDB_PLATFORM_WINDOWS
+	// huge pages of the page cache are PMD-sized, which is 2 MiB on x64 and on ARM64 with 4 KiB pages
+	static constexpr const size_t HugePageSize = 2u * 1024u * 1024u;
+
+
+	PDB_NO_DISCARD static inline uintptr_t AlignUp(uintptr_t value, uintptr_t alignment) PDB_NO_EXCEPT
+	{
+		return (value + alignment - 1u) & ~(alignment - 1u);
+	}
+
+
+	PDB_NO_DISCARD static int GetAdvice(PDB::MappedFile::AccessPattern accessPattern) PDB_NO_EXCEPT
+	{
+		switch (accessPattern)
+		{
+			case PDB::MappedFile::AccessPattern::Normal:
+				return MADV_NORMAL;
+
+			case PDB::MappedFile::AccessPattern::Sequential:
+				return MADV_SEQUENTIAL;
+
+			case PDB::MappedFile::AccessPattern::Random:
+				return MADV_RANDOM;
+		}
+
+		return MADV_NORMAL;
+	}
+
+
+	// Maps the file at an address aligned to a huge page, which is a requirement for the kernel to back it with huge pages.
+	// An anonymous region large enough for aligning the mapping is reserved first, and the parts not used by the file are unmapped.
+	PDB_NO_DISCARD static void* MapAlignedToHugePage(int file, size_t size, int flags) PDB_NO_EXCEPT
+	{
+		const size_t reservationSize = size + HugePageSize;
+		void* reservation = mmap(nullptr, reservationSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (reservation == MAP_FAILED)
+		{
+			return MAP_FAILED;
+		}
+
+		const uintptr_t reservationBegin = reinterpret_cast<uintptr_t>(reservation);
+		const uintptr_t reservationEnd = reservationBegin + reservationSize;
+		const uintptr_t alignedBegin = AlignUp(reservationBegin, HugePageSize);
+
+		void* data = mmap(reinterpret_cast<void*>(alignedBegin), size, PROT_READ, flags | MAP_FIXED, file, 0);
+		if (data == MAP_FAILED)
+		{
+			munmap(reservation, reservationSize);
+
+			return MAP_FAILED;
+		}
+
+		// the file occupies whole pages, everything around them is released again
+		const uintptr_t alignedEnd = AlignUp(alignedBegin + size, static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)));
+		if (alignedBegin != reservationBegin)
+		{
+			munmap(reservation, alignedBegin - reservationBegin);
+		}
+
+		if (alignedEnd < reservationEnd)
+		{
+			munmap(reinterpret_cast<void*>(alignedEnd), reservationEnd - alignedEnd);
+		}
+
+		return data;
+	}
+#endif
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::MappedFile::Options PDB::MappedFile::ForIndexBuild(void) PDB_NO_EXCEPT
+{
+	// every page is going to be touched, so reading the file up front and with large read-ahead is cheapest
+	Options options;
+	options.accessPattern = AccessPattern::Sequential;
+	options.populate = true;
+
+	return options;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::MappedFile::Options PDB::MappedFile::ForPointLookups(void) PDB_NO_EXCEPT
+{
+	// only a few pages are going to be touched, read-ahead would mostly read data that is never accessed
+	Options options;
+	options.accessPattern = AccessPattern::Random;
+	options.populate = false;
+
+	return options;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MappedFile::MappedFile(void) PDB_NO_EXCEPT
+	: m_data(nullptr)
+	, m_size(0u)
+	, m_file(InvalidFile)
+	, m_fileMapping(0)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MappedFile::MappedFile(MappedFile&& other) PDB_NO_EXCEPT
+	: m_data(PDB_MOVE(other.m_data))
+	, m_size(PDB_MOVE(other.m_size))
+	, m_file(PDB_MOVE(other.m_file))
+	, m_fileMapping(PDB_MOVE(other.m_fileMapping))
+{
+	other.m_data = nullptr;
+	other.m_size = 0u;
+	other.m_file = InvalidFile;
+	other.m_fileMapping = 0;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MappedFile& PDB::MappedFile::operator=(MappedFile&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		Close();
+
+		m_data = PDB_MOVE(other.m_data);
+		m_size = PDB_MOVE(other.m_size);
+		m_file = PDB_MOVE(other.m_file);
+		m_fileMapping = PDB_MOVE(other.m_fileMapping);
+
+		other.m_data = nullptr;
+		other.m_size = 0u;
+		other.m_file = InvalidFile;
+		other.m_fileMapping = 0;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MappedFile::MappedFile(const char* path) PDB_NO_EXCEPT
+	: MappedFile(path, Options())
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MappedFile::MappedFile(const char* path, const Options& options) PDB_NO_EXCEPT
+	: m_data(nullptr)
+	, m_size(0u)
+	, m_file(InvalidFile)
+	, m_fileMapping(0)
+{
+#if PDB_PLATFORM_WINDOWS
+	// the cache manager uses these flags for choosing how much to read ahead
+	DWORD flags = FILE_ATTRIBUTE_READONLY;
+	if (options.accessPattern == AccessPattern::Sequential)
+	{
+		flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+	}
+	else if (options.accessPattern == AccessPattern::Random)
+	{
+		flags |= FILE_FLAG_RANDOM_ACCESS;
+	}
+
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	m_file = reinterpret_cast<intptr_t>(file);
+
+	LARGE_INTEGER size = {};
+	if (!GetFileSizeEx(file, &size) || (size.QuadPart <= 0) || (static_cast<uint64_t>(size.QuadPart) > static_cast<uint64_t>(SIZE_MAX)))
+	{
+		Close();
+
+		return;
+	}
+
+	HANDLE fileMapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!fileMapping)
+	{
+		Close();
+
+		return;
+	}
+
+	m_fileMapping = reinterpret_cast<intptr_t>(fileMapping);
+
+	void* data = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+	if (!data)
+	{
+		Close();
+
+		return;
+	}
+
+	m_data = data;
+	m_size = static_cast<size_t>(size.QuadPart);
+
+#	if defined(_WIN32_WINNT) && (_WIN32_WINNT >= 0x0602)
+	if (options.populate)
+	{
+		// failing to prefetch only makes accessing the file slower
+		WIN32_MEMORY_RANGE_ENTRY range = { data, m_size };
+		(void)PrefetchVirtualMemory(GetCurrentProcess(), 1u, &range, 0u);
+	}
+#	endif
+#else
+	const int file = open(path, O_RDONLY | O_CLOEXEC);
+	if (file == -1)
+	{
+		return;
+	}
+
+	m_file = static_cast<intptr_t>(file);
+
+	struct stat status = {};
+	if ((fstat(file, &status) == -1) || (status.st_size <= 0) || (static_cast<uint64_t>(status.st_size) > static_cast<uint64_t>(SIZE_MAX)))
+	{
+		Close();
+
+		return;
+	}
+
+	const size_t size = static_cast<size_t>(status.st_size);
+
+	int flags = options.shared ? MAP_SHARED : MAP_PRIVATE;
+#	ifdef MAP_POPULATE
+	if (options.populate)
+	{
+		flags |= MAP_POPULATE;
+	}
+#	endif
+
+	// mapping the file somewhere else is fine if it cannot be aligned
+	void* data = options.hugePages ? MapAlignedToHugePage(file, size, flags) : MAP_FAILED;
+	if (data == MAP_FAILED)
+	{
+		data = mmap(nullptr, size, PROT_READ, flags, file, 0);
+		if (data == MAP_FAILED)
+		{
+			Close();
+
+			return;
+		}
+	}
+
+	m_data = data;
+	m_size = size;
+
+	// all hints are only hints, failing to apply them doesn't make the mapping unusable
+#	ifdef MADV_HUGEPAGE
+	if (options.hugePages)
+	{
+		(void)madvise(data, size, MADV_HUGEPAGE);
+	}
+#	endif
+
+#	ifndef MAP_POPULATE
+	if (options.populate)
+	{
+		(void)madvise(data, size, MADV_WILLNEED);
+	}
+#	endif
+
+	Advise(options.accessPattern);
+#endif
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MappedFile::~MappedFile(void) PDB_NO_EXCEPT
+{
+	Close();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MappedFile::Advise(AccessPattern accessPattern) const PDB_NO_EXCEPT
+{
+	if (!m_data)
+	{
+		return;
+	}
+
+#if PDB_PLATFORM_WINDOWS
+	// the access pattern of a file can only be chosen when opening it
+	(void)accessPattern;
+#else
+	(void)madvise(const_cast<void*>(m_data), m_size, GetAdvice(accessPattern));
+#endif
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::MappedFile::Close(void) PDB_NO_EXCEPT
+{
+#if PDB_PLATFORM_WINDOWS
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+
+	if (m_fileMapping)
+	{
+		CloseHandle(reinterpret_cast<HANDLE>(m_fileMapping));
+	}
+
+	if (m_file != InvalidFile)
+	{
+		CloseHandle(reinterpret_cast<HANDLE>(m_file));
+	}
+#else
+	if (m_data)
+	{
+		munmap(const_cast<void*>(m_data), m_size);
+	}
+
+	if (m_file != InvalidFile)
+	{
+		close(static_cast<int>(m_file));
+	}
+#endif
+
+	m_data = nullptr;
+	m_size = 0u;
+	m_file = InvalidFile;
+	m_fileMapping = 0;
+}
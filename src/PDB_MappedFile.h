@@ -0,0 +1,95 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstddef>
+#include <cstdint>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+namespace PDB
+{
+	// A file mapped read-only into memory, which is unmapped and closed when the object is destroyed.
+	// The mapping can be handed over to a RawFile, tying its lifetime to the file read from it.
+	// The options tell the operating system how the file is going to be accessed, which mostly affects how much is read ahead
+	// on page faults. Options not supported by a platform are ignored, the file is mapped regardless.
+	class PDB_NO_DISCARD MappedFile
+	{
+	public:
+		enum class PDB_NO_DISCARD AccessPattern : uint8_t
+		{
+			Normal,												// default read-ahead
+			Sequential,											// aggressive read-ahead, pages can be dropped soon after being read
+			Random												// no read-ahead, only the touched pages are read
+		};
+
+		struct Options
+		{
+			AccessPattern accessPattern = AccessPattern::Normal;
+
+			// reads the whole file while mapping it, so that accessing it later never faults. Linux only (MAP_POPULATE), and
+			// using PrefetchVirtualMemory on Windows.
+			bool populate = false;
+
+			// maps the file as shared instead of as private copy-on-write memory. the mapping is read-only either way, but a shared
+			// mapping never needs to reserve memory for copies. Linux only, file views are always shared on Windows.
+			bool shared = true;
+
+			// aligns the mapping to a huge page and asks for it to be backed by huge pages, saving TLB misses when accessing
+			// large files all over the place. Linux only, and only effective if the kernel supports huge pages for the page cache.
+			bool hugePages = false;
+		};
+
+		// Options for reading the whole file once, e.g. when building indices over all symbols or types.
+		PDB_NO_DISCARD static Options ForIndexBuild(void) PDB_NO_EXCEPT;
+
+		// Options for looking up a few records in a large file, e.g. when symbolizing addresses with a prebuilt index.
+		PDB_NO_DISCARD static Options ForPointLookups(void) PDB_NO_EXCEPT;
+
+		MappedFile(void) PDB_NO_EXCEPT;
+		MappedFile(MappedFile&& other) PDB_NO_EXCEPT;
+		MappedFile& operator=(MappedFile&& other) PDB_NO_EXCEPT;
+
+		// Opens and maps the file at the given path. Check IsOpen() for whether this succeeded.
+		explicit MappedFile(const char* path) PDB_NO_EXCEPT;
+		explicit MappedFile(const char* path, const Options& options) PDB_NO_EXCEPT;
+		~MappedFile(void) PDB_NO_EXCEPT;
+
+		// Changes the access pattern of an open file, e.g. after building indices and before looking up records.
+		void Advise(AccessPattern accessPattern) const PDB_NO_EXCEPT;
+
+		PDB_NO_DISCARD inline bool IsOpen(void) const PDB_NO_EXCEPT
+		{
+			return (m_data != nullptr);
+		}
+
+		PDB_NO_DISCARD inline const void* GetData(void) const PDB_NO_EXCEPT
+		{
+			return m_data;
+		}
+
+		PDB_NO_DISCARD inline size_t GetSize(void) const PDB_NO_EXCEPT
+		{
+			return m_size;
+		}
+
+		// Returns the POSIX file descriptor or Windows HANDLE of the file, which stays open while the file is mapped.
+		PDB_NO_DISCARD inline intptr_t GetFileHandle(void) const PDB_NO_EXCEPT
+		{
+			return m_file;
+		}
+
+	private:
+		void Close(void) PDB_NO_EXCEPT;
+
+		const void* m_data;
+		size_t m_size;
+		intptr_t m_file;
+		intptr_t m_fileMapping;
+
+		PDB_DISABLE_COPY(MappedFile);
+	};
+}
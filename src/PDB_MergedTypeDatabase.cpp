@@ -0,0 +1,556 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_MergedTypeDatabase.h"
+#include "PDB_TypeTable.h"
+#include "PDB_GlobalTypeHashes.h"
+#include "PDB_TypeReferences.h"
+#include "PDB_IndexImage.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+const char PDB::MergedTypeDatabase::Header::MAGIC[8u] = { 'R', 'P', 'D', 'B', 'T', 'Y', 'P', '\0' };
+
+
+namespace
+{
+	// unique records are copied and remapped in chunks
+	static constexpr const uint32_t RecordsPerJob = 4096u;
+
+	// type indices stored in records are 32-bit, which limits the number of unique records
+	static constexpr const size_t MaxRecordCount = 0xFFFFFFFFu - PDB::MergedTypeDatabase::FirstTypeIndex;
+
+
+	// The source and position of the first occurrence of a unique record.
+	struct RecordOrigin
+	{
+		uint32_t sourceIndex;
+		uint32_t position;
+	};
+
+	struct HashContext
+	{
+		const PDB::TypeTable* const* typeTables;
+		PDB::GlobalTypeHashes* hashes;
+	};
+
+	struct CopyContext
+	{
+		const PDB::TypeTable* const* typeTables;
+		const PDB::MergedTypeDatabase::Source* sources;
+		const uint32_t* remappedIndices;
+		const RecordOrigin* origins;
+		const uint64_t* recordOffsets;
+		size_t recordCount;
+		PDB::Byte* records;
+	};
+
+
+	PDB_NO_DISCARD static inline size_t GetRecordSize(const PDB::CodeView::TPI::Record* record) PDB_NO_EXCEPT
+	{
+		return static_cast<size_t>(record->header.size) + sizeof(uint16_t);
+	}
+
+
+	PDB_NO_DISCARD static inline size_t AlignRecordSize(size_t size) PDB_NO_EXCEPT
+	{
+		return (size + 3u) & ~static_cast<size_t>(3u);
+	}
+
+
+	// Returns the slot of the given hash in the hash table, which is either empty or holds the type index with that hash.
+	PDB_NO_DISCARD static inline size_t FindSlot(const uint32_t* hashTable, size_t hashTableSize, const uint64_t* hashes, uint64_t hash) PDB_NO_EXCEPT
+	{
+		const size_t mask = hashTableSize - 1u;
+		for (size_t slot = static_cast<size_t>(hash) & mask; /* empty */; slot = (slot + 1u) & mask)
+		{
+			const uint32_t typeIndex = hashTable[slot];
+			if ((typeIndex == 0u) || (hashes[typeIndex - PDB::MergedTypeDatabase::FirstTypeIndex] == hash))
+			{
+				return slot;
+			}
+		}
+	}
+
+
+	// Rebuilds the hash table with twice the number of slots.
+	PDB_NO_DISCARD static uint32_t* GrowHashTable(uint32_t* hashTable, size_t& hashTableSize, const uint64_t* hashes) PDB_NO_EXCEPT
+	{
+		const size_t newSize = hashTableSize * 2u;
+		uint32_t* newHashTable = PDB_NEW_ARRAY(uint32_t, newSize);
+		std::memset(newHashTable, 0, newSize * sizeof(uint32_t));
+
+		for (size_t i = 0u; i < hashTableSize; ++i)
+		{
+			const uint32_t typeIndex = hashTable[i];
+			if (typeIndex != 0u)
+			{
+				newHashTable[FindSlot(newHashTable, newSize, hashes, hashes[typeIndex - PDB::MergedTypeDatabase::FirstTypeIndex])] = typeIndex;
+			}
+		}
+
+		PDB_DELETE_ARRAY(hashTable);
+		hashTableSize = newSize;
+
+		return newHashTable;
+	}
+
+
+	// Hashes all records of a single type table.
+	static void HashTypeTableJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const HashContext* context = static_cast<const HashContext*>(jobData);
+
+		// each table is hashed on the thread running the job, the tables themselves are the unit of parallelism
+		context->hashes[index] = PDB::GlobalTypeHashes(*context->typeTables[index], nullptr);
+	}
+
+
+	// Copies a chunk of unique records, remapping the type indices they store to global type indices.
+	static void CopyRecordsJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const CopyContext* context = static_cast<const CopyContext*>(jobData);
+
+		const size_t begin = static_cast<size_t>(index) * RecordsPerJob;
+		const size_t end = (begin + RecordsPerJob < context->recordCount) ? begin + RecordsPerJob : context->recordCount;
+
+		PDB::GrowableArray<PDB::TypeReference> references;
+		for (size_t i = begin; i < end; ++i)
+		{
+			const RecordOrigin& origin = context->origins[i];
+			const PDB::MergedTypeDatabase::Source& source = context->sources[origin.sourceIndex];
+			const PDB::CodeView::TPI::Record* record = context->typeTables[origin.sourceIndex]->GetTypeRecords()[origin.position];
+
+			const size_t recordSize = GetRecordSize(record);
+			PDB::Byte* destination = context->records + context->recordOffsets[i];
+			std::memcpy(destination, record, recordSize);
+			std::memset(destination + recordSize, 0, AlignRecordSize(recordSize) - recordSize);
+
+			references.Clear();
+			PDB::GetTypeReferences(record, references);
+
+			const PDB::TypeReference* referenceData = references.GetData();
+			for (size_t j = 0u; j < references.GetSize(); ++j)
+			{
+				uint32_t typeIndex = 0u;
+				std::memcpy(&typeIndex, destination + referenceData[j].offset, sizeof(typeIndex));
+
+				if (typeIndex < source.firstTypeIndex)
+				{
+					// simple types are the same in all PDBs
+					continue;
+				}
+
+				// indices out of range cannot be resolved and are turned into T_NOTYPE
+				typeIndex = (typeIndex - source.firstTypeIndex < source.typeCount)
+					? context->remappedIndices[source.remapOffset + typeIndex - source.firstTypeIndex]
+					: 0u;
+				std::memcpy(destination + referenceData[j].offset, &typeIndex, sizeof(typeIndex));
+			}
+		}
+	}
+
+
+	// Reads all arrays of a serialized database, returning whether all of them were stored completely.
+	PDB_NO_DISCARD static bool ReadArrays(PDB::IndexImageReader& reader, const PDB::MergedTypeDatabase::Source*& sources, size_t& sourceCount,
+		const uint32_t*& remappedIndices, size_t& remappedIndexCount, const uint64_t*& recordOffsets, size_t& recordCount,
+		const PDB::Byte*& records, size_t& recordsSize, const uint64_t*& hashes, const uint32_t*& hashTable, size_t& hashTableSize) PDB_NO_EXCEPT
+	{
+		size_t hashCount = 0u;
+		sources = reader.ReadArray<PDB::MergedTypeDatabase::Source>(sourceCount);
+		remappedIndices = reader.ReadArray<uint32_t>(remappedIndexCount);
+		recordOffsets = reader.ReadArray<uint64_t>(recordCount);
+		records = reader.ReadArray<PDB::Byte>(recordsSize);
+		hashes = reader.ReadArray<uint64_t>(hashCount);
+		hashTable = reader.ReadArray<uint32_t>(hashTableSize);
+
+		// the hash table must have a power-of-two size with at least one empty slot, otherwise lookups never finish
+		return reader.IsValid() && (hashCount == recordCount) && (hashTableSize > recordCount) && ((hashTableSize & (hashTableSize - 1u)) == 0u);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MergedTypeDatabase::MergedTypeDatabase(void) PDB_NO_EXCEPT
+	: m_sources(nullptr)
+	, m_sourceCount(0u)
+	, m_remappedIndices(nullptr)
+	, m_remappedIndexCount(0u)
+	, m_recordOffsets(nullptr)
+	, m_recordCount(0u)
+	, m_records(nullptr)
+	, m_recordsSize(0u)
+	, m_hashes(nullptr)
+	, m_hashTable(nullptr)
+	, m_hashTableSize(0u)
+	, m_ownsData(true)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MergedTypeDatabase::MergedTypeDatabase(MergedTypeDatabase&& other) PDB_NO_EXCEPT
+	: m_sources(PDB_MOVE(other.m_sources))
+	, m_sourceCount(PDB_MOVE(other.m_sourceCount))
+	, m_remappedIndices(PDB_MOVE(other.m_remappedIndices))
+	, m_remappedIndexCount(PDB_MOVE(other.m_remappedIndexCount))
+	, m_recordOffsets(PDB_MOVE(other.m_recordOffsets))
+	, m_recordCount(PDB_MOVE(other.m_recordCount))
+	, m_records(PDB_MOVE(other.m_records))
+	, m_recordsSize(PDB_MOVE(other.m_recordsSize))
+	, m_hashes(PDB_MOVE(other.m_hashes))
+	, m_hashTable(PDB_MOVE(other.m_hashTable))
+	, m_hashTableSize(PDB_MOVE(other.m_hashTableSize))
+	, m_ownsData(PDB_MOVE(other.m_ownsData))
+{
+	other.m_sources = nullptr;
+	other.m_sourceCount = 0u;
+	other.m_remappedIndices = nullptr;
+	other.m_remappedIndexCount = 0u;
+	other.m_recordOffsets = nullptr;
+	other.m_recordCount = 0u;
+	other.m_records = nullptr;
+	other.m_recordsSize = 0u;
+	other.m_hashes = nullptr;
+	other.m_hashTable = nullptr;
+	other.m_hashTableSize = 0u;
+	other.m_ownsData = true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MergedTypeDatabase& PDB::MergedTypeDatabase::operator=(MergedTypeDatabase&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		if (m_ownsData)
+		{
+			PDB_DELETE_ARRAY(m_sources);
+			PDB_DELETE_ARRAY(m_remappedIndices);
+			PDB_DELETE_ARRAY(m_recordOffsets);
+			PDB_DELETE_ARRAY(m_records);
+			PDB_DELETE_ARRAY(m_hashes);
+			PDB_DELETE_ARRAY(m_hashTable);
+		}
+
+		m_sources = PDB_MOVE(other.m_sources);
+		m_sourceCount = PDB_MOVE(other.m_sourceCount);
+		m_remappedIndices = PDB_MOVE(other.m_remappedIndices);
+		m_remappedIndexCount = PDB_MOVE(other.m_remappedIndexCount);
+		m_recordOffsets = PDB_MOVE(other.m_recordOffsets);
+		m_recordCount = PDB_MOVE(other.m_recordCount);
+		m_records = PDB_MOVE(other.m_records);
+		m_recordsSize = PDB_MOVE(other.m_recordsSize);
+		m_hashes = PDB_MOVE(other.m_hashes);
+		m_hashTable = PDB_MOVE(other.m_hashTable);
+		m_hashTableSize = PDB_MOVE(other.m_hashTableSize);
+		m_ownsData = PDB_MOVE(other.m_ownsData);
+
+		other.m_sources = nullptr;
+		other.m_sourceCount = 0u;
+		other.m_remappedIndices = nullptr;
+		other.m_remappedIndexCount = 0u;
+		other.m_recordOffsets = nullptr;
+		other.m_recordCount = 0u;
+		other.m_records = nullptr;
+		other.m_recordsSize = 0u;
+		other.m_hashes = nullptr;
+		other.m_hashTable = nullptr;
+		other.m_hashTableSize = 0u;
+		other.m_ownsData = true;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MergedTypeDatabase::MergedTypeDatabase(const TypeTable* const* typeTables, size_t typeTableCount, ParallelForFunction parallelFor, void* userData) PDB_NO_EXCEPT
+	: m_sources(nullptr)
+	, m_sourceCount(typeTableCount)
+	, m_remappedIndices(nullptr)
+	, m_remappedIndexCount(0u)
+	, m_recordOffsets(nullptr)
+	, m_recordCount(0u)
+	, m_records(nullptr)
+	, m_recordsSize(0u)
+	, m_hashes(nullptr)
+	, m_hashTable(nullptr)
+	, m_hashTableSize(0u)
+	, m_ownsData(true)
+{
+	// hash the records of all tables in parallel. hashing is by far the most expensive step, and each table is independent of the others.
+	GlobalTypeHashes* tableHashes = PDB_NEW_ARRAY(GlobalTypeHashes, typeTableCount);
+	{
+		HashContext context = { typeTables, tableHashes };
+		PDB::ParallelFor(parallelFor, userData, static_cast<uint32_t>(typeTableCount), &HashTypeTableJob, &context);
+	}
+
+	Source* sources = PDB_NEW_ARRAY(Source, typeTableCount);
+	for (size_t i = 0u; i < typeTableCount; ++i)
+	{
+		sources[i].firstTypeIndex = typeTables[i]->GetFirstTypeIndex();
+		sources[i].typeCount = static_cast<uint32_t>(typeTables[i]->GetTypeRecords().GetLength());
+		sources[i].remapOffset = m_remappedIndexCount;
+		m_remappedIndexCount += sources[i].typeCount;
+	}
+
+	// assign global type indices in the order of the tables and their records. the first occurrence of each record decides its
+	// global type index, so records only ever refer to records that were assigned an index before them.
+	uint32_t* remappedIndices = PDB_NEW_ARRAY(uint32_t, m_remappedIndexCount);
+	GrowableArray<uint64_t> hashes;
+	GrowableArray<RecordOrigin> origins;
+
+	size_t hashTableSize = 1024u;
+	uint32_t* hashTable = PDB_NEW_ARRAY(uint32_t, hashTableSize);
+	std::memset(hashTable, 0, hashTableSize * sizeof(uint32_t));
+
+	for (size_t i = 0u; i < typeTableCount; ++i)
+	{
+		const ArrayView<const CodeView::TPI::Record*> records = typeTables[i]->GetTypeRecords();
+		const ArrayView<uint64_t> recordHashes = tableHashes[i].GetTypeHashes();
+		uint32_t* sourceIndices = remappedIndices + sources[i].remapOffset;
+
+		for (uint32_t position = 0u; position < sources[i].typeCount; ++position)
+		{
+			if (!records[position])
+			{
+				// records of truncated streams are not available
+				sourceIndices[position] = 0u;
+				continue;
+			}
+
+			const uint64_t hash = recordHashes[position];
+			const size_t slot = FindSlot(hashTable, hashTableSize, hashes.GetData(), hash);
+			if (hashTable[slot] != 0u)
+			{
+				sourceIndices[position] = hashTable[slot];
+				continue;
+			}
+			else if (hashes.GetSize() == MaxRecordCount)
+			{
+				sourceIndices[position] = 0u;
+				continue;
+			}
+
+			const uint32_t typeIndex = FirstTypeIndex + static_cast<uint32_t>(hashes.GetSize());
+			hashes.Add(hash);
+			origins.Add(RecordOrigin { static_cast<uint32_t>(i), position });
+			hashTable[slot] = typeIndex;
+			sourceIndices[position] = typeIndex;
+
+			// keep the load factor below one half
+			if (hashes.GetSize() * 2u > hashTableSize)
+			{
+				hashTable = GrowHashTable(hashTable, hashTableSize, hashes.GetData());
+			}
+		}
+	}
+
+	PDB_DELETE_ARRAY(tableHashes);
+
+	m_recordCount = hashes.GetSize();
+	uint64_t* recordOffsets = PDB_NEW_ARRAY(uint64_t, m_recordCount);
+	{
+		const RecordOrigin* originData = origins.GetData();
+		for (size_t i = 0u; i < m_recordCount; ++i)
+		{
+			recordOffsets[i] = m_recordsSize;
+			m_recordsSize += AlignRecordSize(GetRecordSize(typeTables[originData[i].sourceIndex]->GetTypeRecords()[originData[i].position]));
+		}
+	}
+
+	Byte* records = PDB_NEW_ARRAY(Byte, m_recordsSize);
+	{
+		CopyContext context = {};
+		context.typeTables = typeTables;
+		context.sources = sources;
+		context.remappedIndices = remappedIndices;
+		context.origins = origins.GetData();
+		context.recordOffsets = recordOffsets;
+		context.recordCount = m_recordCount;
+		context.records = records;
+
+		const uint32_t jobCount = static_cast<uint32_t>((m_recordCount + RecordsPerJob - 1u) / RecordsPerJob);
+		PDB::ParallelFor(parallelFor, userData, jobCount, &CopyRecordsJob, &context);
+	}
+
+	m_sources = sources;
+	m_remappedIndices = remappedIndices;
+	m_recordOffsets = recordOffsets;
+	m_records = records;
+	m_hashes = hashes.Release();
+	m_hashTable = hashTable;
+	m_hashTableSize = hashTableSize;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MergedTypeDatabase::MergedTypeDatabase(const void* data) PDB_NO_EXCEPT
+	: m_sources(nullptr)
+	, m_sourceCount(0u)
+	, m_remappedIndices(nullptr)
+	, m_remappedIndexCount(0u)
+	, m_recordOffsets(nullptr)
+	, m_recordCount(0u)
+	, m_records(nullptr)
+	, m_recordsSize(0u)
+	, m_hashes(nullptr)
+	, m_hashTable(nullptr)
+	, m_hashTableSize(0u)
+	, m_ownsData(false)
+{
+	const Header* header = static_cast<const Header*>(data);
+	IndexImageReader reader(static_cast<const Byte*>(data) + sizeof(Header), static_cast<size_t>(header->size - sizeof(Header)));
+
+	if (!ReadArrays(reader, m_sources, m_sourceCount, m_remappedIndices, m_remappedIndexCount, m_recordOffsets, m_recordCount,
+		m_records, m_recordsSize, m_hashes, m_hashTable, m_hashTableSize))
+	{
+		// all accessors check a global type index against the record count, a source index against the source count and
+		// probe the hash table only if it has slots. with every count reset, a truncated database behaves like an empty one.
+		m_sourceCount = 0u;
+		m_remappedIndexCount = 0u;
+		m_recordCount = 0u;
+		m_recordsSize = 0u;
+		m_hashTableSize = 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::MergedTypeDatabase::~MergedTypeDatabase(void) PDB_NO_EXCEPT
+{
+	if (m_ownsData)
+	{
+		PDB_DELETE_ARRAY(m_sources);
+		PDB_DELETE_ARRAY(m_remappedIndices);
+		PDB_DELETE_ARRAY(m_recordOffsets);
+		PDB_DELETE_ARRAY(m_records);
+		PDB_DELETE_ARRAY(m_hashes);
+		PDB_DELETE_ARRAY(m_hashTable);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD size_t PDB::MergedTypeDatabase::Write(void* buffer) const PDB_NO_EXCEPT
+{
+	Byte* image = static_cast<Byte*>(buffer);
+
+	static_assert((sizeof(Header) & 7u) == 0u, "The arrays following the header must be aligned to 8 bytes.");
+	IndexImageWriter writer(image ? image + sizeof(Header) : nullptr);
+	writer.WriteArray(m_sources, m_sourceCount);
+	writer.WriteArray(m_remappedIndices, m_remappedIndexCount);
+	writer.WriteArray(m_recordOffsets, m_recordCount);
+	writer.WriteArray(m_records, m_recordsSize);
+	writer.WriteArray(m_hashes, m_recordCount);
+	writer.WriteArray(m_hashTable, m_hashTableSize);
+
+	Header header = {};
+	std::memcpy(header.magic, Header::MAGIC, sizeof(Header::MAGIC));
+	header.version = Header::Version;
+	header.sourceCount = static_cast<uint32_t>(m_sourceCount);
+	header.size = sizeof(Header) + writer.GetSize();
+
+	if (image)
+	{
+		// the header is written last, so that readers never see a complete header in front of incomplete arrays
+		std::memcpy(image, &header, sizeof(Header));
+	}
+
+	return static_cast<size_t>(header.size);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint32_t PDB::MergedTypeDatabase::GetGlobalTypeIndex(size_t sourceIndex, uint32_t typeIndex) const PDB_NO_EXCEPT
+{
+	if (sourceIndex >= m_sourceCount)
+	{
+		return 0u;
+	}
+
+	const Source& source = m_sources[sourceIndex];
+	if (typeIndex < source.firstTypeIndex)
+	{
+		return typeIndex;
+	}
+	else if (typeIndex - source.firstTypeIndex >= source.typeCount)
+	{
+		return 0u;
+	}
+
+	return m_remappedIndices[source.remapOffset + typeIndex - source.firstTypeIndex];
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint32_t PDB::MergedTypeDatabase::FindTypeIndex(uint64_t hash) const PDB_NO_EXCEPT
+{
+	if (m_hashTableSize == 0u)
+	{
+		return 0u;
+	}
+
+	return m_hashTable[FindSlot(m_hashTable, m_hashTableSize, m_hashes, hash)];
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::ValidateMergedTypeDatabase(const void* data, size_t size) PDB_NO_EXCEPT
+{
+	if (size < sizeof(MergedTypeDatabase::Header))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	const MergedTypeDatabase::Header* header = static_cast<const MergedTypeDatabase::Header*>(data);
+	if (std::memcmp(header->magic, MergedTypeDatabase::Header::MAGIC, sizeof(MergedTypeDatabase::Header::MAGIC)) != 0)
+	{
+		return ErrorCode::InvalidSignature;
+	}
+
+	if (header->version != MergedTypeDatabase::Header::Version)
+	{
+		return ErrorCode::UnknownVersion;
+	}
+
+	if ((header->size < sizeof(MergedTypeDatabase::Header)) || (header->size > size))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	// only the layout is validated, the records and indices themselves are expected to be written by a trusted process
+	IndexImageReader reader(static_cast<const Byte*>(data) + sizeof(MergedTypeDatabase::Header), static_cast<size_t>(header->size - sizeof(MergedTypeDatabase::Header)));
+
+	const MergedTypeDatabase::Source* sources = nullptr;
+	const uint32_t* remappedIndices = nullptr;
+	const uint64_t* recordOffsets = nullptr;
+	const Byte* records = nullptr;
+	const uint64_t* hashes = nullptr;
+	const uint32_t* hashTable = nullptr;
+	size_t sourceCount = 0u;
+	size_t remappedIndexCount = 0u;
+	size_t recordCount = 0u;
+	size_t recordsSize = 0u;
+	size_t hashTableSize = 0u;
+	if (!ReadArrays(reader, sources, sourceCount, remappedIndices, remappedIndexCount, recordOffsets, recordCount, records, recordsSize, hashes, hashTable, hashTableSize) ||
+		(sourceCount != header->sourceCount))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	return ErrorCode::Success;
+}
@@ -0,0 +1,161 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_ParallelFor.h"
+#include "PDB_ErrorCodes.h"
+#include "PDB_Types.h"
+#include "PDB_TPITypes.h"
+
+
+namespace PDB
+{
+	class TypeTable;
+
+
+	// A single type database holding the TPI records of several PDBs, e.g. of all modules loaded into a process.
+	// Structurally identical records are stored only once, identified by their global type hash (see GlobalTypeHashes), and
+	// all type indices stored in the records are remapped into one global index space. Records of the first PDB keep their
+	// relative order, and records of later PDBs that are not already known are appended, so records still only refer to
+	// records with lower indices.
+	// The database can be written into a position-independent image and opened from memory without copying any data, so
+	// that it can be built once and mapped read-only by several processes.
+	class PDB_NO_DISCARD MergedTypeDatabase
+	{
+	public:
+		struct Header
+		{
+			static const char MAGIC[8u];
+			static const uint32_t Version = 1u;
+
+			char magic[8u];
+			uint32_t version;
+			uint32_t sourceCount;								// number of merged PDBs
+			uint64_t size;										// size of the whole image including the header
+		};
+
+		// Describes where the remapped type indices of a merged PDB are stored.
+		struct Source
+		{
+			uint32_t firstTypeIndex;							// first and number of type indices of the PDB
+			uint32_t typeCount;
+			uint64_t remapOffset;								// offset of the global indices of its records in the remapped indices
+		};
+
+		// global type indices start where the type indices of PDBs start
+		static constexpr const uint32_t FirstTypeIndex = 0x1000u;
+
+		MergedTypeDatabase(void) PDB_NO_EXCEPT;
+		MergedTypeDatabase(MergedTypeDatabase&& other) PDB_NO_EXCEPT;
+		MergedTypeDatabase& operator=(MergedTypeDatabase&& other) PDB_NO_EXCEPT;
+
+		// Merges the records of the given type tables. Records of all tables are hashed in parallel, one table per job, and
+		// the unique records are then copied and remapped in parallel if a parallel loop is given.
+		// The type tables are only accessed while the database is built.
+		explicit MergedTypeDatabase(const TypeTable* const* typeTables, size_t typeTableCount, ParallelForFunction parallelFor = nullptr, void* userData = nullptr) PDB_NO_EXCEPT;
+
+		// Creates a database referring to a serialized image. The image must have been validated using
+		// ValidateMergedTypeDatabase(), and must outlive the database.
+		explicit MergedTypeDatabase(const void* data) PDB_NO_EXCEPT;
+		~MergedTypeDatabase(void) PDB_NO_EXCEPT;
+
+		// Writes the database into a position-independent image. Returns the size of the image.
+		// Pass a nullptr buffer to compute the size of the image without writing it.
+		PDB_NO_DISCARD size_t Write(void* buffer) const PDB_NO_EXCEPT;
+
+		// Returns the first global type index. Indices below are simple types, which are the same in all PDBs.
+		PDB_NO_DISCARD inline uint32_t GetFirstTypeIndex(void) const PDB_NO_EXCEPT
+		{
+			return FirstTypeIndex;
+		}
+
+		// Returns the index behind the last global type.
+		PDB_NO_DISCARD inline uint32_t GetLastTypeIndex(void) const PDB_NO_EXCEPT
+		{
+			return FirstTypeIndex + static_cast<uint32_t>(m_recordCount);
+		}
+
+		// Returns the number of unique records.
+		PDB_NO_DISCARD inline size_t GetTypeCount(void) const PDB_NO_EXCEPT
+		{
+			return m_recordCount;
+		}
+
+		// Returns the record with the given global type index, or nullptr for simple types and indices out of range.
+		// All type indices stored in the record are global type indices.
+		PDB_NO_DISCARD inline const CodeView::TPI::Record* GetTypeRecord(uint32_t globalTypeIndex) const PDB_NO_EXCEPT
+		{
+			if ((globalTypeIndex < FirstTypeIndex) || (globalTypeIndex - FirstTypeIndex >= m_recordCount))
+			{
+				return nullptr;
+			}
+
+			return reinterpret_cast<const CodeView::TPI::Record*>(m_records + m_recordOffsets[globalTypeIndex - FirstTypeIndex]);
+		}
+
+		// Returns the global type hash of the record with the given global type index, or the index of a simple type.
+		PDB_NO_DISCARD inline uint64_t GetTypeHash(uint32_t globalTypeIndex) const PDB_NO_EXCEPT
+		{
+			if (globalTypeIndex < FirstTypeIndex)
+			{
+				return globalTypeIndex;
+			}
+			else if (globalTypeIndex - FirstTypeIndex >= m_recordCount)
+			{
+				return 0u;
+			}
+
+			return m_hashes[globalTypeIndex - FirstTypeIndex];
+		}
+
+		// Returns the global type index of a type of one of the merged PDBs, in the order they were given when the database was built.
+		// Simple types are returned unchanged, indices out of range yield 0.
+		PDB_NO_DISCARD uint32_t GetGlobalTypeIndex(size_t sourceIndex, uint32_t typeIndex) const PDB_NO_EXCEPT;
+
+		// Returns the global type index of the record with the given global type hash, or 0 if there is none.
+		PDB_NO_DISCARD uint32_t FindTypeIndex(uint64_t hash) const PDB_NO_EXCEPT;
+
+		// Returns a view of all merged PDBs.
+		PDB_NO_DISCARD inline ArrayView<Source> GetSources(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Source>(m_sources, m_sourceCount);
+		}
+
+		// Returns the total size of all unique records in bytes.
+		PDB_NO_DISCARD inline size_t GetRecordsSize(void) const PDB_NO_EXCEPT
+		{
+			return m_recordsSize;
+		}
+
+	private:
+		const Source* m_sources;
+		size_t m_sourceCount;
+
+		// global type indices of the records of all sources, indexed by "source.remapOffset + typeIndex - source.firstTypeIndex"
+		const uint32_t* m_remappedIndices;
+		size_t m_remappedIndexCount;
+
+		// unique records, each one aligned to 4 bytes
+		const uint64_t* m_recordOffsets;
+		size_t m_recordCount;
+		const Byte* m_records;
+		size_t m_recordsSize;
+
+		const uint64_t* m_hashes;
+
+		// open-addressing hash table of global type indices keyed by their hash, 0 marks an empty slot
+		const uint32_t* m_hashTable;
+		size_t m_hashTableSize;
+
+		// databases referring to serialized data don't own any memory
+		bool m_ownsData;
+
+		PDB_DISABLE_COPY(MergedTypeDatabase);
+	};
+
+	// Validates the header of a merged type database image and whether all of its arrays are stored completely.
+	PDB_NO_DISCARD ErrorCode ValidateMergedTypeDatabase(const void* data, size_t size) PDB_NO_EXCEPT;
+}
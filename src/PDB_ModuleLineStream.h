@@ -5,6 +5,7 @@
 
 #include "Foundation/PDB_Macros.h"
 #include "Foundation/PDB_BitUtil.h"
+#include "Foundation/PDB_IteratorRange.h"
 #include "PDB_DBITypes.h"
 #include "PDB_Util.h"
 #include "PDB_CoalescedMSFStream.h"
@@ -17,54 +18,205 @@ namespace PDB
 	class PDB_NO_DISCARD ModuleLineStream
 	{
 	public:
-		ModuleLineStream(void) PDB_NO_EXCEPT;
-		explicit ModuleLineStream(const RawFile& file, uint16_t streamIndex, uint32_t streamSize, size_t c13LineInfoOffset) PDB_NO_EXCEPT;
+		// A forward iterator that walks the debug subsections (lines, file checksums, inlinee lines, etc.) in the stream.
+		class SectionIterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = const CodeView::DBI::LineSection*;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = const CodeView::DBI::LineSection*;
+
+			inline SectionIterator(void) PDB_NO_EXCEPT
+				: m_stream(nullptr)
+				, m_offset(0u)
+			{
+			}
 
-		PDB_DEFAULT_MOVE(ModuleLineStream);
+			inline explicit SectionIterator(const CoalescedMSFStream* stream, size_t offset) PDB_NO_EXCEPT
+				: m_stream(stream)
+				, m_offset(offset)
+			{
+			}
 
-		template <typename F>
-		void ForEachSection(F&& functor) const PDB_NO_EXCEPT
+			PDB_DEFAULT_COPY_MOVE(SectionIterator);
+
+			PDB_NO_DISCARD inline const CodeView::DBI::LineSection* operator*(void) const PDB_NO_EXCEPT
+			{
+				return m_stream->GetDataAtOffset<const CodeView::DBI::LineSection>(m_offset);
+			}
+
+			inline SectionIterator& operator++(void) PDB_NO_EXCEPT
+			{
+				const CodeView::DBI::LineSection* section = m_stream->GetDataAtOffset<const CodeView::DBI::LineSection>(m_offset);
+
+				m_offset = BitUtil::RoundUpToMultiple<size_t>(m_offset + sizeof(CodeView::DBI::DebugSubsectionHeader) + section->header.size, 4u);
+				if (m_offset > m_stream->GetSize())
+				{
+					m_offset = m_stream->GetSize();
+				}
+
+				return *this;
+			}
+
+			inline SectionIterator operator++(int) PDB_NO_EXCEPT
+			{
+				SectionIterator previous(*this);
+				++(*this);
+				return previous;
+			}
+
+			PDB_NO_DISCARD inline bool operator==(const SectionIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_offset == other.m_offset);
+			}
+
+			PDB_NO_DISCARD inline bool operator!=(const SectionIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_offset != other.m_offset);
+			}
+
+		private:
+			const CoalescedMSFStream* m_stream;
+			size_t m_offset;
+		};
+
+		// A single block of lines belonging to one file, as yielded by a LinesBlockIterator.
+		struct LinesBlock
 		{
-			size_t offset = m_c13LineInfoOffset;
+			const CodeView::DBI::LinesFileBlockHeader* header;
+			const CodeView::DBI::Line* lines;
+			const CodeView::DBI::Column* columns;			// nullptr if the block doesn't store any columns
+		};
 
-			// read the line stream sections
-			while (offset < m_stream.GetSize())
+		// A forward iterator that walks the blocks of lines stored in a S_LINES subsection.
+		class LinesBlockIterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = LinesBlock;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const LinesBlock*;
+			using reference = LinesBlock;
+
+			inline LinesBlockIterator(void) PDB_NO_EXCEPT
+				: m_stream(nullptr)
+				, m_offset(0u)
+				, m_endOffset(0u)
 			{
-				const CodeView::DBI::LineSection* section = m_stream.GetDataAtOffset<const CodeView::DBI::LineSection>(offset);
+			}
 
-				functor(section);
+			inline explicit LinesBlockIterator(const CoalescedMSFStream* stream, size_t offset, size_t endOffset) PDB_NO_EXCEPT
+				: m_stream(stream)
+				, m_offset(offset)
+				, m_endOffset(endOffset)
+			{
+			}
+
+			PDB_DEFAULT_COPY_MOVE(LinesBlockIterator);
+
+			PDB_NO_DISCARD inline LinesBlock operator*(void) const PDB_NO_EXCEPT
+			{
+				const CodeView::DBI::LinesFileBlockHeader* linesBlockHeader = m_stream->GetDataAtOffset<const CodeView::DBI::LinesFileBlockHeader>(m_offset);
+				const CodeView::DBI::Line* blockLines = m_stream->GetDataAtOffset<const CodeView::DBI::Line>(m_offset + sizeof(CodeView::DBI::LinesFileBlockHeader));
+
+				const size_t blockColumnsOffset = sizeof(CodeView::DBI::LinesFileBlockHeader) + (linesBlockHeader->numLines * (sizeof(CodeView::DBI::Line)));
+				const CodeView::DBI::Column* blockColumns = blockColumnsOffset < linesBlockHeader->size ? m_stream->GetDataAtOffset<const CodeView::DBI::Column>(m_offset + blockColumnsOffset) : nullptr;
+
+				return LinesBlock { linesBlockHeader, blockLines, blockColumns };
+			}
+
+			inline LinesBlockIterator& operator++(void) PDB_NO_EXCEPT
+			{
+				const CodeView::DBI::LinesFileBlockHeader* linesBlockHeader = m_stream->GetDataAtOffset<const CodeView::DBI::LinesFileBlockHeader>(m_offset);
+
+				m_offset = BitUtil::RoundUpToMultiple<size_t>(m_offset + linesBlockHeader->size, 4u);
+				PDB_ASSERT(m_offset <= m_endOffset, "Mismatch between offset %zu and header end %zu when reading lines blocks", m_offset, m_endOffset);
+				if (m_offset > m_endOffset)
+				{
+					m_offset = m_endOffset;
+				}
+
+				return *this;
+			}
 
-				offset = BitUtil::RoundUpToMultiple<size_t>(offset + sizeof(CodeView::DBI::DebugSubsectionHeader) + section->header.size, 4u);
+			inline LinesBlockIterator operator++(int) PDB_NO_EXCEPT
+			{
+				LinesBlockIterator previous(*this);
+				++(*this);
+				return previous;
+			}
+
+			PDB_NO_DISCARD inline bool operator==(const LinesBlockIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_offset == other.m_offset);
+			}
+
+			PDB_NO_DISCARD inline bool operator!=(const LinesBlockIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_offset != other.m_offset);
 			}
+
+		private:
+			const CoalescedMSFStream* m_stream;
+			size_t m_offset;
+			size_t m_endOffset;
+		};
+
+		using SectionRange = IteratorRange<SectionIterator>;
+		using LinesBlockRange = IteratorRange<LinesBlockIterator>;
+
+		ModuleLineStream(void) PDB_NO_EXCEPT;
+		explicit ModuleLineStream(const RawFile& file, uint16_t streamIndex, uint32_t streamSize, size_t c13LineInfoOffset) PDB_NO_EXCEPT;
+
+		PDB_DEFAULT_MOVE(ModuleLineStream);
+
+		// Returns a range of all debug subsections in the stream.
+		// Unlike ForEachSection, walking the range can be stopped at any time.
+		PDB_NO_DISCARD inline SectionRange GetSections(void) const PDB_NO_EXCEPT
+		{
+			const size_t beginOffset = (m_stream.GetSize() < m_c13LineInfoOffset) ? m_stream.GetSize() : m_c13LineInfoOffset;
+
+			return SectionRange(SectionIterator(&m_stream, beginOffset), SectionIterator(&m_stream, m_stream.GetSize()));
 		}
 
-		template <typename F>
-		void ForEachLinesBlock(const CodeView::DBI::LineSection* section, F&& functor) const PDB_NO_EXCEPT
+		// Returns a range of all blocks of lines in a S_LINES subsection.
+		// Unlike ForEachLinesBlock, walking the range can be stopped at any time.
+		PDB_NO_DISCARD inline LinesBlockRange GetLinesBlocks(const CodeView::DBI::LineSection* section) const PDB_NO_EXCEPT
 		{
 			PDB_ASSERT(section->header.kind == CodeView::DBI::DebugSubsectionKind::S_LINES,
 				"DebugSubsectionHeader::Kind %X != S_LINES (%X)", 
 				static_cast<uint32_t>(section->header.kind), static_cast<uint32_t>(CodeView::DBI::DebugSubsectionKind::S_LINES));
 
-			size_t offset = m_stream.GetPointerOffset(section);
-			const size_t headerEnd = BitUtil::RoundUpToMultiple<size_t>(offset + sizeof(CodeView::DBI::DebugSubsectionHeader) + section->header.size, 4u);
-
-			offset = BitUtil::RoundUpToMultiple<size_t>(offset + sizeof(CodeView::DBI::DebugSubsectionHeader) + sizeof(CodeView::DBI::LinesHeader), 4u);
+			const size_t sectionOffset = m_stream.GetPointerOffset(section);
+			const size_t headerEnd = BitUtil::RoundUpToMultiple<size_t>(sectionOffset + sizeof(CodeView::DBI::DebugSubsectionHeader) + section->header.size, 4u);
 
-			// read all blocks of lines
-			while (offset < headerEnd)
+			size_t offset = BitUtil::RoundUpToMultiple<size_t>(sectionOffset + sizeof(CodeView::DBI::DebugSubsectionHeader) + sizeof(CodeView::DBI::LinesHeader), 4u);
+			if (offset > headerEnd)
 			{
-				const CodeView::DBI::LinesFileBlockHeader* linesBlockHeader = m_stream.GetDataAtOffset<const CodeView::DBI::LinesFileBlockHeader>(offset);
-				const CodeView::DBI::Line* blockLines = m_stream.GetDataAtOffset<const CodeView::DBI::Line>(offset + sizeof(CodeView::DBI::LinesFileBlockHeader));
-
-				const size_t blockColumnsOffset = sizeof(CodeView::DBI::LinesFileBlockHeader) + (linesBlockHeader->numLines * (sizeof(CodeView::DBI::Line)));
-				const CodeView::DBI::Column* blockColumns = blockColumnsOffset < linesBlockHeader->size ? m_stream.GetDataAtOffset<const CodeView::DBI::Column>(offset) : nullptr;
+				offset = headerEnd;
+			}
 
-				functor(linesBlockHeader, blockLines, blockColumns);
+			return LinesBlockRange(LinesBlockIterator(&m_stream, offset, headerEnd), LinesBlockIterator(&m_stream, headerEnd, headerEnd));
+		}
 
-				offset = BitUtil::RoundUpToMultiple<size_t>(offset + linesBlockHeader->size, 4u);
+		template <typename F>
+		void ForEachSection(F&& functor) const PDB_NO_EXCEPT
+		{
+			for (const CodeView::DBI::LineSection* section : GetSections())
+			{
+				functor(section);
 			}
+		}
 
-			PDB_ASSERT(offset == headerEnd, "Mismatch between offset %zu and header end %zu when reading lines blocks", offset, headerEnd);
+		template <typename F>
+		void ForEachLinesBlock(const CodeView::DBI::LineSection* section, F&& functor) const PDB_NO_EXCEPT
+		{
+			for (const LinesBlock& linesBlock : GetLinesBlocks(section))
+			{
+				functor(linesBlock.header, linesBlock.lines, linesBlock.columns);
+			}
 		}
 
 		template <typename F>
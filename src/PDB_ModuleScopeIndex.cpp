@@ -0,0 +1,385 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_ModuleScopeIndex.h"
+#include "PDB_ModuleSymbolStream.h"
+#include "PDB_ImageSectionStream.h"
+#include "PDB_BinaryAnnotations.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	struct ScopeInterval
+	{
+		uint32_t rvaBegin;
+		uint32_t rvaEnd;
+		uint32_t depth;
+		uint32_t scopeIndex;
+	};
+
+
+	PDB_NO_DISCARD static bool IsProcedure(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return (kind == SymbolRecordKind::S_LPROC32) || (kind == SymbolRecordKind::S_GPROC32) ||
+			(kind == SymbolRecordKind::S_LPROC32_ID) || (kind == SymbolRecordKind::S_GPROC32_ID) ||
+			(kind == SymbolRecordKind::S_LPROC32_DPC) || (kind == SymbolRecordKind::S_LPROC32_DPC_ID);
+	}
+
+
+	PDB_NO_DISCARD static bool IsInlineSite(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return (kind == SymbolRecordKind::S_INLINESITE) || (kind == SymbolRecordKind::S_INLINESITE2);
+	}
+
+
+	// Returns whether a record is a scope that is indexed.
+	PDB_NO_DISCARD static bool IsIndexedScope(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return IsProcedure(kind) || IsInlineSite(kind) || (kind == SymbolRecordKind::S_BLOCK32) || (kind == SymbolRecordKind::S_SEPCODE);
+	}
+
+
+	// Returns whether a record opens a scope that is closed by a matching S_END, S_PROC_ID_END or S_INLINESITE_END.
+	PDB_NO_DISCARD static bool OpensScope(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return IsIndexedScope(kind) || (kind == SymbolRecordKind::S_THUNK32);
+	}
+
+
+	PDB_NO_DISCARD static bool ClosesScope(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return (kind == SymbolRecordKind::S_END) || (kind == SymbolRecordKind::S_PROC_ID_END) || (kind == SymbolRecordKind::S_INLINESITE_END);
+	}
+}
+
+
+const uint32_t PDB::ModuleScopeIndex::InvalidScopeIndex = 0xFFFFFFFFu;
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ModuleScopeIndex::ModuleScopeIndex(void) PDB_NO_EXCEPT
+	: m_scopes(nullptr)
+	, m_scopeCount(0u)
+	, m_segmentRVAs(nullptr)
+	, m_segmentScopes(nullptr)
+	, m_segmentCount(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ModuleScopeIndex::ModuleScopeIndex(ModuleScopeIndex&& other) PDB_NO_EXCEPT
+	: m_scopes(PDB_MOVE(other.m_scopes))
+	, m_scopeCount(PDB_MOVE(other.m_scopeCount))
+	, m_segmentRVAs(PDB_MOVE(other.m_segmentRVAs))
+	, m_segmentScopes(PDB_MOVE(other.m_segmentScopes))
+	, m_segmentCount(PDB_MOVE(other.m_segmentCount))
+{
+	other.m_scopes = nullptr;
+	other.m_scopeCount = 0u;
+	other.m_segmentRVAs = nullptr;
+	other.m_segmentScopes = nullptr;
+	other.m_segmentCount = 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ModuleScopeIndex& PDB::ModuleScopeIndex::operator=(ModuleScopeIndex&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_scopes);
+		PDB_DELETE_ARRAY(m_segmentRVAs);
+		PDB_DELETE_ARRAY(m_segmentScopes);
+
+		m_scopes = PDB_MOVE(other.m_scopes);
+		m_scopeCount = PDB_MOVE(other.m_scopeCount);
+		m_segmentRVAs = PDB_MOVE(other.m_segmentRVAs);
+		m_segmentScopes = PDB_MOVE(other.m_segmentScopes);
+		m_segmentCount = PDB_MOVE(other.m_segmentCount);
+
+		other.m_scopes = nullptr;
+		other.m_scopeCount = 0u;
+		other.m_segmentRVAs = nullptr;
+		other.m_segmentScopes = nullptr;
+		other.m_segmentCount = 0u;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ModuleScopeIndex::ModuleScopeIndex(const ModuleSymbolStream& symbolStream, const ImageSectionStream& imageSectionStream) PDB_NO_EXCEPT
+	: m_scopes(nullptr)
+	, m_scopeCount(0u)
+	, m_segmentRVAs(nullptr)
+	, m_segmentScopes(nullptr)
+	, m_segmentCount(0u)
+{
+	// first pass: count the scopes and their address ranges, so that all arrays can be allocated up-front
+	size_t openScopeCount = 0u;
+	size_t intervalCount = 0u;
+	for (const CodeView::DBI::Record* record : symbolStream.GetSymbols())
+	{
+		const CodeView::DBI::SymbolRecordKind kind = record->header.kind;
+		if (!OpensScope(kind))
+		{
+			continue;
+		}
+
+		++openScopeCount;
+
+		if (IsInlineSite(kind))
+		{
+			++m_scopeCount;
+			BinaryAnnotations::ForEachInlineSiteCodeRange(record, [&intervalCount](uint32_t, uint32_t)
+			{
+				++intervalCount;
+			});
+		}
+		else if (IsIndexedScope(kind))
+		{
+			++m_scopeCount;
+			++intervalCount;
+		}
+	}
+
+	m_scopes = PDB_NEW_ARRAY(Scope, m_scopeCount);
+
+	ScopeInterval* intervals = PDB_NEW_ARRAY(ScopeInterval, intervalCount);
+	uint32_t* openScopes = PDB_NEW_ARRAY(uint32_t, openScopeCount);
+
+	// the RVA that code offsets of inline sites are relative to, for each open scope.
+	// this is the start of the procedure, or the start of the separated code block the inline site lives in.
+	uint32_t* openScopeCodeBases = PDB_NEW_ARRAY(uint32_t, openScopeCount);
+
+	// second pass: store the scopes and their ranges, tracking the nesting of scopes on a stack.
+	// scopes which are not indexed (e.g. thunks) are still pushed onto the stack to match their S_END.
+	size_t scopeIndex = 0u;
+	size_t intervalIndex = 0u;
+	size_t openScopeDepth = 0u;
+	for (ModuleSymbolStream::SymbolIterator it = symbolStream.GetSymbols().begin(), end = symbolStream.GetSymbols().end(); it != end; ++it)
+	{
+		const CodeView::DBI::Record* record = *it;
+		const CodeView::DBI::SymbolRecordKind kind = record->header.kind;
+
+		if (ClosesScope(kind))
+		{
+			if (openScopeDepth != 0u)
+			{
+				--openScopeDepth;
+			}
+
+			continue;
+		}
+		else if (!OpensScope(kind))
+		{
+			continue;
+		}
+
+		const uint32_t parentCodeBase = (openScopeDepth != 0u) ? openScopeCodeBases[openScopeDepth - 1u] : 0u;
+		if (!IsIndexedScope(kind))
+		{
+			openScopes[openScopeDepth] = InvalidScopeIndex;
+			openScopeCodeBases[openScopeDepth] = parentCodeBase;
+			++openScopeDepth;
+			continue;
+		}
+
+		// the parent is the innermost enclosing scope that is indexed
+		uint32_t parentIndex = InvalidScopeIndex;
+		for (size_t i = openScopeDepth; i > 0u; --i)
+		{
+			if (openScopes[i - 1u] != InvalidScopeIndex)
+			{
+				parentIndex = openScopes[i - 1u];
+				break;
+			}
+		}
+
+		const uint32_t depth = static_cast<uint32_t>(openScopeDepth);
+		const uint32_t currentScopeIndex = static_cast<uint32_t>(scopeIndex);
+		m_scopes[scopeIndex++] = Scope { it.GetOffset(), IsProcedure(kind) ? InvalidScopeIndex : parentIndex, kind };
+		openScopes[openScopeDepth] = currentScopeIndex;
+		openScopeCodeBases[openScopeDepth] = parentCodeBase;
+		++openScopeDepth;
+
+		if (IsProcedure(kind))
+		{
+			const uint32_t procedureRVA = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_GPROC32.section, record->data.S_GPROC32.offset);
+			openScopeCodeBases[openScopeDepth - 1u] = procedureRVA;
+			if ((procedureRVA != 0u) && (record->data.S_GPROC32.codeSize != 0u))
+			{
+				intervals[intervalIndex++] = ScopeInterval { procedureRVA, procedureRVA + record->data.S_GPROC32.codeSize, depth, currentScopeIndex };
+			}
+		}
+		else if (kind == CodeView::DBI::SymbolRecordKind::S_SEPCODE)
+		{
+			// separated code (e.g. the cold part of a function split by PGO) lives outside of its parent procedure's range
+			const uint32_t separatedCodeRVA = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_SEPCODE.section, record->data.S_SEPCODE.offset);
+			openScopeCodeBases[openScopeDepth - 1u] = separatedCodeRVA;
+			if ((separatedCodeRVA != 0u) && (record->data.S_SEPCODE.length != 0u))
+			{
+				intervals[intervalIndex++] = ScopeInterval { separatedCodeRVA, separatedCodeRVA + record->data.S_SEPCODE.length, depth, currentScopeIndex };
+			}
+		}
+		else if (kind == CodeView::DBI::SymbolRecordKind::S_BLOCK32)
+		{
+			const uint32_t blockRVA = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_BLOCK32.section, record->data.S_BLOCK32.offset);
+			if ((blockRVA != 0u) && (record->data.S_BLOCK32.codeSize != 0u))
+			{
+				intervals[intervalIndex++] = ScopeInterval { blockRVA, blockRVA + record->data.S_BLOCK32.codeSize, depth, currentScopeIndex };
+			}
+		}
+		else
+		{
+			// inline site ranges are stored relative to the start of the procedure or separated code block they were inlined into
+			BinaryAnnotations::ForEachInlineSiteCodeRange(record, [&](uint32_t codeOffsetBegin, uint32_t codeOffsetEnd)
+			{
+				if (parentCodeBase != 0u)
+				{
+					intervals[intervalIndex++] = ScopeInterval { parentCodeBase + codeOffsetBegin, parentCodeBase + codeOffsetEnd, depth, currentScopeIndex };
+				}
+			});
+		}
+	}
+
+	PDB_DELETE_ARRAY(openScopeCodeBases);
+	PDB_DELETE_ARRAY(openScopes);
+
+	// sort ranges by address, outer scopes first if they start at the same address
+	Algorithm::Sort(intervals, intervals + intervalIndex, [](const ScopeInterval& lhs, const ScopeInterval& rhs)
+	{
+		if (lhs.rvaBegin != rhs.rvaBegin)
+		{
+			return lhs.rvaBegin < rhs.rvaBegin;
+		}
+
+		return lhs.depth < rhs.depth;
+	});
+
+	// flatten the nested ranges into non-overlapping segments, each belonging to the innermost scope covering it.
+	// every range starts at most one segment, and ends at most one segment.
+	uint32_t* segmentRVAs = PDB_NEW_ARRAY(uint32_t, 2u * intervalIndex);
+	uint32_t* segmentScopes = PDB_NEW_ARRAY(uint32_t, 2u * intervalIndex);
+	size_t segmentCount = 0u;
+
+	auto addSegment = [segmentRVAs, segmentScopes, &segmentCount](uint32_t rva, uint32_t segmentScopeIndex)
+	{
+		// a segment starting at the same address makes the previous segment empty
+		if ((segmentCount != 0u) && (segmentRVAs[segmentCount - 1u] == rva))
+		{
+			--segmentCount;
+		}
+
+		// adjacent segments of the same scope are merged
+		if ((segmentCount != 0u) && (segmentScopes[segmentCount - 1u] == segmentScopeIndex))
+		{
+			return;
+		}
+
+		segmentRVAs[segmentCount] = rva;
+		segmentScopes[segmentCount] = segmentScopeIndex;
+		++segmentCount;
+	};
+
+	// stack of currently open ranges. ranges are clamped to their enclosing range, so ends never increase towards the top.
+	uint32_t* openEnds = PDB_NEW_ARRAY(uint32_t, intervalIndex);
+	uint32_t* openIndices = PDB_NEW_ARRAY(uint32_t, intervalIndex);
+	size_t openCount = 0u;
+
+	for (size_t i = 0u; i < intervalIndex; ++i)
+	{
+		const ScopeInterval& interval = intervals[i];
+
+		// close all ranges that end before this one starts
+		while ((openCount != 0u) && (openEnds[openCount - 1u] <= interval.rvaBegin))
+		{
+			--openCount;
+			addSegment(openEnds[openCount], (openCount != 0u) ? openIndices[openCount - 1u] : InvalidScopeIndex);
+		}
+
+		const uint32_t intervalEnd = ((openCount != 0u) && (openEnds[openCount - 1u] < interval.rvaEnd)) ? openEnds[openCount - 1u] : interval.rvaEnd;
+		if (intervalEnd <= interval.rvaBegin)
+		{
+			continue;
+		}
+
+		addSegment(interval.rvaBegin, interval.scopeIndex);
+		openEnds[openCount] = intervalEnd;
+		openIndices[openCount] = interval.scopeIndex;
+		++openCount;
+	}
+
+	while (openCount != 0u)
+	{
+		--openCount;
+		addSegment(openEnds[openCount], (openCount != 0u) ? openIndices[openCount - 1u] : InvalidScopeIndex);
+	}
+
+	PDB_DELETE_ARRAY(openIndices);
+	PDB_DELETE_ARRAY(openEnds);
+	PDB_DELETE_ARRAY(intervals);
+
+	// store the segments in tightly-sized arrays
+	m_segmentCount = segmentCount;
+	m_segmentRVAs = PDB_NEW_ARRAY(uint32_t, m_segmentCount);
+	m_segmentScopes = PDB_NEW_ARRAY(uint32_t, m_segmentCount);
+	if (m_segmentCount != 0u)
+	{
+		std::memcpy(m_segmentRVAs, segmentRVAs, m_segmentCount * sizeof(uint32_t));
+		std::memcpy(m_segmentScopes, segmentScopes, m_segmentCount * sizeof(uint32_t));
+	}
+
+	PDB_DELETE_ARRAY(segmentScopes);
+	PDB_DELETE_ARRAY(segmentRVAs);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ModuleScopeIndex::~ModuleScopeIndex(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_scopes);
+	PDB_DELETE_ARRAY(m_segmentRVAs);
+	PDB_DELETE_ARRAY(m_segmentScopes);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::ModuleScopeIndex::Scope* PDB::ModuleScopeIndex::FindInnermostScope(uint32_t rva) const PDB_NO_EXCEPT
+{
+	// find the last segment starting at or before the RVA
+	const size_t index = Algorithm::UpperBound(m_segmentRVAs, m_segmentCount, rva);
+	if (index == 0u)
+	{
+		return nullptr;
+	}
+
+	const uint32_t segmentScopeIndex = m_segmentScopes[index - 1u];
+	if (segmentScopeIndex == InvalidScopeIndex)
+	{
+		return nullptr;
+	}
+
+	return &m_scopes[segmentScopeIndex];
+}
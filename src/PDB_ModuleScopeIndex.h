@@ -0,0 +1,67 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_DBITypes.h"
+
+
+namespace PDB
+{
+	class ModuleSymbolStream;
+	class ImageSectionStream;
+
+
+	// An index of the lexical scopes (procedures, separated code, blocks and inline sites) of a single module, answering
+	// "which is the innermost scope containing this RVA?" in O(log n) instead of walking the module's symbol stream.
+	// The scopes' address ranges are flattened into sorted, non-overlapping segments that each map to the innermost scope.
+	// Building the index walks the module's symbols once, so it is best built on demand the first time a module is queried,
+	// and kept around by the caller. Once built, the index is immutable and can be queried from several threads.
+	class PDB_NO_DISCARD ModuleScopeIndex
+	{
+	public:
+		static const uint32_t InvalidScopeIndex;
+
+		struct Scope
+		{
+			uint32_t recordOffset;							// offset of the S_*PROC32*, S_SEPCODE, S_BLOCK32 or S_INLINESITE* record in the module symbol stream
+			uint32_t parentIndex;							// index of the enclosing scope, InvalidScopeIndex for procedures
+			CodeView::DBI::SymbolRecordKind kind;
+		};
+
+		ModuleScopeIndex(void) PDB_NO_EXCEPT;
+		ModuleScopeIndex(ModuleScopeIndex&& other) PDB_NO_EXCEPT;
+		ModuleScopeIndex& operator=(ModuleScopeIndex&& other) PDB_NO_EXCEPT;
+
+		explicit ModuleScopeIndex(const ModuleSymbolStream& symbolStream, const ImageSectionStream& imageSectionStream) PDB_NO_EXCEPT;
+		~ModuleScopeIndex(void) PDB_NO_EXCEPT;
+
+		// Returns the innermost scope containing the given RVA, or nullptr if the RVA doesn't belong to any procedure of this module.
+		PDB_NO_DISCARD const Scope* FindInnermostScope(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the scope enclosing the given scope, or nullptr for procedures.
+		PDB_NO_DISCARD inline const Scope* GetParentScope(const Scope* scope) const PDB_NO_EXCEPT
+		{
+			return (scope->parentIndex == InvalidScopeIndex) ? nullptr : &m_scopes[scope->parentIndex];
+		}
+
+		// Returns a view of all scopes, in the order they appear in the module symbol stream.
+		PDB_NO_DISCARD inline ArrayView<Scope> GetScopes(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Scope>(m_scopes, m_scopeCount);
+		}
+
+	private:
+		Scope* m_scopes;
+		size_t m_scopeCount;
+
+		// segment i covers [m_segmentRVAs[i], m_segmentRVAs[i + 1]) and belongs to scope m_segmentScopes[i], which can be InvalidScopeIndex for gaps
+		uint32_t* m_segmentRVAs;
+		uint32_t* m_segmentScopes;
+		size_t m_segmentCount;
+
+		PDB_DISABLE_COPY(ModuleScopeIndex);
+	};
+}
@@ -38,23 +38,12 @@ PDB::ModuleSymbolStream::ModuleSymbolStream(const RawFile& file, uint16_t stream
 // ------------------------------------------------------------------------------------------------
 PDB_NO_DISCARD const PDB::CodeView::DBI::Record* PDB::ModuleSymbolStream::FindRecord(CodeView::DBI::SymbolRecordKind kind) const PDB_NO_EXCEPT
 {
-	// ignore the stream's 4-byte signature
-	size_t offset = sizeof(uint32_t);
-
-	// parse the CodeView records
-	while (offset < m_stream.GetSize())
+	for (const CodeView::DBI::Record* record : GetSymbols())
 	{
-		// https://llvm.org/docs/PDB/CodeViewTypes.html
-		const CodeView::DBI::Record* record = m_stream.GetDataAtOffset<const CodeView::DBI::Record>(offset);
 		if (record->header.kind == kind)
 		{
 			return record;
 		}
-
-		const uint32_t recordSize = GetCodeViewRecordSize(record);
-
-		// position the module stream offset at the next record
-		offset = BitUtil::RoundUpToMultiple<size_t>(offset + sizeof(CodeView::DBI::RecordHeader) + recordSize, 4u);
 	}
 
 	return nullptr;
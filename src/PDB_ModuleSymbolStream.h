@@ -5,6 +5,7 @@
 
 #include "Foundation/PDB_Macros.h"
 #include "Foundation/PDB_BitUtil.h"
+#include "Foundation/PDB_IteratorRange.h"
 #include "PDB_DBITypes.h"
 #include "PDB_Util.h"
 #include "PDB_CoalescedMSFStream.h"
@@ -18,6 +19,80 @@ namespace PDB
 	class PDB_NO_DISCARD ModuleSymbolStream
 	{
 	public:
+		// A forward iterator that walks the CodeView records in the stream, one record at a time.
+		class SymbolIterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = const CodeView::DBI::Record*;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const CodeView::DBI::Record* const*;
+			using reference = const CodeView::DBI::Record*;
+
+			inline SymbolIterator(void) PDB_NO_EXCEPT
+				: m_stream(nullptr)
+				, m_offset(0u)
+			{
+			}
+
+			inline explicit SymbolIterator(const CoalescedMSFStream* stream, size_t offset) PDB_NO_EXCEPT
+				: m_stream(stream)
+				, m_offset(offset)
+			{
+			}
+
+			PDB_DEFAULT_COPY_MOVE(SymbolIterator);
+
+			PDB_NO_DISCARD inline const CodeView::DBI::Record* operator*(void) const PDB_NO_EXCEPT
+			{
+				return m_stream->GetDataAtOffset<const CodeView::DBI::Record>(m_offset);
+			}
+
+			inline SymbolIterator& operator++(void) PDB_NO_EXCEPT
+			{
+				const CodeView::DBI::Record* record = m_stream->GetDataAtOffset<const CodeView::DBI::Record>(m_offset);
+				const uint32_t recordSize = GetCodeViewRecordSize(record);
+
+				// position the module stream offset at the next record, but never past the end of the stream
+				m_offset = BitUtil::RoundUpToMultiple<size_t>(m_offset + sizeof(CodeView::DBI::RecordHeader) + recordSize, 4u);
+				if (m_offset > m_stream->GetSize())
+				{
+					m_offset = m_stream->GetSize();
+				}
+
+				return *this;
+			}
+
+			inline SymbolIterator operator++(int) PDB_NO_EXCEPT
+			{
+				SymbolIterator previous(*this);
+				++(*this);
+				return previous;
+			}
+
+			PDB_NO_DISCARD inline bool operator==(const SymbolIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_offset == other.m_offset);
+			}
+
+			PDB_NO_DISCARD inline bool operator!=(const SymbolIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_offset != other.m_offset);
+			}
+
+			// Returns the offset of the current record in the stream, which is what parent and end records refer to.
+			PDB_NO_DISCARD inline uint32_t GetOffset(void) const PDB_NO_EXCEPT
+			{
+				return static_cast<uint32_t>(m_offset);
+			}
+
+		private:
+			const CoalescedMSFStream* m_stream;
+			size_t m_offset;
+		};
+
+		using SymbolRange = IteratorRange<SymbolIterator>;
+
 		ModuleSymbolStream(void) PDB_NO_EXCEPT;
 		explicit ModuleSymbolStream(const RawFile& file, uint16_t streamIndex, uint32_t symbolStreamSize) PDB_NO_EXCEPT;
 
@@ -37,28 +112,41 @@ namespace PDB
 			return m_stream.GetDataAtOffset<const CodeView::DBI::Record>(record.end);
 		}
 
+		// Returns the record at the given offset, e.g. a record's parent, end or next offset.
+		PDB_NO_DISCARD inline const CodeView::DBI::Record* GetRecordAtOffset(uint32_t offset) const PDB_NO_EXCEPT
+		{
+			return m_stream.GetDataAtOffset<const CodeView::DBI::Record>(offset);
+		}
+
 		// Finds a record of a certain kind.
 		PDB_NO_DISCARD const CodeView::DBI::Record* FindRecord(CodeView::DBI::SymbolRecordKind Kind) const PDB_NO_EXCEPT;
 
+		// Returns a range of all records in the stream.
+		// Unlike ForEachSymbol, walking the range can be stopped at any time.
+		PDB_NO_DISCARD inline SymbolRange GetSymbols(void) const PDB_NO_EXCEPT
+		{
+			// ignore the stream's 4-byte signature
+			const size_t beginOffset = (m_stream.GetSize() < sizeof(uint32_t)) ? m_stream.GetSize() : sizeof(uint32_t);
+
+			return SymbolRange(SymbolIterator(&m_stream, beginOffset), SymbolIterator(&m_stream, m_stream.GetSize()));
+		}
+
+		// Returns a range of records starting at the record at the given offset, e.g. a procedure's parent or end offset.
+		PDB_NO_DISCARD inline SymbolRange GetSymbolsFromOffset(uint32_t offset) const PDB_NO_EXCEPT
+		{
+			const size_t beginOffset = (m_stream.GetSize() < offset) ? m_stream.GetSize() : offset;
+
+			return SymbolRange(SymbolIterator(&m_stream, beginOffset), SymbolIterator(&m_stream, m_stream.GetSize()));
+		}
+
 
 		// Iterates all records in the stream.
 		template <typename F>
 		void ForEachSymbol(F&& functor) const PDB_NO_EXCEPT
 		{
-			// ignore the stream's 4-byte signature
-			size_t offset = sizeof(uint32_t);
-
-			// parse the CodeView records
-			while (offset < m_stream.GetSize())
+			for (const CodeView::DBI::Record* record : GetSymbols())
 			{
-				// https://llvm.org/docs/PDB/CodeViewTypes.html
-				const CodeView::DBI::Record* record = m_stream.GetDataAtOffset<const CodeView::DBI::Record>(offset);
-				const uint32_t recordSize = GetCodeViewRecordSize(record);
-
 				functor(record);
-
-				// position the module stream offset at the next record
-				offset = BitUtil::RoundUpToMultiple<size_t>(offset + sizeof(CodeView::DBI::RecordHeader) + recordSize, 4u);
 			}
 		}
 
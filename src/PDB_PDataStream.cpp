@@ -0,0 +1,69 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_PDataStream.h"
+#include "PDB_RawFile.h"
+#include "Foundation/PDB_Algorithm.h"
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::PDataStream::PDataStream(void) PDB_NO_EXCEPT
+	: m_stream()
+	, m_header(nullptr)
+	, m_functions(nullptr)
+	, m_count(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::PDataStream::PDataStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT
+	: m_stream(file.CreateMSFStream<CoalescedMSFStream>(streamIndex))
+	, m_header(nullptr)
+	, m_functions(nullptr)
+	, m_count(0u)
+{
+	if (m_stream.GetSize() < sizeof(DebugDataStreamHeader))
+	{
+		return;
+	}
+
+	m_header = m_stream.GetDataAtOffset<DebugDataStreamHeader>(0u);
+	if ((m_header->headerSize < sizeof(DebugDataStreamHeader)) || (m_header->headerSize > m_stream.GetSize()))
+	{
+		return;
+	}
+
+	// the stream might have been written with trailing padding, only trust the data size stored in the header
+	size_t dataSize = m_stream.GetSize() - m_header->headerSize;
+	if (m_header->dataSize < dataSize)
+	{
+		dataSize = m_header->dataSize;
+	}
+
+	m_functions = m_stream.GetDataAtOffset<IMAGE_RUNTIME_FUNCTION_ENTRY>(m_header->headerSize);
+	m_count = dataSize / sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::IMAGE_RUNTIME_FUNCTION_ENTRY* PDB::PDataStream::FindFunction(uint32_t rva) const PDB_NO_EXCEPT
+{
+	// find the last entry beginning at or before the RVA. entries never overlap.
+	const size_t index = Algorithm::UpperBound(m_functions, m_count, rva, [](uint32_t value, const IMAGE_RUNTIME_FUNCTION_ENTRY& function)
+	{
+		return value < function.BeginAddress;
+	});
+
+	if (index == 0u)
+	{
+		return nullptr;
+	}
+
+	const IMAGE_RUNTIME_FUNCTION_ENTRY& function = m_functions[index - 1u];
+	return (rva < function.EndAddress) ? &function : nullptr;
+}
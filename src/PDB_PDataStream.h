@@ -0,0 +1,51 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_UnwindTypes.h"
+#include "PDB_CoalescedMSFStream.h"
+
+
+namespace PDB
+{
+	class RawFile;
+
+
+	// A view of the image's x64 function table (the .pdata section), as stored in the pdata debug stream.
+	// The entries are sorted by their begin address, so finding the entry of an RVA is a single binary search.
+	class PDB_NO_DISCARD PDataStream
+	{
+	public:
+		PDataStream(void) PDB_NO_EXCEPT;
+		explicit PDataStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT;
+
+		PDB_DEFAULT_MOVE(PDataStream);
+
+		// Returns the function table entry of the function containing the given RVA, or nullptr if there is none.
+		// leaf functions don't need an entry, and therefore have none.
+		PDB_NO_DISCARD const IMAGE_RUNTIME_FUNCTION_ENTRY* FindFunction(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Returns the header of the stream.
+		PDB_NO_DISCARD inline const DebugDataStreamHeader* GetHeader(void) const PDB_NO_EXCEPT
+		{
+			return m_header;
+		}
+
+		// Returns a view of all function table entries in the stream.
+		PDB_NO_DISCARD inline ArrayView<IMAGE_RUNTIME_FUNCTION_ENTRY> GetFunctions(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<IMAGE_RUNTIME_FUNCTION_ENTRY>(m_functions, m_count);
+		}
+
+	private:
+		CoalescedMSFStream m_stream;
+		const DebugDataStreamHeader* m_header;
+		const IMAGE_RUNTIME_FUNCTION_ENTRY* m_functions;
+		size_t m_count;
+
+		PDB_DISABLE_COPY(PDataStream);
+	};
+}
@@ -0,0 +1,356 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_PEImage.h"
+#include "Foundation/PDB_Algorithm.h"
+
+
+namespace
+{
+	static constexpr const uint16_t DOSSignature = 0x5A4Du;				// "MZ"
+	static constexpr const uint32_t NTSignature = 0x00004550u;			// "PE\0\0"
+	static constexpr const uint32_t RSDSSignature = 0x53445352u;		// "RSDS"
+
+	static constexpr const uint16_t OptionalHeaderMagic32 = 0x010Bu;
+	static constexpr const uint16_t OptionalHeaderMagic64 = 0x020Bu;
+
+	// offset of the NT headers, stored in the DOS header
+	static constexpr const size_t NTHeadersOffsetOffset = 0x3Cu;
+
+	// offsets into the optional header, which differ between PE32 and PE32+ behind the size of the image
+	static constexpr const size_t SizeOfImageOffset = 56u;
+	static constexpr const size_t RvaAndSizeCountOffset32 = 92u;
+	static constexpr const size_t RvaAndSizeCountOffset64 = 108u;
+
+	// https://learn.microsoft.com/en-us/windows/win32/debug/pe-format#optional-header-data-directories-image-only
+	static constexpr const uint32_t ExceptionDirectoryIndex = 3u;
+	static constexpr const uint32_t DebugDirectoryIndex = 6u;
+
+	// https://learn.microsoft.com/en-us/windows/win32/debug/pe-format#coff-file-header-object-and-image
+	struct FileHeader
+	{
+		uint16_t Machine;
+		uint16_t NumberOfSections;
+		uint32_t TimeDateStamp;
+		uint32_t PointerToSymbolTable;
+		uint32_t NumberOfSymbols;
+		uint16_t SizeOfOptionalHeader;
+		uint16_t Characteristics;
+	};
+
+	static_assert(sizeof(FileHeader) == 20u, "Size mismatch.");
+
+	struct DataDirectory
+	{
+		uint32_t VirtualAddress;
+		uint32_t Size;
+	};
+
+	// The parts of the headers needed for reading the image.
+	struct Headers
+	{
+		FileHeader fileHeader;
+		bool is64Bit;
+		uint32_t sizeOfImage;
+		size_t sectionHeadersOffset;
+		DataDirectory exceptionDirectory;
+		DataDirectory debugDirectory;
+	};
+
+	// the RSDS CodeView record, followed by the null-terminated path of the PDB
+	struct RSDSHeader
+	{
+		uint32_t signature;
+		PDB::GUID guid;
+		uint32_t age;
+	};
+
+	static_assert(sizeof(RSDSHeader) == 24u, "Size mismatch.");
+
+
+	template <typename T>
+	PDB_NO_DISCARD static inline T Read(const PDB::Byte* data, size_t offset) PDB_NO_EXCEPT
+	{
+		T value;
+		std::memcpy(&value, data + offset, sizeof(T));
+
+		return value;
+	}
+
+
+	// Reads the headers, checking that everything they point to is stored in the data.
+	PDB_NO_DISCARD static PDB::ErrorCode ReadHeaders(const PDB::Byte* data, size_t size, Headers& headers) PDB_NO_EXCEPT
+	{
+		if ((size < NTHeadersOffsetOffset + sizeof(uint32_t)) || (Read<uint16_t>(data, 0u) != DOSSignature))
+		{
+			return PDB::ErrorCode::InvalidSignature;
+		}
+
+		const size_t ntHeadersOffset = Read<uint32_t>(data, NTHeadersOffsetOffset);
+		if ((ntHeadersOffset > size) || (size - ntHeadersOffset < sizeof(uint32_t) + sizeof(FileHeader)))
+		{
+			return PDB::ErrorCode::InvalidStream;
+		}
+
+		if (Read<uint32_t>(data, ntHeadersOffset) != NTSignature)
+		{
+			return PDB::ErrorCode::InvalidSignature;
+		}
+
+		headers = {};
+		headers.fileHeader = Read<FileHeader>(data, ntHeadersOffset + sizeof(uint32_t));
+
+		const size_t optionalHeaderOffset = ntHeadersOffset + sizeof(uint32_t) + sizeof(FileHeader);
+		const size_t optionalHeaderSize = headers.fileHeader.SizeOfOptionalHeader;
+		if ((optionalHeaderSize < SizeOfImageOffset + sizeof(uint32_t)) || (size - optionalHeaderOffset < optionalHeaderSize))
+		{
+			return PDB::ErrorCode::InvalidStream;
+		}
+
+		const uint16_t magic = Read<uint16_t>(data, optionalHeaderOffset);
+		if ((magic != OptionalHeaderMagic32) && (magic != OptionalHeaderMagic64))
+		{
+			return PDB::ErrorCode::UnknownVersion;
+		}
+
+		headers.is64Bit = (magic == OptionalHeaderMagic64);
+		headers.sizeOfImage = Read<uint32_t>(data, optionalHeaderOffset + SizeOfImageOffset);
+
+		// the data directories follow their count, and only those that fit into the optional header are used
+		const size_t countOffset = headers.is64Bit ? RvaAndSizeCountOffset64 : RvaAndSizeCountOffset32;
+		if (countOffset + sizeof(uint32_t) <= optionalHeaderSize)
+		{
+			const size_t directoriesOffset = countOffset + sizeof(uint32_t);
+			const size_t storedCount = (optionalHeaderSize - directoriesOffset) / sizeof(DataDirectory);
+			const uint32_t directoryCount = Read<uint32_t>(data, optionalHeaderOffset + countOffset);
+			const size_t count = (directoryCount < storedCount) ? directoryCount : storedCount;
+
+			if (ExceptionDirectoryIndex < count)
+			{
+				headers.exceptionDirectory = Read<DataDirectory>(data, optionalHeaderOffset + directoriesOffset + ExceptionDirectoryIndex * sizeof(DataDirectory));
+			}
+
+			if (DebugDirectoryIndex < count)
+			{
+				headers.debugDirectory = Read<DataDirectory>(data, optionalHeaderOffset + directoriesOffset + DebugDirectoryIndex * sizeof(DataDirectory));
+			}
+		}
+
+		headers.sectionHeadersOffset = optionalHeaderOffset + optionalHeaderSize;
+		if ((size - headers.sectionHeadersOffset) / sizeof(PDB::IMAGE_SECTION_HEADER) < headers.fileHeader.NumberOfSections)
+		{
+			return PDB::ErrorCode::InvalidStream;
+		}
+
+		return PDB::ErrorCode::Success;
+	}
+
+
+	// Converts an RVA into an offset into the file, using the section containing the given range of bytes.
+	// Returns false if the range is not stored completely in the file.
+	PDB_NO_DISCARD static bool GetFileOffset(const PDB::IMAGE_SECTION_HEADER* sections, size_t sectionCount, size_t size, uint32_t rva, uint32_t byteCount, size_t& offset) PDB_NO_EXCEPT
+	{
+		for (size_t i = 0u; i < sectionCount; ++i)
+		{
+			const PDB::IMAGE_SECTION_HEADER& section = sections[i];
+			if ((rva < section.VirtualAddress) || (static_cast<uint64_t>(rva - section.VirtualAddress) + byteCount > section.SizeOfRawData))
+			{
+				continue;
+			}
+
+			const uint64_t fileOffset = static_cast<uint64_t>(section.PointerToRawData) + (rva - section.VirtualAddress);
+			if (fileOffset + byteCount > size)
+			{
+				return false;
+			}
+
+			offset = static_cast<size_t>(fileOffset);
+			return true;
+		}
+
+		return false;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::ValidatePEImage(const void* data, size_t size) PDB_NO_EXCEPT
+{
+	const Byte* image = static_cast<const Byte*>(data);
+
+	Headers headers = {};
+	const ErrorCode error = ReadHeaders(image, size, headers);
+	if (error != ErrorCode::Success)
+	{
+		return error;
+	}
+
+	const IMAGE_SECTION_HEADER* sections = reinterpret_cast<const IMAGE_SECTION_HEADER*>(image + headers.sectionHeadersOffset);
+	const size_t sectionCount = headers.fileHeader.NumberOfSections;
+
+	size_t offset = 0u;
+	if ((headers.debugDirectory.Size != 0u) && !GetFileOffset(sections, sectionCount, size, headers.debugDirectory.VirtualAddress, headers.debugDirectory.Size, offset))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	if ((headers.exceptionDirectory.Size != 0u) && !GetFileOffset(sections, sectionCount, size, headers.exceptionDirectory.VirtualAddress, headers.exceptionDirectory.Size, offset))
+	{
+		return ErrorCode::InvalidStream;
+	}
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::PEImage::PEImage(void) PDB_NO_EXCEPT
+	: m_data(nullptr)
+	, m_size(0u)
+	, m_machine(Machine::Unknown)
+	, m_is64Bit(false)
+	, m_timeDateStamp(0u)
+	, m_sizeOfImage(0u)
+	, m_sections(nullptr)
+	, m_sectionCount(0u)
+	, m_debugDirectory(nullptr)
+	, m_debugDirectoryCount(0u)
+	, m_functions(nullptr)
+	, m_functionCount(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::PEImage::PEImage(const void* data, size_t size) PDB_NO_EXCEPT
+	: m_data(static_cast<const Byte*>(data))
+	, m_size(size)
+	, m_machine(Machine::Unknown)
+	, m_is64Bit(false)
+	, m_timeDateStamp(0u)
+	, m_sizeOfImage(0u)
+	, m_sections(nullptr)
+	, m_sectionCount(0u)
+	, m_debugDirectory(nullptr)
+	, m_debugDirectoryCount(0u)
+	, m_functions(nullptr)
+	, m_functionCount(0u)
+{
+	Headers headers = {};
+	if (ReadHeaders(m_data, m_size, headers) != ErrorCode::Success)
+	{
+		return;
+	}
+
+	m_machine = static_cast<Machine>(headers.fileHeader.Machine);
+	m_is64Bit = headers.is64Bit;
+	m_timeDateStamp = headers.fileHeader.TimeDateStamp;
+	m_sizeOfImage = headers.sizeOfImage;
+
+	m_sections = reinterpret_cast<const IMAGE_SECTION_HEADER*>(m_data + headers.sectionHeadersOffset);
+	m_sectionCount = headers.fileHeader.NumberOfSections;
+
+	m_debugDirectory = static_cast<const IMAGE_DEBUG_DIRECTORY*>(GetDataAtRVA(headers.debugDirectory.VirtualAddress, headers.debugDirectory.Size));
+	m_debugDirectoryCount = m_debugDirectory ? headers.debugDirectory.Size / sizeof(IMAGE_DEBUG_DIRECTORY) : 0u;
+
+	// the function table entries of other machines have a different layout
+	if (m_machine == Machine::AMD64)
+	{
+		m_functions = static_cast<const IMAGE_RUNTIME_FUNCTION_ENTRY*>(GetDataAtRVA(headers.exceptionDirectory.VirtualAddress, headers.exceptionDirectory.Size));
+		m_functionCount = m_functions ? headers.exceptionDirectory.Size / sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY) : 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::IMAGE_RUNTIME_FUNCTION_ENTRY* PDB::PEImage::FindFunction(uint32_t rva) const PDB_NO_EXCEPT
+{
+	// find the last entry beginning at or before the RVA. entries never overlap.
+	const size_t index = Algorithm::UpperBound(m_functions, m_functionCount, rva, [](uint32_t value, const IMAGE_RUNTIME_FUNCTION_ENTRY& function)
+	{
+		return value < function.BeginAddress;
+	});
+
+	if (index == 0u)
+	{
+		return nullptr;
+	}
+
+	const IMAGE_RUNTIME_FUNCTION_ENTRY& function = m_functions[index - 1u];
+	return (rva < function.EndAddress) ? &function : nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::PEImage::GetCodeViewRecord(CodeViewRecord& record) const PDB_NO_EXCEPT
+{
+	for (size_t i = 0u; i < m_debugDirectoryCount; ++i)
+	{
+		const IMAGE_DEBUG_DIRECTORY& entry = m_debugDirectory[i];
+		if ((entry.Type != static_cast<uint32_t>(DebugType::CodeView)) || (entry.SizeOfData <= sizeof(RSDSHeader)))
+		{
+			continue;
+		}
+
+		// debug data is not necessarily mapped into the image, but always stored in the file
+		if ((entry.PointerToRawData > m_size) || (m_size - entry.PointerToRawData < entry.SizeOfData))
+		{
+			continue;
+		}
+
+		const Byte* data = m_data + entry.PointerToRawData;
+		const RSDSHeader header = Read<RSDSHeader>(data, 0u);
+		if (header.signature != RSDSSignature)
+		{
+			continue;
+		}
+
+		const char* path = reinterpret_cast<const char*>(data + sizeof(RSDSHeader));
+		if (!std::memchr(path, '\0', entry.SizeOfData - sizeof(RSDSHeader)))
+		{
+			continue;
+		}
+
+		record.guid = header.guid;
+		record.age = header.age;
+		record.path = path;
+
+		return true;
+	}
+
+	return false;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::PEImage::MatchesPDB(const Header& pdbHeader) const PDB_NO_EXCEPT
+{
+	CodeViewRecord record = {};
+	if (!GetCodeViewRecord(record))
+	{
+		return false;
+	}
+
+	return (std::memcmp(&record.guid, &pdbHeader.guid, sizeof(GUID)) == 0) && (record.age == pdbHeader.age);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const void* PDB::PEImage::GetDataAtRVA(uint32_t rva, uint32_t size) const PDB_NO_EXCEPT
+{
+	size_t offset = 0u;
+	if ((size == 0u) || !GetFileOffset(m_sections, m_sectionCount, m_size, rva, size, offset))
+	{
+		return nullptr;
+	}
+
+	return m_data + offset;
+}
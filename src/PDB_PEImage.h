@@ -0,0 +1,134 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_ErrorCodes.h"
+#include "PDB_Types.h"
+#include "PDB_UnwindTypes.h"
+
+
+// https://learn.microsoft.com/en-us/windows/win32/debug/pe-format
+namespace PDB
+{
+	// Validates whether the data holds a PE/COFF image as stored on disk, e.g. an executable or DLL mapped into memory.
+	// Checks the DOS and NT headers, and whether all section headers and the data directories used by PEImage are stored completely.
+	PDB_NO_DISCARD ErrorCode ValidatePEImage(const void* data, size_t size) PDB_NO_EXCEPT;
+
+
+	// A minimal view of a PE/COFF image as stored on disk, providing what is needed to match the image with its PDB:
+	// the headers, section headers, debug directory and x64 function table (the .pdata section).
+	// Nothing is copied, all data is read from the image directly, which therefore must outlive the view.
+	class PDB_NO_DISCARD PEImage
+	{
+	public:
+		// https://learn.microsoft.com/en-us/windows/win32/debug/pe-format#machine-types
+		enum class PDB_NO_DISCARD Machine : uint16_t
+		{
+			Unknown = 0x0000u,
+			I386 = 0x014Cu,
+			ARM = 0x01C0u,
+			ARMNT = 0x01C4u,
+			ARM64 = 0xAA64u,
+			AMD64 = 0x8664u
+		};
+
+		// https://learn.microsoft.com/en-us/windows/win32/debug/pe-format#debug-type
+		enum class PDB_NO_DISCARD DebugType : uint32_t
+		{
+			CodeView = 2u,
+			FPO = 3u,
+			Misc = 4u,
+			Repro = 16u,
+			ExtendedDllCharacteristics = 20u
+		};
+
+		// The contents of an RSDS CodeView record, which identifies the PDB built together with the image.
+		struct CodeViewRecord
+		{
+			GUID guid;
+			uint32_t age;
+			const char* path;									// path of the PDB when the image was linked, null-terminated
+		};
+
+		PEImage(void) PDB_NO_EXCEPT;
+		PDB_DEFAULT_MOVE(PEImage);
+
+		// The image must have been validated using ValidatePEImage().
+		explicit PEImage(const void* data, size_t size) PDB_NO_EXCEPT;
+
+		PDB_NO_DISCARD inline Machine GetMachine(void) const PDB_NO_EXCEPT
+		{
+			return m_machine;
+		}
+
+		// Returns whether the image uses the PE32+ format of 64-bit images.
+		PDB_NO_DISCARD inline bool Is64Bit(void) const PDB_NO_EXCEPT
+		{
+			return m_is64Bit;
+		}
+
+		// Returns the time stamp and image size stored in the headers. Together, they identify the image on a symbol server.
+		PDB_NO_DISCARD inline uint32_t GetTimeDateStamp(void) const PDB_NO_EXCEPT
+		{
+			return m_timeDateStamp;
+		}
+
+		PDB_NO_DISCARD inline uint32_t GetSizeOfImage(void) const PDB_NO_EXCEPT
+		{
+			return m_sizeOfImage;
+		}
+
+		// Returns a view of all section headers.
+		PDB_NO_DISCARD inline ArrayView<IMAGE_SECTION_HEADER> GetSections(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<IMAGE_SECTION_HEADER>(m_sections, m_sectionCount);
+		}
+
+		// Returns a view of all entries in the debug directory.
+		PDB_NO_DISCARD inline ArrayView<IMAGE_DEBUG_DIRECTORY> GetDebugDirectory(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<IMAGE_DEBUG_DIRECTORY>(m_debugDirectory, m_debugDirectoryCount);
+		}
+
+		// Returns a view of all x64 function table entries, sorted by their begin address. Images of other machines have none.
+		PDB_NO_DISCARD inline ArrayView<IMAGE_RUNTIME_FUNCTION_ENTRY> GetFunctions(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<IMAGE_RUNTIME_FUNCTION_ENTRY>(m_functions, m_functionCount);
+		}
+
+		// Returns the function table entry of the function containing the given RVA, or nullptr if there is none.
+		PDB_NO_DISCARD const IMAGE_RUNTIME_FUNCTION_ENTRY* FindFunction(uint32_t rva) const PDB_NO_EXCEPT;
+
+		// Reads the RSDS CodeView record from the debug directory. Returns false if the image has none.
+		PDB_NO_DISCARD bool GetCodeViewRecord(CodeViewRecord& record) const PDB_NO_EXCEPT;
+
+		// Returns whether the image was built together with the PDB the given header was read from, comparing their GUID and age.
+		PDB_NO_DISCARD bool MatchesPDB(const Header& pdbHeader) const PDB_NO_EXCEPT;
+
+		// Returns a pointer to the data at the given RVA, or nullptr if the given number of bytes is not stored in the file.
+		PDB_NO_DISCARD const void* GetDataAtRVA(uint32_t rva, uint32_t size) const PDB_NO_EXCEPT;
+
+	private:
+		const Byte* m_data;
+		size_t m_size;
+
+		Machine m_machine;
+		bool m_is64Bit;
+		uint32_t m_timeDateStamp;
+		uint32_t m_sizeOfImage;
+
+		const IMAGE_SECTION_HEADER* m_sections;
+		size_t m_sectionCount;
+
+		const IMAGE_DEBUG_DIRECTORY* m_debugDirectory;
+		size_t m_debugDirectoryCount;
+
+		const IMAGE_RUNTIME_FUNCTION_ENTRY* m_functions;
+		size_t m_functionCount;
+
+		PDB_DISABLE_COPY(PEImage);
+	};
+}
@@ -0,0 +1,349 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_ProgressiveFile.h"
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_Types.h"
+#include "PDB_Util.h"
+#include "PDB_CoalescedMSFStream.h"
+#include "Foundation/PDB_BitUtil.h"
+#include "Foundation/PDB_Memory.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstring>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+namespace
+{
+	// blocks that don't belong to any stream, e.g. the SuperBlock, free block maps and the directory
+	static const uint32_t UnusedBlock = 0xffffffffu;
+
+	// the part of the SuperBlock needed to learn about the block size and count
+	static const size_t SuperBlockHeaderSize = sizeof(PDB::SuperBlock);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ProgressiveFile::ProgressiveFile(const void* data) PDB_NO_EXCEPT
+	: ProgressiveFile(data, nullptr, nullptr)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ProgressiveFile::ProgressiveFile(const void* data, StreamAvailableFunction streamAvailable, void* userData) PDB_NO_EXCEPT
+	: m_data(data)
+	, m_streamAvailable(streamAvailable)
+	, m_userData(userData)
+	, m_pendingRanges()
+	, m_superBlock(nullptr)
+	, m_blockSizeLog2(0u)
+	, m_blockCount(0u)
+	, m_availableBlocks(nullptr)
+	, m_partialBlockSizes(nullptr)
+	, m_availableBlockCount(0u)
+	, m_rawFile(nullptr)
+	, m_blockStreams(nullptr)
+	, m_missingBlockCounts(nullptr)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::ProgressiveFile::~ProgressiveFile(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_availableBlocks);
+	PDB_DELETE_ARRAY(m_partialBlockSizes);
+	PDB_DELETE_ARRAY(m_blockStreams);
+	PDB_DELETE_ARRAY(m_missingBlockCounts);
+	PDB_DELETE(m_rawFile);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::ProgressiveFile::AddAvailableData(size_t offset, size_t size) PDB_NO_EXCEPT
+{
+	if (size == 0u)
+	{
+		return ErrorCode::Success;
+	}
+
+	if (!m_superBlock)
+	{
+		// the block size is unknown until the SuperBlock has arrived, so hold on to the ranges until then
+		m_pendingRanges.Add(Range { offset, size });
+
+		const ErrorCode error = ReadSuperBlock();
+		if (error != ErrorCode::Success)
+		{
+			return error;
+		}
+		else if (!m_superBlock)
+		{
+			return ErrorCode::Success;
+		}
+
+		for (size_t i = 0u; i < m_pendingRanges.GetSize(); ++i)
+		{
+			const Range& range = m_pendingRanges.GetData()[i];
+			MarkBlocks(range.offset, range.size);
+		}
+
+		Range* pendingRanges = m_pendingRanges.Release();
+		PDB_DELETE_ARRAY(pendingRanges);
+	}
+	else
+	{
+		MarkBlocks(offset, size);
+	}
+
+	if (!m_rawFile)
+	{
+		ReadDirectory();
+	}
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::ProgressiveFile::IsStreamAvailable(uint32_t streamIndex) const PDB_NO_EXCEPT
+{
+	if (!m_rawFile || (streamIndex >= m_rawFile->GetStreamCount()))
+	{
+		return false;
+	}
+
+	return (m_missingBlockCounts[streamIndex] == 0u);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::ProgressiveFile::IsBlockAvailable(uint32_t blockIndex) const PDB_NO_EXCEPT
+{
+	if (blockIndex >= m_blockCount)
+	{
+		return false;
+	}
+
+	return (m_availableBlocks[blockIndex >> 6u] & (1ull << (blockIndex & 63u))) != 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::ProgressiveFile::MarkBlocks(size_t offset, size_t size) PDB_NO_EXCEPT
+{
+	const size_t blockSize = static_cast<size_t>(1u) << m_blockSizeLog2;
+	const size_t fileSize = static_cast<size_t>(m_blockCount) << m_blockSizeLog2;
+
+	size_t end = offset + size;
+	if (end > fileSize)
+	{
+		end = fileSize;
+	}
+
+	while (offset < end)
+	{
+		const uint32_t blockIndex = static_cast<uint32_t>(offset >> m_blockSizeLog2);
+		const size_t blockEnd = (static_cast<size_t>(blockIndex) + 1u) << m_blockSizeLog2;
+		const size_t bytesInBlock = ((end < blockEnd) ? end : blockEnd) - offset;
+
+		if (bytesInBlock == blockSize)
+		{
+			// fast path, the whole block arrived at once
+			MarkBlock(blockIndex);
+		}
+		else
+		{
+			// ranges don't overlap, so a block is complete once the sizes of all its parts add up
+			m_partialBlockSizes[blockIndex] += static_cast<uint32_t>(bytesInBlock);
+			if (m_partialBlockSizes[blockIndex] == blockSize)
+			{
+				MarkBlock(blockIndex);
+			}
+		}
+
+		offset += bytesInBlock;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::ProgressiveFile::MarkBlock(uint32_t blockIndex) PDB_NO_EXCEPT
+{
+	uint64_t& word = m_availableBlocks[blockIndex >> 6u];
+	const uint64_t mask = 1ull << (blockIndex & 63u);
+	if (word & mask)
+	{
+		return;
+	}
+
+	word |= mask;
+	++m_availableBlockCount;
+
+	if (!m_rawFile)
+	{
+		// streams are updated all at once when the directory arrives
+		return;
+	}
+
+	const uint32_t streamIndex = m_blockStreams[blockIndex];
+	if (streamIndex == UnusedBlock)
+	{
+		return;
+	}
+
+	if ((--m_missingBlockCounts[streamIndex] == 0u) && m_streamAvailable)
+	{
+		m_streamAvailable(m_userData, streamIndex);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD PDB::ErrorCode PDB::ProgressiveFile::ReadSuperBlock(void) PDB_NO_EXCEPT
+{
+	// ranges arrive in any order, so keep extending the contiguous data at the start of the file until no range continues it
+	const Range* ranges = m_pendingRanges.GetData();
+	size_t contiguousSize = 0u;
+	for (bool extended = true; extended; /* nothing */)
+	{
+		extended = false;
+		for (size_t i = 0u; i < m_pendingRanges.GetSize(); ++i)
+		{
+			if ((ranges[i].offset <= contiguousSize) && (ranges[i].offset + ranges[i].size > contiguousSize))
+			{
+				contiguousSize = ranges[i].offset + ranges[i].size;
+				extended = true;
+			}
+		}
+	}
+
+	if (contiguousSize < SuperBlockHeaderSize)
+	{
+		return ErrorCode::Success;
+	}
+
+	// compressed MSF files don't consist of blocks
+	const SuperBlock* superBlock = static_cast<const SuperBlock*>(m_data);
+	if (std::memcmp(superBlock->fileMagic, SuperBlock::MAGIC, sizeof(SuperBlock::MAGIC)) != 0)
+	{
+		return ErrorCode::InvalidSuperBlock;
+	}
+
+	const ErrorCode error = ValidateFile(m_data);
+	if (error != ErrorCode::Success)
+	{
+		return error;
+	}
+
+	m_superBlock = superBlock;
+	m_blockSizeLog2 = BitUtil::FindFirstSetBit(superBlock->blockSize);
+	m_blockCount = superBlock->blockCount;
+
+	const size_t wordCount = (static_cast<size_t>(m_blockCount) + 63u) / 64u;
+	m_availableBlocks = PDB_NEW_ARRAY(uint64_t, wordCount);
+	std::memset(m_availableBlocks, 0, wordCount * sizeof(uint64_t));
+
+	m_partialBlockSizes = PDB_NEW_ARRAY(uint32_t, m_blockCount);
+	std::memset(m_partialBlockSizes, 0, m_blockCount * sizeof(uint32_t));
+
+	return ErrorCode::Success;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::ProgressiveFile::ReadDirectory(void) PDB_NO_EXCEPT
+{
+	// the indices of blocks storing the directory indices are part of the SuperBlock, see RawFile
+	if (!IsBlockAvailable(0u))
+	{
+		return;
+	}
+
+	const uint32_t blockSize = m_superBlock->blockSize;
+	const uint32_t directoryBlockCount = ConvertSizeToBlockCount(m_superBlock->directorySize, blockSize);
+	const uint32_t directoryIndexBlockCount = ConvertSizeToBlockCount(directoryBlockCount * sizeof(uint32_t), blockSize);
+	if (!AreBlocksAvailable(m_superBlock->directoryBlockIndices, directoryIndexBlockCount))
+	{
+		return;
+	}
+
+	const CoalescedMSFStream directoryIndicesStream(m_data, blockSize, m_superBlock->directoryBlockIndices, directoryBlockCount * sizeof(uint32_t));
+	if (!AreBlocksAvailable(directoryIndicesStream.GetDataAtOffset<uint32_t>(0u), directoryBlockCount))
+	{
+		return;
+	}
+
+	// the whole directory is available, so we know which blocks make up each stream
+	m_rawFile = PDB_NEW(RawFile)(m_data);
+
+	m_blockStreams = PDB_NEW_ARRAY(uint32_t, m_blockCount);
+	for (uint32_t i = 0u; i < m_blockCount; ++i)
+	{
+		m_blockStreams[i] = UnusedBlock;
+	}
+
+	const uint32_t streamCount = m_rawFile->GetStreamCount();
+	m_missingBlockCounts = PDB_NEW_ARRAY(uint32_t, streamCount);
+	for (uint32_t streamIndex = 0u; streamIndex < streamCount; ++streamIndex)
+	{
+		const uint32_t* blockIndices = m_rawFile->GetStreamBlockIndices(streamIndex);
+		const uint32_t blockCount = ConvertSizeToBlockCount(m_rawFile->GetStreamSize(streamIndex), blockSize);
+
+		uint32_t missingBlockCount = 0u;
+		for (uint32_t i = 0u; i < blockCount; ++i)
+		{
+			const uint32_t blockIndex = blockIndices[i];
+			if (blockIndex < m_blockCount)
+			{
+				m_blockStreams[blockIndex] = streamIndex;
+			}
+
+			// blocks outside the file never arrive
+			missingBlockCount += IsBlockAvailable(blockIndex) ? 0u : 1u;
+		}
+
+		m_missingBlockCounts[streamIndex] = missingBlockCount;
+	}
+
+	// report all streams that arrived before the directory
+	if (m_streamAvailable)
+	{
+		for (uint32_t streamIndex = 0u; streamIndex < streamCount; ++streamIndex)
+		{
+			if (m_missingBlockCounts[streamIndex] == 0u)
+			{
+				m_streamAvailable(m_userData, streamIndex);
+			}
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::ProgressiveFile::AreBlocksAvailable(const uint32_t* blockIndices, uint32_t count) const PDB_NO_EXCEPT
+{
+	for (uint32_t i = 0u; i < count; ++i)
+	{
+		if (!IsBlockAvailable(blockIndices[i]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
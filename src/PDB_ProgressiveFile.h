@@ -0,0 +1,99 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "PDB_ErrorCodes.h"
+
+
+namespace PDB
+{
+	class RawFile;
+	struct SuperBlock;
+
+
+	// Tracks which blocks of an MSF file have arrived while the file is still being downloaded or written, so that streams
+	// can be parsed as soon as all their blocks are available instead of waiting for the whole file.
+	// The caller writes incoming bytes into a buffer that is large enough to hold the complete file, and reports each range of
+	// bytes once. Ranges can arrive in any order, but must not overlap.
+	// Not thread-safe: all member functions must be called from the thread feeding the data.
+	class PDB_NO_DISCARD ProgressiveFile
+	{
+	public:
+		// Called once for each stream as soon as all its blocks are available.
+		typedef void (*StreamAvailableFunction)(void* userData, uint32_t streamIndex);
+
+		explicit ProgressiveFile(const void* data) PDB_NO_EXCEPT;
+		explicit ProgressiveFile(const void* data, StreamAvailableFunction streamAvailable, void* userData) PDB_NO_EXCEPT;
+		~ProgressiveFile(void) PDB_NO_EXCEPT;
+
+		// Marks the given range of bytes as available. Returns an error if the data turns out not to be a valid MSF file.
+		PDB_NO_DISCARD ErrorCode AddAvailableData(size_t offset, size_t size) PDB_NO_EXCEPT;
+
+		// Returns whether the stream directory is available, which is needed before any stream can be accessed.
+		PDB_NO_DISCARD inline bool IsDirectoryAvailable(void) const PDB_NO_EXCEPT
+		{
+			return (m_rawFile != nullptr);
+		}
+
+		// Returns the raw file, which can only be used once the stream directory is available.
+		PDB_NO_DISCARD inline const RawFile& GetRawFile(void) const PDB_NO_EXCEPT
+		{
+			return *m_rawFile;
+		}
+
+		// Returns whether all blocks of the given stream are available. Always false as long as the directory is not available.
+		PDB_NO_DISCARD bool IsStreamAvailable(uint32_t streamIndex) const PDB_NO_EXCEPT;
+
+		// Returns whether the given block is available. Always false as long as the SuperBlock is not available.
+		PDB_NO_DISCARD bool IsBlockAvailable(uint32_t blockIndex) const PDB_NO_EXCEPT;
+
+		// Returns whether the whole file is available.
+		PDB_NO_DISCARD inline bool IsComplete(void) const PDB_NO_EXCEPT
+		{
+			return (m_blockCount != 0u) && (m_availableBlockCount == m_blockCount);
+		}
+
+	private:
+		struct Range
+		{
+			size_t offset;
+			size_t size;
+		};
+
+		// Marks the blocks covered by the range, and updates the streams they belong to.
+		void MarkBlocks(size_t offset, size_t size) PDB_NO_EXCEPT;
+		void MarkBlock(uint32_t blockIndex) PDB_NO_EXCEPT;
+
+		// Advances through the SuperBlock, the blocks holding the directory indices and the directory.
+		PDB_NO_DISCARD ErrorCode ReadSuperBlock(void) PDB_NO_EXCEPT;
+		void ReadDirectory(void) PDB_NO_EXCEPT;
+
+		PDB_NO_DISCARD bool AreBlocksAvailable(const uint32_t* blockIndices, uint32_t count) const PDB_NO_EXCEPT;
+
+		const void* m_data;
+		StreamAvailableFunction m_streamAvailable;
+		void* m_userData;
+
+		// ranges that arrived before the SuperBlock, which are needed to learn the block size
+		GrowableArray<Range> m_pendingRanges;
+
+		const SuperBlock* m_superBlock;
+		uint32_t m_blockSizeLog2;
+		uint32_t m_blockCount;
+
+		// one bit per block, and the number of bytes that arrived for blocks that are only partially available
+		uint64_t* m_availableBlocks;
+		uint32_t* m_partialBlockSizes;
+		uint32_t m_availableBlockCount;
+
+		// the stream owning each block, and the number of blocks still missing for each stream, once the directory is available
+		RawFile* m_rawFile;
+		uint32_t* m_blockStreams;
+		uint32_t* m_missingBlockCounts;
+
+		PDB_DISABLE_COPY_MOVE(ProgressiveFile);
+	};
+}
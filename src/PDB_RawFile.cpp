@@ -6,26 +6,55 @@
 #include "PDB_Types.h"
 #include "PDB_Util.h"
 #include "PDB_DirectMSFStream.h"
+#include "PDB_MSFZFile.h"
 #include "Foundation/PDB_PointerUtil.h"
 #include "Foundation/PDB_Memory.h"
 #include "Foundation/PDB_Assert.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstring>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+namespace
+{
+	// MSFZ streams are contiguous in memory, so they can be described as consisting of blocks 0 and 1 of a large power-of-two size
+	static const uint32_t MSFZBlockIndices[2u] = { 0u, 1u };
+	static const uint32_t MSFZMaximumBlockSize = 1u << 31u;
+
+
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	PDB_NO_DISCARD static uint32_t GetMSFZBlockSize(uint32_t streamSize) PDB_NO_EXCEPT
+	{
+		uint32_t blockSize = 1u;
+		while ((blockSize < streamSize) && (blockSize < MSFZMaximumBlockSize))
+		{
+			blockSize <<= 1u;
+		}
+
+		return blockSize;
+	}
+}
 
 
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 PDB::RawFile::RawFile(RawFile&& other) PDB_NO_EXCEPT
-	: m_data(PDB_MOVE(other.m_data))
+	: m_file(PDB_MOVE(other.m_file))
+	, m_data(PDB_MOVE(other.m_data))
 	, m_superBlock(PDB_MOVE(other.m_superBlock))
 	, m_directoryStream(PDB_MOVE(other.m_directoryStream))
 	, m_streamCount(PDB_MOVE(other.m_streamCount))
 	, m_streamSizes(PDB_MOVE(other.m_streamSizes))
 	, m_streamBlocks(PDB_MOVE(other.m_streamBlocks))
+	, m_msfzFile(PDB_MOVE(other.m_msfzFile))
 {
 	other.m_data = nullptr;
 	other.m_superBlock = nullptr;
 	other.m_streamCount = 0u;
 	other.m_streamSizes = nullptr;
 	other.m_streamBlocks = nullptr;
+	other.m_msfzFile = nullptr;
 }
 
 
@@ -36,6 +65,7 @@ PDB::RawFile& PDB::RawFile::operator=(RawFile&& other) PDB_NO_EXCEPT
 	if (this != &other)
 	{
 		PDB_DELETE_ARRAY(m_streamBlocks);
+		PDB_DELETE(m_msfzFile);
 
 		m_data = PDB_MOVE(other.m_data);
 		m_superBlock = PDB_MOVE(other.m_superBlock);
@@ -43,12 +73,17 @@ PDB::RawFile& PDB::RawFile::operator=(RawFile&& other) PDB_NO_EXCEPT
 		m_streamCount = PDB_MOVE(other.m_streamCount);
 		m_streamSizes = PDB_MOVE(other.m_streamSizes);
 		m_streamBlocks = PDB_MOVE(other.m_streamBlocks);
+		m_msfzFile = PDB_MOVE(other.m_msfzFile);
+
+		// the previous mapping is released only after nothing refers to it anymore
+		m_file = PDB_MOVE(other.m_file);
 
 		other.m_data = nullptr;
 		other.m_superBlock = nullptr;
 		other.m_streamCount = 0u;
 		other.m_streamSizes = nullptr;
 		other.m_streamBlocks = nullptr;
+		other.m_msfzFile = nullptr;
 	}
 
 	return *this;
@@ -58,13 +93,52 @@ PDB::RawFile& PDB::RawFile::operator=(RawFile&& other) PDB_NO_EXCEPT
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 PDB::RawFile::RawFile(const void* data) PDB_NO_EXCEPT
-	: m_data(data)
+	: RawFile(data, MSFZ::Options())
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::RawFile::RawFile(MappedFile&& file) PDB_NO_EXCEPT
+	: RawFile(PDB_MOVE(file), MSFZ::Options())
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::RawFile::RawFile(MappedFile&& file, const MSFZ::Options& options) PDB_NO_EXCEPT
+	: RawFile(file.GetData(), options)
+{
+	// moving the mapping doesn't change the address of its data, so all pointers into it stay valid
+	m_file = PDB_MOVE(file);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::RawFile::RawFile(const void* data, const MSFZ::Options& options) PDB_NO_EXCEPT
+	: m_file()
+	, m_data(data)
 	, m_superBlock(Pointer::Offset<const SuperBlock*>(data, 0u))
 	, m_directoryStream()
 	, m_streamCount(0u)
 	, m_streamSizes(nullptr)
 	, m_streamBlocks(nullptr)
+	, m_msfzFile(nullptr)
 {
+	if (std::memcmp(data, MSFZ::FileHeader::MAGIC, sizeof(MSFZ::FileHeader::MAGIC)) == 0)
+	{
+		// compressed MSF files don't have a SuperBlock, the stream directory is parsed by the MSFZFile
+		m_superBlock = nullptr;
+		m_msfzFile = PDB_NEW(MSFZFile)(data, options);
+		m_streamCount = m_msfzFile->GetStreamCount();
+		m_streamSizes = m_msfzFile->GetStreamSizes();
+
+		return;
+	}
+
 	// the SuperBlock stores an array of indices of blocks that make up the indices of directory blocks, which need to be stitched together to form the directory.
 	// the blocks holding the indices of directory blocks are not necessarily contiguous, so they need to be coalesced first.
 	const uint32_t directoryBlockCount = PDB::ConvertSizeToBlockCount(m_superBlock->directorySize, m_superBlock->blockSize);
@@ -111,6 +185,7 @@ PDB::RawFile::RawFile(const void* data) PDB_NO_EXCEPT
 PDB::RawFile::~RawFile(void) PDB_NO_EXCEPT
 {
 	PDB_DELETE_ARRAY(m_streamBlocks);
+	PDB_DELETE(m_msfzFile);
 }
 
 
@@ -122,7 +197,7 @@ PDB_NO_DISCARD T PDB::RawFile::CreateMSFStream(uint32_t streamIndex) const PDB_N
 	PDB_ASSERT(streamIndex != PDB::NilStreamIndex, "Invalid stream index.");
 	PDB_ASSERT(streamIndex < m_streamCount, "Invalid stream index.");
 
-	return T(m_data, m_superBlock->blockSize, m_streamBlocks[streamIndex], GetStreamSize(streamIndex));
+	return CreateMSFStream<T>(streamIndex, GetStreamSize(streamIndex));
 }
 
 
@@ -135,6 +210,11 @@ PDB_NO_DISCARD T PDB::RawFile::CreateMSFStream(uint32_t streamIndex, uint32_t st
 	PDB_ASSERT(streamIndex < m_streamCount, "Invalid stream index.");
 	PDB_ASSERT(streamSize <= GetStreamSize(streamIndex), "Invalid stream size.");
 
+	if (m_msfzFile)
+	{
+		return T(m_msfzFile->GetStreamData(streamIndex), GetMSFZBlockSize(streamSize), MSFZBlockIndices, streamSize);
+	}
+
 	return T(m_data, m_superBlock->blockSize, m_streamBlocks[streamIndex], streamSize);
 }
 
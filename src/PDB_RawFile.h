@@ -8,12 +8,15 @@
 #include <cstdint>
 #include "Foundation/PDB_DisableWarningsPop.h"
 #include "PDB_CoalescedMSFStream.h"
+#include "PDB_MSFZTypes.h"
+#include "PDB_MappedFile.h"
 
 
 // https://llvm.org/docs/PDB/index.html
 namespace PDB
 {
 	struct SuperBlock;
+	class MSFZFile;
 
 
 	class PDB_NO_DISCARD RawFile
@@ -23,6 +26,13 @@ namespace PDB
 		RawFile& operator=(RawFile&& other) PDB_NO_EXCEPT;
 
 		explicit RawFile(const void* data) PDB_NO_EXCEPT;
+
+		// Opens either an MSF or a compressed MSF (MSFZ) file, using the given options for decompressing MSFZ streams.
+		explicit RawFile(const void* data, const MSFZ::Options& options) PDB_NO_EXCEPT;
+
+		// Takes ownership of a mapped file, which stays mapped for as long as the raw file exists.
+		explicit RawFile(MappedFile&& file) PDB_NO_EXCEPT;
+		explicit RawFile(MappedFile&& file, const MSFZ::Options& options) PDB_NO_EXCEPT;
 		~RawFile(void) PDB_NO_EXCEPT;
 
 		// Creates any type of MSF stream.
@@ -34,12 +44,18 @@ namespace PDB
 		PDB_NO_DISCARD T CreateMSFStream(uint32_t streamIndex, uint32_t streamSize) const PDB_NO_EXCEPT;
 
 
-		// Returns the SuperBlock.
+		// Returns the SuperBlock, or nullptr for MSFZ files which don't have one.
 		PDB_NO_DISCARD inline const SuperBlock* GetSuperBlock(void) const PDB_NO_EXCEPT
 		{
 			return m_superBlock;
 		}
 
+		// Returns the compressed MSF container, or nullptr for regular MSF files.
+		PDB_NO_DISCARD inline const MSFZFile* GetMSFZFile(void) const PDB_NO_EXCEPT
+		{
+			return m_msfzFile;
+		}
+
 		// Returns the number of streams in the PDB file.
 		PDB_NO_DISCARD inline uint32_t GetStreamCount(void) const PDB_NO_EXCEPT
 		{
@@ -54,7 +70,22 @@ namespace PDB
 			return (streamSize == NilPageSize) ? 0u : streamSize;
 		}
 
+		// Returns the mapped file owned by the raw file, which is not open if the raw file was created from a pointer to its data.
+		PDB_NO_DISCARD inline const MappedFile& GetMappedFile(void) const PDB_NO_EXCEPT
+		{
+			return m_file;
+		}
+
+		// Returns the indices of the blocks that make up the stream with the given index, or nullptr for MSFZ files.
+		PDB_NO_DISCARD inline const uint32_t* GetStreamBlockIndices(uint32_t streamIndex) const PDB_NO_EXCEPT
+		{
+			return m_streamBlocks ? m_streamBlocks[streamIndex] : nullptr;
+		}
+
 	private:
+		// only set if the raw file owns the mapping of its data. declared first, so that it is unmapped last.
+		MappedFile m_file;
+
 		const void* m_data;
 		const SuperBlock* m_superBlock;
 		CoalescedMSFStream m_directoryStream;
@@ -64,6 +95,9 @@ namespace PDB
 		const uint32_t* m_streamSizes;
 		const uint32_t** m_streamBlocks;
 
+		// streams of MSFZ files are decompressed into contiguous memory on demand
+		MSFZFile* m_msfzFile;
+
 		PDB_DISABLE_COPY(RawFile);
 	};
 }
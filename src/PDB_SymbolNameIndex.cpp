@@ -0,0 +1,1119 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_SymbolNameIndex.h"
+#include "PDB_RawFile.h"
+#include "PDB_CoalescedMSFStream.h"
+#include "PDB_PublicSymbolStream.h"
+#include "PDB_ModuleInfoStream.h"
+#include "PDB_ModuleSymbolStream.h"
+#include "PDB_Types.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	// trigrams are built from 6-bit classes of characters, so that the posting list of each trigram can be addressed directly
+	static constexpr const uint32_t CharacterClassCount = 64u;
+	static constexpr const uint32_t TrigramCount = CharacterClassCount * CharacterClassCount * CharacterClassCount;
+
+	// public symbols are gathered in chunks, all other names are gathered per module
+	static constexpr const uint32_t PublicSymbolsPerJob = 65536u;
+
+	// each job building trigrams needs two tables with an entry per trigram, so jobs work on large ranges of names
+	static constexpr const uint32_t NamesPerTrigramJob = 262144u;
+
+	// queries with more trigrams only intersect the shortest posting lists, candidates are compared to the query anyway
+	static constexpr const size_t MaxQueryTrigramCount = 16u;
+
+	// ranks of matches, stored in the upper bits of a score
+	static constexpr const uint32_t RankExact = 0u;
+	static constexpr const uint32_t RankPrefix = 1u;
+	static constexpr const uint32_t RankWordStart = 2u;
+	static constexpr const uint32_t RankSubstring = 3u;
+	static constexpr const uint32_t RankSubsequence = 4u;
+
+	static constexpr const uint32_t NoMatch = 0xFFFFFFFFu;
+
+
+	struct PendingSymbol
+	{
+		const char* name;
+		uint32_t nameOffset;								// offset into the names of the gathering job, only used until the job has finished
+		uint32_t nameLength;
+		PDB::SymbolNameIndex::Symbol symbol;
+	};
+
+	struct GatherJob
+	{
+		PDB::GrowableArray<char> names;
+		PDB::GrowableArray<PendingSymbol> symbols;
+	};
+
+	struct GatherContext
+	{
+		const PDB::RawFile* file;
+		const PDB::ModuleInfoStream* moduleInfoStream;
+		const PDB::PublicSymbolStream* publicSymbolStream;
+		const PDB::CoalescedMSFStream* symbolRecordStream;
+		GatherJob* jobs;
+		uint32_t moduleCount;
+	};
+
+	struct MergeContext
+	{
+		const PendingSymbol* source;
+		PendingSymbol* destination;
+		const size_t* runOffsets;							// one more offset than there are runs
+		size_t runCount;
+	};
+
+	struct TrigramContext
+	{
+		const char* names;
+		const uint32_t* nameOffsets;
+		const uint32_t* nameIndicesByLength;
+		size_t nameCount;
+		const uint8_t* characterClasses;
+		uint64_t* characterMasks;
+		uint32_t* counts;									// TrigramCount entries per job, turned into offsets into the postings before scattering
+		uint32_t* stamps;									// TrigramCount entries per job, storing the last name that contained a trigram
+		uint32_t* postings;
+		uint32_t* wordStartCounts;							// same as above, for trigrams at the start of a word
+		uint32_t* wordStartStamps;
+		uint32_t* wordStartPostings;
+		bool scatter;
+	};
+
+	struct LengthOrderedName
+	{
+		uint32_t length;
+		uint32_t nameIndex;
+	};
+
+	struct PostingRange
+	{
+		const uint32_t* begin;
+		const uint32_t* end;
+	};
+
+
+	PDB_NO_DISCARD static inline unsigned char ToLower(char c) PDB_NO_EXCEPT
+	{
+		const unsigned char u = static_cast<unsigned char>(c);
+		return (static_cast<unsigned char>(u - 'A') < 26u) ? static_cast<unsigned char>(u + ('a' - 'A')) : u;
+	}
+
+
+	PDB_NO_DISCARD static inline bool IsUpper(char c) PDB_NO_EXCEPT
+	{
+		return static_cast<unsigned char>(c - 'A') < 26u;
+	}
+
+
+	PDB_NO_DISCARD static inline bool IsAlphaNumeric(char c) PDB_NO_EXCEPT
+	{
+		const unsigned char lower = ToLower(c);
+		return (static_cast<unsigned char>(lower - 'a') < 26u) || (static_cast<unsigned char>(lower - '0') < 10u);
+	}
+
+
+	// Letters and digits get a class of their own, as do the punctuation characters found in C++ names. All other characters share a class.
+	PDB_NO_DISCARD static uint32_t GetCharacterClass(char c) PDB_NO_EXCEPT
+	{
+		static const char Punctuation[] = "_:<>,*&()~`'?@$.-[]=+!/|^% ";
+		static_assert(26u + 10u + sizeof(Punctuation) - 1u < CharacterClassCount, "Too many character classes.");
+
+		const unsigned char lower = ToLower(c);
+		if (static_cast<unsigned char>(lower - 'a') < 26u)
+		{
+			return lower - 'a';
+		}
+		else if (static_cast<unsigned char>(lower - '0') < 10u)
+		{
+			return 26u + (lower - '0');
+		}
+		else if (lower != '\0')
+		{
+			const char* punctuation = std::strchr(Punctuation, lower);
+			if (punctuation)
+			{
+				return 36u + static_cast<uint32_t>(punctuation - Punctuation);
+			}
+		}
+
+		return CharacterClassCount - 1u;
+	}
+
+
+	// Compares two names case-insensitively, ordering names that only differ in case by their bytes.
+	PDB_NO_DISCARD static int CompareNames(const char* lhs, uint32_t lhsLength, const char* rhs, uint32_t rhsLength) PDB_NO_EXCEPT
+	{
+		const uint32_t length = (lhsLength < rhsLength) ? lhsLength : rhsLength;
+		for (uint32_t i = 0u; i < length; ++i)
+		{
+			const unsigned char l = ToLower(lhs[i]);
+			const unsigned char r = ToLower(rhs[i]);
+			if (l != r)
+			{
+				return (l < r) ? -1 : 1;
+			}
+		}
+
+		if (lhsLength != rhsLength)
+		{
+			return (lhsLength < rhsLength) ? -1 : 1;
+		}
+
+		return std::memcmp(lhs, rhs, length);
+	}
+
+
+	// Compares the start of a null-terminated name case-insensitively to a query, returning 0 if the name starts with the query.
+	PDB_NO_DISCARD static int ComparePrefix(const char* name, const char* query, size_t queryLength) PDB_NO_EXCEPT
+	{
+		for (size_t i = 0u; i < queryLength; ++i)
+		{
+			const unsigned char n = ToLower(name[i]);
+			const unsigned char q = ToLower(query[i]);
+			if (n != q)
+			{
+				return (n < q) ? -1 : 1;
+			}
+		}
+
+		return 0;
+	}
+
+
+	PDB_NO_DISCARD static bool IsLess(const PendingSymbol& lhs, const PendingSymbol& rhs) PDB_NO_EXCEPT
+	{
+		const int result = CompareNames(lhs.name, lhs.nameLength, rhs.name, rhs.nameLength);
+		if (result != 0)
+		{
+			return result < 0;
+		}
+
+		// order symbols sharing a name by their records, so that the index does not depend on the order in which jobs ran
+		if (lhs.symbol.moduleIndex != rhs.symbol.moduleIndex)
+		{
+			return lhs.symbol.moduleIndex < rhs.symbol.moduleIndex;
+		}
+
+		return lhs.symbol.recordOffset < rhs.symbol.recordOffset;
+	}
+
+
+	PDB_NO_DISCARD static bool HaveSameName(const PendingSymbol& lhs, const PendingSymbol& rhs) PDB_NO_EXCEPT
+	{
+		return (lhs.nameLength == rhs.nameLength) && (std::memcmp(lhs.name, rhs.name, lhs.nameLength) == 0);
+	}
+
+
+	static void AddPendingSymbol(GatherJob& job, const char* name, uint32_t moduleIndex, uint32_t recordOffset, PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		const size_t length = std::strlen(name);
+		if (length == 0u)
+		{
+			return;
+		}
+
+		PendingSymbol symbol = {};
+		symbol.nameOffset = static_cast<uint32_t>(job.names.Append(name, length));
+		symbol.nameLength = static_cast<uint32_t>(length);
+		symbol.symbol = PDB::SymbolNameIndex::Symbol { moduleIndex, recordOffset, kind };
+		job.symbols.Add(symbol);
+	}
+
+
+	PDB_NO_DISCARD static bool IsProcedure(PDB::CodeView::DBI::SymbolRecordKind kind) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::DBI;
+
+		return (kind == SymbolRecordKind::S_LPROC32) || (kind == SymbolRecordKind::S_GPROC32) ||
+			(kind == SymbolRecordKind::S_LPROC32_ID) || (kind == SymbolRecordKind::S_GPROC32_ID) ||
+			(kind == SymbolRecordKind::S_LPROC32_DPC) || (kind == SymbolRecordKind::S_LPROC32_DPC_ID);
+	}
+
+
+	// Gathers the names of either a module or a chunk of public symbols, and sorts them.
+	static void GatherNamesJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const GatherContext& context = *static_cast<const GatherContext*>(jobData);
+		GatherJob& job = context.jobs[index];
+
+		if (index < context.moduleCount)
+		{
+			const PDB::ModuleInfoStream::Module& module = context.moduleInfoStream->GetModules()[index];
+			if (module.HasSymbolStream())
+			{
+				const PDB::ModuleSymbolStream moduleSymbolStream = module.CreateSymbolStream(*context.file);
+				for (PDB::ModuleSymbolStream::SymbolIterator it = moduleSymbolStream.GetSymbols().begin(), end = moduleSymbolStream.GetSymbols().end(); it != end; ++it)
+				{
+					const PDB::CodeView::DBI::Record* record = *it;
+					if (IsProcedure(record->header.kind))
+					{
+						// all procedure record kinds share the same layout
+						AddPendingSymbol(job, record->data.S_GPROC32.name, index, it.GetOffset(), record->header.kind);
+					}
+				}
+			}
+		}
+		else
+		{
+			const PDB::ArrayView<PDB::HashRecord> hashRecords = context.publicSymbolStream->GetRecords();
+			const size_t first = static_cast<size_t>(index - context.moduleCount) * PublicSymbolsPerJob;
+			const size_t last = (first + PublicSymbolsPerJob < hashRecords.GetLength()) ? first + PublicSymbolsPerJob : hashRecords.GetLength();
+			for (size_t i = first; i < last; ++i)
+			{
+				const PDB::HashRecord& hashRecord = hashRecords[i];
+				const PDB::CodeView::DBI::Record* record = context.publicSymbolStream->GetRecord(*context.symbolRecordStream, hashRecord);
+				if (record->header.kind == PDB::CodeView::DBI::SymbolRecordKind::S_PUB32)
+				{
+					AddPendingSymbol(job, record->data.S_PUB32.name, PDB::SymbolNameIndex::PublicModuleIndex, hashRecord.offset - 1u, record->header.kind);
+				}
+			}
+		}
+
+		// names no longer move once all of them have been gathered
+		PendingSymbol* symbols = job.symbols.GetData();
+		const size_t symbolCount = job.symbols.GetSize();
+		const char* names = job.names.GetData();
+		for (size_t i = 0u; i < symbolCount; ++i)
+		{
+			symbols[i].name = names + symbols[i].nameOffset;
+		}
+
+		PDB::Algorithm::Sort(symbols, symbols + symbolCount, &IsLess);
+	}
+
+
+	// Merges two neighbouring sorted runs into one.
+	static void MergeRunsJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const MergeContext& context = *static_cast<const MergeContext*>(jobData);
+
+		const size_t firstRun = 2u * static_cast<size_t>(index);
+		const size_t begin = context.runOffsets[firstRun];
+		const size_t middle = context.runOffsets[(firstRun + 1u < context.runCount) ? firstRun + 1u : context.runCount];
+		const size_t end = context.runOffsets[(firstRun + 2u < context.runCount) ? firstRun + 2u : context.runCount];
+
+		const PendingSymbol* source = context.source;
+		PendingSymbol* destination = context.destination + begin;
+
+		size_t lhs = begin;
+		size_t rhs = middle;
+		while ((lhs < middle) && (rhs < end))
+		{
+			*destination++ = IsLess(source[rhs], source[lhs]) ? source[rhs++] : source[lhs++];
+		}
+
+		while (lhs < middle)
+		{
+			*destination++ = source[lhs++];
+		}
+
+		while (rhs < end)
+		{
+			*destination++ = source[rhs++];
+		}
+	}
+
+
+	PDB_NO_DISCARD static bool IsWordStart(const char* name, size_t position) PDB_NO_EXCEPT
+	{
+		if ((position == 0u) || !IsAlphaNumeric(name[position - 1u]))
+		{
+			return true;
+		}
+
+		// humps of camel case names, e.g. "Search" in "FuzzySearch"
+		return !IsUpper(name[position - 1u]) && IsUpper(name[position]);
+	}
+
+
+	// Counts or scatters the distinct trigrams of a range of names in the order of their length. Counting also builds the character masks of the names.
+	static void IndexTrigramsJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const TrigramContext& context = *static_cast<const TrigramContext*>(jobData);
+
+		uint32_t* counts = context.counts + static_cast<size_t>(index) * TrigramCount;
+		uint32_t* stamps = context.stamps + static_cast<size_t>(index) * TrigramCount;
+		uint32_t* wordStartCounts = context.wordStartCounts + static_cast<size_t>(index) * TrigramCount;
+		uint32_t* wordStartStamps = context.wordStartStamps + static_cast<size_t>(index) * TrigramCount;
+		std::memset(stamps, 0, TrigramCount * sizeof(uint32_t));
+		std::memset(wordStartStamps, 0, TrigramCount * sizeof(uint32_t));
+
+		const size_t first = static_cast<size_t>(index) * NamesPerTrigramJob;
+		const size_t last = (first + NamesPerTrigramJob < context.nameCount) ? first + NamesPerTrigramJob : context.nameCount;
+		for (size_t position = first; position < last; ++position)
+		{
+			const uint32_t nameIndex = context.nameIndicesByLength[position];
+			const char* name = context.names + context.nameOffsets[nameIndex];
+			const uint32_t length = context.nameOffsets[nameIndex + 1u] - context.nameOffsets[nameIndex] - 1u;
+
+			// a name containing the same trigram several times is only stored once in its posting list
+			const uint32_t stamp = static_cast<uint32_t>(position) + 1u;
+			uint64_t characterMask = 0u;
+			uint32_t trigram = 0u;
+			for (uint32_t i = 0u; i < length; ++i)
+			{
+				const uint32_t characterClass = context.characterClasses[static_cast<unsigned char>(name[i])];
+				characterMask |= 1ull << characterClass;
+				trigram = ((trigram * CharacterClassCount) + characterClass) % TrigramCount;
+
+				if (i < 2u)
+				{
+					continue;
+				}
+
+				if (stamps[trigram] != stamp)
+				{
+					stamps[trigram] = stamp;
+					if (context.scatter)
+					{
+						context.postings[counts[trigram]++] = static_cast<uint32_t>(position);
+					}
+					else
+					{
+						++counts[trigram];
+					}
+				}
+
+				if ((wordStartStamps[trigram] != stamp) && IsWordStart(name, i - 2u))
+				{
+					wordStartStamps[trigram] = stamp;
+					if (context.scatter)
+					{
+						context.wordStartPostings[wordStartCounts[trigram]++] = static_cast<uint32_t>(position);
+					}
+					else
+					{
+						++wordStartCounts[trigram];
+					}
+				}
+			}
+
+			if (!context.scatter)
+			{
+				context.characterMasks[position] = characterMask;
+			}
+		}
+	}
+
+
+	// Turns the per-job counts of each trigram into offsets into the posting lists, and returns the total number of postings.
+	PDB_NO_DISCARD static uint32_t ComputePostingOffsets(uint32_t* counts, uint32_t jobCount, uint32_t* trigramOffsets) PDB_NO_EXCEPT
+	{
+		uint32_t postingCount = 0u;
+		for (uint32_t trigram = 0u; trigram < TrigramCount; ++trigram)
+		{
+			trigramOffsets[trigram] = postingCount;
+			for (uint32_t job = 0u; job < jobCount; ++job)
+			{
+				uint32_t& count = counts[static_cast<size_t>(job) * TrigramCount + trigram];
+				const uint32_t jobPostingCount = count;
+				count = postingCount;
+				postingCount += jobPostingCount;
+			}
+		}
+
+		trigramOffsets[TrigramCount] = postingCount;
+
+		return postingCount;
+	}
+
+
+	PDB_NO_DISCARD static inline uint32_t MakeScore(uint32_t rank, size_t penalty) PDB_NO_EXCEPT
+	{
+		return (rank << 24u) | ((penalty < 0xFFFFFFu) ? static_cast<uint32_t>(penalty) : 0xFFFFFFu);
+	}
+
+
+	PDB_NO_DISCARD static inline uint32_t GetRank(uint32_t score) PDB_NO_EXCEPT
+	{
+		return score >> 24u;
+	}
+
+
+	// Returns the best score a name of the given length can have when matching with the given rank.
+	PDB_NO_DISCARD static inline uint32_t GetBestScore(uint32_t rank, uint32_t nameLength) PDB_NO_EXCEPT
+	{
+		// subsequence matches only take the first 255 characters of a name into account
+		return MakeScore(rank, ((rank == RankSubsequence) && (nameLength > 255u)) ? 255u : nameLength);
+	}
+
+
+	// Returns the score of the best occurrence of the query in the name, or NoMatch. Shorter names are preferred.
+	PDB_NO_DISCARD static uint32_t ScoreSubstring(const char* name, size_t nameLength, const char* query, size_t queryLength) PDB_NO_EXCEPT
+	{
+		if (queryLength > nameLength)
+		{
+			return NoMatch;
+		}
+
+		const unsigned char first = ToLower(query[0]);
+		bool isFound = false;
+		for (size_t position = 0u; position + queryLength <= nameLength; ++position)
+		{
+			if (ToLower(name[position]) != first)
+			{
+				continue;
+			}
+
+			size_t i = 1u;
+			while ((i < queryLength) && (ToLower(name[position + i]) == ToLower(query[i])))
+			{
+				++i;
+			}
+
+			if (i != queryLength)
+			{
+				continue;
+			}
+
+			if (position == 0u)
+			{
+				return MakeScore((queryLength == nameLength) ? RankExact : RankPrefix, nameLength);
+			}
+			else if (IsWordStart(name, position))
+			{
+				// no later occurrence can be better
+				return MakeScore(RankWordStart, nameLength);
+			}
+
+			isFound = true;
+		}
+
+		return isFound ? MakeScore(RankSubstring, nameLength) : NoMatch;
+	}
+
+
+	// Returns the score of the characters of the query occurring in the name in order, or NoMatch. Tighter matches are preferred.
+	PDB_NO_DISCARD static uint32_t ScoreSubsequence(const char* name, size_t nameLength, const char* query, size_t queryLength) PDB_NO_EXCEPT
+	{
+		// find the characters from left to right, then tighten the match by searching from its end back to the left
+		size_t queryIndex = 0u;
+		size_t end = 0u;
+		for (size_t i = 0u; (i < nameLength) && (queryIndex < queryLength); ++i)
+		{
+			if (ToLower(name[i]) == ToLower(query[queryIndex]))
+			{
+				++queryIndex;
+				end = i;
+			}
+		}
+
+		if (queryIndex != queryLength)
+		{
+			return NoMatch;
+		}
+
+		size_t start = end;
+		for (size_t i = end + 1u; i-- > 0u;)
+		{
+			if (ToLower(name[i]) == ToLower(query[queryIndex - 1u]))
+			{
+				if (--queryIndex == 0u)
+				{
+					start = i;
+					break;
+				}
+			}
+		}
+
+		const size_t gap = (end - start + 1u) - queryLength;
+		return MakeScore(RankSubsequence, gap * 256u + ((nameLength < 255u) ? nameLength : 255u));
+	}
+
+
+	PDB_NO_DISCARD static inline bool IsBetterMatch(const PDB::SymbolNameIndex::Match& lhs, const PDB::SymbolNameIndex::Match& rhs) PDB_NO_EXCEPT
+	{
+		return (lhs.score < rhs.score) || ((lhs.score == rhs.score) && (lhs.nameIndex < rhs.nameIndex));
+	}
+
+
+	// Returns whether no name of the given length or longer can make it into the best matches with the given rank.
+	PDB_NO_DISCARD static inline bool CanStop(const PDB::SymbolNameIndex::Match* matches, size_t matchCount, size_t maxMatchCount, uint32_t rank, uint32_t nameLength) PDB_NO_EXCEPT
+	{
+		return (matchCount == maxMatchCount) && (matches[0].score < GetBestScore(rank, nameLength));
+	}
+
+
+	// Keeps the best matches in a binary heap with the worst match at its root.
+	static void AddMatch(PDB::SymbolNameIndex::Match* matches, size_t& matchCount, size_t maxMatchCount, uint32_t nameIndex, uint32_t score) PDB_NO_EXCEPT
+	{
+		const PDB::SymbolNameIndex::Match match = { nameIndex, score };
+		if (matchCount < maxMatchCount)
+		{
+			size_t index = matchCount++;
+			while (index > 0u)
+			{
+				const size_t parent = (index - 1u) / 2u;
+				if (!IsBetterMatch(matches[parent], match))
+				{
+					break;
+				}
+
+				matches[index] = matches[parent];
+				index = parent;
+			}
+
+			matches[index] = match;
+			return;
+		}
+
+		if (!IsBetterMatch(match, matches[0]))
+		{
+			return;
+		}
+
+		// replace the worst match
+		size_t index = 0u;
+		for (;;)
+		{
+			size_t child = 2u * index + 1u;
+			if (child >= matchCount)
+			{
+				break;
+			}
+
+			if ((child + 1u < matchCount) && IsBetterMatch(matches[child], matches[child + 1u]))
+			{
+				++child;
+			}
+
+			if (!IsBetterMatch(match, matches[child]))
+			{
+				break;
+			}
+
+			matches[index] = matches[child];
+			index = child;
+		}
+
+		matches[index] = match;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::SymbolNameIndex::SymbolNameIndex(void) PDB_NO_EXCEPT
+	: m_names(nullptr)
+	, m_nameOffsets(nullptr)
+	, m_nameCount(0u)
+	, m_nameIndicesByLength(nullptr)
+	, m_characterMasks(nullptr)
+	, m_symbols(nullptr)
+	, m_symbolOffsets(nullptr)
+	, m_trigramOffsets(nullptr)
+	, m_postings(nullptr)
+	, m_wordStartTrigramOffsets(nullptr)
+	, m_wordStartPostings(nullptr)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::SymbolNameIndex::SymbolNameIndex(SymbolNameIndex&& other) PDB_NO_EXCEPT
+	: m_names(PDB_MOVE(other.m_names))
+	, m_nameOffsets(PDB_MOVE(other.m_nameOffsets))
+	, m_nameCount(PDB_MOVE(other.m_nameCount))
+	, m_nameIndicesByLength(PDB_MOVE(other.m_nameIndicesByLength))
+	, m_characterMasks(PDB_MOVE(other.m_characterMasks))
+	, m_symbols(PDB_MOVE(other.m_symbols))
+	, m_symbolOffsets(PDB_MOVE(other.m_symbolOffsets))
+	, m_trigramOffsets(PDB_MOVE(other.m_trigramOffsets))
+	, m_postings(PDB_MOVE(other.m_postings))
+	, m_wordStartTrigramOffsets(PDB_MOVE(other.m_wordStartTrigramOffsets))
+	, m_wordStartPostings(PDB_MOVE(other.m_wordStartPostings))
+{
+	other.m_names = nullptr;
+	other.m_nameOffsets = nullptr;
+	other.m_nameCount = 0u;
+	other.m_nameIndicesByLength = nullptr;
+	other.m_characterMasks = nullptr;
+	other.m_symbols = nullptr;
+	other.m_symbolOffsets = nullptr;
+	other.m_trigramOffsets = nullptr;
+	other.m_postings = nullptr;
+	other.m_wordStartTrigramOffsets = nullptr;
+	other.m_wordStartPostings = nullptr;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::SymbolNameIndex& PDB::SymbolNameIndex::operator=(SymbolNameIndex&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_names);
+		PDB_DELETE_ARRAY(m_nameOffsets);
+		PDB_DELETE_ARRAY(m_nameIndicesByLength);
+	PDB_DELETE_ARRAY(m_nameIndicesByLength);
+		PDB_DELETE_ARRAY(m_characterMasks);
+		PDB_DELETE_ARRAY(m_symbols);
+		PDB_DELETE_ARRAY(m_symbolOffsets);
+		PDB_DELETE_ARRAY(m_trigramOffsets);
+		PDB_DELETE_ARRAY(m_postings);
+		PDB_DELETE_ARRAY(m_wordStartTrigramOffsets);
+		PDB_DELETE_ARRAY(m_wordStartPostings);
+	PDB_DELETE_ARRAY(m_wordStartTrigramOffsets);
+	PDB_DELETE_ARRAY(m_wordStartPostings);
+
+		m_names = PDB_MOVE(other.m_names);
+		m_nameOffsets = PDB_MOVE(other.m_nameOffsets);
+		m_nameCount = PDB_MOVE(other.m_nameCount);
+		m_nameIndicesByLength = PDB_MOVE(other.m_nameIndicesByLength);
+		m_characterMasks = PDB_MOVE(other.m_characterMasks);
+		m_symbols = PDB_MOVE(other.m_symbols);
+		m_symbolOffsets = PDB_MOVE(other.m_symbolOffsets);
+		m_trigramOffsets = PDB_MOVE(other.m_trigramOffsets);
+		m_postings = PDB_MOVE(other.m_postings);
+		m_wordStartTrigramOffsets = PDB_MOVE(other.m_wordStartTrigramOffsets);
+		m_wordStartPostings = PDB_MOVE(other.m_wordStartPostings);
+
+		other.m_names = nullptr;
+		other.m_nameOffsets = nullptr;
+		other.m_nameCount = 0u;
+		other.m_nameIndicesByLength = nullptr;
+	other.m_nameIndicesByLength = nullptr;
+		other.m_characterMasks = nullptr;
+		other.m_symbols = nullptr;
+		other.m_symbolOffsets = nullptr;
+		other.m_trigramOffsets = nullptr;
+		other.m_postings = nullptr;
+		other.m_wordStartTrigramOffsets = nullptr;
+		other.m_wordStartPostings = nullptr;
+	other.m_wordStartTrigramOffsets = nullptr;
+	other.m_wordStartPostings = nullptr;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::SymbolNameIndex::SymbolNameIndex(const RawFile& file, const ModuleInfoStream& moduleInfoStream, const PublicSymbolStream& publicSymbolStream,
+	const CoalescedMSFStream& symbolRecordStream, ParallelForFunction parallelFor, void* userData) PDB_NO_EXCEPT
+	: m_names(nullptr)
+	, m_nameOffsets(nullptr)
+	, m_nameCount(0u)
+	, m_nameIndicesByLength(nullptr)
+	, m_characterMasks(nullptr)
+	, m_symbols(nullptr)
+	, m_symbolOffsets(nullptr)
+	, m_trigramOffsets(nullptr)
+	, m_postings(nullptr)
+	, m_wordStartTrigramOffsets(nullptr)
+	, m_wordStartPostings(nullptr)
+{
+	// gather and sort the names of each module and each chunk of public symbols in parallel
+	const uint32_t moduleCount = static_cast<uint32_t>(moduleInfoStream.GetModules().GetLength());
+	const uint32_t publicSymbolCount = static_cast<uint32_t>(publicSymbolStream.GetRecords().GetLength());
+	const uint32_t gatherJobCount = moduleCount + (publicSymbolCount + PublicSymbolsPerJob - 1u) / PublicSymbolsPerJob;
+
+	GatherJob* gatherJobs = PDB_NEW_ARRAY(GatherJob, gatherJobCount);
+	GatherContext gatherContext = { &file, &moduleInfoStream, &publicSymbolStream, &symbolRecordStream, gatherJobs, moduleCount };
+	ParallelFor(parallelFor, userData, gatherJobCount, &GatherNamesJob, &gatherContext);
+
+	// concatenate the sorted runs of all jobs, and merge pairs of neighbouring runs in parallel until a single run is left
+	size_t symbolCount = 0u;
+	for (uint32_t i = 0u; i < gatherJobCount; ++i)
+	{
+		symbolCount += gatherJobs[i].symbols.GetSize();
+	}
+
+	PendingSymbol* pendingSymbols = PDB_NEW_ARRAY(PendingSymbol, symbolCount);
+	PendingSymbol* mergedSymbols = PDB_NEW_ARRAY(PendingSymbol, symbolCount);
+	size_t* runOffsets = PDB_NEW_ARRAY(size_t, gatherJobCount + 1u);
+	size_t runCount = 0u;
+	{
+		size_t offset = 0u;
+		for (uint32_t i = 0u; i < gatherJobCount; ++i)
+		{
+			const size_t count = gatherJobs[i].symbols.GetSize();
+			if (count == 0u)
+			{
+				continue;
+			}
+
+			std::memcpy(pendingSymbols + offset, gatherJobs[i].symbols.GetData(), count * sizeof(PendingSymbol));
+			runOffsets[runCount++] = offset;
+			offset += count;
+		}
+
+		runOffsets[runCount] = symbolCount;
+	}
+
+	while (runCount > 1u)
+	{
+		MergeContext mergeContext = { pendingSymbols, mergedSymbols, runOffsets, runCount };
+		const size_t pairCount = (runCount + 1u) / 2u;
+		ParallelFor(parallelFor, userData, static_cast<uint32_t>(pairCount), &MergeRunsJob, &mergeContext);
+
+		for (size_t i = 0u; i < pairCount; ++i)
+		{
+			runOffsets[i] = runOffsets[2u * i];
+		}
+
+		runOffsets[pairCount] = symbolCount;
+		runCount = pairCount;
+
+		PendingSymbol* symbols = pendingSymbols;
+		pendingSymbols = mergedSymbols;
+		mergedSymbols = symbols;
+	}
+
+	PDB_DELETE_ARRAY(mergedSymbols);
+	PDB_DELETE_ARRAY(runOffsets);
+
+	// intern the names, symbols sharing a name are neighbours after sorting
+	size_t nameCount = 0u;
+	size_t namesSize = 0u;
+	for (size_t i = 0u; i < symbolCount; ++i)
+	{
+		if ((i == 0u) || !HaveSameName(pendingSymbols[i - 1u], pendingSymbols[i]))
+		{
+			++nameCount;
+			namesSize += pendingSymbols[i].nameLength + 1u;
+		}
+	}
+
+	m_names = PDB_NEW_ARRAY(char, namesSize);
+	m_nameOffsets = PDB_NEW_ARRAY(uint32_t, nameCount + 1u);
+	m_nameCount = nameCount;
+	m_symbols = PDB_NEW_ARRAY(Symbol, symbolCount);
+	m_symbolOffsets = PDB_NEW_ARRAY(uint32_t, nameCount + 1u);
+	{
+		size_t nameIndex = 0u;
+		size_t namesOffset = 0u;
+		for (size_t i = 0u; i < symbolCount; ++i)
+		{
+			const PendingSymbol& symbol = pendingSymbols[i];
+			if ((i == 0u) || !HaveSameName(pendingSymbols[i - 1u], symbol))
+			{
+				m_nameOffsets[nameIndex] = static_cast<uint32_t>(namesOffset);
+				m_symbolOffsets[nameIndex] = static_cast<uint32_t>(i);
+				++nameIndex;
+
+				std::memcpy(m_names + namesOffset, symbol.name, symbol.nameLength);
+				m_names[namesOffset + symbol.nameLength] = '\0';
+				namesOffset += symbol.nameLength + 1u;
+			}
+
+			m_symbols[i] = symbol.symbol;
+		}
+
+		m_nameOffsets[nameCount] = static_cast<uint32_t>(namesSize);
+		m_symbolOffsets[nameCount] = static_cast<uint32_t>(symbolCount);
+	}
+
+	PDB_DELETE_ARRAY(pendingSymbols);
+	PDB_DELETE_ARRAY(gatherJobs);
+
+	// order the names by their length, so that searches can stop once no longer name can make it into the best matches
+	{
+		LengthOrderedName* namesByLength = PDB_NEW_ARRAY(LengthOrderedName, nameCount);
+		for (size_t i = 0u; i < nameCount; ++i)
+		{
+			const uint32_t nameIndex = static_cast<uint32_t>(i);
+			namesByLength[i] = LengthOrderedName { GetNameLength(nameIndex), nameIndex };
+		}
+
+		Algorithm::Sort(namesByLength, namesByLength + nameCount, [](const LengthOrderedName& lhs, const LengthOrderedName& rhs)
+		{
+			return (lhs.length < rhs.length) || ((lhs.length == rhs.length) && (lhs.nameIndex < rhs.nameIndex));
+		});
+
+		m_nameIndicesByLength = PDB_NEW_ARRAY(uint32_t, nameCount);
+		for (size_t i = 0u; i < nameCount; ++i)
+		{
+			m_nameIndicesByLength[i] = namesByLength[i].nameIndex;
+		}
+
+		PDB_DELETE_ARRAY(namesByLength);
+	}
+
+	// count the trigrams of all names in parallel, compute where each job stores its part of a posting list, and scatter the names
+	// into the posting lists in a second parallel pass. jobs work on ascending ranges of names, so each posting list ends up sorted.
+	uint8_t characterClasses[256u];
+	for (uint32_t i = 0u; i < 256u; ++i)
+	{
+		characterClasses[i] = static_cast<uint8_t>(GetCharacterClass(static_cast<char>(i)));
+	}
+
+	const uint32_t trigramJobCount = static_cast<uint32_t>((nameCount + NamesPerTrigramJob - 1u) / NamesPerTrigramJob);
+	const size_t tableSize = static_cast<size_t>(trigramJobCount) * TrigramCount;
+	uint32_t* counts = PDB_NEW_ARRAY(uint32_t, tableSize);
+	uint32_t* stamps = PDB_NEW_ARRAY(uint32_t, tableSize);
+	uint32_t* wordStartCounts = PDB_NEW_ARRAY(uint32_t, tableSize);
+	uint32_t* wordStartStamps = PDB_NEW_ARRAY(uint32_t, tableSize);
+	std::memset(counts, 0, tableSize * sizeof(uint32_t));
+	std::memset(wordStartCounts, 0, tableSize * sizeof(uint32_t));
+
+	m_characterMasks = PDB_NEW_ARRAY(uint64_t, nameCount);
+
+	TrigramContext trigramContext = { m_names, m_nameOffsets, m_nameIndicesByLength, nameCount, characterClasses, m_characterMasks,
+		counts, stamps, nullptr, wordStartCounts, wordStartStamps, nullptr, false };
+	ParallelFor(parallelFor, userData, trigramJobCount, &IndexTrigramsJob, &trigramContext);
+
+	m_trigramOffsets = PDB_NEW_ARRAY(uint32_t, TrigramCount + 1u);
+	m_postings = PDB_NEW_ARRAY(uint32_t, ComputePostingOffsets(counts, trigramJobCount, m_trigramOffsets));
+
+	m_wordStartTrigramOffsets = PDB_NEW_ARRAY(uint32_t, TrigramCount + 1u);
+	m_wordStartPostings = PDB_NEW_ARRAY(uint32_t, ComputePostingOffsets(wordStartCounts, trigramJobCount, m_wordStartTrigramOffsets));
+
+	trigramContext.postings = m_postings;
+	trigramContext.wordStartPostings = m_wordStartPostings;
+	trigramContext.scatter = true;
+	ParallelFor(parallelFor, userData, trigramJobCount, &IndexTrigramsJob, &trigramContext);
+
+	PDB_DELETE_ARRAY(counts);
+	PDB_DELETE_ARRAY(stamps);
+	PDB_DELETE_ARRAY(wordStartCounts);
+	PDB_DELETE_ARRAY(wordStartStamps);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::SymbolNameIndex::~SymbolNameIndex(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_names);
+	PDB_DELETE_ARRAY(m_nameOffsets);
+	PDB_DELETE_ARRAY(m_nameIndicesByLength);
+	PDB_DELETE_ARRAY(m_characterMasks);
+	PDB_DELETE_ARRAY(m_symbols);
+	PDB_DELETE_ARRAY(m_symbolOffsets);
+	PDB_DELETE_ARRAY(m_trigramOffsets);
+	PDB_DELETE_ARRAY(m_postings);
+	PDB_DELETE_ARRAY(m_wordStartTrigramOffsets);
+	PDB_DELETE_ARRAY(m_wordStartPostings);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD size_t PDB::SymbolNameIndex::Search(const char* query, SearchMode mode, Match* matches, size_t maxMatchCount) const PDB_NO_EXCEPT
+{
+	const size_t queryLength = query ? std::strlen(query) : 0u;
+	if ((queryLength == 0u) || (maxMatchCount == 0u) || (m_nameCount == 0u))
+	{
+		return 0u;
+	}
+
+	// matches of each rank are searched separately from best to worst rank, each search stopping once it cannot improve the matches.
+	// exact matches and prefixes are neighbours in the sorted names, all other searches skip the matches of better ranks.
+	size_t matchCount = 0u;
+	SearchPrefix(query, queryLength, matches, matchCount, maxMatchCount);
+
+	if ((mode != SearchMode::Prefix) && (queryLength < 3u))
+	{
+		// too short to contain a trigram
+		SearchCharacterMasks(query, queryLength, RankWordStart, mode == SearchMode::Subsequence, matches, matchCount, maxMatchCount);
+	}
+	else if (mode != SearchMode::Prefix)
+	{
+		SearchTrigrams(query, queryLength, true, matches, matchCount, maxMatchCount);
+		SearchTrigrams(query, queryLength, false, matches, matchCount, maxMatchCount);
+
+		if (mode == SearchMode::Subsequence)
+		{
+			SearchCharacterMasks(query, queryLength, RankSubsequence, true, matches, matchCount, maxMatchCount);
+		}
+	}
+
+	// turn the heap into a sorted array
+	Algorithm::Sort(matches, matches + matchCount, &IsBetterMatch);
+
+	return matchCount;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::SymbolNameIndex::SearchPrefix(const char* query, size_t queryLength, Match* matches, size_t& matchCount, size_t maxMatchCount) const PDB_NO_EXCEPT
+{
+	// names are sorted case-insensitively, so all names starting with the query are neighbours
+	const char* names = m_names;
+	const size_t first = Algorithm::LowerBound(m_nameOffsets, m_nameCount, query, [names, queryLength](uint32_t nameOffset, const char* value)
+	{
+		return ComparePrefix(&names[nameOffset], value, queryLength) < 0;
+	});
+
+	for (size_t i = first; (i < m_nameCount) && (ComparePrefix(&m_names[m_nameOffsets[i]], query, queryLength) == 0); ++i)
+	{
+		const uint32_t nameIndex = static_cast<uint32_t>(i);
+		const uint32_t nameLength = GetNameLength(nameIndex);
+		AddMatch(matches, matchCount, maxMatchCount, nameIndex, MakeScore((nameLength == queryLength) ? RankExact : RankPrefix, nameLength));
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::SymbolNameIndex::SearchTrigrams(const char* query, size_t queryLength, bool atWordStart, Match* matches, size_t& matchCount, size_t maxMatchCount) const PDB_NO_EXCEPT
+{
+	const uint32_t rank = atWordStart ? RankWordStart : RankSubstring;
+
+	// gather the posting lists of the query's trigrams, keeping the shortest ones. matches at the start of a word must start
+	// with the query's first trigram at the start of a word.
+	PostingRange ranges[MaxQueryTrigramCount] = {};
+	size_t rangeCount = 0u;
+
+	uint32_t trigram = 0u;
+	for (size_t i = 0u; i < queryLength; ++i)
+	{
+		trigram = ((trigram * CharacterClassCount) + GetCharacterClass(query[i])) % TrigramCount;
+		if (i < 2u)
+		{
+			continue;
+		}
+
+		const PostingRange range = (atWordStart && (i == 2u))
+			? PostingRange { m_wordStartPostings + m_wordStartTrigramOffsets[trigram], m_wordStartPostings + m_wordStartTrigramOffsets[trigram + 1u] }
+			: PostingRange { m_postings + m_trigramOffsets[trigram], m_postings + m_trigramOffsets[trigram + 1u] };
+		if (range.begin == range.end)
+		{
+			// no name contains the trigram
+			return;
+		}
+
+		if (rangeCount < MaxQueryTrigramCount)
+		{
+			ranges[rangeCount++] = range;
+			continue;
+		}
+
+		size_t longest = 0u;
+		for (size_t j = 1u; j < rangeCount; ++j)
+		{
+			if (ranges[j].end - ranges[j].begin > ranges[longest].end - ranges[longest].begin)
+			{
+				longest = j;
+			}
+		}
+
+		if (range.end - range.begin < ranges[longest].end - ranges[longest].begin)
+		{
+			ranges[longest] = range;
+		}
+	}
+
+	if (rangeCount == 0u)
+	{
+		// queries shorter than a trigram are handled by the character mask search, there is nothing to intersect
+		return;
+	}
+
+	// candidates are taken from the shortest posting list, all other lists are advanced alongside
+	size_t shortest = 0u;
+	for (size_t i = 1u; i < rangeCount; ++i)
+	{
+		if (ranges[i].end - ranges[i].begin < ranges[shortest].end - ranges[shortest].begin)
+		{
+			shortest = i;
+		}
+	}
+
+	const PostingRange candidates = ranges[shortest];
+	ranges[shortest] = ranges[--rangeCount];
+
+	for (const uint32_t* candidate = candidates.begin; candidate != candidates.end; ++candidate)
+	{
+		const uint32_t position = *candidate;
+		const uint32_t nameIndex = m_nameIndicesByLength[position];
+		const uint32_t nameLength = GetNameLength(nameIndex);
+		if (CanStop(matches, matchCount, maxMatchCount, rank, nameLength))
+		{
+			// posting lists are ordered by length, and no longer name can be better
+			return;
+		}
+
+		bool isCandidate = true;
+		for (size_t i = 0u; i < rangeCount; ++i)
+		{
+			PostingRange& range = ranges[i];
+			while ((range.begin != range.end) && (*range.begin < position))
+			{
+				++range.begin;
+			}
+
+			if (range.begin == range.end)
+			{
+				// no later candidate can be in all lists
+				return;
+			}
+			else if (*range.begin != position)
+			{
+				isCandidate = false;
+				break;
+			}
+		}
+
+		if (!isCandidate)
+		{
+			continue;
+		}
+
+		// trigrams only consist of character classes, the name still needs to be compared. matches of other ranks are found by other searches.
+		const uint32_t score = ScoreSubstring(GetName(nameIndex), nameLength, query, queryLength);
+		if ((score != NoMatch) && (GetRank(score) == rank))
+		{
+			AddMatch(matches, matchCount, maxMatchCount, nameIndex, score);
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::SymbolNameIndex::SearchCharacterMasks(const char* query, size_t queryLength, uint32_t minimumRank, bool allowSubsequence, Match* matches, size_t& matchCount, size_t maxMatchCount) const PDB_NO_EXCEPT
+{
+	uint64_t queryMask = 0u;
+	for (size_t i = 0u; i < queryLength; ++i)
+	{
+		queryMask |= 1ull << GetCharacterClass(query[i]);
+	}
+
+	// only names containing all characters of the query are compared
+	for (size_t position = 0u; position < m_nameCount; ++position)
+	{
+		if ((m_characterMasks[position] & queryMask) != queryMask)
+		{
+			continue;
+		}
+
+		const uint32_t nameIndex = m_nameIndicesByLength[position];
+		const uint32_t nameLength = GetNameLength(nameIndex);
+		if (nameLength < queryLength)
+		{
+			continue;
+		}
+		else if (CanStop(matches, matchCount, maxMatchCount, minimumRank, nameLength))
+		{
+			// names are ordered by length, and no longer name can be better
+			return;
+		}
+
+		const char* name = GetName(nameIndex);
+		uint32_t score = ScoreSubstring(name, nameLength, query, queryLength);
+		if ((score == NoMatch) && allowSubsequence)
+		{
+			score = ScoreSubsequence(name, nameLength, query, queryLength);
+		}
+
+		if ((score != NoMatch) && (GetRank(score) >= minimumRank))
+		{
+			AddMatch(matches, matchCount, maxMatchCount, nameIndex, score);
+		}
+	}
+}
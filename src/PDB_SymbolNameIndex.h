@@ -0,0 +1,120 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_ParallelFor.h"
+#include "PDB_DBITypes.h"
+
+
+namespace PDB
+{
+	class RawFile;
+	class CoalescedMSFStream;
+	class PublicSymbolStream;
+	class ModuleInfoStream;
+
+
+	// An index of the names of all procedures in the module symbol streams and all public symbols, answering prefix, substring
+	// and subsequence ("fuzzy") queries with ranked results, e.g. for finding symbols while the user is typing.
+	// Names are interned into a single pool sorted case-insensitively, so that prefix queries are a binary search. Substring
+	// queries intersect the posting lists of the query's trigrams, first of those starting a word and then of all trigrams.
+	// Queries too short for trigrams and subsequence queries check a 64-bit mask of the characters contained in each name.
+	// Posting lists and masks are ordered by the length of names, which lets each search stop as soon as no remaining name can
+	// make it into the best matches, so that searching does not need to look at all names matching a common query.
+	// All comparisons ignore the case of ASCII letters. Once built, the index is immutable and can be queried from several threads.
+	class PDB_NO_DISCARD SymbolNameIndex
+	{
+	public:
+		// module index of public symbols, whose records are stored in the symbol record stream
+		static const uint32_t PublicModuleIndex = 0xFFFFFFFFu;
+
+		enum class PDB_NO_DISCARD SearchMode : uint8_t
+		{
+			Prefix,												// names starting with the query
+			Substring,											// names containing the query
+			Subsequence											// names containing all characters of the query in order, e.g. "fzsrch" matches "FuzzySearch"
+		};
+
+		struct Symbol
+		{
+			uint32_t moduleIndex;								// PublicModuleIndex for public symbols
+			uint32_t recordOffset;								// offset of the record in the module symbol stream or the symbol record stream
+			CodeView::DBI::SymbolRecordKind kind;
+		};
+
+		struct Match
+		{
+			uint32_t nameIndex;
+			uint32_t score;										// lower is better: exact matches first, then prefixes, matches at word boundaries and other matches
+		};
+
+		SymbolNameIndex(void) PDB_NO_EXCEPT;
+		SymbolNameIndex(SymbolNameIndex&& other) PDB_NO_EXCEPT;
+		SymbolNameIndex& operator=(SymbolNameIndex&& other) PDB_NO_EXCEPT;
+
+		// Builds the index, gathering the names of different modules in parallel if a parallel loop is given.
+		explicit SymbolNameIndex(const RawFile& file, const ModuleInfoStream& moduleInfoStream, const PublicSymbolStream& publicSymbolStream,
+			const CoalescedMSFStream& symbolRecordStream, ParallelForFunction parallelFor = nullptr, void* userData = nullptr) PDB_NO_EXCEPT;
+		~SymbolNameIndex(void) PDB_NO_EXCEPT;
+
+		// Stores the best matches for the given query in the array, sorted by score, and returns the number of matches stored.
+		// Ties are broken by the case-insensitive order of names. Searching does not allocate any memory.
+		PDB_NO_DISCARD size_t Search(const char* query, SearchMode mode, Match* matches, size_t maxMatchCount) const PDB_NO_EXCEPT;
+
+		// Returns the number of distinct names.
+		PDB_NO_DISCARD inline size_t GetNameCount(void) const PDB_NO_EXCEPT
+		{
+			return m_nameCount;
+		}
+
+		// Returns the name with the given index.
+		PDB_NO_DISCARD inline const char* GetName(uint32_t nameIndex) const PDB_NO_EXCEPT
+		{
+			return &m_names[m_nameOffsets[nameIndex]];
+		}
+
+		// Returns the length of the name with the given index.
+		PDB_NO_DISCARD inline uint32_t GetNameLength(uint32_t nameIndex) const PDB_NO_EXCEPT
+		{
+			return m_nameOffsets[nameIndex + 1u] - m_nameOffsets[nameIndex] - 1u;
+		}
+
+		// Returns a view of all symbols sharing the name with the given index.
+		PDB_NO_DISCARD inline ArrayView<Symbol> GetSymbols(uint32_t nameIndex) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Symbol>(&m_symbols[m_symbolOffsets[nameIndex]], m_symbolOffsets[nameIndex + 1u] - m_symbolOffsets[nameIndex]);
+		}
+
+	private:
+		// Each search adds the matches of one or more ranks to the best matches, stored in a heap.
+		void SearchPrefix(const char* query, size_t queryLength, Match* matches, size_t& matchCount, size_t maxMatchCount) const PDB_NO_EXCEPT;
+		void SearchTrigrams(const char* query, size_t queryLength, bool atWordStart, Match* matches, size_t& matchCount, size_t maxMatchCount) const PDB_NO_EXCEPT;
+		void SearchCharacterMasks(const char* query, size_t queryLength, uint32_t minimumRank, bool allowSubsequence, Match* matches, size_t& matchCount, size_t maxMatchCount) const PDB_NO_EXCEPT;
+
+		// pool of all distinct names, each one null-terminated. m_nameOffsets stores one more offset than there are names.
+		char* m_names;
+		uint32_t* m_nameOffsets;
+		size_t m_nameCount;
+
+		// indices of all names ordered by their length. the masks and posting lists below refer to names by their position in this order.
+		uint32_t* m_nameIndicesByLength;
+
+		// one bit for each class of characters contained in a name
+		uint64_t* m_characterMasks;
+
+		// symbols sorted by name. m_symbolOffsets stores the first symbol of each name, and one more offset than there are names.
+		Symbol* m_symbols;
+		uint32_t* m_symbolOffsets;
+
+		// posting lists for each trigram, either anywhere in a name or at the start of a word only
+		uint32_t* m_trigramOffsets;
+		uint32_t* m_postings;
+		uint32_t* m_wordStartTrigramOffsets;
+		uint32_t* m_wordStartPostings;
+
+		PDB_DISABLE_COPY(SymbolNameIndex);
+	};
+}
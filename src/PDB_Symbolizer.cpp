@@ -0,0 +1,287 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_Symbolizer.h"
+#include "PDB_RawFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_InfoStream.h"
+#include "PDB_ModuleSymbolStream.h"
+#include "PDB_ModuleLineStream.h"
+#include "PDB_ModuleScopeIndex.h"
+#include "PDB_BinaryAnnotations.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+#include "Foundation/PDB_PointerUtil.h"
+
+
+// the file and line an inlined function starts at, as stored in the module's S_INLINEELINES subsection
+struct PDB::Symbolizer::InlineeLine
+{
+	uint32_t inlinee;
+	uint32_t fileChecksumOffset;
+	uint32_t lineNumber;
+};
+
+
+// everything needed for resolving inline frames in a single module
+struct PDB::Symbolizer::ModuleData
+{
+	ModuleData(void) PDB_NO_EXCEPT
+		: symbolStream()
+		, lineStream()
+		, scopeIndex()
+		, fileChecksumSection(nullptr)
+		, inlineeLines(nullptr)
+		, inlineeLineCount(0u)
+	{
+	}
+
+	~ModuleData(void) PDB_NO_EXCEPT
+	{
+		PDB_DELETE_ARRAY(inlineeLines);
+	}
+
+	ModuleSymbolStream symbolStream;
+	ModuleLineStream lineStream;
+	ModuleScopeIndex scopeIndex;
+	const CodeView::DBI::LineSection* fileChecksumSection;
+
+	// sorted by inlinee
+	InlineeLine* inlineeLines;
+	size_t inlineeLineCount;
+
+	PDB_DISABLE_COPY_MOVE(ModuleData);
+};
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::Symbolizer::Symbolizer(const RawFile& file, const DBIStream& dbiStream, const InfoStream& infoStream) PDB_NO_EXCEPT
+	: m_file(&file)
+	, m_imageSectionStream(dbiStream.CreateImageSectionStream(file))
+	, m_moduleInfoStream(dbiStream.CreateModuleInfoStream(file))
+	, m_namesStream(infoStream.HasNamesStream() ? infoStream.CreateNamesStream(file) : NamesStream())
+	, m_hasNamesStream(infoStream.HasNamesStream())
+	, m_ipiStream((HasValidIPIStream(file) == ErrorCode::Success) ? CreateIPIStream(file) : IPIStream())
+	, m_functionIndex(file, m_imageSectionStream, m_moduleInfoStream)
+	, m_lineIndex(m_hasNamesStream ? LineIndex(file, m_imageSectionStream, m_moduleInfoStream, m_namesStream) : LineIndex())
+	, m_modules(nullptr)
+	, m_moduleCount(m_moduleInfoStream.GetModules().GetLength())
+{
+	m_modules = PDB_NEW_ARRAY(std::atomic<ModuleData*>, m_moduleCount);
+	for (size_t i = 0u; i < m_moduleCount; ++i)
+	{
+		m_modules[i].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::Symbolizer::~Symbolizer(void) PDB_NO_EXCEPT
+{
+	for (size_t i = 0u; i < m_moduleCount; ++i)
+	{
+		ModuleData* moduleData = m_modules[i].load(std::memory_order_relaxed);
+		PDB_DELETE(moduleData);
+	}
+
+	PDB_DELETE_ARRAY(m_modules);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint32_t PDB::Symbolizer::Symbolize(uint32_t rva, Frame* frames, uint32_t frameCapacity) const PDB_NO_EXCEPT
+{
+	const FunctionIndex::Function* function = m_functionIndex.FindFunction(rva);
+	if (!function)
+	{
+		return 0u;
+	}
+
+	uint32_t frameCount = 0u;
+	auto addFrame = [frames, frameCapacity, &frameCount](const char* name, const char* fileName, uint32_t lineNumber, bool isInlined)
+	{
+		if (frameCount < frameCapacity)
+		{
+			frames[frameCount] = Frame { name, fileName, lineNumber, isInlined };
+		}
+
+		++frameCount;
+	};
+
+	const ModuleData* moduleData = GetModuleData(function->moduleIndex);
+	const ModuleScopeIndex::Scope* innermostScope = moduleData ? moduleData->scopeIndex.FindInnermostScope(rva) : nullptr;
+
+	// the code ranges of inline sites are relative to the procedure or separated code block they were inlined into
+	uint32_t codeBaseRVA = 0u;
+	for (const ModuleScopeIndex::Scope* scope = innermostScope; scope; scope = moduleData->scopeIndex.GetParentScope(scope))
+	{
+		const CodeView::DBI::Record* record = moduleData->symbolStream.GetRecordAtOffset(scope->recordOffset);
+		if (scope->kind == CodeView::DBI::SymbolRecordKind::S_SEPCODE)
+		{
+			codeBaseRVA = m_imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_SEPCODE.section, record->data.S_SEPCODE.offset);
+			break;
+		}
+		else if (scope->parentIndex == ModuleScopeIndex::InvalidScopeIndex)
+		{
+			codeBaseRVA = m_imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_GPROC32.section, record->data.S_GPROC32.offset);
+			break;
+		}
+	}
+
+	for (const ModuleScopeIndex::Scope* scope = innermostScope; scope && (codeBaseRVA != 0u); scope = moduleData->scopeIndex.GetParentScope(scope))
+	{
+		if ((scope->kind != CodeView::DBI::SymbolRecordKind::S_INLINESITE) && (scope->kind != CodeView::DBI::SymbolRecordKind::S_INLINESITE2))
+		{
+			continue;
+		}
+
+		// S_INLINESITE and S_INLINESITE2 store the inlinee at the same offset
+		const CodeView::DBI::Record* record = moduleData->symbolStream.GetRecordAtOffset(scope->recordOffset);
+		const uint32_t inlinee = record->data.S_INLINESITE.inlinee;
+
+		const InlineeLine* inlineeLines = moduleData->inlineeLines;
+		const size_t inlineeLineIndex = Algorithm::LowerBound(inlineeLines, moduleData->inlineeLineCount, inlinee, [](const InlineeLine& inlineeLine, uint32_t value)
+		{
+			return inlineeLine.inlinee < value;
+		});
+
+		if ((inlineeLineIndex == moduleData->inlineeLineCount) || (inlineeLines[inlineeLineIndex].inlinee != inlinee))
+		{
+			addFrame(GetInlineeName(inlinee), "", 0u, true);
+			continue;
+		}
+
+		// find the line of the inlined code at the RVA
+		const uint32_t codeOffset = rva - codeBaseRVA;
+		const char* fileName = "";
+		uint32_t lineNumber = 0u;
+		BinaryAnnotations::ForEachInlineSiteLineRange(record, inlineeLines[inlineeLineIndex].fileChecksumOffset, inlineeLines[inlineeLineIndex].lineNumber,
+			[this, moduleData, codeOffset, &fileName, &lineNumber](uint32_t codeOffsetBegin, uint32_t codeOffsetEnd, uint32_t fileChecksumOffset, uint32_t rangeLineNumber)
+		{
+			if ((codeOffset >= codeOffsetBegin) && (codeOffset < codeOffsetEnd) && (fileChecksumOffset < moduleData->fileChecksumSection->header.size))
+			{
+				const CodeView::DBI::FileChecksumHeader* fileChecksumHeader = Pointer::Offset<const CodeView::DBI::FileChecksumHeader*>(&moduleData->fileChecksumSection->checksumHeader, fileChecksumOffset);
+				fileName = m_namesStream.GetFilename(fileChecksumHeader->filenameOffset);
+				lineNumber = rangeLineNumber;
+			}
+		});
+
+		addFrame(GetInlineeName(inlinee), fileName, lineNumber, true);
+	}
+
+	// lines stored for inlined code refer to the call site in the function it was inlined into
+	const LineIndex::Line* line = m_lineIndex.FindLine(rva);
+	addFrame(m_functionIndex.GetName(*function), line ? m_lineIndex.GetFileName(*line) : "", line ? line->lineNumber : 0u, false);
+
+	return frameCount;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::Symbolizer::ModuleData* PDB::Symbolizer::GetModuleData(uint32_t moduleIndex) const PDB_NO_EXCEPT
+{
+	if (moduleIndex >= m_moduleCount)
+	{
+		return nullptr;
+	}
+
+	ModuleData* moduleData = m_modules[moduleIndex].load(std::memory_order_acquire);
+	if (moduleData)
+	{
+		return moduleData;
+	}
+
+	moduleData = PDB_NEW(ModuleData);
+
+	const ModuleInfoStream::Module& module = m_moduleInfoStream.GetModule(moduleIndex);
+	if (module.HasSymbolStream())
+	{
+		moduleData->symbolStream = module.CreateSymbolStream(*m_file);
+		moduleData->scopeIndex = ModuleScopeIndex(moduleData->symbolStream, m_imageSectionStream);
+	}
+
+	// without file names, inline frames are reported without lines
+	if (m_hasNamesStream && module.HasLineStream())
+	{
+		moduleData->lineStream = module.CreateLineStream(*m_file);
+
+		GrowableArray<InlineeLine> inlineeLineArray;
+		for (const CodeView::DBI::LineSection* section : moduleData->lineStream.GetSections())
+		{
+			if (section->header.kind == CodeView::DBI::DebugSubsectionKind::S_FILECHECKSUMS)
+			{
+				moduleData->fileChecksumSection = section;
+			}
+			else if (section->header.kind == CodeView::DBI::DebugSubsectionKind::S_INLINEELINES)
+			{
+				if (section->inlineeHeader.kind == CodeView::DBI::InlineeSourceLineKind::Signature)
+				{
+					moduleData->lineStream.ForEachInlineeSourceLine(section, [&inlineeLineArray](const CodeView::DBI::InlineeSourceLine* inlineeSourceLine)
+					{
+						inlineeLineArray.Add(InlineeLine { inlineeSourceLine->inlinee, inlineeSourceLine->fileChecksumOffset, inlineeSourceLine->lineNumber });
+					});
+				}
+				else
+				{
+					moduleData->lineStream.ForEachInlineeSourceLineEx(section, [&inlineeLineArray](const CodeView::DBI::InlineeSourceLineEx* inlineeSourceLineEx)
+					{
+						inlineeLineArray.Add(InlineeLine { inlineeSourceLineEx->inlinee, inlineeSourceLineEx->fileChecksumOffset, inlineeSourceLineEx->lineNumber });
+					});
+				}
+			}
+		}
+
+		// inlinee lines refer to files, so they are only useful if the module stores file checksums
+		if (moduleData->fileChecksumSection)
+		{
+			moduleData->inlineeLineCount = inlineeLineArray.GetSize();
+			moduleData->inlineeLines = inlineeLineArray.Release();
+
+			Algorithm::Sort(moduleData->inlineeLines, moduleData->inlineeLines + moduleData->inlineeLineCount, [](const InlineeLine& lhs, const InlineeLine& rhs)
+			{
+				return lhs.inlinee < rhs.inlinee;
+			});
+		}
+	}
+
+	// another thread might have built the same data in the meantime, in which case its data is used instead
+	ModuleData* expected = nullptr;
+	if (!m_modules[moduleIndex].compare_exchange_strong(expected, moduleData, std::memory_order_acq_rel, std::memory_order_acquire))
+	{
+		PDB_DELETE(moduleData);
+		return expected;
+	}
+
+	return moduleData;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const char* PDB::Symbolizer::GetInlineeName(uint32_t inlinee) const PDB_NO_EXCEPT
+{
+	const ArrayView<const CodeView::IPI::Record*> records = m_ipiStream.GetTypeRecords();
+	const uint32_t firstTypeIndex = m_ipiStream.GetFirstTypeIndex();
+	if ((inlinee < firstTypeIndex) || (inlinee - firstTypeIndex >= records.GetLength()))
+	{
+		return "";
+	}
+
+	const CodeView::IPI::Record* record = records[inlinee - firstTypeIndex];
+	if (record->header.kind == CodeView::IPI::TypeRecordKind::LF_FUNC_ID)
+	{
+		return record->data.LF_FUNC_ID.name;
+	}
+	else if (record->header.kind == CodeView::IPI::TypeRecordKind::LF_MFUNC_ID)
+	{
+		return record->data.LF_MFUNC_ID.name;
+	}
+
+	return "";
+}
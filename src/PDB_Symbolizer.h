@@ -0,0 +1,80 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <atomic>
+#include "Foundation/PDB_DisableWarningsPop.h"
+#include "PDB_ImageSectionStream.h"
+#include "PDB_ModuleInfoStream.h"
+#include "PDB_NamesStream.h"
+#include "PDB_IPIStream.h"
+#include "PDB_FunctionIndex.h"
+#include "PDB_LineIndex.h"
+
+
+namespace PDB
+{
+	class RawFile;
+	class DBIStream;
+	class InfoStream;
+
+
+	// Resolves RVAs into the function, file and line they belong to, including the chain of functions inlined at that RVA.
+	// The function and line indices are built when the symbolizer is created. The data needed for inline frames is built
+	// per module, the first time an RVA inside that module is resolved.
+	// Symbolize() can be called from several threads at the same time. The raw file must outlive the symbolizer.
+	class PDB_NO_DISCARD Symbolizer
+	{
+	public:
+		struct Frame
+		{
+			const char* name;									// name of the function, or of the inlined function
+			const char* fileName;								// empty if unknown
+			uint32_t lineNumber;								// 0 if unknown
+			bool isInlined;
+		};
+
+		explicit Symbolizer(const RawFile& file, const DBIStream& dbiStream, const InfoStream& infoStream) PDB_NO_EXCEPT;
+		~Symbolizer(void) PDB_NO_EXCEPT;
+
+		// Resolves the given RVA into frames, starting with the innermost inlined function and ending with the function
+		// containing the RVA. At most frameCapacity frames are stored. Returns the number of frames at the RVA, which can be
+		// larger than frameCapacity, or 0 if the RVA doesn't belong to any function.
+		PDB_NO_DISCARD uint32_t Symbolize(uint32_t rva, Frame* frames, uint32_t frameCapacity) const PDB_NO_EXCEPT;
+
+		PDB_NO_DISCARD inline const FunctionIndex& GetFunctionIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_functionIndex;
+		}
+
+		PDB_NO_DISCARD inline const LineIndex& GetLineIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_lineIndex;
+		}
+
+	private:
+		struct InlineeLine;
+		struct ModuleData;
+
+		PDB_NO_DISCARD const ModuleData* GetModuleData(uint32_t moduleIndex) const PDB_NO_EXCEPT;
+		PDB_NO_DISCARD const char* GetInlineeName(uint32_t inlinee) const PDB_NO_EXCEPT;
+
+		const RawFile* m_file;
+		ImageSectionStream m_imageSectionStream;
+		ModuleInfoStream m_moduleInfoStream;
+		NamesStream m_namesStream;
+		bool m_hasNamesStream;
+		IPIStream m_ipiStream;
+		FunctionIndex m_functionIndex;
+		LineIndex m_lineIndex;
+
+		// per-module data is published once it has been built, threads racing to build it discard all but one copy
+		std::atomic<ModuleData*>* m_modules;
+		size_t m_moduleCount;
+
+		PDB_DISABLE_COPY_MOVE(Symbolizer);
+	};
+}
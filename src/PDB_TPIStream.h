@@ -2,6 +2,7 @@
 
 #include "Foundation/PDB_Macros.h"
 #include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_IteratorRange.h"
 #include "PDB_ErrorCodes.h"
 #include "PDB_TPITypes.h"
 #include "PDB_DirectMSFStream.h"
@@ -17,6 +18,95 @@ namespace PDB
 	class PDB_NO_DISCARD TPIStream
 	{
 	public:
+		// A type record's header along with its offset in the stream, as yielded by a TypeRecordIterator.
+		struct TypeRecordHeaderAndOffset
+		{
+			CodeView::TPI::RecordHeader header;
+			size_t offset;
+		};
+
+		// A forward iterator that walks the type records in the stream, reading only their headers.
+		class TypeRecordIterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = TypeRecordHeaderAndOffset;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const TypeRecordHeaderAndOffset*;
+			using reference = const TypeRecordHeaderAndOffset&;
+
+			inline TypeRecordIterator(void) PDB_NO_EXCEPT
+				: m_stream(nullptr)
+				, m_current()
+			{
+			}
+
+			inline explicit TypeRecordIterator(const DirectMSFStream* stream, size_t offset) PDB_NO_EXCEPT
+				: m_stream(stream)
+				, m_current()
+			{
+				Read(offset);
+			}
+
+			PDB_DEFAULT_COPY_MOVE(TypeRecordIterator);
+
+			PDB_NO_DISCARD inline const TypeRecordHeaderAndOffset& operator*(void) const PDB_NO_EXCEPT
+			{
+				return m_current;
+			}
+
+			PDB_NO_DISCARD inline const TypeRecordHeaderAndOffset* operator->(void) const PDB_NO_EXCEPT
+			{
+				return &m_current;
+			}
+
+			inline TypeRecordIterator& operator++(void) PDB_NO_EXCEPT
+			{
+				// position the stream offset at the next record
+				Read(m_current.offset + sizeof(CodeView::TPI::RecordHeader) + m_current.header.size - sizeof(uint16_t));
+
+				return *this;
+			}
+
+			inline TypeRecordIterator operator++(int) PDB_NO_EXCEPT
+			{
+				TypeRecordIterator previous(*this);
+				++(*this);
+				return previous;
+			}
+
+			PDB_NO_DISCARD inline bool operator==(const TypeRecordIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_current.offset == other.m_current.offset);
+			}
+
+			PDB_NO_DISCARD inline bool operator!=(const TypeRecordIterator& other) const PDB_NO_EXCEPT
+			{
+				return (m_current.offset != other.m_current.offset);
+			}
+
+		private:
+			inline void Read(size_t offset) PDB_NO_EXCEPT
+			{
+				// only read headers that are inside the stream, the end iterator doesn't refer to a record
+				if (offset < m_stream->GetSize())
+				{
+					m_current.header = m_stream->ReadAtOffset<CodeView::TPI::RecordHeader>(offset);
+					m_current.offset = offset;
+				}
+				else
+				{
+					m_current.header = CodeView::TPI::RecordHeader {};
+					m_current.offset = m_stream->GetSize();
+				}
+			}
+
+			const DirectMSFStream* m_stream;
+			TypeRecordHeaderAndOffset m_current;
+		};
+
+		using TypeRecordRange = IteratorRange<TypeRecordIterator>;
+
 		TPIStream(void) PDB_NO_EXCEPT;
 		TPIStream(TPIStream&& other) PDB_NO_EXCEPT;
 		TPIStream& operator=(TPIStream&& other) PDB_NO_EXCEPT;
@@ -52,20 +142,20 @@ namespace PDB
 			return header;
 		}
 
-		template <typename F>
-		void ForEachTypeRecordHeaderAndOffset(F&& functor) const PDB_NO_EXCEPT
+		// Returns a range of the headers and offsets of all type records in the stream.
+		// Unlike ForEachTypeRecordHeaderAndOffset, walking the range can be stopped at any time.
+		PDB_NO_DISCARD inline TypeRecordRange GetTypeRecordHeadersAndOffsets(void) const PDB_NO_EXCEPT
 		{
 			// ignore the stream's header
-			size_t offset = sizeof(TPI::StreamHeader);
+			return TypeRecordRange(TypeRecordIterator(&m_stream, sizeof(TPI::StreamHeader)), TypeRecordIterator(&m_stream, m_stream.GetSize()));
+		}
 
-			while (offset < m_stream.GetSize())
+		template <typename F>
+		void ForEachTypeRecordHeaderAndOffset(F&& functor) const PDB_NO_EXCEPT
+		{
+			for (const TypeRecordHeaderAndOffset& record : GetTypeRecordHeadersAndOffsets())
 			{
-				const CodeView::TPI::RecordHeader header = ReadTypeRecordHeader(offset);
-
-				functor(header, offset);
-
-				// position the stream offset at the next record
-				offset += sizeof(CodeView::TPI::RecordHeader) + header.size - sizeof(uint16_t);
+				functor(record.header, record.offset);
 			}
 		}
 
@@ -103,6 +103,8 @@ namespace PDB
 				LF_MEMBERMODIFY = 0x001513u,
 				LF_MANAGED = 0x001514u,
 				LF_TYPESERVER2 = 0x001515u,
+				LF_INTERFACE = 0x001519u,
+				LF_VFTABLE = 0x00151Du,
 				LF_CLASS2 = 0x001608u,
 				LF_STRUCTURE2 = 0x001609u,
 
@@ -0,0 +1,748 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_TypeLayout.h"
+#include "PDB_TypeTable.h"
+#include "PDB_Types.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	// records are scanned for definitions in chunks
+	static constexpr const uint32_t RecordsPerJob = 4096u;
+
+	// continuations of field lists only ever refer to records with lower indices, this guards against malformed streams
+	static constexpr const unsigned int MaxFieldListCount = 4096u;
+
+	static constexpr const unsigned int MaxTypeKeyRecursionDepth = 32u;
+
+	// members of field lists are padded to 4 bytes using LF_PAD0 to LF_PAD15, which are single bytes
+	static constexpr const uint8_t FirstPadLeaf = 0xF0u;
+
+
+	struct JobLayouts
+	{
+		PDB::GrowableArray<PDB::TypeLayoutMap::Layout> layouts;
+		PDB::GrowableArray<PDB::LayoutMember> members;
+		PDB::GrowableArray<uint64_t> typeKeys;
+	};
+
+	struct BuildContext
+	{
+		const PDB::TypeTable* typeTable;
+		JobLayouts* jobLayouts;
+	};
+
+
+	PDB_NO_DISCARD static inline uint16_t ReadUInt16(const PDB::Byte* data, uint32_t offset) PDB_NO_EXCEPT
+	{
+		uint16_t value = 0u;
+		std::memcpy(&value, data + offset, sizeof(value));
+
+		return value;
+	}
+
+
+	PDB_NO_DISCARD static inline uint32_t ReadUInt32(const PDB::Byte* data, uint32_t offset) PDB_NO_EXCEPT
+	{
+		uint32_t value = 0u;
+		std::memcpy(&value, data + offset, sizeof(value));
+
+		return value;
+	}
+
+
+	// Reads the numeric leaf at the given offset, returning the offset behind it, or 0 if the leaf is not an integer.
+	PDB_NO_DISCARD static uint32_t ReadNumericLeaf(const PDB::Byte* data, uint32_t offset, uint32_t recordSize, uint64_t& value) PDB_NO_EXCEPT
+	{
+		if (offset + sizeof(uint16_t) > recordSize)
+		{
+			return 0u;
+		}
+
+		const size_t leafSize = PDB::TypeTable::ReadNumericLeaf(data + offset, value);
+		return (leafSize != 0u) ? static_cast<uint32_t>(offset + leafSize) : 0u;
+	}
+
+
+	// Returns the offset after the null-terminated name at the given offset, or 0 if the name is not terminated.
+	PDB_NO_DISCARD static uint32_t SkipName(const PDB::Byte* data, uint32_t offset, uint32_t recordSize) PDB_NO_EXCEPT
+	{
+		if (offset >= recordSize)
+		{
+			return 0u;
+		}
+
+		const size_t length = strnlen(reinterpret_cast<const char*>(data + offset), recordSize - offset);
+		return (offset + length < recordSize) ? static_cast<uint32_t>(offset + length + 1u) : 0u;
+	}
+
+
+	// 64-bit FNV-1a
+	PDB_NO_DISCARD static uint64_t HashName(const char* name) PDB_NO_EXCEPT
+	{
+		uint64_t hash = 14695981039346656037ull;
+		while (*name != '\0')
+		{
+			hash ^= static_cast<uint8_t>(*name++);
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+
+	// the finalizer of MurmurHash3, used for combining keys
+	PDB_NO_DISCARD static inline uint64_t Combine(uint64_t key, uint64_t value) PDB_NO_EXCEPT
+	{
+		key ^= value + 0x9E3779B97F4A7C15ull;
+		key ^= key >> 33u;
+		key *= 0xFF51AFD7ED558CCDull;
+		key ^= key >> 33u;
+		key *= 0xC4CEB9FE1A85EC53ull;
+		key ^= key >> 33u;
+
+		return key;
+	}
+
+
+	// Returns a key for the given type that only depends on the properties relevant for the layout of its instances.
+	PDB_NO_DISCARD static uint64_t GetTypeKey(const PDB::TypeTable& typeTable, uint32_t typeIndex, unsigned int depth) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::TPI;
+
+		if (typeIndex < typeTable.GetFirstTypeIndex())
+		{
+			return typeIndex;
+		}
+
+		const Record* record = typeTable.GetTypeRecord(typeIndex);
+		if (!record || (depth >= MaxTypeKeyRecursionDepth))
+		{
+			return 0u;
+		}
+
+		const uint64_t kind = static_cast<uint64_t>(record->header.kind);
+		switch (record->header.kind)
+		{
+			case TypeRecordKind::LF_MODIFIER:
+				// const and volatile don't change the layout
+				return GetTypeKey(typeTable, record->data.LF_MODIFIER.type, depth + 1u);
+
+			case TypeRecordKind::LF_BITFIELD:
+				return GetTypeKey(typeTable, record->data.LF_BITFIELD.type, depth + 1u);
+
+			case TypeRecordKind::LF_POINTER:
+				return Combine(kind, record->data.LF_POINTER.attr.size);
+
+			case TypeRecordKind::LF_ARRAY:
+			{
+				uint64_t size = 0u;
+				(void)PDB::TypeTable::ReadNumericLeaf(record->data.LF_ARRAY.data, size);
+				return Combine(Combine(kind, size), GetTypeKey(typeTable, record->data.LF_ARRAY.elemtype, depth + 1u));
+			}
+
+			case TypeRecordKind::LF_CLASS:
+			case TypeRecordKind::LF_STRUCTURE:
+			case TypeRecordKind::LF_INTERFACE:
+			case TypeRecordKind::LF_CLASS2:
+			case TypeRecordKind::LF_STRUCTURE2:
+			{
+				// classes and structures only differ in the default access of their members
+				const char* name = PDB::TypeTable::GetUserDefinedTypeName(record);
+				return Combine(static_cast<uint64_t>(TypeRecordKind::LF_STRUCTURE), name ? HashName(name) : 0u);
+			}
+
+			case TypeRecordKind::LF_UNION:
+			case TypeRecordKind::LF_ENUM:
+			{
+				const char* name = PDB::TypeTable::GetUserDefinedTypeName(record);
+				return Combine(kind, name ? HashName(name) : 0u);
+			}
+
+			default:
+				return kind;
+		}
+	}
+
+
+	// Returns whether the name of a type is generated by the compiler and differs between builds.
+	PDB_NO_DISCARD static bool IsGeneratedName(const char* name) PDB_NO_EXCEPT
+	{
+		return (std::strstr(name, "<unnamed-") != nullptr) || (std::strstr(name, "<lambda_") != nullptr) || (std::strstr(name, "__unnamed") != nullptr);
+	}
+
+
+	PDB_NO_DISCARD static inline bool IsSameName(const char* lhs, const char* rhs) PDB_NO_EXCEPT
+	{
+		return (lhs == rhs) || (lhs && rhs && (std::strcmp(lhs, rhs) == 0));
+	}
+
+
+	// Builds the layouts of the definitions in a chunk of records.
+	static void BuildLayoutsJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const BuildContext* context = static_cast<const BuildContext*>(jobData);
+		const PDB::TypeTable& typeTable = *context->typeTable;
+		JobLayouts& jobLayouts = context->jobLayouts[index];
+
+		const PDB::ArrayView<const PDB::CodeView::TPI::Record*> records = typeTable.GetTypeRecords();
+		const size_t begin = static_cast<size_t>(index) * RecordsPerJob;
+		const size_t end = (begin + RecordsPerJob < records.GetLength()) ? begin + RecordsPerJob : records.GetLength();
+
+		for (size_t i = begin; i < end; ++i)
+		{
+			PDB::UserDefinedType type = {};
+			if (!records[i] || !PDB::GetUserDefinedType(records[i], type) || type.property.fwdref || !type.name || IsGeneratedName(type.name))
+			{
+				continue;
+			}
+
+			PDB::TypeLayoutMap::Layout layout = {};
+			layout.name = type.name;
+			layout.size = type.size;
+			layout.typeIndex = typeTable.GetFirstTypeIndex() + static_cast<uint32_t>(i);
+			layout.firstMember = static_cast<uint32_t>(jobLayouts.members.GetSize());
+			layout.kind = type.kind;
+
+			PDB::GetLayoutMembers(typeTable, type, jobLayouts.members);
+			layout.memberCount = static_cast<uint32_t>(jobLayouts.members.GetSize()) - layout.firstMember;
+			jobLayouts.layouts.Add(layout);
+
+			const PDB::LayoutMember* members = jobLayouts.members.GetData() + layout.firstMember;
+			for (uint32_t j = 0u; j < layout.memberCount; ++j)
+			{
+				jobLayouts.typeKeys.Add(GetTypeKey(typeTable, members[j].typeIndex, 0u));
+			}
+		}
+	}
+
+
+	// Returns the member of the new layout matching the given member of the old layout, starting the search at the given hint
+	// because members are rarely reordered. Returns the member count if there is no matching member.
+	PDB_NO_DISCARD static size_t FindMatchingMember(const PDB::LayoutMember& member, PDB::ArrayView<PDB::LayoutMember> members, const bool* isMatched, size_t hint) PDB_NO_EXCEPT
+	{
+		const size_t count = members.GetLength();
+		for (size_t i = 0u; i < count; ++i)
+		{
+			const size_t index = (hint + i < count) ? hint + i : hint + i - count;
+			if (!isMatched[index] && (members[index].kind == member.kind) && IsSameName(members[index].name, member.name))
+			{
+				return index;
+			}
+		}
+
+		return count;
+	}
+
+
+	static void AddDifference(PDB::GrowableArray<PDB::TypeLayoutDifference>& differences, PDB::TypeLayoutDifference::Kind kind,
+		const PDB::TypeLayoutMap::Layout* oldLayout, const PDB::TypeLayoutMap::Layout* newLayout, const PDB::LayoutMember* oldMember, const PDB::LayoutMember* newMember) PDB_NO_EXCEPT
+	{
+		differences.Add(PDB::TypeLayoutDifference { kind, oldLayout, newLayout, oldMember, newMember });
+	}
+
+
+	// Compares the members of two layouts of the same type.
+	static void DiffMembers(const PDB::TypeLayoutMap& oldMap, const PDB::TypeLayoutMap::Layout& oldLayout, const PDB::TypeLayoutMap& newMap, const PDB::TypeLayoutMap::Layout& newLayout,
+		PDB::GrowableArray<bool>& isMatched, PDB::GrowableArray<PDB::TypeLayoutDifference>& differences) PDB_NO_EXCEPT
+	{
+		using Kind = PDB::TypeLayoutDifference::Kind;
+
+		const PDB::ArrayView<PDB::LayoutMember> oldMembers = oldMap.GetMembers(oldLayout);
+		const PDB::ArrayView<PDB::LayoutMember> newMembers = newMap.GetMembers(newLayout);
+
+		isMatched.Clear();
+		isMatched.Reserve(newMembers.GetLength());
+		for (size_t i = 0u; i < newMembers.GetLength(); ++i)
+		{
+			isMatched.Add(false);
+		}
+
+		size_t hint = 0u;
+		for (size_t i = 0u; i < oldMembers.GetLength(); ++i)
+		{
+			const PDB::LayoutMember& oldMember = oldMembers[i];
+			const size_t j = FindMatchingMember(oldMember, newMembers, isMatched.GetData(), hint);
+			if (j == newMembers.GetLength())
+			{
+				AddDifference(differences, Kind::MemberRemoved, &oldLayout, &newLayout, &oldMember, nullptr);
+				continue;
+			}
+
+			isMatched.GetData()[j] = true;
+			hint = j + 1u;
+
+			const PDB::LayoutMember& newMember = newMembers[j];
+			if (oldMember.offset != newMember.offset)
+			{
+				AddDifference(differences, Kind::MemberOffsetChanged, &oldLayout, &newLayout, &oldMember, &newMember);
+			}
+
+			if (oldMember.size != newMember.size)
+			{
+				AddDifference(differences, Kind::MemberSizeChanged, &oldLayout, &newLayout, &oldMember, &newMember);
+			}
+
+			if (oldMap.GetTypeKey(oldLayout, i) != newMap.GetTypeKey(newLayout, j))
+			{
+				AddDifference(differences, Kind::MemberTypeChanged, &oldLayout, &newLayout, &oldMember, &newMember);
+			}
+
+			if ((oldMember.bitPosition != newMember.bitPosition) || (oldMember.bitLength != newMember.bitLength))
+			{
+				AddDifference(differences, Kind::MemberBitfieldChanged, &oldLayout, &newLayout, &oldMember, &newMember);
+			}
+		}
+
+		for (size_t j = 0u; j < newMembers.GetLength(); ++j)
+		{
+			if (!isMatched.GetData()[j])
+			{
+				AddDifference(differences, Kind::MemberAdded, &oldLayout, &newLayout, nullptr, &newMembers[j]);
+			}
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD bool PDB::GetUserDefinedType(const CodeView::TPI::Record* record, UserDefinedType& type) PDB_NO_EXCEPT
+{
+	using namespace CodeView::TPI;
+
+	const char* data = nullptr;
+	switch (record->header.kind)
+	{
+		case TypeRecordKind::LF_CLASS:
+		case TypeRecordKind::LF_STRUCTURE:
+		case TypeRecordKind::LF_INTERFACE:
+			type.fieldList = record->data.LF_CLASS.field;
+			type.property = record->data.LF_CLASS.property;
+			data = record->data.LF_CLASS.data;
+			break;
+
+		case TypeRecordKind::LF_CLASS2:
+		case TypeRecordKind::LF_STRUCTURE2:
+		{
+			// the lower 16 bits of the 32-bit property share the layout of the 16-bit property
+			const uint16_t lowerBits = static_cast<uint16_t>(record->data.LF_CLASS2.property);
+			std::memcpy(&type.property, &lowerBits, sizeof(type.property));
+			type.fieldList = record->data.LF_CLASS2.field;
+			data = record->data.LF_CLASS2.data;
+			break;
+		}
+
+		case TypeRecordKind::LF_UNION:
+			type.fieldList = record->data.LF_UNION.field;
+			type.property = record->data.LF_UNION.property;
+			data = record->data.LF_UNION.data;
+			break;
+
+		default:
+			return false;
+	}
+
+	type.size = 0u;
+	type.kind = record->header.kind;
+	type.name = (TypeTable::ReadNumericLeaf(data, type.size) != 0u) ? TypeTable::GetUserDefinedTypeName(record) : nullptr;
+
+	return true;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::GetLayoutMembers(const TypeTable& typeTable, const UserDefinedType& type, GrowableArray<LayoutMember>& members) PDB_NO_EXCEPT
+{
+	using namespace CodeView::TPI;
+
+	uint32_t fieldList = type.fieldList;
+	for (unsigned int fieldListCount = 0u; (fieldList != 0u) && (fieldListCount < MaxFieldListCount); ++fieldListCount)
+	{
+		const Record* record = typeTable.GetTypeRecord(fieldList);
+		if (!record || (record->header.kind != TypeRecordKind::LF_FIELDLIST))
+		{
+			return;
+		}
+
+		// members are read at offsets relative to the start of the record, the first one starts behind the header
+		const Byte* data = reinterpret_cast<const Byte*>(record);
+		const uint32_t recordSize = static_cast<uint32_t>(record->header.size) + sizeof(uint16_t);
+
+		fieldList = 0u;
+		uint32_t offset = 4u;
+		while (offset + sizeof(uint16_t) <= recordSize)
+		{
+			LayoutMember member = {};
+			bool isLayoutMember = false;
+
+			const TypeRecordKind kind = static_cast<TypeRecordKind>(ReadUInt16(data, offset));
+			switch (kind)
+			{
+				case TypeRecordKind::LF_BCLASS:
+				{
+					// attributes, base class, offset
+					if (offset + 8u > recordSize)
+					{
+						return;
+					}
+
+					member.kind = LayoutMember::Kind::BaseClass;
+					member.typeIndex = ReadUInt32(data, offset + 4u);
+					offset = ReadNumericLeaf(data, offset + 8u, recordSize, member.offset);
+					isLayoutMember = true;
+					break;
+				}
+
+				case TypeRecordKind::LF_VBCLASS:
+				case TypeRecordKind::LF_IVBCLASS:
+				{
+					// attributes, base class, virtual base pointer, offset of the virtual base pointer, index in the virtual base table
+					if (offset + 12u > recordSize)
+					{
+						return;
+					}
+
+					uint64_t virtualBaseIndex = 0u;
+					member.kind = LayoutMember::Kind::VirtualBaseClass;
+					member.typeIndex = ReadUInt32(data, offset + 4u);
+					const uint32_t virtualBasePointer = ReadUInt32(data, offset + 8u);
+					offset = ReadNumericLeaf(data, offset + 12u, recordSize, member.offset);
+					offset = (offset != 0u) ? ReadNumericLeaf(data, offset, recordSize, virtualBaseIndex) : 0u;
+
+					// only direct virtual bases are part of the layout, indirect ones share the virtual base pointer
+					isLayoutMember = (kind == TypeRecordKind::LF_VBCLASS);
+					member.size = typeTable.GetTypeSize(virtualBasePointer);
+					break;
+				}
+
+				case TypeRecordKind::LF_VFUNCTAB:
+					// padding, type of the pointer, which is always stored at the start of the class
+					if (offset + 8u > recordSize)
+					{
+						return;
+					}
+
+					member.kind = LayoutMember::Kind::VirtualFunctionTablePointer;
+					member.typeIndex = ReadUInt32(data, offset + 4u);
+					member.size = typeTable.GetTypeSize(member.typeIndex);
+					offset += 8u;
+					isLayoutMember = true;
+					break;
+
+				case TypeRecordKind::LF_INDEX:
+					// the field list continues in another record
+					if (offset + 8u > recordSize)
+					{
+						return;
+					}
+
+					fieldList = ReadUInt32(data, offset + 4u);
+					offset += 8u;
+					break;
+
+				case TypeRecordKind::LF_VFUNCOFF:
+					offset += 12u;
+					break;
+
+				case TypeRecordKind::LF_FRIENDCLS:
+					offset += 8u;
+					break;
+
+				case TypeRecordKind::LF_ENUMERATE:
+				{
+					uint64_t value = 0u;
+					offset = ReadNumericLeaf(data, offset + 4u, recordSize, value);
+					offset = (offset != 0u) ? SkipName(data, offset, recordSize) : 0u;
+					break;
+				}
+
+				case TypeRecordKind::LF_MEMBER:
+				{
+					// attributes, type, offset, name
+					if (offset + 8u > recordSize)
+					{
+						return;
+					}
+
+					member.kind = LayoutMember::Kind::DataMember;
+					member.typeIndex = ReadUInt32(data, offset + 4u);
+					offset = ReadNumericLeaf(data, offset + 8u, recordSize, member.offset);
+					if (offset != 0u)
+					{
+						member.name = reinterpret_cast<const char*>(data + offset);
+						offset = SkipName(data, offset, recordSize);
+					}
+
+					const Record* memberType = typeTable.GetTypeRecord(member.typeIndex);
+					if (memberType && (memberType->header.kind == TypeRecordKind::LF_BITFIELD))
+					{
+						member.typeIndex = memberType->data.LF_BITFIELD.type;
+						member.bitPosition = memberType->data.LF_BITFIELD.position;
+						member.bitLength = memberType->data.LF_BITFIELD.length;
+					}
+
+					isLayoutMember = true;
+					break;
+				}
+
+				case TypeRecordKind::LF_STMEMBER:
+				case TypeRecordKind::LF_NESTTYPE:
+				case TypeRecordKind::LF_NESTTYPEEX:
+				case TypeRecordKind::LF_METHOD:
+				case TypeRecordKind::LF_FRIENDFCN:
+					// attributes, padding or count, type, name
+					offset = SkipName(data, offset + 8u, recordSize);
+					break;
+
+				case TypeRecordKind::LF_ONEMETHOD:
+				{
+					// attributes, type, offset in the virtual function table for introducing methods only, name
+					const uint32_t methodProperty = (ReadUInt16(data, offset + 2u) >> 2u) & 0x7u;
+					const bool isIntroducing = (methodProperty == PDB_AS_UNDERLYING(MethodProperty::Intro)) || (methodProperty == PDB_AS_UNDERLYING(MethodProperty::PureIntro));
+					offset = SkipName(data, offset + (isIntroducing ? 12u : 8u), recordSize);
+					break;
+				}
+
+				default:
+					// the size of unknown members cannot be determined
+					return;
+			}
+
+			if (offset == 0u)
+			{
+				return;
+			}
+
+			if (isLayoutMember)
+			{
+				if (member.kind == LayoutMember::Kind::BaseClass)
+				{
+					const Record* baseClass = typeTable.GetTypeRecord(member.typeIndex);
+					member.name = baseClass ? TypeTable::GetUserDefinedTypeName(baseClass) : nullptr;
+					member.size = typeTable.GetTypeSize(member.typeIndex);
+				}
+				else if (member.kind == LayoutMember::Kind::VirtualBaseClass)
+				{
+					const Record* baseClass = typeTable.GetTypeRecord(member.typeIndex);
+					member.name = baseClass ? TypeTable::GetUserDefinedTypeName(baseClass) : nullptr;
+				}
+				else if (member.kind == LayoutMember::Kind::DataMember)
+				{
+					member.size = typeTable.GetTypeSize(member.typeIndex);
+				}
+
+				members.Add(member);
+			}
+
+			while ((offset < recordSize) && (static_cast<uint8_t>(data[offset]) >= FirstPadLeaf))
+			{
+				++offset;
+			}
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutMap::TypeLayoutMap(void) PDB_NO_EXCEPT
+	: m_layouts(nullptr)
+	, m_layoutCount(0u)
+	, m_members(nullptr)
+	, m_typeKeys(nullptr)
+	, m_memberCount(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutMap::TypeLayoutMap(TypeLayoutMap&& other) PDB_NO_EXCEPT
+	: m_layouts(PDB_MOVE(other.m_layouts))
+	, m_layoutCount(PDB_MOVE(other.m_layoutCount))
+	, m_members(PDB_MOVE(other.m_members))
+	, m_typeKeys(PDB_MOVE(other.m_typeKeys))
+	, m_memberCount(PDB_MOVE(other.m_memberCount))
+{
+	other.m_layouts = nullptr;
+	other.m_layoutCount = 0u;
+	other.m_members = nullptr;
+	other.m_typeKeys = nullptr;
+	other.m_memberCount = 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutMap& PDB::TypeLayoutMap::operator=(TypeLayoutMap&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_layouts);
+		PDB_DELETE_ARRAY(m_members);
+		PDB_DELETE_ARRAY(m_typeKeys);
+
+		m_layouts = PDB_MOVE(other.m_layouts);
+		m_layoutCount = PDB_MOVE(other.m_layoutCount);
+		m_members = PDB_MOVE(other.m_members);
+		m_typeKeys = PDB_MOVE(other.m_typeKeys);
+		m_memberCount = PDB_MOVE(other.m_memberCount);
+
+		other.m_layouts = nullptr;
+		other.m_layoutCount = 0u;
+		other.m_members = nullptr;
+		other.m_typeKeys = nullptr;
+		other.m_memberCount = 0u;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutMap::TypeLayoutMap(const TypeTable& typeTable, ParallelForFunction parallelFor, void* userData) PDB_NO_EXCEPT
+	: m_layouts(nullptr)
+	, m_layoutCount(0u)
+	, m_members(nullptr)
+	, m_typeKeys(nullptr)
+	, m_memberCount(0u)
+{
+	const size_t recordCount = typeTable.GetTypeRecords().GetLength();
+	const uint32_t jobCount = static_cast<uint32_t>((recordCount + RecordsPerJob - 1u) / RecordsPerJob);
+
+	JobLayouts* jobLayouts = PDB_NEW_ARRAY(JobLayouts, jobCount);
+	{
+		BuildContext context = { &typeTable, jobLayouts };
+		PDB::ParallelFor(parallelFor, userData, jobCount, &BuildLayoutsJob, &context);
+	}
+
+	for (uint32_t i = 0u; i < jobCount; ++i)
+	{
+		m_layoutCount += jobLayouts[i].layouts.GetSize();
+		m_memberCount += jobLayouts[i].members.GetSize();
+	}
+
+	// concatenate the results of all jobs in the order of their records
+	m_layouts = PDB_NEW_ARRAY(Layout, m_layoutCount);
+	m_members = PDB_NEW_ARRAY(LayoutMember, m_memberCount);
+	m_typeKeys = PDB_NEW_ARRAY(uint64_t, m_memberCount);
+	{
+		size_t layoutOffset = 0u;
+		size_t memberOffset = 0u;
+		for (uint32_t i = 0u; i < jobCount; ++i)
+		{
+			const size_t layoutCount = jobLayouts[i].layouts.GetSize();
+			const size_t memberCount = jobLayouts[i].members.GetSize();
+
+			for (size_t j = 0u; j < layoutCount; ++j)
+			{
+				m_layouts[layoutOffset + j] = jobLayouts[i].layouts.GetData()[j];
+				m_layouts[layoutOffset + j].firstMember += static_cast<uint32_t>(memberOffset);
+			}
+
+			if (memberCount != 0u)
+			{
+				std::memcpy(m_members + memberOffset, jobLayouts[i].members.GetData(), memberCount * sizeof(LayoutMember));
+				std::memcpy(m_typeKeys + memberOffset, jobLayouts[i].typeKeys.GetData(), memberCount * sizeof(uint64_t));
+			}
+
+			layoutOffset += layoutCount;
+			memberOffset += memberCount;
+		}
+	}
+
+	PDB_DELETE_ARRAY(jobLayouts);
+
+	// the type index decides between definitions with the same name, so that the first definition is kept
+	Algorithm::Sort(m_layouts, m_layouts + m_layoutCount, [](const Layout& lhs, const Layout& rhs)
+	{
+		const int result = std::strcmp(lhs.name, rhs.name);
+		return (result < 0) || ((result == 0) && (lhs.typeIndex < rhs.typeIndex));
+	});
+
+	size_t uniqueCount = 0u;
+	for (size_t i = 0u; i < m_layoutCount; ++i)
+	{
+		if ((uniqueCount == 0u) || (std::strcmp(m_layouts[uniqueCount - 1u].name, m_layouts[i].name) != 0))
+		{
+			m_layouts[uniqueCount++] = m_layouts[i];
+		}
+	}
+
+	m_layoutCount = uniqueCount;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutMap::~TypeLayoutMap(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_layouts);
+	PDB_DELETE_ARRAY(m_members);
+	PDB_DELETE_ARRAY(m_typeKeys);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::TypeLayoutMap::Layout* PDB::TypeLayoutMap::FindLayout(const char* name) const PDB_NO_EXCEPT
+{
+	const size_t index = Algorithm::LowerBound(m_layouts, m_layoutCount, name, [](const Layout& layout, const char* value)
+	{
+		return std::strcmp(layout.name, value) < 0;
+	});
+
+	if ((index == m_layoutCount) || (std::strcmp(m_layouts[index].name, name) != 0))
+	{
+		return nullptr;
+	}
+
+	return &m_layouts[index];
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::DiffTypeLayouts(const TypeLayoutMap& oldMap, const TypeLayoutMap& newMap, GrowableArray<TypeLayoutDifference>& differences) PDB_NO_EXCEPT
+{
+	using Kind = TypeLayoutDifference::Kind;
+
+	const ArrayView<TypeLayoutMap::Layout> oldLayouts = oldMap.GetLayouts();
+	const ArrayView<TypeLayoutMap::Layout> newLayouts = newMap.GetLayouts();
+
+	GrowableArray<bool> isMatched;
+
+	// both maps are sorted by name, so matching layouts is a single merge
+	size_t i = 0u;
+	size_t j = 0u;
+	while ((i < oldLayouts.GetLength()) || (j < newLayouts.GetLength()))
+	{
+		const int result = (i == oldLayouts.GetLength()) ? 1 : (j == newLayouts.GetLength()) ? -1 : std::strcmp(oldLayouts[i].name, newLayouts[j].name);
+		if (result < 0)
+		{
+			AddDifference(differences, Kind::TypeRemoved, &oldLayouts[i++], nullptr, nullptr, nullptr);
+		}
+		else if (result > 0)
+		{
+			AddDifference(differences, Kind::TypeAdded, nullptr, &newLayouts[j++], nullptr, nullptr);
+		}
+		else
+		{
+			const TypeLayoutMap::Layout& oldLayout = oldLayouts[i++];
+			const TypeLayoutMap::Layout& newLayout = newLayouts[j++];
+			if (oldLayout.size != newLayout.size)
+			{
+				AddDifference(differences, Kind::TypeSizeChanged, &oldLayout, &newLayout, nullptr, nullptr);
+			}
+
+			DiffMembers(oldMap, oldLayout, newMap, newLayout, isMatched, differences);
+		}
+	}
+}
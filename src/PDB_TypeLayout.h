@@ -0,0 +1,142 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_ParallelFor.h"
+#include "PDB_TPITypes.h"
+
+
+namespace PDB
+{
+	class TypeTable;
+
+
+	// A part of a class, structure or union that occupies memory in its instances.
+	struct LayoutMember
+	{
+		enum class PDB_NO_DISCARD Kind : uint8_t
+		{
+			DataMember,
+			BaseClass,
+			VirtualBaseClass,									// occupies the virtual base pointer, the base itself is placed by the most-derived class
+			VirtualFunctionTablePointer
+		};
+
+		const char* name;										// name of the data member or base class, nullptr for virtual function table pointers
+		uint64_t offset;										// offset in bytes, the offset of the virtual base pointer for virtual base classes
+		uint64_t size;											// size in bytes, the size of the underlying type for bitfields
+		uint32_t typeIndex;										// type of the member, the underlying type for bitfields
+		uint8_t bitPosition;									// position and length of bitfields, the length is 0 for all other members
+		uint8_t bitLength;
+		Kind kind;
+	};
+
+	// A class, structure or union definition as stored in its record.
+	struct UserDefinedType
+	{
+		const char* name;
+		uint64_t size;
+		uint32_t fieldList;										// type index of the field list, 0 if the type has no members
+		CodeView::TPI::TypeProperty property;
+		CodeView::TPI::TypeRecordKind kind;
+	};
+
+	// Reads a class, structure or union record. Returns false for records of other kinds.
+	PDB_NO_DISCARD bool GetUserDefinedType(const CodeView::TPI::Record* record, UserDefinedType& type) PDB_NO_EXCEPT;
+
+	// Appends the data members, base classes and virtual function table pointers of a class, structure or union in the order of
+	// its field list, following continuations of long field lists. Static data members, methods and nested types are skipped.
+	void GetLayoutMembers(const TypeTable& typeTable, const UserDefinedType& type, GrowableArray<LayoutMember>& members) PDB_NO_EXCEPT;
+
+
+	// The layouts of all named classes, structures and unions of a PDB, sorted by name so that layouts of different PDBs can be
+	// matched quickly. Each layout stores the size of its type and the offsets, sizes and types of its members.
+	// Names of unnamed types and lambdas are generated by the compiler and are not stable between builds, such types are skipped.
+	// If several definitions share a name, only the first one is kept.
+	// The layouts refer to the names stored in the type table, which must outlive the map.
+	class PDB_NO_DISCARD TypeLayoutMap
+	{
+	public:
+		struct Layout
+		{
+			const char* name;
+			uint64_t size;
+			uint32_t typeIndex;									// type index of the definition
+			uint32_t firstMember;								// first and number of members in the members of the map
+			uint32_t memberCount;
+			CodeView::TPI::TypeRecordKind kind;
+		};
+
+		TypeLayoutMap(void) PDB_NO_EXCEPT;
+		TypeLayoutMap(TypeLayoutMap&& other) PDB_NO_EXCEPT;
+		TypeLayoutMap& operator=(TypeLayoutMap&& other) PDB_NO_EXCEPT;
+
+		// Builds the layouts of all definitions, running jobs for chunks of records in parallel if a parallel loop is given.
+		explicit TypeLayoutMap(const TypeTable& typeTable, ParallelForFunction parallelFor = nullptr, void* userData = nullptr) PDB_NO_EXCEPT;
+		~TypeLayoutMap(void) PDB_NO_EXCEPT;
+
+		// Returns the layout of the type with the given name, or nullptr if there is none.
+		PDB_NO_DISCARD const Layout* FindLayout(const char* name) const PDB_NO_EXCEPT;
+
+		// Returns a view of all layouts, sorted by name.
+		PDB_NO_DISCARD inline ArrayView<Layout> GetLayouts(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Layout>(m_layouts, m_layoutCount);
+		}
+
+		// Returns a view of the members of a layout.
+		PDB_NO_DISCARD inline ArrayView<LayoutMember> GetMembers(const Layout& layout) const PDB_NO_EXCEPT
+		{
+			return ArrayView<LayoutMember>(m_members + layout.firstMember, layout.memberCount);
+		}
+
+		// Returns the key of the type of a member, which is the same for types with the same layout in different PDBs.
+		// Pointers only differ by their size, and classes, structures, unions and enums by their name.
+		PDB_NO_DISCARD inline uint64_t GetTypeKey(const Layout& layout, size_t memberIndex) const PDB_NO_EXCEPT
+		{
+			return m_typeKeys[layout.firstMember + memberIndex];
+		}
+
+	private:
+		Layout* m_layouts;
+		size_t m_layoutCount;
+
+		LayoutMember* m_members;
+		uint64_t* m_typeKeys;
+		size_t m_memberCount;
+
+		PDB_DISABLE_COPY(TypeLayoutMap);
+	};
+
+
+	// A difference between the layouts of a type in two PDBs.
+	struct TypeLayoutDifference
+	{
+		enum class PDB_NO_DISCARD Kind : uint8_t
+		{
+			TypeAdded,
+			TypeRemoved,
+			TypeSizeChanged,
+			MemberAdded,
+			MemberRemoved,
+			MemberOffsetChanged,
+			MemberSizeChanged,
+			MemberTypeChanged,
+			MemberBitfieldChanged
+		};
+
+		Kind kind;
+		const TypeLayoutMap::Layout* oldLayout;					// nullptr for added types
+		const TypeLayoutMap::Layout* newLayout;					// nullptr for removed types
+		const LayoutMember* oldMember;							// the member a difference refers to, nullptr for added members and type differences
+		const LayoutMember* newMember;							// nullptr for removed members and type differences
+	};
+
+	// Appends all differences between the layouts of types with the same name, and types that exist in only one of the maps.
+	// Members are matched by their kind and name. Each changed member yields one difference for each changed property.
+	void DiffTypeLayouts(const TypeLayoutMap& oldMap, const TypeLayoutMap& newMap, GrowableArray<TypeLayoutDifference>& differences) PDB_NO_EXCEPT;
+}
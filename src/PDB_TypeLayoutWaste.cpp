@@ -0,0 +1,271 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_TypeLayoutWaste.h"
+#include "PDB_TypeLayout.h"
+#include "PDB_TypeTable.h"
+#include "Foundation/PDB_Algorithm.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	// records are analyzed in chunks
+	static constexpr const uint32_t RecordsPerJob = 4096u;
+
+	static constexpr const uint64_t MaxMemberAlignment = 8u;
+
+
+	// The bytes occupied by a member, or by the storage of several bitfields.
+	struct Range
+	{
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	struct AnalyzeContext
+	{
+		const PDB::TypeTable* typeTable;
+		PDB::GrowableArray<PDB::TypeLayoutWaste::Type>* jobTypes;
+	};
+
+
+	// Returns the assumed alignment of a member, which is the largest power of two dividing its size.
+	PDB_NO_DISCARD static inline uint64_t GetAlignment(uint64_t size) PDB_NO_EXCEPT
+	{
+		const uint64_t alignment = size & (~size + 1u);
+		return (alignment < MaxMemberAlignment) ? alignment : MaxMemberAlignment;
+	}
+
+
+	PDB_NO_DISCARD static inline uint64_t AlignUp(uint64_t value, uint64_t alignment) PDB_NO_EXCEPT
+	{
+		return (value + alignment - 1u) & ~(alignment - 1u);
+	}
+
+
+	// Analyzes the members of a single type, returning whether it wastes any memory.
+	PDB_NO_DISCARD static bool AnalyzeType(const PDB::UserDefinedType& userDefinedType, const PDB::LayoutMember* memberData, size_t memberCount, PDB::GrowableArray<Range>& ranges, PDB::TypeLayoutWaste::Type& type) PDB_NO_EXCEPT
+	{
+		using Kind = PDB::LayoutMember::Kind;
+
+		uint64_t memberSizes = 0u;
+		uint64_t maxAlignment = 1u;
+		bool hasVirtualBasePointer = false;
+
+		ranges.Clear();
+		for (size_t i = 0u; i < memberCount; ++i)
+		{
+			const PDB::LayoutMember& member = memberData[i];
+			if (member.size == 0u)
+			{
+				// members of unknown size cannot be analyzed
+				continue;
+			}
+
+			if (member.kind == Kind::VirtualBaseClass)
+			{
+				// all virtual bases share a single virtual base pointer
+				type.hasVirtualBases = true;
+				if (hasVirtualBasePointer)
+				{
+					continue;
+				}
+
+				hasVirtualBasePointer = true;
+			}
+
+			if (member.bitLength != 0u)
+			{
+				// consecutive bitfields at the same offset share their storage
+				uint64_t usedBits = member.bitLength;
+				while ((i + 1u < memberCount) && (memberData[i + 1u].bitLength != 0u) && (memberData[i + 1u].offset == member.offset))
+				{
+					usedBits += memberData[++i].bitLength;
+				}
+
+				const uint64_t storageBits = member.size * 8u;
+				type.unusedBitfieldBits += (storageBits > usedBits) ? static_cast<uint32_t>(storageBits - usedBits) : 0u;
+			}
+
+			const uint64_t end = member.offset + member.size;
+			if (member.offset / PDB::TypeLayoutWaste::CacheLineSize != (end - 1u) / PDB::TypeLayoutWaste::CacheLineSize)
+			{
+				++type.straddlingMemberCount;
+			}
+
+			ranges.Add(Range { member.offset, end });
+			memberSizes += member.size;
+
+			const uint64_t alignment = GetAlignment(member.size);
+			maxAlignment = (alignment > maxAlignment) ? alignment : maxAlignment;
+		}
+
+		if (ranges.GetSize() == 0u)
+		{
+			return false;
+		}
+
+		// walk the ranges in order of their offsets, counting the gaps between them
+		Range* rangeData = ranges.GetData();
+		PDB::Algorithm::Sort(rangeData, rangeData + ranges.GetSize(), [](const Range& lhs, const Range& rhs)
+		{
+			return lhs.begin < rhs.begin;
+		});
+
+		uint64_t coveredEnd = 0u;
+		for (size_t i = 0u; i < ranges.GetSize(); ++i)
+		{
+			if (rangeData[i].begin > coveredEnd)
+			{
+				const uint64_t holeSize = rangeData[i].begin - coveredEnd;
+				type.paddingBytes += holeSize;
+				type.largestHoleBytes = (holeSize > type.largestHoleBytes) ? holeSize : type.largestHoleBytes;
+				++type.holeCount;
+			}
+
+			coveredEnd = (rangeData[i].end > coveredEnd) ? rangeData[i].end : coveredEnd;
+		}
+
+		type.size = userDefinedType.size;
+		type.tailPaddingBytes = (!type.hasVirtualBases && (type.size > coveredEnd)) ? type.size - coveredEnd : 0u;
+		type.paddingBytes += type.tailPaddingBytes;
+
+		// ordering members by decreasing alignment leaves no gaps between them, because each size is a multiple of its alignment
+		const uint64_t packedSize = AlignUp(memberSizes, maxAlignment);
+		type.packedSize = (!type.hasVirtualBases && (packedSize < type.size)) ? packedSize : type.size;
+
+		type.cacheLineCount = static_cast<uint32_t>((type.size + PDB::TypeLayoutWaste::CacheLineSize - 1u) / PDB::TypeLayoutWaste::CacheLineSize);
+		type.score = (type.paddingBytes + type.unusedBitfieldBits / 8u) * type.cacheLineCount;
+
+		return (type.paddingBytes != 0u) || (type.unusedBitfieldBits != 0u) || (type.straddlingMemberCount != 0u);
+	}
+
+
+	// Analyzes the class and structure definitions in a chunk of records.
+	static void AnalyzeTypesJob(void* jobData, uint32_t index) PDB_NO_EXCEPT
+	{
+		const AnalyzeContext* context = static_cast<const AnalyzeContext*>(jobData);
+		const PDB::TypeTable& typeTable = *context->typeTable;
+		PDB::GrowableArray<PDB::TypeLayoutWaste::Type>& types = context->jobTypes[index];
+
+		const PDB::ArrayView<const PDB::CodeView::TPI::Record*> records = typeTable.GetTypeRecords();
+		const size_t begin = static_cast<size_t>(index) * RecordsPerJob;
+		const size_t end = (begin + RecordsPerJob < records.GetLength()) ? begin + RecordsPerJob : records.GetLength();
+
+		PDB::GrowableArray<PDB::LayoutMember> members;
+		PDB::GrowableArray<Range> ranges;
+		for (size_t i = begin; i < end; ++i)
+		{
+			PDB::UserDefinedType userDefinedType = {};
+			if (!records[i] || !PDB::GetUserDefinedType(records[i], userDefinedType) || userDefinedType.property.fwdref ||
+				!userDefinedType.name || (userDefinedType.kind == PDB::CodeView::TPI::TypeRecordKind::LF_UNION))
+			{
+				continue;
+			}
+
+			members.Clear();
+			PDB::GetLayoutMembers(typeTable, userDefinedType, members);
+
+			PDB::TypeLayoutWaste::Type type = {};
+			type.name = userDefinedType.name;
+			type.typeIndex = typeTable.GetFirstTypeIndex() + static_cast<uint32_t>(i);
+			if (AnalyzeType(userDefinedType, members.GetData(), members.GetSize(), ranges, type))
+			{
+				types.Add(type);
+			}
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutWaste::TypeLayoutWaste(void) PDB_NO_EXCEPT
+	: m_types(nullptr)
+	, m_typeCount(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutWaste::TypeLayoutWaste(TypeLayoutWaste&& other) PDB_NO_EXCEPT
+	: m_types(PDB_MOVE(other.m_types))
+	, m_typeCount(PDB_MOVE(other.m_typeCount))
+{
+	other.m_types = nullptr;
+	other.m_typeCount = 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutWaste& PDB::TypeLayoutWaste::operator=(TypeLayoutWaste&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_types);
+
+		m_types = PDB_MOVE(other.m_types);
+		m_typeCount = PDB_MOVE(other.m_typeCount);
+
+		other.m_types = nullptr;
+		other.m_typeCount = 0u;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutWaste::TypeLayoutWaste(const TypeTable& typeTable, ParallelForFunction parallelFor, void* userData) PDB_NO_EXCEPT
+	: m_types(nullptr)
+	, m_typeCount(0u)
+{
+	const size_t recordCount = typeTable.GetTypeRecords().GetLength();
+	const uint32_t jobCount = static_cast<uint32_t>((recordCount + RecordsPerJob - 1u) / RecordsPerJob);
+
+	GrowableArray<Type>* jobTypes = PDB_NEW_ARRAY(GrowableArray<Type>, jobCount);
+	{
+		AnalyzeContext context = { &typeTable, jobTypes };
+		PDB::ParallelFor(parallelFor, userData, jobCount, &AnalyzeTypesJob, &context);
+	}
+
+	for (uint32_t i = 0u; i < jobCount; ++i)
+	{
+		m_typeCount += jobTypes[i].GetSize();
+	}
+
+	m_types = PDB_NEW_ARRAY(Type, m_typeCount);
+	{
+		size_t offset = 0u;
+		for (uint32_t i = 0u; i < jobCount; ++i)
+		{
+			if (jobTypes[i].GetSize() != 0u)
+			{
+				std::memcpy(m_types + offset, jobTypes[i].GetData(), jobTypes[i].GetSize() * sizeof(Type));
+				offset += jobTypes[i].GetSize();
+			}
+		}
+	}
+
+	PDB_DELETE_ARRAY(jobTypes);
+
+	// the type index breaks ties, so that the order does not depend on the sort
+	Algorithm::Sort(m_types, m_types + m_typeCount, [](const Type& lhs, const Type& rhs)
+	{
+		return (lhs.score > rhs.score) || ((lhs.score == rhs.score) && (lhs.typeIndex < rhs.typeIndex));
+	});
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeLayoutWaste::~TypeLayoutWaste(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_types);
+}
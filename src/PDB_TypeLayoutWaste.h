@@ -0,0 +1,67 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "Foundation/PDB_ParallelFor.h"
+
+
+namespace PDB
+{
+	class TypeTable;
+
+
+	// Finds classes and structures whose layout wastes memory, based on the offsets and sizes of their members.
+	// Bytes not covered by any data member, base class or hidden pointer are counted as padding, and so are unused bits in
+	// the storage of bitfields. Members crossing a cache line boundary are counted assuming instances are aligned to a cache line.
+	// The packed size is an estimate of the size with members ordered by decreasing alignment, assuming each member is aligned
+	// to the largest power of two dividing its size, up to 8 bytes.
+	// Unions are skipped, because their members overlap by design. Virtual base classes are placed behind the members of the
+	// most-derived class, so the tail of types with virtual bases is not counted as padding.
+	// The types refer to the names stored in the type table, which must outlive the analysis.
+	class PDB_NO_DISCARD TypeLayoutWaste
+	{
+	public:
+		static constexpr const uint64_t CacheLineSize = 64u;
+
+		struct Type
+		{
+			const char* name;
+			uint64_t size;
+			uint64_t paddingBytes;								// bytes not covered by any member, including tail padding
+			uint64_t tailPaddingBytes;
+			uint64_t largestHoleBytes;
+			uint64_t packedSize;								// estimated size with members reordered, never larger than the size
+			uint64_t score;										// wasted bytes times the number of cache lines occupied by an instance
+			uint32_t typeIndex;
+			uint32_t holeCount;									// gaps between members, not including tail padding
+			uint32_t unusedBitfieldBits;
+			uint32_t straddlingMemberCount;						// members crossing a cache line boundary
+			uint32_t cacheLineCount;							// cache lines occupied by an instance aligned to a cache line
+			bool hasVirtualBases;
+		};
+
+		TypeLayoutWaste(void) PDB_NO_EXCEPT;
+		TypeLayoutWaste(TypeLayoutWaste&& other) PDB_NO_EXCEPT;
+		TypeLayoutWaste& operator=(TypeLayoutWaste&& other) PDB_NO_EXCEPT;
+
+		// Analyzes all class and structure definitions, running jobs for chunks of records in parallel if a parallel loop is given.
+		// Only types wasting memory or having members that cross a cache line boundary are kept.
+		explicit TypeLayoutWaste(const TypeTable& typeTable, ParallelForFunction parallelFor = nullptr, void* userData = nullptr) PDB_NO_EXCEPT;
+		~TypeLayoutWaste(void) PDB_NO_EXCEPT;
+
+		// Returns a view of all types, ordered by decreasing score.
+		PDB_NO_DISCARD inline ArrayView<Type> GetTypes(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<Type>(m_types, m_typeCount);
+		}
+
+	private:
+		Type* m_types;
+		size_t m_typeCount;
+
+		PDB_DISABLE_COPY(TypeLayoutWaste);
+	};
+}
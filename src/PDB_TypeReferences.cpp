@@ -0,0 +1,330 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_TypeReferences.h"
+#include "PDB_TypeTable.h"
+#include "PDB_Types.h"
+
+
+namespace
+{
+	// the data of a record starts after its size and kind
+	static constexpr const uint32_t RecordDataOffset = 4u;
+
+	// https://github.com/microsoft/microsoft-pdb/blob/master/include/cvinfo.h#L1477
+	static constexpr const uint32_t PointerModeDataMember = 2u;
+	static constexpr const uint32_t PointerModeMemberFunction = 3u;
+
+	// members of field lists are padded to 4 bytes using LF_PAD0 to LF_PAD15, which are single bytes
+	static constexpr const uint8_t FirstPadLeaf = 0xF0u;
+
+
+	PDB_NO_DISCARD static inline uint16_t ReadUInt16(const PDB::Byte* data, uint32_t offset) PDB_NO_EXCEPT
+	{
+		uint16_t value = 0u;
+		std::memcpy(&value, data + offset, sizeof(value));
+
+		return value;
+	}
+
+
+	PDB_NO_DISCARD static inline uint32_t ReadUInt32(const PDB::Byte* data, uint32_t offset) PDB_NO_EXCEPT
+	{
+		uint32_t value = 0u;
+		std::memcpy(&value, data + offset, sizeof(value));
+
+		return value;
+	}
+
+
+	// Adds the given number of consecutive type indices, as long as they are inside the record.
+	static void AddReferences(PDB::GrowableArray<PDB::TypeReference>& references, uint32_t offset, uint32_t count, uint32_t recordSize, PDB::TypeReference::Kind kind) PDB_NO_EXCEPT
+	{
+		for (uint32_t i = 0u; (i < count) && (offset + sizeof(uint32_t) <= recordSize); ++i, offset += sizeof(uint32_t))
+		{
+			references.Add(PDB::TypeReference { offset, kind });
+		}
+	}
+
+
+	// Returns the offset after the null-terminated name at the given offset, or the record size if the name is not terminated.
+	PDB_NO_DISCARD static uint32_t SkipName(const PDB::Byte* data, uint32_t offset, uint32_t recordSize) PDB_NO_EXCEPT
+	{
+		if (offset >= recordSize)
+		{
+			return recordSize;
+		}
+
+		const size_t length = strnlen(reinterpret_cast<const char*>(data + offset), recordSize - offset);
+		return (offset + length < recordSize) ? static_cast<uint32_t>(offset + length + 1u) : recordSize;
+	}
+
+
+	// Returns the offset after the numeric leaf at the given offset, or 0 if the leaf is not an integer.
+	PDB_NO_DISCARD static uint32_t SkipNumericLeaf(const PDB::Byte* data, uint32_t offset, uint32_t recordSize) PDB_NO_EXCEPT
+	{
+		if (offset + sizeof(uint16_t) > recordSize)
+		{
+			return 0u;
+		}
+
+		uint64_t value = 0u;
+		const size_t leafSize = PDB::TypeTable::ReadNumericLeaf(data + offset, value);
+
+		return (leafSize != 0u) ? static_cast<uint32_t>(offset + leafSize) : 0u;
+	}
+
+
+	// Walks the members of a field list. Each member starts with its kind, and is followed by padding.
+	static void GetFieldListReferences(const PDB::Byte* data, uint32_t recordSize, PDB::GrowableArray<PDB::TypeReference>& references) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::TPI;
+
+		const PDB::TypeReference::Kind type = PDB::TypeReference::Kind::Type;
+
+		uint32_t offset = RecordDataOffset;
+		while (offset + sizeof(uint16_t) <= recordSize)
+		{
+			const TypeRecordKind kind = static_cast<TypeRecordKind>(ReadUInt16(data, offset));
+			switch (kind)
+			{
+				case TypeRecordKind::LF_BCLASS:
+					// attributes, base class, offset
+					AddReferences(references, offset + 4u, 1u, recordSize, type);
+					offset = SkipNumericLeaf(data, offset + 8u, recordSize);
+					break;
+
+				case TypeRecordKind::LF_VBCLASS:
+				case TypeRecordKind::LF_IVBCLASS:
+					// attributes, base class, virtual base pointer, two offsets
+					AddReferences(references, offset + 4u, 2u, recordSize, type);
+					offset = SkipNumericLeaf(data, offset + 12u, recordSize);
+					offset = (offset != 0u) ? SkipNumericLeaf(data, offset, recordSize) : 0u;
+					break;
+
+				case TypeRecordKind::LF_INDEX:
+				case TypeRecordKind::LF_VFUNCTAB:
+				case TypeRecordKind::LF_FRIENDCLS:
+					// padding, type
+					AddReferences(references, offset + 4u, 1u, recordSize, type);
+					offset += 8u;
+					break;
+
+				case TypeRecordKind::LF_VFUNCOFF:
+					// padding, type, offset
+					AddReferences(references, offset + 4u, 1u, recordSize, type);
+					offset += 12u;
+					break;
+
+				case TypeRecordKind::LF_ENUMERATE:
+					// attributes, value, name
+					offset = SkipNumericLeaf(data, offset + 4u, recordSize);
+					offset = (offset != 0u) ? SkipName(data, offset, recordSize) : 0u;
+					break;
+
+				case TypeRecordKind::LF_MEMBER:
+					// attributes, type, offset, name
+					AddReferences(references, offset + 4u, 1u, recordSize, type);
+					offset = SkipNumericLeaf(data, offset + 8u, recordSize);
+					offset = (offset != 0u) ? SkipName(data, offset, recordSize) : 0u;
+					break;
+
+				case TypeRecordKind::LF_STMEMBER:
+				case TypeRecordKind::LF_NESTTYPE:
+				case TypeRecordKind::LF_NESTTYPEEX:
+				case TypeRecordKind::LF_METHOD:
+				case TypeRecordKind::LF_FRIENDFCN:
+					// attributes, padding or count, type, name
+					AddReferences(references, offset + 4u, 1u, recordSize, type);
+					offset = SkipName(data, offset + 8u, recordSize);
+					break;
+
+				case TypeRecordKind::LF_ONEMETHOD:
+				{
+					// attributes, type, offset in the virtual function table for introducing methods only, name
+					AddReferences(references, offset + 4u, 1u, recordSize, type);
+
+					const uint32_t methodProperty = (ReadUInt16(data, offset + 2u) >> 2u) & 0x7u;
+					const bool isIntroducing = (methodProperty == PDB_AS_UNDERLYING(MethodProperty::Intro)) || (methodProperty == PDB_AS_UNDERLYING(MethodProperty::PureIntro));
+					offset = SkipName(data, offset + (isIntroducing ? 12u : 8u), recordSize);
+					break;
+				}
+
+				default:
+					// the size of unknown members cannot be determined
+					return;
+			}
+
+			if (offset == 0u)
+			{
+				return;
+			}
+
+			while ((offset < recordSize) && (static_cast<uint8_t>(data[offset]) >= FirstPadLeaf))
+			{
+				++offset;
+			}
+		}
+	}
+
+
+	// Walks the entries of a method list, each of which consists of attributes, padding, type and an optional offset.
+	static void GetMethodListReferences(const PDB::Byte* data, uint32_t recordSize, PDB::GrowableArray<PDB::TypeReference>& references) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::TPI;
+
+		uint32_t offset = RecordDataOffset;
+		while (offset + 8u <= recordSize)
+		{
+			AddReferences(references, offset + 4u, 1u, recordSize, PDB::TypeReference::Kind::Type);
+
+			const uint32_t methodProperty = (ReadUInt16(data, offset) >> 2u) & 0x7u;
+			const bool isIntroducing = (methodProperty == PDB_AS_UNDERLYING(MethodProperty::Intro)) || (methodProperty == PDB_AS_UNDERLYING(MethodProperty::PureIntro));
+			offset += isIntroducing ? 12u : 8u;
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::GetTypeReferences(const CodeView::TPI::Record* record, GrowableArray<TypeReference>& references) PDB_NO_EXCEPT
+{
+	using namespace CodeView::TPI;
+
+	const Byte* data = reinterpret_cast<const Byte*>(record);
+	const uint32_t recordSize = static_cast<uint32_t>(record->header.size) + sizeof(uint16_t);
+	const TypeReference::Kind type = TypeReference::Kind::Type;
+
+	// offsets of type indices are relative to the start of the record, the data of each record starts at offset 4
+	switch (record->header.kind)
+	{
+		case TypeRecordKind::LF_MODIFIER:
+		case TypeRecordKind::LF_BITFIELD:
+			AddReferences(references, 4u, 1u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_POINTER:
+		{
+			AddReferences(references, 4u, 1u, recordSize, type);
+
+			// pointers to members also store the containing class
+			const uint32_t pointerMode = (ReadUInt32(data, 8u) >> 5u) & 0x7u;
+			if ((pointerMode == PointerModeDataMember) || (pointerMode == PointerModeMemberFunction))
+			{
+				AddReferences(references, 12u, 1u, recordSize, type);
+			}
+			break;
+		}
+
+		case TypeRecordKind::LF_PROCEDURE:
+			// return type, calling convention, attributes, parameter count, argument list
+			AddReferences(references, 4u, 1u, recordSize, type);
+			AddReferences(references, 12u, 1u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_MFUNCTION:
+			// return type, class, this, calling convention, attributes, parameter count, argument list
+			AddReferences(references, 4u, 3u, recordSize, type);
+			AddReferences(references, 20u, 1u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_ARGLIST:
+			AddReferences(references, 8u, ReadUInt32(data, 4u), recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_ARRAY:
+		case TypeRecordKind::LF_VFTABLE:
+			// element and index type, or class and overridden table
+			AddReferences(references, 4u, 2u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_CLASS:
+		case TypeRecordKind::LF_STRUCTURE:
+		case TypeRecordKind::LF_INTERFACE:
+			// count, property, field list, derived list, shape
+			AddReferences(references, 8u, 3u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_CLASS2:
+		case TypeRecordKind::LF_STRUCTURE2:
+			// count, 32-bit property, field list, derived list, shape
+			AddReferences(references, 10u, 3u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_UNION:
+			AddReferences(references, 8u, 1u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_ENUM:
+			// count, property, underlying type, field list
+			AddReferences(references, 8u, 2u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_FIELDLIST:
+			GetFieldListReferences(data, recordSize, references);
+			break;
+
+		case TypeRecordKind::LF_METHODLIST:
+			GetMethodListReferences(data, recordSize, references);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PDB::GetTypeReferences(const CodeView::IPI::Record* record, GrowableArray<TypeReference>& references) PDB_NO_EXCEPT
+{
+	using namespace CodeView::IPI;
+
+	const Byte* data = reinterpret_cast<const Byte*>(record);
+	const uint32_t recordSize = static_cast<uint32_t>(record->header.size) + sizeof(uint16_t);
+	const TypeReference::Kind type = TypeReference::Kind::Type;
+	const TypeReference::Kind id = TypeReference::Kind::Id;
+
+	switch (record->header.kind)
+	{
+		case TypeRecordKind::LF_FUNC_ID:
+			// parent scope, function type
+			AddReferences(references, 4u, 1u, recordSize, id);
+			AddReferences(references, 8u, 1u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_MFUNC_ID:
+			// parent class, function type
+			AddReferences(references, 4u, 2u, recordSize, type);
+			break;
+
+		case TypeRecordKind::LF_STRING_ID:
+			// list of substrings
+			AddReferences(references, 4u, 1u, recordSize, id);
+			break;
+
+		case TypeRecordKind::LF_SUBSTR_LIST:
+			AddReferences(references, 8u, ReadUInt32(data, 4u), recordSize, id);
+			break;
+
+		case TypeRecordKind::LF_BUILDINFO:
+			AddReferences(references, 6u, ReadUInt16(data, 4u), recordSize, id);
+			break;
+
+		case TypeRecordKind::LF_UDT_SRC_LINE:
+			// type, source file, line
+			AddReferences(references, 4u, 1u, recordSize, type);
+			AddReferences(references, 8u, 1u, recordSize, id);
+			break;
+
+		case TypeRecordKind::LF_UDT_MOD_SRC_LINE:
+			// type, offset of the source file in the names stream, line, module
+			AddReferences(references, 4u, 1u, recordSize, type);
+			break;
+
+		default:
+			break;
+	}
+}
@@ -0,0 +1,34 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_GrowableArray.h"
+#include "PDB_TPITypes.h"
+#include "PDB_IPITypes.h"
+
+
+namespace PDB
+{
+	// A type index stored inside a TPI or IPI record.
+	struct TypeReference
+	{
+		enum class PDB_NO_DISCARD Kind : uint8_t
+		{
+			Type,												// refers to a record in the TPI stream
+			Id													// refers to a record in the IPI stream
+		};
+
+		uint32_t offset;										// offset of the 32-bit type index from the start of the record, including its header
+		Kind kind;
+	};
+
+	// Appends all type indices stored in the given TPI record, including those stored in the members of field lists.
+	// Records of unknown kind are treated as not referring to any other record, and walking a field list stops at the first
+	// member of unknown kind.
+	void GetTypeReferences(const CodeView::TPI::Record* record, GrowableArray<TypeReference>& references) PDB_NO_EXCEPT;
+
+	// Appends all type indices stored in the given IPI record, which can refer to records in both the TPI and the IPI stream.
+	void GetTypeReferences(const CodeView::IPI::Record* record, GrowableArray<TypeReference>& references) PDB_NO_EXCEPT;
+}
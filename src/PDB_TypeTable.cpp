@@ -0,0 +1,583 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_TypeTable.h"
+#include "PDB_TPIStream.h"
+#include "Foundation/PDB_Memory.h"
+
+
+namespace
+{
+	// chains of modifiers, enums and forward references are short, anything deeper is a malformed stream
+	static constexpr const unsigned int MaxTypeSizeRecursionDepth = 32u;
+
+
+	// 32-bit FNV-1a
+	PDB_NO_DISCARD static uint32_t HashName(const char* name) PDB_NO_EXCEPT
+	{
+		uint32_t hash = 2166136261u;
+		while (*name != '\0')
+		{
+			hash ^= static_cast<uint8_t>(*name++);
+			hash *= 16777619u;
+		}
+
+		return hash;
+	}
+
+
+	// Returns the property of a class, structure, union or enum record.
+	PDB_NO_DISCARD static bool GetUserDefinedTypeProperty(const PDB::CodeView::TPI::Record* record, PDB::CodeView::TPI::TypeProperty& property) PDB_NO_EXCEPT
+	{
+		using namespace PDB::CodeView::TPI;
+
+		switch (record->header.kind)
+		{
+			case TypeRecordKind::LF_CLASS:
+			case TypeRecordKind::LF_STRUCTURE:
+			case TypeRecordKind::LF_INTERFACE:
+				property = record->data.LF_CLASS.property;
+				return true;
+
+			case TypeRecordKind::LF_CLASS2:
+			case TypeRecordKind::LF_STRUCTURE2:
+			{
+				// the lower 16 bits of the 32-bit property share the layout of the 16-bit property
+				const uint16_t lowerBits = static_cast<uint16_t>(record->data.LF_CLASS2.property);
+				std::memcpy(&property, &lowerBits, sizeof(property));
+				return true;
+			}
+
+			case TypeRecordKind::LF_UNION:
+				property = record->data.LF_UNION.property;
+				return true;
+
+			case TypeRecordKind::LF_ENUM:
+				property = record->data.LF_ENUM.property;
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+
+	// Returns the name used for matching forward references with their definition.
+	// this is the unique (decorated) name if the record has one, otherwise the regular name.
+	PDB_NO_DISCARD static const char* GetMatchingName(const PDB::CodeView::TPI::Record* record, const PDB::CodeView::TPI::TypeProperty& property) PDB_NO_EXCEPT
+	{
+		const char* name = PDB::TypeTable::GetUserDefinedTypeName(record);
+		if (name && property.hasuniquename)
+		{
+			return name + std::strlen(name) + 1u;
+		}
+
+		return name;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeTable::TypeTable(void) PDB_NO_EXCEPT
+	: m_typeIndexBegin(0u)
+	, m_typeIndexEnd(0u)
+	, m_stream()
+	, m_records(nullptr)
+	, m_recordCount(0u)
+	, m_definitions(nullptr)
+	, m_definitionMask(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeTable::TypeTable(TypeTable&& other) PDB_NO_EXCEPT
+	: m_typeIndexBegin(PDB_MOVE(other.m_typeIndexBegin))
+	, m_typeIndexEnd(PDB_MOVE(other.m_typeIndexEnd))
+	, m_stream(PDB_MOVE(other.m_stream))
+	, m_records(PDB_MOVE(other.m_records))
+	, m_recordCount(PDB_MOVE(other.m_recordCount))
+	, m_definitions(PDB_MOVE(other.m_definitions))
+	, m_definitionMask(PDB_MOVE(other.m_definitionMask))
+{
+	other.m_typeIndexBegin = 0u;
+	other.m_typeIndexEnd = 0u;
+	other.m_records = nullptr;
+	other.m_recordCount = 0u;
+	other.m_definitions = nullptr;
+	other.m_definitionMask = 0u;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeTable& PDB::TypeTable::operator=(TypeTable&& other) PDB_NO_EXCEPT
+{
+	if (this != &other)
+	{
+		PDB_DELETE_ARRAY(m_records);
+		PDB_DELETE_ARRAY(m_definitions);
+
+		m_typeIndexBegin = PDB_MOVE(other.m_typeIndexBegin);
+		m_typeIndexEnd = PDB_MOVE(other.m_typeIndexEnd);
+		m_stream = PDB_MOVE(other.m_stream);
+		m_records = PDB_MOVE(other.m_records);
+		m_recordCount = PDB_MOVE(other.m_recordCount);
+		m_definitions = PDB_MOVE(other.m_definitions);
+		m_definitionMask = PDB_MOVE(other.m_definitionMask);
+
+		other.m_typeIndexBegin = 0u;
+		other.m_typeIndexEnd = 0u;
+		other.m_records = nullptr;
+		other.m_recordCount = 0u;
+		other.m_definitions = nullptr;
+		other.m_definitionMask = 0u;
+	}
+
+	return *this;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeTable::TypeTable(const TPIStream& tpiStream) PDB_NO_EXCEPT
+	: m_typeIndexBegin(tpiStream.GetFirstTypeIndex())
+	, m_typeIndexEnd(tpiStream.GetLastTypeIndex())
+	, m_stream()
+	, m_records(nullptr)
+	, m_recordCount(tpiStream.GetTypeRecordCount())
+	, m_definitions(nullptr)
+	, m_definitionMask(0u)
+{
+	// create a coalesced stream from the TPI stream, so the records can be referenced directly using pointers
+	const DirectMSFStream& directStream = tpiStream.GetDirectMSFStream();
+	m_stream = CoalescedMSFStream(directStream, directStream.GetSize(), 0u);
+
+	// types in the TPI stream are accessed by their index from other streams.
+	// however, the index is not stored with types in the TPI stream directly, but has to be built while walking the stream.
+	// similarly, because types are variable-length records, there are no direct offsets to access individual types.
+	// we therefore walk the TPI stream once, and store pointers to the records for trivial O(1) array lookup by index later.
+	m_records = PDB_NEW_ARRAY(const CodeView::TPI::Record*, m_recordCount);
+
+	size_t typeIndex = 0u;
+	size_t definitionCount = 0u;
+	for (const TPIStream::TypeRecordHeaderAndOffset& header : tpiStream.GetTypeRecordHeadersAndOffsets())
+	{
+		if (typeIndex == m_recordCount)
+		{
+			break;
+		}
+
+		const CodeView::TPI::Record* record = m_stream.GetDataAtOffset<const CodeView::TPI::Record>(header.offset);
+		m_records[typeIndex++] = record;
+
+		CodeView::TPI::TypeProperty property = {};
+		if (GetUserDefinedTypeProperty(record, property) && !property.fwdref)
+		{
+			++definitionCount;
+		}
+	}
+
+	// guard against streams that hold fewer records than announced in their header
+	for (; typeIndex < m_recordCount; ++typeIndex)
+	{
+		m_records[typeIndex] = nullptr;
+	}
+
+	// build a hash table of all definitions with a load factor of at most 50%
+	size_t definitionCapacity = 16u;
+	while (definitionCapacity < definitionCount * 2u)
+	{
+		definitionCapacity *= 2u;
+	}
+
+	m_definitions = PDB_NEW_ARRAY(DefinitionEntry, definitionCapacity);
+	m_definitionMask = definitionCapacity - 1u;
+	for (size_t i = 0u; i < definitionCapacity; ++i)
+	{
+		m_definitions[i] = DefinitionEntry { 0u, 0u };
+	}
+
+	for (size_t i = 0u; i < m_recordCount; ++i)
+	{
+		const CodeView::TPI::Record* record = m_records[i];
+		CodeView::TPI::TypeProperty property = {};
+		if (!record || !GetUserDefinedTypeProperty(record, property) || property.fwdref)
+		{
+			continue;
+		}
+
+		const char* name = GetMatchingName(record, property);
+		if (!name)
+		{
+			continue;
+		}
+
+		// type index 0 is never a valid record index, and marks empty slots.
+		// if several definitions share the same name, the first one wins.
+		const uint32_t hash = HashName(name);
+		for (size_t slot = hash & m_definitionMask; ; slot = (slot + 1u) & m_definitionMask)
+		{
+			DefinitionEntry& entry = m_definitions[slot];
+			if (entry.typeIndex == 0u)
+			{
+				entry = DefinitionEntry { hash, m_typeIndexBegin + static_cast<uint32_t>(i) };
+				break;
+			}
+			else if (entry.hash == hash)
+			{
+				const CodeView::TPI::Record* existing = GetTypeRecord(entry.typeIndex);
+				CodeView::TPI::TypeProperty existingProperty = {};
+				(void)GetUserDefinedTypeProperty(existing, existingProperty);
+				if (std::strcmp(GetMatchingName(existing, existingProperty), name) == 0)
+				{
+					break;
+				}
+			}
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::TypeTable::~TypeTable(void) PDB_NO_EXCEPT
+{
+	PDB_DELETE_ARRAY(m_records);
+	PDB_DELETE_ARRAY(m_definitions);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint32_t PDB::TypeTable::ResolveForwardReference(uint32_t typeIndex) const PDB_NO_EXCEPT
+{
+	const CodeView::TPI::Record* record = GetTypeRecord(typeIndex);
+	CodeView::TPI::TypeProperty property = {};
+	if (!record || !GetUserDefinedTypeProperty(record, property) || !property.fwdref)
+	{
+		return typeIndex;
+	}
+
+	const char* name = GetMatchingName(record, property);
+	if (!name)
+	{
+		return typeIndex;
+	}
+
+	const uint32_t hash = HashName(name);
+	for (size_t slot = hash & m_definitionMask; ; slot = (slot + 1u) & m_definitionMask)
+	{
+		const DefinitionEntry& entry = m_definitions[slot];
+		if (entry.typeIndex == 0u)
+		{
+			return typeIndex;
+		}
+
+		if (entry.hash == hash)
+		{
+			const CodeView::TPI::Record* definition = GetTypeRecord(entry.typeIndex);
+
+			CodeView::TPI::TypeProperty definitionProperty = {};
+			(void)GetUserDefinedTypeProperty(definition, definitionProperty);
+			if (std::strcmp(GetMatchingName(definition, definitionProperty), name) == 0)
+			{
+				return entry.typeIndex;
+			}
+		}
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint64_t PDB::TypeTable::GetTypeSize(uint32_t typeIndex) const PDB_NO_EXCEPT
+{
+	return GetTypeSize(typeIndex, 0u);
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint64_t PDB::TypeTable::GetTypeSize(uint32_t typeIndex, unsigned int depth) const PDB_NO_EXCEPT
+{
+	using namespace CodeView::TPI;
+
+	if (typeIndex < m_typeIndexBegin)
+	{
+		return GetSimpleTypeSize(typeIndex);
+	}
+
+	if (depth >= MaxTypeSizeRecursionDepth)
+	{
+		return 0u;
+	}
+
+	const Record* record = GetTypeRecord(typeIndex);
+	if (!record)
+	{
+		return 0u;
+	}
+
+	uint64_t size = 0u;
+	switch (record->header.kind)
+	{
+		case TypeRecordKind::LF_POINTER:
+			return record->data.LF_POINTER.attr.size;
+
+		case TypeRecordKind::LF_MODIFIER:
+			return GetTypeSize(record->data.LF_MODIFIER.type, depth + 1u);
+
+		case TypeRecordKind::LF_BITFIELD:
+			return GetTypeSize(record->data.LF_BITFIELD.type, depth + 1u);
+
+		case TypeRecordKind::LF_ARRAY:
+			return (ReadNumericLeaf(record->data.LF_ARRAY.data, size) != 0u) ? size : 0u;
+
+		case TypeRecordKind::LF_CLASS:
+		case TypeRecordKind::LF_STRUCTURE:
+		case TypeRecordKind::LF_INTERFACE:
+		case TypeRecordKind::LF_CLASS2:
+		case TypeRecordKind::LF_STRUCTURE2:
+		case TypeRecordKind::LF_UNION:
+		case TypeRecordKind::LF_ENUM:
+		{
+			const uint32_t definitionIndex = ResolveForwardReference(typeIndex);
+			if (definitionIndex != typeIndex)
+			{
+				return GetTypeSize(definitionIndex, depth + 1u);
+			}
+
+			const Record* definition = GetTypeRecord(definitionIndex);
+			switch (definition->header.kind)
+			{
+				case TypeRecordKind::LF_CLASS:
+				case TypeRecordKind::LF_STRUCTURE:
+				case TypeRecordKind::LF_INTERFACE:
+					return (ReadNumericLeaf(definition->data.LF_CLASS.data, size) != 0u) ? size : 0u;
+
+				case TypeRecordKind::LF_CLASS2:
+				case TypeRecordKind::LF_STRUCTURE2:
+					return (ReadNumericLeaf(definition->data.LF_CLASS2.data, size) != 0u) ? size : 0u;
+
+				case TypeRecordKind::LF_UNION:
+					return (ReadNumericLeaf(definition->data.LF_UNION.data, size) != 0u) ? size : 0u;
+
+				case TypeRecordKind::LF_ENUM:
+					return GetTypeSize(definition->data.LF_ENUM.utype, depth + 1u);
+
+				default:
+					return 0u;
+			}
+		}
+
+		default:
+			return 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const char* PDB::TypeTable::GetUserDefinedTypeName(const CodeView::TPI::Record* record) PDB_NO_EXCEPT
+{
+	using namespace CodeView::TPI;
+
+	uint64_t size = 0u;
+	size_t leafSize = 0u;
+	switch (record->header.kind)
+	{
+		case TypeRecordKind::LF_CLASS:
+		case TypeRecordKind::LF_STRUCTURE:
+		case TypeRecordKind::LF_INTERFACE:
+			leafSize = ReadNumericLeaf(record->data.LF_CLASS.data, size);
+			return (leafSize != 0u) ? &record->data.LF_CLASS.data[leafSize] : nullptr;
+
+		case TypeRecordKind::LF_CLASS2:
+		case TypeRecordKind::LF_STRUCTURE2:
+			leafSize = ReadNumericLeaf(record->data.LF_CLASS2.data, size);
+			return (leafSize != 0u) ? &record->data.LF_CLASS2.data[leafSize] : nullptr;
+
+		case TypeRecordKind::LF_UNION:
+			leafSize = ReadNumericLeaf(record->data.LF_UNION.data, size);
+			return (leafSize != 0u) ? &record->data.LF_UNION.data[leafSize] : nullptr;
+
+		case TypeRecordKind::LF_ENUM:
+			return record->data.LF_ENUM.name;
+
+		default:
+			return nullptr;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint32_t PDB::TypeTable::GetSimpleTypeSize(uint32_t typeIndex) PDB_NO_EXCEPT
+{
+	// https://llvm.org/docs/PDB/TpiStream.html#type-indices
+	// bits 8-11 store the pointer mode, bits 0-7 the kind of the simple type
+	const uint32_t mode = (typeIndex >> 8u) & 0xFu;
+	switch (mode)
+	{
+		case 0x0u:
+			break;
+
+		case 0x1u:		// near pointer
+			return 2u;
+
+		case 0x2u:		// far pointer
+		case 0x3u:		// huge pointer
+		case 0x4u:		// 32-bit pointer
+			return 4u;
+
+		case 0x5u:		// 16:32 pointer
+			return 6u;
+
+		case 0x6u:		// 64-bit pointer
+			return 8u;
+
+		default:		// 128-bit pointer
+			return 16u;
+	}
+
+	switch (typeIndex & 0xFFu)
+	{
+		case 0x10u:		// signed char
+		case 0x20u:		// unsigned char
+		case 0x30u:		// 8-bit bool
+		case 0x68u:		// 8-bit signed int
+		case 0x69u:		// 8-bit unsigned int
+		case 0x70u:		// really a char
+		case 0x7Cu:		// char8_t
+			return 1u;
+
+		case 0x11u:		// short
+		case 0x21u:		// unsigned short
+		case 0x31u:		// 16-bit bool
+		case 0x46u:		// 16-bit real
+		case 0x71u:		// wchar_t
+		case 0x72u:		// 16-bit signed int
+		case 0x73u:		// 16-bit unsigned int
+		case 0x7Au:		// char16_t
+			return 2u;
+
+		case 0x08u:		// HRESULT
+		case 0x12u:		// long
+		case 0x22u:		// unsigned long
+		case 0x32u:		// 32-bit bool
+		case 0x40u:		// 32-bit real
+		case 0x45u:		// 32-bit PP real
+		case 0x74u:		// 32-bit signed int
+		case 0x75u:		// 32-bit unsigned int
+		case 0x7Bu:		// char32_t
+			return 4u;
+
+		case 0x44u:		// 48-bit real
+			return 6u;
+
+		case 0x13u:		// long long
+		case 0x23u:		// unsigned long long
+		case 0x33u:		// 64-bit bool
+		case 0x41u:		// 64-bit real
+		case 0x50u:		// 32-bit complex
+		case 0x76u:		// 64-bit signed int
+		case 0x77u:		// 64-bit unsigned int
+			return 8u;
+
+		case 0x42u:		// 80-bit real
+			return 10u;
+
+		case 0x54u:		// 48-bit complex
+			return 12u;
+
+		case 0x14u:		// 128-bit signed int
+		case 0x24u:		// 128-bit unsigned int
+		case 0x43u:		// 128-bit real
+		case 0x51u:		// 64-bit complex
+		case 0x78u:		// 128-bit signed int
+		case 0x79u:		// 128-bit unsigned int
+			return 16u;
+
+		case 0x52u:		// 80-bit complex
+			return 20u;
+
+		case 0x53u:		// 128-bit complex
+			return 32u;
+
+		default:		// no type, void, etc.
+			return 0u;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD size_t PDB::TypeTable::ReadNumericLeaf(const void* data, uint64_t& value) PDB_NO_EXCEPT
+{
+	using namespace CodeView::TPI;
+
+	// values below LF_NUMERIC are stored directly in the leaf
+	uint16_t leaf = 0u;
+	std::memcpy(&leaf, data, sizeof(leaf));
+	if (leaf < PDB_AS_UNDERLYING(TypeRecordKind::LF_NUMERIC))
+	{
+		value = leaf;
+		return sizeof(uint16_t);
+	}
+
+	const Byte* payload = static_cast<const Byte*>(data) + sizeof(uint16_t);
+	switch (static_cast<TypeRecordKind>(leaf))
+	{
+		case TypeRecordKind::LF_CHAR:
+		{
+			int8_t signedValue = 0;
+			std::memcpy(&signedValue, payload, sizeof(signedValue));
+			value = static_cast<uint64_t>(static_cast<int64_t>(signedValue));
+			return sizeof(uint16_t) + sizeof(signedValue);
+		}
+
+		case TypeRecordKind::LF_SHORT:
+		{
+			int16_t signedValue = 0;
+			std::memcpy(&signedValue, payload, sizeof(signedValue));
+			value = static_cast<uint64_t>(static_cast<int64_t>(signedValue));
+			return sizeof(uint16_t) + sizeof(signedValue);
+		}
+
+		case TypeRecordKind::LF_USHORT:
+		{
+			uint16_t unsignedValue = 0u;
+			std::memcpy(&unsignedValue, payload, sizeof(unsignedValue));
+			value = unsignedValue;
+			return sizeof(uint16_t) + sizeof(unsignedValue);
+		}
+
+		case TypeRecordKind::LF_LONG:
+		{
+			int32_t signedValue = 0;
+			std::memcpy(&signedValue, payload, sizeof(signedValue));
+			value = static_cast<uint64_t>(static_cast<int64_t>(signedValue));
+			return sizeof(uint16_t) + sizeof(signedValue);
+		}
+
+		case TypeRecordKind::LF_ULONG:
+		{
+			uint32_t unsignedValue = 0u;
+			std::memcpy(&unsignedValue, payload, sizeof(unsignedValue));
+			value = unsignedValue;
+			return sizeof(uint16_t) + sizeof(unsignedValue);
+		}
+
+		case TypeRecordKind::LF_QUADWORD:
+		case TypeRecordKind::LF_UQUADWORD:
+			std::memcpy(&value, payload, sizeof(value));
+			return sizeof(uint16_t) + sizeof(uint64_t);
+
+		default:
+			return 0u;
+	}
+}
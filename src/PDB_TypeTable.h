@@ -0,0 +1,101 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_TPITypes.h"
+#include "PDB_CoalescedMSFStream.h"
+
+
+namespace PDB
+{
+	class TPIStream;
+
+
+	// Provides O(1) access to the records of the TPI stream by type index, along with type sizes.
+	// Because types are variable-length records, the TPI stream is walked once to store pointers to the individual records.
+	// Forward references to classes, structures, unions and enums are resolved to their definition by name, using a hash
+	// table that is built alongside.
+	class PDB_NO_DISCARD TypeTable
+	{
+	public:
+		TypeTable(void) PDB_NO_EXCEPT;
+		TypeTable(TypeTable&& other) PDB_NO_EXCEPT;
+		TypeTable& operator=(TypeTable&& other) PDB_NO_EXCEPT;
+
+		explicit TypeTable(const TPIStream& tpiStream) PDB_NO_EXCEPT;
+		~TypeTable(void) PDB_NO_EXCEPT;
+
+		// Returns the index of the first type, which is not necessarily zero.
+		PDB_NO_DISCARD inline uint32_t GetFirstTypeIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_typeIndexBegin;
+		}
+
+		// Returns the index of the last type.
+		PDB_NO_DISCARD inline uint32_t GetLastTypeIndex(void) const PDB_NO_EXCEPT
+		{
+			return m_typeIndexEnd;
+		}
+
+		// Returns the record with the given type index, or nullptr for simple types and indices out of range.
+		PDB_NO_DISCARD inline const CodeView::TPI::Record* GetTypeRecord(uint32_t typeIndex) const PDB_NO_EXCEPT
+		{
+			if ((typeIndex < m_typeIndexBegin) || (typeIndex >= m_typeIndexEnd))
+			{
+				return nullptr;
+			}
+
+			return m_records[typeIndex - m_typeIndexBegin];
+		}
+
+		// Returns a view of all type records.
+		// Records identified by a type index can be accessed via "allRecords[typeIndex - firstTypeIndex]".
+		PDB_NO_DISCARD inline ArrayView<const CodeView::TPI::Record*> GetTypeRecords(void) const PDB_NO_EXCEPT
+		{
+			return ArrayView<const CodeView::TPI::Record*>(m_records, m_recordCount);
+		}
+
+		// Returns the type index of the definition of a forward-referenced class, structure, union or enum.
+		// Returns the given type index for all other types, and for forward references without a definition.
+		PDB_NO_DISCARD uint32_t ResolveForwardReference(uint32_t typeIndex) const PDB_NO_EXCEPT;
+
+		// Returns the size of a type in bytes, resolving forward references, modifiers and enums along the way.
+		// Returns 0 for types without a size, e.g. void or functions, and types that cannot be resolved.
+		PDB_NO_DISCARD uint64_t GetTypeSize(uint32_t typeIndex) const PDB_NO_EXCEPT;
+
+		// Returns the name of a class, structure, union or enum record, or nullptr for other records.
+		PDB_NO_DISCARD static const char* GetUserDefinedTypeName(const CodeView::TPI::Record* record) PDB_NO_EXCEPT;
+
+		// Returns the size in bytes of a simple type, i.e. a type index below the first type index, or 0 if it has no size.
+		PDB_NO_DISCARD static uint32_t GetSimpleTypeSize(uint32_t typeIndex) PDB_NO_EXCEPT;
+
+		// Reads a numeric leaf as used for sizes, offsets and enumerator values, storing its value.
+		// Returns the number of bytes occupied by the leaf, or 0 for leaves that are not integers.
+		PDB_NO_DISCARD static size_t ReadNumericLeaf(const void* data, uint64_t& value) PDB_NO_EXCEPT;
+
+	private:
+		PDB_NO_DISCARD uint64_t GetTypeSize(uint32_t typeIndex, unsigned int depth) const PDB_NO_EXCEPT;
+
+		struct DefinitionEntry
+		{
+			uint32_t hash;
+			uint32_t typeIndex;
+		};
+
+		uint32_t m_typeIndexBegin;
+		uint32_t m_typeIndexEnd;
+
+		CoalescedMSFStream m_stream;
+		const CodeView::TPI::Record** m_records;
+		size_t m_recordCount;
+
+		// open-addressing hash table of definitions, indexed by the hash of their (unique) name
+		DefinitionEntry* m_definitions;
+		size_t m_definitionMask;
+
+		PDB_DISABLE_COPY(TypeTable);
+	};
+}
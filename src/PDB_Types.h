@@ -54,6 +54,21 @@ namespace PDB
 
 	static_assert(sizeof(IMAGE_SECTION_HEADER) == 40u, "Size mismatch.");
 
+	// this matches the definition in winnt.h, but we don't want to pull that in
+	struct IMAGE_DEBUG_DIRECTORY
+	{
+		uint32_t Characteristics;
+		uint32_t TimeDateStamp;
+		uint16_t MajorVersion;
+		uint16_t MinorVersion;
+		uint32_t Type;
+		uint32_t SizeOfData;
+		uint32_t AddressOfRawData;
+		uint32_t PointerToRawData;
+	};
+
+	static_assert(sizeof(IMAGE_DEBUG_DIRECTORY) == 28u, "Size mismatch.");
+
 	// https://llvm.org/docs/PDB/MsfFile.html#msf-superblock
 	struct PDB_NO_DISCARD SuperBlock
 	{
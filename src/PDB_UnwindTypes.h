@@ -0,0 +1,125 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_BitOperators.h"
+#include "Foundation/PDB_DisableWarningsPush.h"
+#include <cstdint>
+#include "Foundation/PDB_DisableWarningsPop.h"
+
+
+// x64 exception handling data as stored in the pdata and xdata debug streams
+// https://learn.microsoft.com/en-us/cpp/build/exception-handling-x64
+namespace PDB
+{
+	// header of the pdata and xdata debug streams, based on DbgRvaVaBlob defined here:
+	// https://github.com/microsoft/microsoft-pdb/blob/master/PDB/dbi/dbi.h
+	struct DebugDataStreamHeader
+	{
+		uint32_t version;
+		uint32_t headerSize;					// the data starts right after the header
+		uint32_t dataSize;
+		uint32_t rvaDataBase;					// RVA of the first byte of data in the image
+		uint64_t vaImageBase;
+		uint32_t reserved1;
+		uint32_t reserved2;
+	};
+
+	static_assert(sizeof(DebugDataStreamHeader) == 32u, "Size mismatch.");
+
+	// this matches the definition of IMAGE_RUNTIME_FUNCTION_ENTRY for x64 in winnt.h, but we don't want to pull that in
+	struct IMAGE_RUNTIME_FUNCTION_ENTRY
+	{
+		uint32_t BeginAddress;
+		uint32_t EndAddress;
+		uint32_t UnwindInfoAddress;
+	};
+
+	static_assert(sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY) == 12u, "Size mismatch.");
+
+	enum class PDB_NO_DISCARD UnwindOperation : uint8_t
+	{
+		PushNonVolatile = 0u,					// UWOP_PUSH_NONVOL, 1 slot
+		AllocLarge = 1u,						// UWOP_ALLOC_LARGE, 2 or 3 slots depending on the operation info
+		AllocSmall = 2u,						// UWOP_ALLOC_SMALL, 1 slot
+		SetFramePointer = 3u,					// UWOP_SET_FPREG, 1 slot
+		SaveNonVolatile = 4u,					// UWOP_SAVE_NONVOL, 2 slots
+		SaveNonVolatileFar = 5u,				// UWOP_SAVE_NONVOL_FAR, 3 slots
+		Epilog = 6u,							// UWOP_EPILOG, 2 slots, version 2 only
+		Spare = 7u,								// UWOP_SPARE_CODE, 3 slots
+		SaveXMM128 = 8u,						// UWOP_SAVE_XMM128, 2 slots
+		SaveXMM128Far = 9u,						// UWOP_SAVE_XMM128_FAR, 3 slots
+		PushMachineFrame = 10u					// UWOP_PUSH_MACHFRAME, 1 slot
+	};
+
+	enum class PDB_NO_DISCARD UnwindFlags : uint8_t
+	{
+		None = 0u,
+		ExceptionHandler = 1u << 0u,			// UNW_FLAG_EHANDLER
+		TerminationHandler = 1u << 1u,			// UNW_FLAG_UHANDLER
+		ChainInfo = 1u << 2u					// UNW_FLAG_CHAININFO
+	};
+	PDB_DEFINE_BIT_OPERATORS(UnwindFlags);
+
+	// this matches the definition of UNWIND_CODE, but without the anonymous struct.
+	// slots following an operation that needs operands store these operands as 16-bit values instead, see GetUnwindCodeSlotCount().
+	struct UNWIND_CODE
+	{
+		uint8_t CodeOffset;						// offset of the end of the prolog instruction
+		uint8_t UnwindOp : 4;					// UnwindOperation
+		uint8_t OpInfo : 4;
+	};
+
+	static_assert(sizeof(UNWIND_CODE) == 2u, "Size mismatch.");
+
+	// this matches the definition of UNWIND_INFO.
+	// the unwind codes are followed by either an exception handler RVA and its data, or a chained IMAGE_RUNTIME_FUNCTION_ENTRY,
+	// both aligned to an even number of codes.
+	struct UNWIND_INFO
+	{
+		uint8_t Version : 3;
+		uint8_t Flags : 5;						// UnwindFlags
+		uint8_t SizeOfProlog;
+		uint8_t CountOfCodes;
+		uint8_t FrameRegister : 4;
+		uint8_t FrameOffset : 4;				// scaled by 16
+		PDB_FLEXIBLE_ARRAY_MEMBER(UNWIND_CODE, UnwindCode);
+	};
+
+	// Returns the number of slots occupied by an unwind code and its operands.
+	PDB_NO_DISCARD inline uint32_t GetUnwindCodeSlotCount(const UNWIND_CODE& code) PDB_NO_EXCEPT
+	{
+		switch (static_cast<UnwindOperation>(code.UnwindOp))
+		{
+			case UnwindOperation::AllocLarge:
+				return (code.OpInfo == 0u) ? 2u : 3u;
+
+			case UnwindOperation::SaveNonVolatile:
+			case UnwindOperation::Epilog:
+			case UnwindOperation::SaveXMM128:
+				return 2u;
+
+			case UnwindOperation::SaveNonVolatileFar:
+			case UnwindOperation::Spare:
+			case UnwindOperation::SaveXMM128Far:
+				return 3u;
+
+			case UnwindOperation::PushNonVolatile:
+			case UnwindOperation::AllocSmall:
+			case UnwindOperation::SetFramePointer:
+			case UnwindOperation::PushMachineFrame:
+			default:
+				return 1u;
+		}
+	}
+
+	// Returns the 16-bit operand stored in the slot at the given index, e.g. the scaled offset of UWOP_SAVE_NONVOL.
+	// 32-bit operands are stored in two consecutive slots, low part first.
+	PDB_NO_DISCARD inline uint16_t GetUnwindCodeOperand(const UNWIND_CODE* codes, size_t slotIndex) PDB_NO_EXCEPT
+	{
+		const UNWIND_CODE& slot = codes[slotIndex];
+		return static_cast<uint16_t>(slot.CodeOffset | (slot.UnwindOp << 8u) | (slot.OpInfo << 12u));
+	}
+}
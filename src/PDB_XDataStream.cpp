@@ -0,0 +1,134 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB_PCH.h"
+#include "PDB_XDataStream.h"
+#include "PDB_RawFile.h"
+
+
+namespace
+{
+	// ------------------------------------------------------------------------------------------------
+	// ------------------------------------------------------------------------------------------------
+	PDB_NO_DISCARD static inline size_t GetUnwindInfoSize(const PDB::UNWIND_INFO& unwindInfo) PDB_NO_EXCEPT
+	{
+		// the array of unwind codes always occupies an even number of slots
+		const size_t slotCount = (unwindInfo.CountOfCodes + 1u) & ~1u;
+		return sizeof(PDB::UNWIND_INFO) + slotCount * sizeof(PDB::UNWIND_CODE);
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::XDataStream::XDataStream(void) PDB_NO_EXCEPT
+	: m_stream()
+	, m_header(nullptr)
+	, m_dataSize(0u)
+{
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB::XDataStream::XDataStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT
+	: m_stream(file.CreateMSFStream<CoalescedMSFStream>(streamIndex))
+	, m_header(nullptr)
+	, m_dataSize(0u)
+{
+	if (m_stream.GetSize() < sizeof(DebugDataStreamHeader))
+	{
+		return;
+	}
+
+	const DebugDataStreamHeader* header = m_stream.GetDataAtOffset<DebugDataStreamHeader>(0u);
+	if ((header->headerSize < sizeof(DebugDataStreamHeader)) || (header->headerSize > m_stream.GetSize()))
+	{
+		return;
+	}
+
+	m_header = header;
+	m_dataSize = m_stream.GetSize() - header->headerSize;
+	if (header->dataSize < m_dataSize)
+	{
+		m_dataSize = header->dataSize;
+	}
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::UNWIND_INFO* PDB::XDataStream::GetUnwindInfo(uint32_t unwindInfoRVA) const PDB_NO_EXCEPT
+{
+	if (!m_header || (unwindInfoRVA < m_header->rvaDataBase))
+	{
+		return nullptr;
+	}
+
+	const size_t offset = unwindInfoRVA - m_header->rvaDataBase;
+	if (offset + sizeof(UNWIND_INFO) > m_dataSize)
+	{
+		return nullptr;
+	}
+
+	const UNWIND_INFO* unwindInfo = m_stream.GetDataAtOffset<UNWIND_INFO>(m_header->headerSize + offset);
+	if (offset + GetUnwindInfoSize(*unwindInfo) > m_dataSize)
+	{
+		// the unwind codes are cut off
+		return nullptr;
+	}
+
+	return unwindInfo;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const PDB::IMAGE_RUNTIME_FUNCTION_ENTRY* PDB::XDataStream::GetChainedFunction(const UNWIND_INFO& unwindInfo) const PDB_NO_EXCEPT
+{
+	if ((static_cast<UnwindFlags>(unwindInfo.Flags) & UnwindFlags::ChainInfo) == UnwindFlags::None)
+	{
+		return nullptr;
+	}
+
+	return static_cast<const IMAGE_RUNTIME_FUNCTION_ENTRY*>(GetTrailingData(unwindInfo, sizeof(IMAGE_RUNTIME_FUNCTION_ENTRY)));
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD uint32_t PDB::XDataStream::GetExceptionHandlerRVA(const UNWIND_INFO& unwindInfo) const PDB_NO_EXCEPT
+{
+	// chained unwind information never has a handler of its own
+	const UnwindFlags flags = static_cast<UnwindFlags>(unwindInfo.Flags);
+	if (((flags & UnwindFlags::ChainInfo) != UnwindFlags::None) || ((flags & (UnwindFlags::ExceptionHandler | UnwindFlags::TerminationHandler)) == UnwindFlags::None))
+	{
+		return 0u;
+	}
+
+	const void* data = GetTrailingData(unwindInfo, sizeof(uint32_t));
+	if (!data)
+	{
+		return 0u;
+	}
+
+	uint32_t handlerRVA = 0u;
+	std::memcpy(&handlerRVA, data, sizeof(uint32_t));
+
+	return handlerRVA;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+PDB_NO_DISCARD const void* PDB::XDataStream::GetTrailingData(const UNWIND_INFO& unwindInfo, size_t size) const PDB_NO_EXCEPT
+{
+	// unwind information handed out by this stream is known to lie within the stream's data
+	const size_t offset = m_stream.GetPointerOffset(&unwindInfo) + GetUnwindInfoSize(unwindInfo);
+	if (offset + size > m_header->headerSize + m_dataSize)
+	{
+		return nullptr;
+	}
+
+	return m_stream.GetDataAtOffset<void>(offset);
+}
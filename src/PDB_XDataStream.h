@@ -0,0 +1,64 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "Foundation/PDB_Macros.h"
+#include "Foundation/PDB_ArrayView.h"
+#include "PDB_UnwindTypes.h"
+#include "PDB_CoalescedMSFStream.h"
+
+
+namespace PDB
+{
+	class RawFile;
+
+
+	// A view of the image's x64 unwind information (the UNWIND_INFO structures referenced by the function table), as stored
+	// in the xdata debug stream. Unwind information is addressed by the RVA it has in the image.
+	class PDB_NO_DISCARD XDataStream
+	{
+	public:
+		XDataStream(void) PDB_NO_EXCEPT;
+		explicit XDataStream(const RawFile& file, uint16_t streamIndex) PDB_NO_EXCEPT;
+
+		PDB_DEFAULT_MOVE(XDataStream);
+
+		// Returns the unwind information at the given RVA, or nullptr if it is not part of the stream.
+		PDB_NO_DISCARD const UNWIND_INFO* GetUnwindInfo(uint32_t unwindInfoRVA) const PDB_NO_EXCEPT;
+
+		// Returns the unwind information of the given function table entry, or nullptr if it is not part of the stream.
+		PDB_NO_DISCARD inline const UNWIND_INFO* GetUnwindInfo(const IMAGE_RUNTIME_FUNCTION_ENTRY& function) const PDB_NO_EXCEPT
+		{
+			return GetUnwindInfo(function.UnwindInfoAddress);
+		}
+
+		// Returns a view of the unwind code slots of the given unwind information, in reverse order of the prolog instructions.
+		PDB_NO_DISCARD inline ArrayView<UNWIND_CODE> GetUnwindCodes(const UNWIND_INFO& unwindInfo) const PDB_NO_EXCEPT
+		{
+			return ArrayView<UNWIND_CODE>(unwindInfo.UnwindCode, unwindInfo.CountOfCodes);
+		}
+
+		// Returns the function table entry the given unwind information is chained to, or nullptr if it isn't chained.
+		PDB_NO_DISCARD const IMAGE_RUNTIME_FUNCTION_ENTRY* GetChainedFunction(const UNWIND_INFO& unwindInfo) const PDB_NO_EXCEPT;
+
+		// Returns the RVA of the language-specific exception or termination handler, or 0 if there is none.
+		PDB_NO_DISCARD uint32_t GetExceptionHandlerRVA(const UNWIND_INFO& unwindInfo) const PDB_NO_EXCEPT;
+
+		// Returns the header of the stream.
+		PDB_NO_DISCARD inline const DebugDataStreamHeader* GetHeader(void) const PDB_NO_EXCEPT
+		{
+			return m_header;
+		}
+
+	private:
+		// Returns the data following the unwind codes, or nullptr if the requested size exceeds the stream.
+		PDB_NO_DISCARD const void* GetTrailingData(const UNWIND_INFO& unwindInfo, size_t size) const PDB_NO_EXCEPT;
+
+		CoalescedMSFStream m_stream;
+		const DebugDataStreamHeader* m_header;
+		size_t m_dataSize;
+
+		PDB_DISABLE_COPY(XDataStream);
+	};
+}
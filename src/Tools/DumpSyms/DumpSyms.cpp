@@ -0,0 +1,529 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_MappedFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_InfoStream.h"
+#include "PDB_NamesStream.h"
+#include "PDB_FunctionIndex.h"
+#include "PDB_LineIndex.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// Writes a Breakpad symbol file (https://chromium.googlesource.com/breakpad/breakpad/+/master/docs/symbol_files.md).
+// Functions and lines are taken from a FunctionIndex and a LineIndex, and their records are formatted in parallel in batches
+// of consecutive code ranges, which are then written in address order.
+namespace
+{
+	static const size_t WriterBufferSize = 1u << 20u;
+
+	// number of code ranges whose records are formatted by a single job
+	static const size_t CodeRangesPerBatch = 4096u;
+
+	// the frame type Breakpad uses for frame data described by a program string
+	static const uint32_t FrameDataFrameType = 4u;
+
+
+	struct Public
+	{
+		uint32_t rva;
+		const char* name;
+	};
+
+
+	struct StackRecord
+	{
+		uint32_t frameType;
+		uint32_t rva;
+		uint32_t codeSize;
+		uint32_t prologSize;
+		uint32_t parameterSize;
+		uint32_t savedRegisterSize;
+		uint32_t localSize;
+		uint32_t maxStackSize;
+		const char* programString;									// nullptr if there is none
+		bool allocatesBasePointer;
+	};
+
+
+	// collects output in a large buffer, so that the many small records don't each cause a call into the C runtime
+	class BufferedWriter
+	{
+	public:
+		explicit BufferedWriter(FILE* file)
+			: m_file(file)
+			, m_buffer(WriterBufferSize)
+			, m_size(0u)
+			, m_hasFailed(false)
+		{
+		}
+
+		void Write(const char* data, size_t size)
+		{
+			if (m_size + size > m_buffer.size())
+			{
+				Flush();
+
+				// data that doesn't fit into the buffer is written directly
+				if (size > m_buffer.size())
+				{
+					m_hasFailed |= (fwrite(data, 1u, size, m_file) != size);
+					return;
+				}
+			}
+
+			std::memcpy(m_buffer.data() + m_size, data, size);
+			m_size += size;
+		}
+
+		void Write(const char* string)
+		{
+			Write(string, std::strlen(string));
+		}
+
+		template <typename... Args>
+		void Printf(const char* format, Args... args)
+		{
+			char line[256];
+			const int length = snprintf(line, sizeof(line), format, args...);
+			Write(line, std::min(static_cast<size_t>(length), sizeof(line) - 1u));
+		}
+
+		void Flush(void)
+		{
+			m_hasFailed |= (fwrite(m_buffer.data(), 1u, m_size, m_file) != m_size);
+			m_size = 0u;
+		}
+
+		bool HasFailed(void) const
+		{
+			return m_hasFailed;
+		}
+
+	private:
+		FILE* m_file;
+		std::vector<char> m_buffer;
+		size_t m_size;
+		bool m_hasFailed;
+	};
+
+
+	template <typename F>
+	static void ParallelFor(size_t count, unsigned int threadCount, F&& functor)
+	{
+		std::atomic<size_t> nextIndex(0u);
+		auto run = [count, &nextIndex, &functor]()
+		{
+			for (size_t i = nextIndex.fetch_add(1u); i < count; i = nextIndex.fetch_add(1u))
+			{
+				functor(i);
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (unsigned int i = 1u; i < threadCount; ++i)
+		{
+			threads.emplace_back(run);
+		}
+
+		run();
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	static const char* GetArchitecture(uint16_t machine)
+	{
+		switch (machine)
+		{
+			case 0x014Cu:
+				return "x86";
+
+			case 0x01C4u:
+				return "arm";
+
+			case 0x8664u:
+				return "x86_64";
+
+			case 0xAA64u:
+				return "arm64";
+
+			default:
+				return "unknown";
+		}
+	}
+
+	// returns the ID of the file a line belongs to, which is the index of the file in the list of all files sorted by name offset
+	static size_t GetFileId(const std::vector<const PDB::LineIndex::Line*>& fileLines, const PDB::LineIndex::Line& line)
+	{
+		return static_cast<size_t>(std::lower_bound(fileLines.begin(), fileLines.end(), line.fileNameOffset, [](const PDB::LineIndex::Line* lhs, uint32_t fileNameOffset)
+		{
+			return lhs->fileNameOffset < fileNameOffset;
+		}) - fileLines.begin());
+	}
+
+	// formats the FUNC and LINE records of a batch of code ranges. separated code is written as a function of its own carrying
+	// the name of its parent, so that addresses in e.g. cold code of PGO builds resolve to the function they belong to.
+	// code shared by functions the linker folded is marked with "m", like publics sharing an RVA.
+	static void FormatCodeRanges(const PDB::FunctionIndex& functionIndex, const PDB::LineIndex& lineIndex, const std::vector<const PDB::LineIndex::Line*>& fileLines, size_t begin, size_t end, std::string& text)
+	{
+		const PDB::ArrayView<PDB::FunctionIndex::CodeRange> codeRanges = functionIndex.GetCodeRanges();
+		const PDB::ArrayView<PDB::LineIndex::Line> lines = lineIndex.GetLines();
+
+		char record[64];
+		for (size_t i = begin; i < end; ++i)
+		{
+			const PDB::FunctionIndex::CodeRange& codeRange = codeRanges[i];
+
+			const PDB::FunctionIndex::Function& function = functionIndex.GetFunction(codeRange);
+
+			int length = snprintf(record, sizeof(record), "FUNC %s%x %x 0 ", function.isFolded ? "m " : "", codeRange.rva, codeRange.size);
+			text.append(record, static_cast<size_t>(length));
+			text.append(functionIndex.GetName(function));
+			text.push_back('\n');
+
+			const uint32_t codeRangeEndRVA = codeRange.rva + codeRange.size;
+			const PDB::LineIndex::Line* line = std::lower_bound(lines.begin(), lines.end(), codeRange.rva, [](const PDB::LineIndex::Line& lhs, uint32_t rva)
+			{
+				return lhs.rva < rva;
+			});
+
+			for (/* nothing */; (line != lines.end()) && (line->rva < codeRangeEndRVA); ++line)
+			{
+				// the line index doesn't store hidden lines, but lines can still be empty
+				if (line->size == 0u)
+				{
+					continue;
+				}
+
+				const uint32_t size = std::min(line->size, codeRangeEndRVA - line->rva);
+				length = snprintf(record, sizeof(record), "%x %x %u %zu\n", line->rva, size, line->lineNumber, GetFileId(fileLines, *line));
+				text.append(record, static_cast<size_t>(length));
+			}
+		}
+	}
+
+	static void WritePublics(BufferedWriter& writer, const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream, const PDB::ImageSectionStream& imageSectionStream, const PDB::FunctionIndex& functionIndex)
+	{
+		const PDB::CoalescedMSFStream symbolRecordStream = dbiStream.CreateSymbolRecordStream(rawFile);
+		const PDB::PublicSymbolStream publicSymbolStream = dbiStream.CreatePublicSymbolStream(rawFile);
+
+		std::vector<Public> publics;
+		for (const PDB::HashRecord& hashRecord : publicSymbolStream.GetRecords())
+		{
+			const PDB::CodeView::DBI::Record* record = publicSymbolStream.GetRecord(symbolRecordStream, hashRecord);
+			if ((record->header.kind != PDB::CodeView::DBI::SymbolRecordKind::S_PUB32) ||
+				!PDB_AS_UNDERLYING(record->data.S_PUB32.flags & (PDB::CodeView::DBI::PublicSymbolFlags::Code | PDB::CodeView::DBI::PublicSymbolFlags::Function)))
+			{
+				continue;
+			}
+
+			const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_PUB32.section, record->data.S_PUB32.offset);
+			// code ranges already have a FUNC record
+			const PDB::FunctionIndex::CodeRange* codeRange = (rva != 0u) ? functionIndex.FindCodeRange(rva) : nullptr;
+			if ((rva == 0u) || (codeRange && (codeRange->rva == rva)))
+			{
+				continue;
+			}
+
+			publics.push_back(Public { rva, record->data.S_PUB32.name });
+		}
+
+		// publics are stored in hash order, sort them by RVA and name so the output is stable
+		std::sort(publics.begin(), publics.end(), [](const Public& lhs, const Public& rhs)
+		{
+			return (lhs.rva != rhs.rva) ? (lhs.rva < rhs.rva) : (std::strcmp(lhs.name, rhs.name) < 0);
+		});
+
+		for (size_t i = 0u; i < publics.size(); /* nothing */)
+		{
+			size_t end = i + 1u;
+			while ((end < publics.size()) && (publics[end].rva == publics[i].rva))
+			{
+				++end;
+			}
+
+			writer.Printf("PUBLIC %s%x 0 ", (end - i > 1u) ? "m " : "", publics[i].rva);
+			writer.Write(publics[i].name);
+			writer.Write("\n", 1u);
+
+			i = end;
+		}
+	}
+
+	// x86 images describe their stack frames in the FPO streams. other architectures unwind using the image's unwind information.
+	static void WriteStackRecords(BufferedWriter& writer, const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream, const PDB::NamesStream* namesStream)
+	{
+		std::vector<StackRecord> stackRecords;
+
+		if (dbiStream.HasValidFPOStream(rawFile) == PDB::ErrorCode::Success)
+		{
+			const PDB::FPOStream fpoStream = dbiStream.CreateFPOStream(rawFile);
+			for (const PDB::DBI::FPOData& fpoData : fpoStream.GetFPOData())
+			{
+				stackRecords.push_back(StackRecord
+				{
+					fpoData.frameType,
+					fpoData.offsetStart,
+					fpoData.procedureSize,
+					fpoData.prologSize,
+					fpoData.parameterCount * 4u,
+					fpoData.savedRegisterCount * 4u,
+					fpoData.localCount * 4u,
+					0u,
+					nullptr,
+					fpoData.usesBasePointer != 0u
+				});
+			}
+		}
+
+		// program strings are stored in the /names stream
+		if (namesStream && (dbiStream.HasValidFrameDataStream(rawFile) == PDB::ErrorCode::Success))
+		{
+			const PDB::FrameDataStream frameDataStream = dbiStream.CreateFrameDataStream(rawFile);
+			for (const PDB::DBI::FrameData& frameData : frameDataStream.GetFrameData())
+			{
+				const char* programString = namesStream->GetFilename(frameData.frameFunction);
+				stackRecords.push_back(StackRecord
+				{
+					FrameDataFrameType,
+					frameData.rvaStart,
+					frameData.codeSize,
+					frameData.prologSize,
+					frameData.parameterSize,
+					frameData.savedRegisterSize,
+					frameData.localSize,
+					frameData.maxStackSize,
+					(programString[0] != '\0') ? programString : nullptr,
+					false
+				});
+			}
+		}
+
+		std::stable_sort(stackRecords.begin(), stackRecords.end(), [](const StackRecord& lhs, const StackRecord& rhs)
+		{
+			return lhs.rva < rhs.rva;
+		});
+
+		for (const StackRecord& record : stackRecords)
+		{
+			writer.Printf("STACK WIN %x %x %x %x 0 %x %x %x %x %d ", record.frameType, record.rva, record.codeSize, record.prologSize,
+				record.parameterSize, record.savedRegisterSize, record.localSize, record.maxStackSize, record.programString ? 1 : 0);
+
+			if (record.programString)
+			{
+				writer.Write(record.programString);
+			}
+			else
+			{
+				writer.Write(record.allocatesBasePointer ? "1" : "0", 1u);
+			}
+
+			writer.Write("\n", 1u);
+		}
+	}
+
+	static bool WriteSymbolFile(FILE* file, const char* pdbPath, const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream, unsigned int threadCount)
+	{
+		const PDB::InfoStream infoStream(rawFile);
+		const PDB::ImageSectionStream imageSectionStream = dbiStream.CreateImageSectionStream(rawFile);
+		const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawFile);
+
+		const bool hasNamesStream = infoStream.HasNamesStream();
+		const PDB::NamesStream namesStream = hasNamesStream ? infoStream.CreateNamesStream(rawFile) : PDB::NamesStream();
+
+		const PDB::FunctionIndex functionIndex(rawFile, imageSectionStream, moduleInfoStream);
+
+		// without the /names stream, lines cannot refer to their files
+		const PDB::LineIndex lineIndex = hasNamesStream ? PDB::LineIndex(rawFile, imageSectionStream, moduleInfoStream, namesStream) : PDB::LineIndex();
+
+		// files are identified by their index in the list of all files sorted by name offset, each represented by one of its lines
+		std::vector<const PDB::LineIndex::Line*> fileLines;
+		for (const PDB::LineIndex::Line& line : lineIndex.GetLines())
+		{
+			fileLines.push_back(&line);
+		}
+
+		std::sort(fileLines.begin(), fileLines.end(), [](const PDB::LineIndex::Line* lhs, const PDB::LineIndex::Line* rhs)
+		{
+			return lhs->fileNameOffset < rhs->fileNameOffset;
+		});
+
+		fileLines.erase(std::unique(fileLines.begin(), fileLines.end(), [](const PDB::LineIndex::Line* lhs, const PDB::LineIndex::Line* rhs)
+		{
+			return lhs->fileNameOffset == rhs->fileNameOffset;
+		}), fileLines.end());
+
+		const size_t codeRangeCount = functionIndex.GetCodeRanges().GetLength();
+		std::vector<std::string> batchTexts((codeRangeCount + CodeRangesPerBatch - 1u) / CodeRangesPerBatch);
+
+		ParallelFor(batchTexts.size(), threadCount, [&](size_t batchIndex)
+		{
+			const size_t begin = batchIndex * CodeRangesPerBatch;
+			FormatCodeRanges(functionIndex, lineIndex, fileLines, begin, std::min(begin + CodeRangesPerBatch, codeRangeCount), batchTexts[batchIndex]);
+		});
+
+		BufferedWriter writer(file);
+
+		// the module ID is the GUID and age the executable refers to its PDB with
+		const PDB::GUID& guid = infoStream.GetHeader()->guid;
+		const char* pdbName = std::strrchr(pdbPath, '/');
+		writer.Printf("MODULE windows %s %08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X%X ", GetArchitecture(dbiStream.GetHeader().machine),
+			guid.Data1, guid.Data2, guid.Data3, guid.Data4[0], guid.Data4[1], guid.Data4[2], guid.Data4[3], guid.Data4[4], guid.Data4[5], guid.Data4[6], guid.Data4[7],
+			dbiStream.GetHeader().age);
+		writer.Write(pdbName ? pdbName + 1 : pdbPath);
+		writer.Write("\n", 1u);
+
+		for (size_t i = 0u; i < fileLines.size(); ++i)
+		{
+			writer.Printf("FILE %zu ", i);
+			writer.Write(lineIndex.GetFileName(*fileLines[i]));
+			writer.Write("\n", 1u);
+		}
+
+		// code ranges are sorted by RVA, and so are the batches
+		for (const std::string& batchText : batchTexts)
+		{
+			writer.Write(batchText.data(), batchText.size());
+		}
+
+		WritePublics(writer, rawFile, dbiStream, imageSectionStream, functionIndex);
+		WriteStackRecords(writer, rawFile, dbiStream, hasNamesStream ? &namesStream : nullptr);
+
+		writer.Flush();
+
+		return !writer.HasFailed() && (fflush(file) == 0);
+	}
+
+	// the symbol file is built from these streams, so all of them must be valid before any of them is created
+	PDB_NO_DISCARD static bool HasValidDBIStreams(const char* pdbPath, const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream)
+	{
+		if (dbiStream.HasValidImageSectionStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid image section stream\n", pdbPath);
+
+			return false;
+		}
+
+		if (dbiStream.HasValidSymbolRecordStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid symbol record stream\n", pdbPath);
+
+			return false;
+		}
+
+		if (dbiStream.HasValidPublicSymbolStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid public symbol stream\n", pdbPath);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	static void PrintUsage(void)
+	{
+		fprintf(stderr, "Usage: raw_pdb_dump_syms [--threads <count>] <PDB path> [output path]\n"
+			"Writes a Breakpad symbol file for the PDB to the output path, or to stdout if none is given.\n");
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	unsigned int threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	const char* paths[2] = { nullptr, nullptr };
+	int pathCount = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if ((std::strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+		{
+			threadCount = static_cast<unsigned int>(std::max(std::atoi(argv[++i]), 1));
+		}
+		else if (pathCount < 2)
+		{
+			paths[pathCount++] = argv[i];
+		}
+		else
+		{
+			pathCount = 0;
+			break;
+		}
+	}
+
+	if (pathCount == 0)
+	{
+		PrintUsage();
+		fprintf(stderr, "Error: Incorrect usage\n");
+
+		return 1;
+	}
+
+	// every stream is walked once, so the file is mapped for reading it sequentially
+	const char* pdbPath = paths[0];
+	PDB::MappedFile pdbFile(pdbPath, PDB::MappedFile::ForIndexBuild());
+	if (!pdbFile.IsOpen())
+	{
+		fprintf(stderr, "Cannot memory-map file %s\n", pdbPath);
+
+		return 2;
+	}
+
+	if (PDB::ValidateFile(pdbFile.GetData()) != PDB::ErrorCode::Success)
+	{
+		fprintf(stderr, "File %s is not a valid PDB\n", pdbPath);
+
+		return 2;
+	}
+
+	// the raw file owns the mapping from here on
+	const PDB::RawFile rawFile = PDB::CreateRawFile(std::move(pdbFile));
+	if (PDB::HasValidDBIStream(rawFile) != PDB::ErrorCode::Success)
+	{
+		fprintf(stderr, "File %s is not a valid PDB\n", pdbPath);
+
+		return 2;
+	}
+
+	const PDB::DBIStream dbiStream = PDB::CreateDBIStream(rawFile);
+	if (!HasValidDBIStreams(pdbPath, rawFile, dbiStream))
+	{
+		return 2;
+	}
+
+	FILE* output = paths[1] ? fopen(paths[1], "wb") : stdout;
+	if (!output)
+	{
+		fprintf(stderr, "Cannot create file %s\n", paths[1]);
+
+		return 3;
+	}
+
+	const bool success = WriteSymbolFile(output, pdbPath, rawFile, dbiStream, threadCount);
+	if (!success)
+	{
+		fprintf(stderr, "Cannot write symbol file\n");
+	}
+
+	if (paths[1])
+	{
+		fclose(output);
+	}
+
+	return success ? 0 : 3;
+}
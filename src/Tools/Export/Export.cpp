@@ -0,0 +1,571 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_MappedFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_InfoStream.h"
+#include "PDB_NamesStream.h"
+#include "PDB_TPIStream.h"
+#include "PDB_TypeTable.h"
+#include "PDB_FunctionIndex.h"
+#include "PDB_LineIndex.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// Exports the contents of a PDB as tables stored column by column, for loading into analytical databases.
+// Each column of fixed-width values is stored in a file of its own as a plain array in the machine's byte order. String
+// columns are stored as an array of uint64_t end offsets, one per row, along with a heap holding the strings back to back,
+// which is the layout Arrow uses for its large string arrays. manifest.json lists the tables, their row counts and columns.
+// Functions and lines are taken from a FunctionIndex and a LineIndex, and exporting types builds a TypeTable over the
+// coalesced TPI stream, so memory usage grows with the number of functions, lines and types rather than only depending on
+// the size of the write buffers. All other columns are written while the PDB is being walked.
+namespace
+{
+	static const size_t ColumnBufferSize = 256u * 1024u;
+
+
+	enum class ColumnType
+	{
+		UInt16,
+		UInt32,
+		UInt64,
+		String
+	};
+
+
+	struct ColumnDescription
+	{
+		const char* name;
+		ColumnType type;
+	};
+
+
+	static const char* GetTypeName(ColumnType type)
+	{
+		switch (type)
+		{
+			case ColumnType::UInt16:
+				return "uint16";
+
+			case ColumnType::UInt32:
+				return "uint32";
+
+			case ColumnType::UInt64:
+				return "uint64";
+
+			case ColumnType::String:
+				return "string";
+		}
+
+		return "";
+	}
+
+
+	// an append-only file that is written in large chunks
+	class ColumnFile
+	{
+	public:
+		explicit ColumnFile(const std::string& path)
+			: m_path(path)
+			, m_fd(open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644))
+			, m_buffer(ColumnBufferSize)
+			, m_size(0u)
+			, m_hasFailed(m_fd == -1)
+		{
+		}
+
+		~ColumnFile(void)
+		{
+			Close();
+		}
+
+		void Append(const void* data, size_t size)
+		{
+			if (m_size + size > m_buffer.size())
+			{
+				Flush();
+
+				// data that doesn't fit into the buffer is written directly
+				if (size > m_buffer.size())
+				{
+					WriteAll(data, size);
+					return;
+				}
+			}
+
+			std::memcpy(m_buffer.data() + m_size, data, size);
+			m_size += size;
+		}
+
+		bool Close(void)
+		{
+			if (m_fd != -1)
+			{
+				Flush();
+				m_hasFailed |= (close(m_fd) != 0);
+				m_fd = -1;
+			}
+
+			return !m_hasFailed;
+		}
+
+		const std::string& GetPath(void) const
+		{
+			return m_path;
+		}
+
+	private:
+		void Flush(void)
+		{
+			WriteAll(m_buffer.data(), m_size);
+			m_size = 0u;
+		}
+
+		void WriteAll(const void* data, size_t size)
+		{
+			const char* source = static_cast<const char*>(data);
+			while (!m_hasFailed && (size != 0u))
+			{
+				const ssize_t bytesWritten = write(m_fd, source, size);
+				if ((bytesWritten < 0) && (errno == EINTR))
+				{
+					continue;
+				}
+
+				m_hasFailed = (bytesWritten <= 0);
+				source += (bytesWritten > 0) ? bytesWritten : 0;
+				size -= (bytesWritten > 0) ? static_cast<size_t>(bytesWritten) : 0u;
+			}
+		}
+
+		std::string m_path;
+		int m_fd;
+		std::vector<char> m_buffer;
+		size_t m_size;
+		bool m_hasFailed;
+	};
+
+
+	// writes the rows of a table to one file per column, or two for string columns.
+	// rows are written by calling Add() for each column in the order the columns were declared, followed by EndRow().
+	class TableWriter
+	{
+	public:
+		TableWriter(const std::string& directory, const char* name, std::initializer_list<ColumnDescription> columns)
+			: m_name(name)
+			, m_columns(columns)
+			, m_rowCount(0u)
+			, m_currentColumn(0u)
+		{
+			for (const ColumnDescription& column : m_columns)
+			{
+				const std::string basePath = directory + "/" + m_name + "." + column.name;
+				if (column.type == ColumnType::String)
+				{
+					m_files.emplace_back(new ColumnFile(basePath + ".offsets"));
+					m_heaps.emplace_back(new ColumnFile(basePath + ".heap"));
+				}
+				else
+				{
+					m_files.emplace_back(new ColumnFile(basePath + "." + GetTypeName(column.type)));
+					m_heaps.emplace_back(nullptr);
+				}
+
+				m_heapSizes.push_back(0u);
+			}
+		}
+
+		TableWriter& Add(uint16_t value)
+		{
+			return AddValue(ColumnType::UInt16, &value, sizeof(value));
+		}
+
+		TableWriter& Add(uint32_t value)
+		{
+			return AddValue(ColumnType::UInt32, &value, sizeof(value));
+		}
+
+		TableWriter& Add(uint64_t value)
+		{
+			return AddValue(ColumnType::UInt64, &value, sizeof(value));
+		}
+
+		TableWriter& Add(const char* string)
+		{
+			const size_t length = std::strlen(string);
+			m_heaps[m_currentColumn]->Append(string, length);
+			m_heapSizes[m_currentColumn] += length;
+
+			return AddValue(ColumnType::String, &m_heapSizes[m_currentColumn], sizeof(uint64_t));
+		}
+
+		void EndRow(void)
+		{
+			PDB_ASSERT(m_currentColumn == m_columns.size(), "Row of table %s has %zu values, expected %zu.", m_name.c_str(), m_currentColumn, m_columns.size());
+
+			m_currentColumn = 0u;
+			++m_rowCount;
+		}
+
+		bool Close(void)
+		{
+			bool success = true;
+			for (size_t i = 0u; i < m_files.size(); ++i)
+			{
+				success &= m_files[i]->Close();
+				success &= (!m_heaps[i] || m_heaps[i]->Close());
+			}
+
+			return success;
+		}
+
+		void WriteManifest(std::string& manifest) const
+		{
+			char rowCount[32];
+			snprintf(rowCount, sizeof(rowCount), "%llu", static_cast<unsigned long long>(m_rowCount));
+
+			manifest += "    {\n      \"name\": \"" + m_name + "\",\n      \"rows\": " + rowCount + ",\n      \"columns\": [\n";
+			for (size_t i = 0u; i < m_columns.size(); ++i)
+			{
+				const std::string fileName = m_files[i]->GetPath().substr(m_files[i]->GetPath().rfind('/') + 1u);
+				manifest += std::string("        { \"name\": \"") + m_columns[i].name + "\", \"type\": \"" + GetTypeName(m_columns[i].type) + "\", ";
+				if (m_heaps[i])
+				{
+					const std::string heapName = m_heaps[i]->GetPath().substr(m_heaps[i]->GetPath().rfind('/') + 1u);
+					manifest += "\"offsets\": \"" + fileName + "\", \"heap\": \"" + heapName + "\" }";
+				}
+				else
+				{
+					manifest += "\"file\": \"" + fileName + "\" }";
+				}
+
+				manifest += (i + 1u < m_columns.size()) ? ",\n" : "\n";
+			}
+
+			manifest += "      ]\n    }";
+		}
+
+	private:
+		TableWriter& AddValue(ColumnType type, const void* data, size_t size)
+		{
+			// the type is only checked in builds with assertions enabled
+			(void)type;
+
+			PDB_ASSERT((m_currentColumn < m_columns.size()) && (m_columns[m_currentColumn].type == type), "Value of the wrong type for column %zu of table %s.", m_currentColumn, m_name.c_str());
+
+			m_files[m_currentColumn]->Append(data, size);
+			++m_currentColumn;
+
+			return *this;
+		}
+
+		std::string m_name;
+		std::vector<ColumnDescription> m_columns;
+		std::vector<std::unique_ptr<ColumnFile>> m_files;
+		std::vector<std::unique_ptr<ColumnFile>> m_heaps;
+		std::vector<uint64_t> m_heapSizes;
+		uint64_t m_rowCount;
+		size_t m_currentColumn;
+	};
+
+
+	static void ExportModules(const PDB::ModuleInfoStream& moduleInfoStream, TableWriter& modules)
+	{
+		const PDB::ArrayView<PDB::ModuleInfoStream::Module> moduleArray = moduleInfoStream.GetModules();
+		for (size_t i = 0u; i < moduleArray.GetLength(); ++i)
+		{
+			const PDB::ModuleInfoStream::Module& module = moduleArray[i];
+			modules.Add(static_cast<uint32_t>(i)).Add(module.GetName().Decay()).Add(module.GetObjectName().Decay()).EndRow();
+		}
+	}
+
+	// each code range is a row of its own, so separated code shows up as a row carrying the name of its parent function
+	static void ExportFunctions(const PDB::FunctionIndex& functionIndex, TableWriter& functions)
+	{
+		for (const PDB::FunctionIndex::CodeRange& codeRange : functionIndex.GetCodeRanges())
+		{
+			const PDB::FunctionIndex::Function& function = functionIndex.GetFunction(codeRange);
+			functions.Add(codeRange.rva).Add(codeRange.size).Add(static_cast<uint16_t>(codeRange.kind)).Add(function.moduleIndex).Add(functionIndex.GetName(function)).EndRow();
+		}
+	}
+
+	// lines refer to their file by the offset of its name in the line index, which is the offset column of the files table.
+	// code that isn't part of any function is attributed to module NoModule.
+	static void ExportLines(const PDB::FunctionIndex& functionIndex, const PDB::LineIndex& lineIndex, TableWriter& lines, TableWriter& files)
+	{
+		static const uint32_t NoModule = 0xFFFFFFFFu;
+
+		// each file is represented by one of its lines
+		std::vector<const PDB::LineIndex::Line*> fileLines;
+		for (const PDB::LineIndex::Line& line : lineIndex.GetLines())
+		{
+			const PDB::FunctionIndex::Function* function = functionIndex.FindFunction(line.rva);
+			lines.Add(line.rva).Add(line.size).Add(line.lineNumber).Add(line.fileNameOffset).Add(function ? function->moduleIndex : NoModule).EndRow();
+
+			fileLines.push_back(&line);
+		}
+
+		std::sort(fileLines.begin(), fileLines.end(), [](const PDB::LineIndex::Line* lhs, const PDB::LineIndex::Line* rhs)
+		{
+			return lhs->fileNameOffset < rhs->fileNameOffset;
+		});
+
+		fileLines.erase(std::unique(fileLines.begin(), fileLines.end(), [](const PDB::LineIndex::Line* lhs, const PDB::LineIndex::Line* rhs)
+		{
+			return lhs->fileNameOffset == rhs->fileNameOffset;
+		}), fileLines.end());
+
+		for (const PDB::LineIndex::Line* line : fileLines)
+		{
+			files.Add(line->fileNameOffset).Add(lineIndex.GetFileName(*line)).EndRow();
+		}
+	}
+
+	static void ExportNames(const PDB::NamesStream& namesStream, TableWriter& names)
+	{
+		const char* strings = namesStream.GetFilename(0u);
+		const uint32_t size = namesStream.GetHeader()->size;
+
+		for (uint32_t offset = 0u; offset < size; /* nothing */)
+		{
+			const char* string = strings + offset;
+			const size_t length = strnlen(string, size - offset);
+			if (length == size - offset)
+			{
+				// the last string is not terminated, the stream is corrupt
+				break;
+			}
+
+			names.Add(offset).Add(string).EndRow();
+			offset += static_cast<uint32_t>(length) + 1u;
+		}
+	}
+
+	static void ExportContributions(const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream, const PDB::ImageSectionStream& imageSectionStream, TableWriter& contributions)
+	{
+		const PDB::SectionContributionStream sectionContributionStream = dbiStream.CreateSectionContributionStream(rawFile);
+		for (const PDB::DBI::SectionContribution& contribution : sectionContributionStream.GetContributions())
+		{
+			const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(contribution.section, contribution.offset);
+			if (rva == 0u)
+			{
+				continue;
+			}
+
+			contributions.Add(rva).Add(contribution.size).Add(contribution.characteristics).Add(static_cast<uint32_t>(contribution.moduleIndex)).EndRow();
+		}
+	}
+
+	static void ExportPublics(const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream, const PDB::ImageSectionStream& imageSectionStream, TableWriter& publics)
+	{
+		const PDB::CoalescedMSFStream symbolRecordStream = dbiStream.CreateSymbolRecordStream(rawFile);
+		const PDB::PublicSymbolStream publicSymbolStream = dbiStream.CreatePublicSymbolStream(rawFile);
+		for (const PDB::HashRecord& hashRecord : publicSymbolStream.GetRecords())
+		{
+			const PDB::CodeView::DBI::Record* record = publicSymbolStream.GetRecord(symbolRecordStream, hashRecord);
+			if (record->header.kind != PDB::CodeView::DBI::SymbolRecordKind::S_PUB32)
+			{
+				continue;
+			}
+
+			const uint32_t rva = imageSectionStream.ConvertSectionOffsetToRVA(record->data.S_PUB32.section, record->data.S_PUB32.offset);
+			publics.Add(rva).Add(static_cast<uint32_t>(record->data.S_PUB32.flags)).Add(record->data.S_PUB32.name).EndRow();
+		}
+	}
+
+	// the type table is needed for the sizes of types, which can refer to other types. it stores one pointer per type.
+	static void ExportTypes(const PDB::RawFile& rawFile, TableWriter& types)
+	{
+		const PDB::TPIStream tpiStream = PDB::CreateTPIStream(rawFile);
+		const PDB::TypeTable typeTable(tpiStream);
+
+		uint32_t typeIndex = typeTable.GetFirstTypeIndex();
+		for (const PDB::CodeView::TPI::Record* record : typeTable.GetTypeRecords())
+		{
+			const char* name = PDB::TypeTable::GetUserDefinedTypeName(record);
+			types.Add(typeIndex).Add(static_cast<uint16_t>(record->header.kind)).Add(typeTable.GetTypeSize(typeIndex)).Add(name ? name : "").EndRow();
+
+			++typeIndex;
+		}
+	}
+
+	// every table is exported from one of these streams, so all of them must be valid before any of them is created
+	PDB_NO_DISCARD static bool HasValidStreams(const char* pdbPath, const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream)
+	{
+		if (dbiStream.HasValidImageSectionStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid image section stream\n", pdbPath);
+
+			return false;
+		}
+
+		if (dbiStream.HasValidSymbolRecordStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid symbol record stream\n", pdbPath);
+
+			return false;
+		}
+
+		if (dbiStream.HasValidPublicSymbolStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid public symbol stream\n", pdbPath);
+
+			return false;
+		}
+
+		if ((dbiStream.GetHeader().sectionContributionSize < sizeof(PDB::DBI::SectionContribution::Version)) || (dbiStream.HasValidSectionContributionStream(rawFile) != PDB::ErrorCode::Success))
+		{
+			fprintf(stderr, "File %s has no valid section contribution stream\n", pdbPath);
+
+			return false;
+		}
+
+		if (PDB::HasValidTPIStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid TPI stream\n", pdbPath);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	static void PrintUsage(void)
+	{
+		fprintf(stderr, "Usage: raw_pdb_export <PDB path> <output directory>\n"
+			"Writes the modules, functions, lines, files, names, contributions, publics and types of the PDB as column files.\n");
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc != 3)
+	{
+		PrintUsage();
+		fprintf(stderr, "Error: Incorrect usage\n");
+
+		return 1;
+	}
+
+	const char* pdbPath = argv[1];
+	const std::string directory = argv[2];
+
+	// every stream is walked once, so the file is mapped for reading it sequentially
+	PDB::MappedFile pdbFile(pdbPath, PDB::MappedFile::ForIndexBuild());
+	if (!pdbFile.IsOpen())
+	{
+		fprintf(stderr, "Cannot memory-map file %s\n", pdbPath);
+
+		return 2;
+	}
+
+	if (PDB::ValidateFile(pdbFile.GetData()) != PDB::ErrorCode::Success)
+	{
+		fprintf(stderr, "File %s is not a valid PDB\n", pdbPath);
+
+		return 2;
+	}
+
+	// the raw file owns the mapping from here on
+	const PDB::RawFile rawFile = PDB::CreateRawFile(std::move(pdbFile));
+	if (PDB::HasValidDBIStream(rawFile) != PDB::ErrorCode::Success)
+	{
+		fprintf(stderr, "File %s is not a valid PDB\n", pdbPath);
+
+		return 2;
+	}
+
+	const PDB::DBIStream dbiStream = PDB::CreateDBIStream(rawFile);
+	if (!HasValidStreams(pdbPath, rawFile, dbiStream))
+	{
+		return 2;
+	}
+
+	if ((mkdir(directory.c_str(), 0755) != 0) && (errno != EEXIST))
+	{
+		fprintf(stderr, "Cannot create directory %s\n", directory.c_str());
+
+		return 3;
+	}
+
+	bool success = true;
+	{
+		const PDB::InfoStream infoStream(rawFile);
+		const PDB::ImageSectionStream imageSectionStream = dbiStream.CreateImageSectionStream(rawFile);
+		const PDB::ModuleInfoStream moduleInfoStream = dbiStream.CreateModuleInfoStream(rawFile);
+
+		TableWriter modules(directory, "modules", { { "index", ColumnType::UInt32 }, { "name", ColumnType::String }, { "object_name", ColumnType::String } });
+		TableWriter functions(directory, "functions", { { "rva", ColumnType::UInt32 }, { "size", ColumnType::UInt32 }, { "kind", ColumnType::UInt16 }, { "module", ColumnType::UInt32 }, { "name", ColumnType::String } });
+		TableWriter lines(directory, "lines", { { "rva", ColumnType::UInt32 }, { "size", ColumnType::UInt32 }, { "line", ColumnType::UInt32 }, { "file", ColumnType::UInt32 }, { "module", ColumnType::UInt32 } });
+		TableWriter files(directory, "files", { { "offset", ColumnType::UInt32 }, { "name", ColumnType::String } });
+		TableWriter names(directory, "names", { { "offset", ColumnType::UInt32 }, { "value", ColumnType::String } });
+		TableWriter contributions(directory, "contributions", { { "rva", ColumnType::UInt32 }, { "size", ColumnType::UInt32 }, { "characteristics", ColumnType::UInt32 }, { "module", ColumnType::UInt32 } });
+		TableWriter publics(directory, "publics", { { "rva", ColumnType::UInt32 }, { "flags", ColumnType::UInt32 }, { "name", ColumnType::String } });
+		TableWriter types(directory, "types", { { "index", ColumnType::UInt32 }, { "kind", ColumnType::UInt16 }, { "size", ColumnType::UInt64 }, { "name", ColumnType::String } });
+
+		const bool hasNamesStream = infoStream.HasNamesStream();
+		const PDB::NamesStream namesStream = hasNamesStream ? infoStream.CreateNamesStream(rawFile) : PDB::NamesStream();
+
+		// the indices take care of separated code and hidden lines. without the /names stream, lines cannot refer to their files.
+		{
+			const PDB::FunctionIndex functionIndex(rawFile, imageSectionStream, moduleInfoStream);
+			const PDB::LineIndex lineIndex = hasNamesStream ? PDB::LineIndex(rawFile, imageSectionStream, moduleInfoStream, namesStream) : PDB::LineIndex();
+
+			ExportModules(moduleInfoStream, modules);
+			ExportFunctions(functionIndex, functions);
+			ExportLines(functionIndex, lineIndex, lines, files);
+		}
+
+		if (hasNamesStream)
+		{
+			ExportNames(namesStream, names);
+		}
+
+		ExportContributions(rawFile, dbiStream, imageSectionStream, contributions);
+		ExportPublics(rawFile, dbiStream, imageSectionStream, publics);
+		ExportTypes(rawFile, types);
+
+		const uint16_t byteOrderProbe = 1u;
+		const bool isLittleEndian = (*reinterpret_cast<const uint8_t*>(&byteOrderProbe) == 1u);
+
+		std::string manifest = std::string("{\n  \"byteOrder\": \"") + (isLittleEndian ? "little" : "big") + "\",\n  \"tables\": [\n";
+		const TableWriter* tables[] = { &modules, &functions, &lines, &files, &names, &contributions, &publics, &types };
+		for (size_t i = 0u; i < sizeof(tables) / sizeof(tables[0]); ++i)
+		{
+			tables[i]->WriteManifest(manifest);
+			manifest += (i + 1u < sizeof(tables) / sizeof(tables[0])) ? ",\n" : "\n";
+		}
+
+		manifest += "  ]\n}\n";
+
+		success &= modules.Close() && functions.Close() && lines.Close() && files.Close() && names.Close() && contributions.Close() && publics.Close() && types.Close();
+
+		ColumnFile manifestFile(directory + "/manifest.json");
+		manifestFile.Append(manifest.data(), manifest.size());
+		success &= manifestFile.Close();
+	}
+
+	if (!success)
+	{
+		fprintf(stderr, "Cannot write to directory %s\n", directory.c_str());
+
+		return 3;
+	}
+
+	return 0;
+}
@@ -0,0 +1,526 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_MappedFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_InfoStream.h"
+#include "PDB_Symbolizer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+
+namespace
+{
+	// the reader hands out whatever it parsed from a single read, so interactive use doesn't wait for a batch to fill up
+	static const size_t ReadBufferSize = 64u * 1024u;
+
+	// the number of batches per resolver thread that can be queued, resolved or waiting to be written at the same time.
+	// the reader stops reading from stdin while this many batches are in flight.
+	static const size_t BatchesInFlightPerResolver = 4u;
+
+
+	struct Address
+	{
+		uint32_t rva;
+		bool isValid;												// false for text that is not a hexadecimal RVA
+	};
+
+
+	struct Batch
+	{
+		uint64_t sequence;
+		std::vector<Address> addresses;
+		std::string output;
+	};
+
+
+	// the validated PDB and its streams. the symbolizer and its indices are built the first time they are needed.
+	struct LoadedPDB
+	{
+		LoadedPDB(const PDB::RawFile& file, const PDB::DBIStream& stream)
+			: rawFile(file)
+			, dbiStream(stream)
+			, infoStream(file)
+		{
+		}
+
+		const PDB::Symbolizer& GetSymbolizer(void)
+		{
+			std::call_once(symbolizerFlag, [this]()
+			{
+				symbolizer.reset(new PDB::Symbolizer(rawFile, dbiStream, infoStream));
+
+				// once the indices are built, resolving addresses only touches a few records here and there
+				rawFile.GetMappedFile().Advise(PDB::MappedFile::AccessPattern::Random);
+			});
+
+			return *symbolizer;
+		}
+
+		const PDB::RawFile& rawFile;
+		const PDB::DBIStream& dbiStream;
+		PDB::InfoStream infoStream;
+
+		std::once_flag symbolizerFlag;
+		std::unique_ptr<PDB::Symbolizer> symbolizer;
+	};
+
+
+	// hands batches from the reader to the resolvers, and resolved batches to the writer in the order they were read
+	class Pipeline
+	{
+	public:
+		explicit Pipeline(size_t maxBatchesInFlight)
+			: m_maxBatchesInFlight(maxBatchesInFlight)
+			, m_batchesInFlight(0u)
+			, m_batchesRead(0u)
+			, m_batchesWritten(0u)
+			, m_isClosed(false)
+		{
+		}
+
+		void PushBatch(std::unique_ptr<Batch> batch)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_readerCondition.wait(lock, [this]() { return m_batchesInFlight < m_maxBatchesInFlight; });
+
+				batch->sequence = m_batchesRead++;
+				++m_batchesInFlight;
+				m_pendingBatches.push_back(std::move(batch));
+			}
+
+			m_resolverCondition.notify_one();
+		}
+
+		// signals that the reader has reached the end of the input
+		void Close(void)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_isClosed = true;
+			}
+
+			m_resolverCondition.notify_all();
+			m_writerCondition.notify_one();
+		}
+
+		// returns nullptr once all batches have been handed out
+		std::unique_ptr<Batch> PopBatch(void)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_resolverCondition.wait(lock, [this]() { return !m_pendingBatches.empty() || m_isClosed; });
+			if (m_pendingBatches.empty())
+			{
+				return nullptr;
+			}
+
+			std::unique_ptr<Batch> batch = std::move(m_pendingBatches.front());
+			m_pendingBatches.pop_front();
+
+			return batch;
+		}
+
+		void CompleteBatch(std::unique_ptr<Batch> batch)
+		{
+			bool isNextBatch = false;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				isNextBatch = (batch->sequence == m_batchesWritten);
+				m_completedBatches.emplace(batch->sequence, std::move(batch));
+			}
+
+			// batches completing out of order have to wait for earlier ones anyway
+			if (isNextBatch)
+			{
+				m_writerCondition.notify_one();
+			}
+		}
+
+		// returns completed batches in the order they were read, and nullptr once all batches have been returned
+		std::unique_ptr<Batch> PopCompletedBatch(void)
+		{
+			std::unique_ptr<Batch> batch;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_writerCondition.wait(lock, [this]()
+				{
+					return ((!m_completedBatches.empty()) && (m_completedBatches.begin()->first == m_batchesWritten)) || (m_isClosed && (m_batchesWritten == m_batchesRead));
+				});
+
+				if (m_batchesWritten == m_batchesRead)
+				{
+					return nullptr;
+				}
+
+				batch = std::move(m_completedBatches.begin()->second);
+				m_completedBatches.erase(m_completedBatches.begin());
+
+				++m_batchesWritten;
+				--m_batchesInFlight;
+			}
+
+			m_readerCondition.notify_one();
+
+			return batch;
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_readerCondition;
+		std::condition_variable m_resolverCondition;
+		std::condition_variable m_writerCondition;
+
+		std::deque<std::unique_ptr<Batch>> m_pendingBatches;
+		std::map<uint64_t, std::unique_ptr<Batch>> m_completedBatches;
+
+		const size_t m_maxBatchesInFlight;
+		size_t m_batchesInFlight;
+		uint64_t m_batchesRead;
+		uint64_t m_batchesWritten;
+		bool m_isClosed;
+	};
+
+
+	static bool IsWhitespace(char c)
+	{
+		return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+	}
+
+	// parses a hexadecimal RVA with an optional 0x prefix
+	static Address ParseAddress(const char* token, size_t length)
+	{
+		if ((length > 2u) && (token[0] == '0') && ((token[1] == 'x') || (token[1] == 'X')))
+		{
+			token += 2u;
+			length -= 2u;
+		}
+
+		uint64_t value = 0u;
+		for (size_t i = 0u; i < length; ++i)
+		{
+			const char c = token[i];
+			uint32_t digit = 0u;
+			if ((c >= '0') && (c <= '9'))
+			{
+				digit = static_cast<uint32_t>(c - '0');
+			}
+			else if ((c >= 'a') && (c <= 'f'))
+			{
+				digit = static_cast<uint32_t>(c - 'a' + 10);
+			}
+			else if ((c >= 'A') && (c <= 'F'))
+			{
+				digit = static_cast<uint32_t>(c - 'A' + 10);
+			}
+			else
+			{
+				return Address { 0u, false };
+			}
+
+			value = (value << 4u) | digit;
+			if (value > 0xFFFFFFFFull)
+			{
+				return Address { 0u, false };
+			}
+		}
+
+		return Address { static_cast<uint32_t>(value), true };
+	}
+
+	// parses whitespace-separated addresses. an address at the end of the data might continue in the next read,
+	// so it is left in the pending text unless the end of the input has been reached.
+	static void ParseText(std::string& pendingText, bool isEndOfInput, std::vector<Address>& addresses)
+	{
+		const char* text = pendingText.data();
+		const size_t length = pendingText.size();
+
+		size_t position = 0u;
+		for (;;)
+		{
+			while ((position < length) && IsWhitespace(text[position]))
+			{
+				++position;
+			}
+
+			size_t end = position;
+			while ((end < length) && !IsWhitespace(text[end]))
+			{
+				++end;
+			}
+
+			if ((position == end) || ((end == length) && !isEndOfInput))
+			{
+				break;
+			}
+
+			addresses.push_back(ParseAddress(text + position, end - position));
+			position = end;
+		}
+
+		pendingText.erase(0u, position);
+	}
+
+	// binary input consists of RVAs stored as uint32_t in the native byte order, a trailing partial RVA is ignored
+	static void ParseBinary(std::string& pendingData, std::vector<Address>& addresses)
+	{
+		const size_t count = pendingData.size() / sizeof(uint32_t);
+		for (size_t i = 0u; i < count; ++i)
+		{
+			uint32_t rva = 0u;
+			std::memcpy(&rva, pendingData.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+			addresses.push_back(Address { rva, true });
+		}
+
+		pendingData.erase(0u, count * sizeof(uint32_t));
+	}
+
+	static void RunReader(Pipeline& pipeline, bool isBinary)
+	{
+		std::vector<char> buffer(ReadBufferSize);
+		std::string pendingData;
+
+		for (;;)
+		{
+			const ssize_t bytesRead = read(STDIN_FILENO, buffer.data(), buffer.size());
+			if ((bytesRead < 0) && (errno == EINTR))
+			{
+				continue;
+			}
+
+			const bool isEndOfInput = (bytesRead <= 0);
+			if (!isEndOfInput)
+			{
+				pendingData.append(buffer.data(), static_cast<size_t>(bytesRead));
+			}
+
+			std::unique_ptr<Batch> batch(new Batch);
+			if (isBinary)
+			{
+				ParseBinary(pendingData, batch->addresses);
+			}
+			else
+			{
+				ParseText(pendingData, isEndOfInput, batch->addresses);
+			}
+
+			if (!batch->addresses.empty())
+			{
+				pipeline.PushBatch(std::move(batch));
+			}
+
+			if (isEndOfInput)
+			{
+				break;
+			}
+		}
+
+		pipeline.Close();
+	}
+
+	// each address is written as a line holding the RVA, followed by a line holding the function name and a line holding
+	// its file and line for every frame, innermost inlined function first, followed by an empty line.
+	static void ResolveBatch(LoadedPDB& pdb, Batch& batch, std::vector<PDB::Symbolizer::Frame>& frames)
+	{
+		char line[64];
+		for (const Address& address : batch.addresses)
+		{
+			if (!address.isValid)
+			{
+				batch.output += "invalid address\n??\n??:0\n\n";
+				continue;
+			}
+
+			snprintf(line, sizeof(line), "0x%X\n", address.rva);
+			batch.output += line;
+
+			const PDB::Symbolizer& symbolizer = pdb.GetSymbolizer();
+			uint32_t frameCount = symbolizer.Symbolize(address.rva, frames.data(), static_cast<uint32_t>(frames.size()));
+			if (frameCount > frames.size())
+			{
+				frames.resize(frameCount);
+				frameCount = symbolizer.Symbolize(address.rva, frames.data(), static_cast<uint32_t>(frames.size()));
+			}
+
+			if (frameCount == 0u)
+			{
+				batch.output += "??\n??:0\n";
+			}
+
+			for (uint32_t i = 0u; i < frameCount; ++i)
+			{
+				const PDB::Symbolizer::Frame& frame = frames[i];
+				batch.output += frame.name;
+				batch.output += '\n';
+				batch.output += (frame.fileName[0] != '\0') ? frame.fileName : "??";
+
+				snprintf(line, sizeof(line), ":%u\n", frame.lineNumber);
+				batch.output += line;
+			}
+
+			batch.output += '\n';
+		}
+	}
+
+	static void RunResolver(Pipeline& pipeline, LoadedPDB& pdb)
+	{
+		std::vector<PDB::Symbolizer::Frame> frames(16u);
+		for (;;)
+		{
+			std::unique_ptr<Batch> batch = pipeline.PopBatch();
+			if (!batch)
+			{
+				break;
+			}
+
+			ResolveBatch(pdb, *batch, frames);
+			pipeline.CompleteBatch(std::move(batch));
+		}
+	}
+
+	// the symbolizer is built from these streams, so all of them must be valid before it is constructed
+	PDB_NO_DISCARD static bool HasValidDBIStreams(const char* path, const PDB::RawFile& rawFile, const PDB::DBIStream& dbiStream)
+	{
+		if (dbiStream.HasValidImageSectionStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid image section stream\n", path);
+
+			return false;
+		}
+
+		if (dbiStream.HasValidSymbolRecordStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			fprintf(stderr, "File %s has no valid symbol record stream\n", path);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	static void PrintUsage(void)
+	{
+		fprintf(stderr, "Usage: raw_pdb_symbolize [--binary] [--threads <count>] <PDB path>\n"
+			"Reads RVAs from stdin and writes their functions, files and lines to stdout.\n"
+			"Text input consists of hexadecimal RVAs separated by whitespace, binary input of uint32_t RVAs in native byte order.\n");
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	bool isBinary = false;
+	unsigned int resolverCount = std::max(std::thread::hardware_concurrency(), 1u);
+	const char* path = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--binary") == 0)
+		{
+			isBinary = true;
+		}
+		else if ((std::strcmp(argv[i], "--threads") == 0) && (i + 1 < argc))
+		{
+			resolverCount = static_cast<unsigned int>(std::max(std::atoi(argv[++i]), 1));
+		}
+		else if (!path)
+		{
+			path = argv[i];
+		}
+		else
+		{
+			path = nullptr;
+			break;
+		}
+	}
+
+	if (!path)
+	{
+		PrintUsage();
+		fprintf(stderr, "Error: Incorrect usage\n");
+
+		return 1;
+	}
+
+	// building the symbolizer's indices walks all module streams, so the file is mapped for reading it sequentially
+	PDB::MappedFile pdbFile(path, PDB::MappedFile::ForIndexBuild());
+	if (!pdbFile.IsOpen())
+	{
+		fprintf(stderr, "Cannot memory-map file %s\n", path);
+
+		return 2;
+	}
+
+	if (PDB::ValidateFile(pdbFile.GetData()) != PDB::ErrorCode::Success)
+	{
+		fprintf(stderr, "File %s is not a valid PDB\n", path);
+
+		return 2;
+	}
+
+	// the raw file owns the mapping from here on
+	const PDB::RawFile rawFile = PDB::CreateRawFile(std::move(pdbFile));
+	if (PDB::HasValidDBIStream(rawFile) != PDB::ErrorCode::Success)
+	{
+		fprintf(stderr, "File %s is not a valid PDB\n", path);
+
+		return 2;
+	}
+
+	const PDB::DBIStream dbiStream = PDB::CreateDBIStream(rawFile);
+	if (!HasValidDBIStreams(path, rawFile, dbiStream))
+	{
+		return 2;
+	}
+
+	{
+		LoadedPDB pdb(rawFile, dbiStream);
+		Pipeline pipeline(resolverCount * BatchesInFlightPerResolver);
+
+		std::thread reader(&RunReader, std::ref(pipeline), isBinary);
+
+		std::vector<std::thread> resolvers;
+		for (unsigned int i = 0u; i < resolverCount; ++i)
+		{
+			resolvers.emplace_back(&RunResolver, std::ref(pipeline), std::ref(pdb));
+		}
+
+		// the main thread writes the output, flushing after every batch so that interactive callers see results right away
+		for (;;)
+		{
+			std::unique_ptr<Batch> batch = pipeline.PopCompletedBatch();
+			if (!batch)
+			{
+				break;
+			}
+
+			fwrite(batch->output.data(), 1u, batch->output.size(), stdout);
+			fflush(stdout);
+		}
+
+		reader.join();
+		for (std::thread& resolver : resolvers)
+		{
+			resolver.join();
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,454 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#include "SymbolizeProtocol.h"
+#include "PDB.h"
+#include "PDB_RawFile.h"
+#include "PDB_MappedFile.h"
+#include "PDB_DBIStream.h"
+#include "PDB_InfoStream.h"
+#include "PDB_Symbolizer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+namespace
+{
+	// the number of requests of a single connection that can be queued or resolved at the same time.
+	// the daemon stops reading from a connection that has this many requests in flight, until responses have been sent.
+	static const size_t MaxRequestsInFlight = 64u;
+
+
+	// a PDB that stays memory-mapped with its indices built for the lifetime of the daemon
+	struct LoadedPDB
+	{
+		explicit LoadedPDB(PDB::RawFile&& file)
+			: rawFile(std::move(file))
+			, dbiStream(PDB::CreateDBIStream(rawFile))
+			, infoStream(rawFile)
+			, symbolizer(rawFile, dbiStream, infoStream)
+		{
+		}
+
+		PDB::RawFile rawFile;
+		PDB::DBIStream dbiStream;
+		PDB::InfoStream infoStream;
+		PDB::Symbolizer symbolizer;
+	};
+
+
+	struct Connection
+	{
+		explicit Connection(int socket)
+			: fd(socket)
+			, requestsInFlight(0u)
+		{
+		}
+
+		~Connection(void)
+		{
+			close(fd);
+		}
+
+		int fd;
+
+		// responses are written by several worker threads
+		std::mutex writeMutex;
+
+		std::mutex inFlightMutex;
+		std::condition_variable inFlightCondition;
+		size_t requestsInFlight;
+	};
+
+
+	struct Request
+	{
+		std::shared_ptr<Connection> connection;
+		SymbolizeProtocol::RequestHeader header;
+		std::vector<uint32_t> rvas;
+	};
+
+
+	// requests of all connections are resolved by a shared pool of workers
+	class RequestQueue
+	{
+	public:
+		void Push(Request&& request)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_requests.push_back(std::move(request));
+			}
+
+			m_condition.notify_one();
+		}
+
+		Request Pop(void)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return !m_requests.empty(); });
+
+			Request request = std::move(m_requests.front());
+			m_requests.pop_front();
+
+			return request;
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::deque<Request> m_requests;
+	};
+
+
+	static std::vector<std::unique_ptr<LoadedPDB>> g_pdbs;
+	static RequestQueue g_requestQueue;
+
+
+	static bool ReadAll(int fd, void* buffer, size_t size)
+	{
+		uint8_t* destination = static_cast<uint8_t*>(buffer);
+		while (size != 0u)
+		{
+			const ssize_t bytesRead = read(fd, destination, size);
+			if (bytesRead <= 0)
+			{
+				return false;
+			}
+
+			destination += bytesRead;
+			size -= static_cast<size_t>(bytesRead);
+		}
+
+		return true;
+	}
+
+	static bool WriteAll(int fd, const void* buffer, size_t size)
+	{
+		const uint8_t* source = static_cast<const uint8_t*>(buffer);
+		while (size != 0u)
+		{
+			const ssize_t bytesWritten = write(fd, source, size);
+			if (bytesWritten <= 0)
+			{
+				return false;
+			}
+
+			source += bytesWritten;
+			size -= static_cast<size_t>(bytesWritten);
+		}
+
+		return true;
+	}
+
+	template <typename T>
+	static void Append(std::vector<uint8_t>& buffer, const T* values, size_t count)
+	{
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(values);
+		buffer.insert(buffer.end(), data, data + count * sizeof(T));
+	}
+
+	static void SendResponse(Connection& connection, const std::vector<uint8_t>& response)
+	{
+		std::lock_guard<std::mutex> lock(connection.writeMutex);
+		if (!WriteAll(connection.fd, response.data(), response.size()))
+		{
+			// the client has gone away, make the reader thread stop as well
+			shutdown(connection.fd, SHUT_RDWR);
+		}
+	}
+
+	static void SendStatus(Connection& connection, uint32_t requestId, SymbolizeProtocol::Status status)
+	{
+		const SymbolizeProtocol::ResponseHeader header = { SymbolizeProtocol::ResponseMagic, requestId, status, 0u, 0u, 0u };
+
+		std::vector<uint8_t> response;
+		Append(response, &header, 1u);
+		SendResponse(connection, response);
+	}
+
+	static const LoadedPDB* FindPDB(const PDB::GUID& guid, uint32_t age)
+	{
+		for (const std::unique_ptr<LoadedPDB>& pdb : g_pdbs)
+		{
+			const PDB::Header* header = pdb->infoStream.GetHeader();
+			if ((header->age == age) && (std::memcmp(&header->guid, &guid, sizeof(PDB::GUID)) == 0))
+			{
+				return pdb.get();
+			}
+		}
+
+		return nullptr;
+	}
+
+	static void ResolveRequest(const Request& request)
+	{
+		const LoadedPDB* pdb = FindPDB(request.header.guid, request.header.age);
+		if (!pdb)
+		{
+			SendStatus(*request.connection, request.header.requestId, SymbolizeProtocol::Status::UnknownPDB);
+			return;
+		}
+
+		std::vector<uint32_t> frameCounts;
+		std::vector<SymbolizeProtocol::Frame> frames;
+		std::vector<char> stringTable;
+		frameCounts.reserve(request.rvas.size());
+		frames.reserve(request.rvas.size());
+
+		// names and files are stored once per response. the symbolizer hands out stable pointers, so they identify the strings.
+		std::unordered_map<const char*, uint32_t> stringOffsets;
+		auto addString = [&stringTable, &stringOffsets](const char* string) -> uint32_t
+		{
+			const auto it = stringOffsets.find(string);
+			if (it != stringOffsets.end())
+			{
+				return it->second;
+			}
+
+			const uint32_t offset = static_cast<uint32_t>(stringTable.size());
+			stringTable.insert(stringTable.end(), string, string + std::strlen(string) + 1u);
+			stringOffsets.emplace(string, offset);
+
+			return offset;
+		};
+
+		std::vector<PDB::Symbolizer::Frame> symbolizerFrames(16u);
+		for (const uint32_t rva : request.rvas)
+		{
+			uint32_t frameCount = pdb->symbolizer.Symbolize(rva, symbolizerFrames.data(), static_cast<uint32_t>(symbolizerFrames.size()));
+			if (frameCount > symbolizerFrames.size())
+			{
+				symbolizerFrames.resize(frameCount);
+				frameCount = pdb->symbolizer.Symbolize(rva, symbolizerFrames.data(), static_cast<uint32_t>(symbolizerFrames.size()));
+			}
+
+			frameCounts.push_back(frameCount);
+			for (uint32_t i = 0u; i < frameCount; ++i)
+			{
+				const PDB::Symbolizer::Frame& frame = symbolizerFrames[i];
+				frames.push_back(SymbolizeProtocol::Frame { addString(frame.name), addString(frame.fileName), frame.lineNumber, frame.isInlined ? SymbolizeProtocol::Frame::FlagInlined : 0u });
+			}
+		}
+
+		const SymbolizeProtocol::ResponseHeader header =
+		{
+			SymbolizeProtocol::ResponseMagic,
+			request.header.requestId,
+			SymbolizeProtocol::Status::Success,
+			static_cast<uint32_t>(frameCounts.size()),
+			static_cast<uint32_t>(frames.size()),
+			static_cast<uint32_t>(stringTable.size())
+		};
+
+		std::vector<uint8_t> response;
+		response.reserve(sizeof(header) + frameCounts.size() * sizeof(uint32_t) + frames.size() * sizeof(SymbolizeProtocol::Frame) + stringTable.size());
+		Append(response, &header, 1u);
+		Append(response, frameCounts.data(), frameCounts.size());
+		Append(response, frames.data(), frames.size());
+		Append(response, stringTable.data(), stringTable.size());
+
+		SendResponse(*request.connection, response);
+	}
+
+	static void RunWorker(void)
+	{
+		for (;;)
+		{
+			Request request = g_requestQueue.Pop();
+			ResolveRequest(request);
+
+			Connection& connection = *request.connection;
+			{
+				std::lock_guard<std::mutex> lock(connection.inFlightMutex);
+				--connection.requestsInFlight;
+			}
+
+			connection.inFlightCondition.notify_one();
+		}
+	}
+
+	// reads requests from a connection and hands them to the workers, without waiting for earlier requests to be resolved
+	static void RunConnection(std::shared_ptr<Connection> connection)
+	{
+		for (;;)
+		{
+			Request request;
+			if (!ReadAll(connection->fd, &request.header, sizeof(request.header)))
+			{
+				break;
+			}
+
+			if ((request.header.magic != SymbolizeProtocol::RequestMagic) || (request.header.addressCount > SymbolizeProtocol::MaxAddressCount))
+			{
+				// the rest of the stream cannot be interpreted anymore
+				SendStatus(*connection, request.header.requestId, SymbolizeProtocol::Status::InvalidRequest);
+				break;
+			}
+
+			request.rvas.resize(request.header.addressCount);
+			if (!ReadAll(connection->fd, request.rvas.data(), request.rvas.size() * sizeof(uint32_t)))
+			{
+				break;
+			}
+
+			{
+				std::unique_lock<std::mutex> lock(connection->inFlightMutex);
+				connection->inFlightCondition.wait(lock, [&connection]() { return connection->requestsInFlight < MaxRequestsInFlight; });
+				++connection->requestsInFlight;
+			}
+
+			request.connection = connection;
+			g_requestQueue.Push(std::move(request));
+		}
+
+		// the socket is closed once the workers have sent the responses to all requests read so far
+		shutdown(connection->fd, SHUT_RD);
+	}
+
+	// the symbolizer is built from these streams, so all of them must be valid before it is constructed
+	PDB_NO_DISCARD static bool HasValidDBIStreams(const char* path, const PDB::RawFile& rawFile)
+	{
+		if (PDB::HasValidDBIStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			printf("File %s is not a valid PDB\n", path);
+			return false;
+		}
+
+		const PDB::DBIStream dbiStream = PDB::CreateDBIStream(rawFile);
+		if (dbiStream.HasValidImageSectionStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			printf("File %s has no valid image section stream\n", path);
+			return false;
+		}
+
+		if (dbiStream.HasValidSymbolRecordStream(rawFile) != PDB::ErrorCode::Success)
+		{
+			printf("File %s has no valid symbol record stream\n", path);
+			return false;
+		}
+
+		return true;
+	}
+
+	static bool LoadPDB(const char* path)
+	{
+		// the indices are built once at startup, after that only the few records needed for resolving each address are touched
+		PDB::MappedFile pdbFile(path, PDB::MappedFile::ForPointLookups());
+		if (!pdbFile.IsOpen())
+		{
+			printf("Cannot memory-map file %s\n", path);
+			return false;
+		}
+
+		if (PDB::ValidateFile(pdbFile.GetData()) != PDB::ErrorCode::Success)
+		{
+			printf("File %s is not a valid PDB\n", path);
+			return false;
+		}
+
+		// the raw file owns the mapping from here on, and the file stays mapped until the daemon exits
+		PDB::RawFile rawFile = PDB::CreateRawFile(std::move(pdbFile));
+		if (!HasValidDBIStreams(path, rawFile))
+		{
+			return false;
+		}
+
+		g_pdbs.emplace_back(new LoadedPDB(std::move(rawFile)));
+
+		const PDB::GUID& guid = g_pdbs.back()->infoStream.GetHeader()->guid;
+		printf("Loaded %s, GUID %08x-%04x-%04x-%02x%02x%02x%02x%02x%02x%02x%02x, age %u, %zu functions\n", path,
+			guid.Data1, guid.Data2, guid.Data3, guid.Data4[0], guid.Data4[1], guid.Data4[2], guid.Data4[3], guid.Data4[4], guid.Data4[5], guid.Data4[6], guid.Data4[7],
+			g_pdbs.back()->infoStream.GetHeader()->age, g_pdbs.back()->symbolizer.GetFunctionIndex().GetFunctions().GetLength());
+
+		return true;
+	}
+}
+
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		printf("Usage: raw_pdb_symbolize_daemon <socket path> <PDB path>...\nError: Incorrect usage\n");
+
+		return 1;
+	}
+
+	// PDBs that cannot be loaded are skipped, requests for them are answered with Status::UnknownPDB
+	for (int i = 2; i < argc; ++i)
+	{
+		if (!LoadPDB(argv[i]))
+		{
+			printf("Skipping %s\n", argv[i]);
+		}
+	}
+
+	if (g_pdbs.empty())
+	{
+		printf("No PDB could be loaded\n");
+
+		return 2;
+	}
+
+	const char* socketPath = argv[1];
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (std::strlen(socketPath) >= sizeof(address.sun_path))
+	{
+		printf("Socket path %s is too long\n", socketPath);
+
+		return 3;
+	}
+
+	std::strcpy(address.sun_path, socketPath);
+
+	// a socket left behind by a previous instance would make binding fail
+	unlink(socketPath);
+
+	const int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if ((listenSocket == -1) || (bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) || (listen(listenSocket, SOMAXCONN) != 0))
+	{
+		printf("Cannot listen on socket %s\n", socketPath);
+
+		return 3;
+	}
+
+	// writing to a client that has gone away must not terminate the daemon
+	std::signal(SIGPIPE, SIG_IGN);
+
+	const unsigned int workerCount = std::max(std::thread::hardware_concurrency(), 1u);
+	for (unsigned int i = 0u; i < workerCount; ++i)
+	{
+		std::thread(&RunWorker).detach();
+	}
+
+	printf("Listening on %s using %u workers\n", socketPath, workerCount);
+	fflush(stdout);
+
+	for (;;)
+	{
+		const int clientSocket = accept(listenSocket, nullptr, nullptr);
+		if (clientSocket == -1)
+		{
+			continue;
+		}
+
+		std::thread(&RunConnection, std::make_shared<Connection>(clientSocket)).detach();
+	}
+}
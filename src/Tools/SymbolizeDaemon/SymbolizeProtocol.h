@@ -0,0 +1,65 @@
+// Copyright 2011-2022, Molecular Matters GmbH <office@molecular-matters.com>
+// See LICENSE.txt for licensing details (2-clause BSD License: https://opensource.org/licenses/BSD-2-Clause)
+
+#pragma once
+
+#include "PDB_Types.h"
+
+
+// The binary protocol spoken by the symbolization daemon over a Unix domain socket.
+// All values are stored in the native byte order of the machine, since both sides always run on the same host.
+//
+// A client sends any number of requests without waiting for responses, each consisting of a RequestHeader followed by
+// addressCount RVAs (uint32_t). For every request, the daemon sends a response consisting of a ResponseHeader, followed by
+// - addressCount frame counts (uint32_t), one per RVA,
+// - frameCount Frames, the frames of each RVA stored one after another, innermost inlined function first,
+// - stringTableSize bytes of null-terminated strings, referred to by the frames.
+// Requests are resolved in parallel, so responses can arrive in a different order than the requests were sent. Clients
+// match responses to requests using the request ID. Responses with a status other than Success don't store any data.
+namespace SymbolizeProtocol
+{
+	static const uint32_t RequestMagic = 0x51535052u;				// 'RPSQ'
+	static const uint32_t ResponseMagic = 0x52535052u;				// 'RPSR'
+
+	// requests with more RVAs are rejected, clients split larger batches
+	static const uint32_t MaxAddressCount = 1u << 20u;
+
+	struct RequestHeader
+	{
+		uint32_t magic;
+		uint32_t requestId;										// chosen by the client, echoed in the response
+		PDB::GUID guid;											// GUID and age of the PDB, as stored in the executable's debug directory
+		uint32_t age;
+		uint32_t addressCount;
+	};
+
+	enum class Status : uint32_t
+	{
+		Success = 0u,
+		UnknownPDB,												// the daemon has not loaded a PDB with the requested GUID and age
+		InvalidRequest											// the request had too many RVAs. the daemon closes the connection afterwards.
+	};
+
+	struct ResponseHeader
+	{
+		uint32_t magic;
+		uint32_t requestId;
+		Status status;
+		uint32_t addressCount;
+		uint32_t frameCount;
+		uint32_t stringTableSize;
+	};
+
+	struct Frame
+	{
+		enum : uint32_t
+		{
+			FlagInlined = 1u << 0u
+		};
+
+		uint32_t nameOffset;									// offsets into the string table
+		uint32_t fileNameOffset;
+		uint32_t lineNumber;									// 0 if unknown
+		uint32_t flags;
+	};
+}